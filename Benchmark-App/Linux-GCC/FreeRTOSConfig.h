@@ -0,0 +1,155 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+ * Application specific definitions.
+ *
+ * These definitions should be adjusted for your particular hardware and
+ * application requirements.
+ *
+ * THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+ * FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.  See
+ * http://www.freertos.org/a00110.html
+ *
+ * The benchmarks compare kernel and port options, so options that are being
+ * compared can be overridden from the command line, see the Makefile.
+ *----------------------------------------------------------*/
+
+#define configUSE_PREEMPTION					1
+#define configUSE_IDLE_HOOK						0
+#define configUSE_TICK_HOOK						0
+#define configTICK_RATE_HZ						( 1000 )
+#define configMAX_TASK_NAME_LEN					( 12 )
+#define configUSE_TRACE_FACILITY				1
+#define configUSE_16_BIT_TICKS					0
+#define configIDLE_SHOULD_YIELD					1
+#define configUSE_MUTEXES						1
+#define configCHECK_FOR_STACK_OVERFLOW			0
+#define configUSE_RECURSIVE_MUTEXES				1
+#define configQUEUE_REGISTRY_SIZE				0
+#define configUSE_MALLOC_FAILED_HOOK			1
+#define configUSE_APPLICATION_TASK_TAG			0
+#define configUSE_COUNTING_SEMAPHORES			1
+#define configUSE_ALTERNATIVE_API				0
+#define configUSE_QUEUE_SETS					1
+#define configUSE_TASK_NOTIFICATIONS			1
+#define configSUPPORT_STATIC_ALLOCATION			0
+
+/* Software timer related configuration options. */
+#define configUSE_TIMERS						0
+#define configTIMER_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH				20
+#define configTIMER_TASK_STACK_DEPTH			( configMINIMAL_STACK_SIZE * 2 )
+
+#ifndef configMAX_PRIORITIES
+	#define configMAX_PRIORITIES				( 7 )
+#endif
+
+/* Port options compared by the benchmarks. */
+#ifndef configNUMBER_OF_CORES
+	#define configNUMBER_OF_CORES				1
+#endif
+
+#if( configNUMBER_OF_CORES > 1 )
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION	0
+	#define configUSE_CORE_AFFINITY				1
+#elif !defined( configUSE_PORT_OPTIMISED_TASK_SELECTION )
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
+#endif
+
+#ifndef configUSE_HANDOFF_CONTEXT_SWITCH
+	#define configUSE_HANDOFF_CONTEXT_SWITCH	0
+#endif
+
+#ifndef configUSE_TICKLESS_IDLE
+	#define configUSE_TICKLESS_IDLE				0
+#endif
+
+#ifndef configUSE_VIRTUAL_TIME
+	#define configUSE_VIRTUAL_TIME				0
+#endif
+
+#ifndef configUSE_FIBER_TASKS
+	#define configUSE_FIBER_TASKS				0
+#endif
+
+#ifndef configUSE_TIMING_WHEEL
+	#define configUSE_TIMING_WHEEL				0
+#endif
+
+#ifndef configUSE_INTERRUPT_RECORD_REPLAY
+	#define configUSE_INTERRUPT_RECORD_REPLAY	0
+#endif
+
+#ifndef configUSE_INTERRUPT_LATENCY_HISTOGRAMS
+	#define configUSE_INTERRUPT_LATENCY_HISTOGRAMS	1
+#endif
+
+#if( configUSE_FIBER_TASKS == 1 )
+	/* Tasks execute on their own stack, which must have room for printf() and
+	a host signal frame.  The heap is large enough for the task scaling
+	benchmark. */
+	#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 2048 )
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 256 * 1024 * 1024 ) )
+#else
+	/* In this simulated case, the stack only has to hold one small structure
+	as the real stack is part of the host thread. */
+	#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 70 )
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 16 * 1024 * 1024 ) )
+#endif
+
+/* Co-routine related configuration options. */
+#define configUSE_CO_ROUTINES 					0
+#define configMAX_CO_ROUTINE_PRIORITIES			( 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function.  In most cases the linker will remove unused
+functions anyway. */
+#define INCLUDE_vTaskPrioritySet				1
+#define INCLUDE_uxTaskPriorityGet				1
+#define INCLUDE_vTaskDelete						1
+#define INCLUDE_vTaskCleanUpResources			0
+#define INCLUDE_vTaskSuspend					1
+#define INCLUDE_vTaskDelayUntil					1
+#define INCLUDE_vTaskDelay						1
+#define INCLUDE_uxTaskGetStackHighWaterMark		1
+#define INCLUDE_xTaskGetSchedulerState			1
+#define INCLUDE_xTaskGetIdleTaskHandle			1
+#define INCLUDE_xTaskGetHandle					1
+#define INCLUDE_eTaskGetState					1
+#define INCLUDE_xSemaphoreGetMutexHolder		1
+#define INCLUDE_xTaskAbortDelay					1
+
+/* It is a good idea to define configASSERT() while developing.  configASSERT()
+uses the same semantics as the standard C assert() macro. */
+extern void vAssertCalled( unsigned long ulLine, const char * const pcFileName );
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __LINE__, __FILE__ )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,123 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Context switch benchmark.
+ *
+ * Two tasks of equal priority, above that of the idle task, repeatedly call
+ * taskYIELD(), so every yield switches to the other task.  Before yielding a
+ * task notes the time, and the task switched to measures the time taken for
+ * the switch to complete.  Build with and without
+ * configUSE_HANDOFF_CONTEXT_SWITCH, or configUSE_FIBER_TASKS, set to compare
+ * the ways the simulator can switch between tasks.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The number of switches timed, after the warm up switches that are not. */
+#define csWARM_UP_SWITCHES			( 1000UL )
+#define csTIMED_SWITCHES			( 50000UL )
+
+#define csTASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The two tasks that yield to each other.
+ */
+static void prvYieldingTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The time at which the last task to yield called taskYIELD(). */
+static volatile uint64_t ullYieldTime = 0ULL;
+
+/* The number of switches performed so far, by both tasks. */
+static volatile uint32_t ulSwitches = 0UL;
+
+static BenchmarkStats_t xSwitchLatency;
+static uint64_t ullStartTime = 0ULL;
+
+/*-----------------------------------------------------------*/
+
+void vStartContextSwitchBenchmark( void )
+{
+	vBenchmarkStatsReset( &xSwitchLatency );
+
+	xTaskCreate( prvYieldingTask, "Yield1", configMINIMAL_STACK_SIZE, NULL, csTASK_PRIORITY, NULL );
+	xTaskCreate( prvYieldingTask, "Yield2", configMINIMAL_STACK_SIZE, NULL, csTASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvYieldingTask( void *pvParameters )
+{
+uint64_t ullNow, ullThen;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ullYieldTime = ullBenchmarkTimeNs();
+		taskYIELD();
+		ullNow = ullBenchmarkTimeNs();
+
+		ulSwitches++;
+
+		if( ulSwitches == csWARM_UP_SWITCHES )
+		{
+			ullStartTime = ullNow;
+		}
+		else if( ulSwitches > csWARM_UP_SWITCHES )
+		{
+			/* A tick that preempts this task after it read the time lets
+			another task update ullYieldTime, so the sample is lost. */
+			ullThen = ullYieldTime;
+			if( ullNow > ullThen )
+			{
+				vBenchmarkStatsAdd( &xSwitchLatency, ullNow - ullThen );
+			}
+
+			if( ulSwitches == ( csWARM_UP_SWITCHES + csTIMED_SWITCHES ) )
+			{
+				printf( "configUSE_HANDOFF_CONTEXT_SWITCH = %d\r\n", configUSE_HANDOFF_CONTEXT_SWITCH );
+				printf( "configUSE_FIBER_TASKS = %d\r\n", configUSE_FIBER_TASKS );
+				vBenchmarkPrintRate( "Context switches", csTIMED_SWITCHES, ullNow - ullStartTime );
+				vBenchmarkStatsPrint( "Switch latency", &xSwitchLatency );
+				vTaskEndScheduler();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
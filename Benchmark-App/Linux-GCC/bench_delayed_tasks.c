@@ -0,0 +1,239 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+/*
+ * Delayed tasks benchmark.
+ *
+ * Steps the number of tasks in the Blocked state up, each task repeatedly
+ * calling vTaskDelay() with a pseudo random number of ticks, so tasks are
+ * continuously added to and woken from the delayed task lists.  For each step
+ * reports the rate at which tasks were woken, how many of them woke on a later
+ * tick than the one they asked for, and the time from a task calling
+ * vTaskDelay() to the next task running - which is mostly the time taken to
+ * add the task to the delayed lists.  A task of the lowest priority runs
+ * whenever no delaying task can, so there is always a next task to time.
+ *
+ * Build with configUSE_TIMING_WHEEL set to 1 to hold the delayed tasks on a
+ * timing wheel rather than in sorted lists, and with configUSE_FIBER_TASKS set
+ * to 1 so the cost of switching host threads does not hide that of the lists.
+ * The largest number of tasks can be set with -DdtNUMBER_OF_TASKS in
+ * CONFIG_FLAGS.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#ifndef dtNUMBER_OF_TASKS
+	#define dtNUMBER_OF_TASKS		( 10000UL )
+#endif
+
+/* The number of tasks is multiplied by dtSTEP_FACTOR each step. */
+#define dtFIRST_STEP_TASKS			( 10UL )
+#define dtSTEP_FACTOR				( 10UL )
+
+/* Each task delays for between 1 and xMaxDelay ticks, xMaxDelay being set so
+about dtWAKEUPS_PER_TICK tasks are woken each tick whatever the number of
+tasks, so every step is measured at the same load. */
+#define dtWAKEUPS_PER_TICK			( 2UL )
+
+/* Each step is measured for dtSTEP_TICKS, after the tasks created for it have
+run for at least dtSETTLE_TICKS, and until all the tasks have picked a delay
+from the range used by the step. */
+#define dtSETTLE_TICKS				pdMS_TO_TICKS( 500 )
+#define dtSTEP_TICKS				pdMS_TO_TICKS( 2000 )
+
+#define dtSPINNING_TASK_PRIORITY	( tskIDLE_PRIORITY + 1 )
+#define dtDELAYING_TASK_PRIORITY	( tskIDLE_PRIORITY + 2 )
+#define dtCONTROL_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Creates the delaying tasks for each step and reports the results.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * The tasks that repeatedly delay.  The parameter seeds the delays.
+ */
+static void prvDelayingTask( void *pvParameters );
+
+/*
+ * Runs whenever no other task can.
+ */
+static void prvSpinningTask( void *pvParameters );
+
+/*
+ * Called by whichever task runs after a delaying task blocked.
+ */
+static void prvRecordBlockTime( void );
+
+/*-----------------------------------------------------------*/
+
+/* The time the last delaying task to block called vTaskDelay(), or 0 once the
+next task to run has recorded it. */
+static volatile uint64_t ullBlockTime = 0ULL;
+
+static BenchmarkStats_t xBlockLatency;
+static volatile uint32_t ulWakeups = 0UL;
+static volatile uint32_t ulLateWakeups = 0UL;
+static volatile TickType_t xMaxDelay = ( TickType_t ) 1;
+
+/*-----------------------------------------------------------*/
+
+void vStartDelayedTasksBenchmark( void )
+{
+	vBenchmarkStatsReset( &xBlockLatency );
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, dtCONTROL_TASK_PRIORITY, NULL );
+	xTaskCreate( prvSpinningTask, "Spinning", configMINIMAL_STACK_SIZE, NULL, dtSPINNING_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+uint32_t ulTasks = 0UL, ulTarget = dtFIRST_STEP_TASKS, ulStartWakeups, ulStartLateWakeups;
+uint64_t ullStartTime, ullElapsedNs;
+
+	( void ) pvParameters;
+
+	printf( "configUSE_TIMING_WHEEL = %d, configUSE_FIBER_TASKS = %d\r\n", configUSE_TIMING_WHEEL, configUSE_FIBER_TASKS );
+
+	for( ;; )
+	{
+		xMaxDelay = ( TickType_t ) ( ( 2UL * ulTarget ) / dtWAKEUPS_PER_TICK );
+
+		while( ulTasks < ulTarget )
+		{
+			if( xTaskCreate( prvDelayingTask, "Delaying", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) ( ulTasks + 1UL ), dtDELAYING_TASK_PRIORITY, NULL ) != pdPASS )
+			{
+				printf( "Could only create %lu tasks\r\n", ( unsigned long ) ulTasks );
+				configASSERT( pdFALSE );
+			}
+
+			ulTasks++;
+		}
+
+		vTaskDelay( ( xMaxDelay > dtSETTLE_TICKS ) ? xMaxDelay : dtSETTLE_TICKS );
+
+		taskENTER_CRITICAL();
+		{
+			vBenchmarkStatsReset( &xBlockLatency );
+			ulStartWakeups = ulWakeups;
+			ulStartLateWakeups = ulLateWakeups;
+		}
+		taskEXIT_CRITICAL();
+		ullStartTime = ullBenchmarkTimeNs();
+
+		vTaskDelay( dtSTEP_TICKS );
+
+		ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+
+		printf( "%lu tasks delaying for up to %lu ticks, %lu woke late\r\n",
+				( unsigned long ) ulTasks,
+				( unsigned long ) xMaxDelay,
+				( unsigned long ) ( ulLateWakeups - ulStartLateWakeups ) );
+		vBenchmarkPrintRate( "    Wakeups", ulWakeups - ulStartWakeups, ullElapsedNs );
+		vBenchmarkStatsPrint( "    Block latency", &xBlockLatency );
+
+		if( ulTasks >= dtNUMBER_OF_TASKS )
+		{
+			vTaskEndScheduler();
+		}
+
+		ulTarget = ulTasks * dtSTEP_FACTOR;
+		if( ulTarget > dtNUMBER_OF_TASKS )
+		{
+			ulTarget = dtNUMBER_OF_TASKS;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayingTask( void *pvParameters )
+{
+uint32_t ulRandom = ( uint32_t ) ( uintptr_t ) pvParameters * 2654435761UL;
+TickType_t xDelay, xTimeToWake;
+
+	for( ;; )
+	{
+		/* xorshift32. */
+		ulRandom ^= ulRandom << 13;
+		ulRandom ^= ulRandom >> 17;
+		ulRandom ^= ulRandom << 5;
+		xDelay = ( TickType_t ) ( ulRandom % xMaxDelay ) + ( TickType_t ) 1;
+
+		xTimeToWake = xTaskGetTickCount() + xDelay;
+		ullBlockTime = ullBenchmarkTimeNs();
+		vTaskDelay( xDelay );
+		prvRecordBlockTime();
+
+		ulWakeups++;
+
+		if( xTaskGetTickCount() != xTimeToWake )
+		{
+			ulLateWakeups++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpinningTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		prvRecordBlockTime();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordBlockTime( void )
+{
+uint64_t ullNow;
+
+	taskENTER_CRITICAL();
+	{
+		/* Not set if this task was preempted rather than a delaying task
+		blocking. */
+		if( ullBlockTime != 0ULL )
+		{
+			ullNow = ullBenchmarkTimeNs();
+			vBenchmarkStatsAdd( &xBlockLatency, ullNow - ullBlockTime );
+			ullBlockTime = 0ULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,220 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * EDF scheduling benchmark.
+ *
+ * Two periodic tasks of the same priority share the CPU - a short task that
+ * runs in 4 ticks out of every 5, and a long task that runs in 8 ticks out of
+ * every 40.  Each job's deadline is the start of its next period.  The tasks
+ * are released with vTaskDelayUntil(), and a job's work is done once it has
+ * seen itself running in its number of different ticks, so the work does not
+ * depend on how fast the host is, or on the host stealing time from it.
+ *
+ * Without EDF scheduling the two tasks take turns, a tick at a time, whenever
+ * both are ready, so the short task's jobs take longer than its period and
+ * miss their deadline.  With configUSE_EDF_SCHEDULING set to 1 the task with
+ * the earlier deadline runs first, so the short task only misses a deadline
+ * when the host has not run the simulation for longer than a tick, and the
+ * ticks that were missed are then processed together.  Build with
+ * configINITIAL_TICK_COUNT just below the tick count overflow to check the
+ * order survives it.  Reports the jobs, deadline misses and worst response
+ * time of each task.
+ *
+ * The workers cover the three places EDF orders the ready list - a task made
+ * ready is inserted by deadline, a task that is switched out is reinserted
+ * behind the tasks with the same deadline, and vTaskDelayUntil() moves the
+ * deadline on with each release.  Keeping a priority's ready list in deadline
+ * order makes inserting a task O(n) in the tasks ready at that priority, where
+ * without EDF it is O(1).
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define edfTASKS					( 2UL )
+#define edfRUN_TIME					pdMS_TO_TICKS( 4000 )
+
+#define edfWORKER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define edfCONTROL_TASK_PRIORITY	( tskIDLE_PRIORITY + 2 )
+
+/* The period, and the ticks each job runs in, of each task. */
+static const TickType_t xPeriods[ edfTASKS ] = { 5, 40 };
+static const TickType_t xJobTicks[ edfTASKS ] = { 4, 8 };
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Starts the workers, waits, then reports.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * A periodic task, whose parameter is its index.
+ */
+static void prvWorkerTask( void *pvParameters );
+
+/*
+ * Spin until the calling task has run in xTicks different ticks.
+ */
+static void prvRunForTicks( TickType_t xTicks );
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xWorkers[ edfTASKS ];
+
+/* Set by the control task to stop the workers counting. */
+static volatile BaseType_t xStopped = pdFALSE;
+
+static volatile uint32_t ulJobs[ edfTASKS ], ulMisses[ edfTASKS ];
+static volatile TickType_t xWorstResponse[ edfTASKS ];
+
+/*-----------------------------------------------------------*/
+
+void vStartEDFSchedulingBenchmark( void )
+{
+uint32_t ulTask;
+
+	/* The workers wait to be notified, so both are released on the same
+	tick. */
+	for( ulTask = 0UL; ulTask < edfTASKS; ulTask++ )
+	{
+		xTaskCreate( prvWorkerTask, ( ulTask == 0UL ) ? "Short" : "Long", configMINIMAL_STACK_SIZE, ( void * ) ( size_t ) ulTask, edfWORKER_PRIORITY, &( xWorkers[ ulTask ] ) );
+	}
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, edfCONTROL_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+uint32_t ulTask;
+
+	( void ) pvParameters;
+
+	printf( "configUSE_EDF_SCHEDULING = %d, start tick count %lu\r\n",
+			configUSE_EDF_SCHEDULING,
+			( unsigned long ) xTaskGetTickCount() );
+
+	for( ulTask = 0UL; ulTask < edfTASKS; ulTask++ )
+	{
+		xTaskNotifyGive( xWorkers[ ulTask ] );
+	}
+
+	vTaskDelay( edfRUN_TIME );
+	xStopped = pdTRUE;
+
+	for( ulTask = 0UL; ulTask < edfTASKS; ulTask++ )
+	{
+		printf( "%-6s period %2lu ticks, runs in %lu ticks, jobs %5lu, deadline misses %5lu, worst response %2lu ticks\r\n",
+				pcTaskGetName( xWorkers[ ulTask ] ),
+				( unsigned long ) xPeriods[ ulTask ],
+				( unsigned long ) xJobTicks[ ulTask ],
+				( unsigned long ) ulJobs[ ulTask ],
+				( unsigned long ) ulMisses[ ulTask ],
+				( unsigned long ) xWorstResponse[ ulTask ] );
+	}
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void *pvParameters )
+{
+const uint32_t ulTask = ( uint32_t ) ( size_t ) pvParameters;
+TickType_t xRelease, xResponse;
+
+	ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		/* vTaskDelayUntil() moves the deadline on with each release. */
+		vTaskSetDeadline( NULL, xPeriods[ ulTask ] );
+	}
+	#endif
+
+	xRelease = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		prvRunForTicks( xJobTicks[ ulTask ] );
+
+		/* The ticks from the release up to and including the one the job
+		completed in.  Measured as a difference, as the tick count may
+		overflow. */
+		xResponse = ( xTaskGetTickCount() - xRelease ) + ( TickType_t ) 1;
+
+		if( xStopped == pdFALSE )
+		{
+			ulJobs[ ulTask ]++;
+
+			if( xResponse > xPeriods[ ulTask ] )
+			{
+				ulMisses[ ulTask ]++;
+			}
+
+			if( xResponse > xWorstResponse[ ulTask ] )
+			{
+				xWorstResponse[ ulTask ] = xResponse;
+			}
+		}
+
+		/* A job that overran is released again at once, so its successor's
+		deadline stays on the task's period. */
+		vTaskDelayUntil( &xRelease, xPeriods[ ulTask ] );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunForTicks( TickType_t xTicks )
+{
+TickType_t xLastTick, xTick;
+
+	/* The job is released by the tick, so it starts running in the tick it
+	was released in. */
+	xLastTick = xTaskGetTickCount();
+	xTicks--;
+
+	while( xTicks > ( TickType_t ) 0 )
+	{
+		xTick = xTaskGetTickCount();
+
+		if( xTick != xLastTick )
+		{
+			xLastTick = xTick;
+			xTicks--;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
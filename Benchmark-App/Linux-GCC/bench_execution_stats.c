@@ -0,0 +1,206 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Execution statistics benchmark.
+ *
+ * Two tasks share a priority and never block, so are time sliced, and a
+ * higher priority task runs briefly then delays each tick.  A monitor task
+ * wakes every 10ms, as a monitor polling at 100Hz would, and takes the
+ * execution statistics of the tasks with vTaskGetExecutionStats(), then the
+ * state of all the tasks with uxTaskGetSystemState(), timing both.  Reports
+ * the cost of each way of polling, then the statistics of each task.  Build
+ * with configGENERATE_EXECUTION_STATS set to 1, and run the context-switch
+ * benchmark with and without it to see the cost of keeping the statistics.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define esPOLLS						( 200UL )
+#define esPOLL_PERIOD				pdMS_TO_TICKS( 10 )
+#define esBUSY_NS					( 200000ULL )
+
+#define esSPINNING_TASKS			( 2UL )
+#define esMONITORED_TASKS			( esSPINNING_TASKS + 2UL )
+
+#define esSPIN_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define esPERIODIC_TASK_PRIORITY	( tskIDLE_PRIORITY + 2 )
+#define esMONITOR_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Polls the statistics, then reports them.
+ */
+static void prvMonitorTask( void *pvParameters );
+
+/*
+ * Never blocks.
+ */
+static void prvSpinTask( void *pvParameters );
+
+/*
+ * Runs for esBUSY_NS then delays until the next tick.
+ */
+static void prvPeriodicTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The tasks whose statistics are taken, the idle task being added once the
+scheduler has started. */
+static TaskHandle_t xMonitoredTasks[ esMONITORED_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+void vStartExecutionStatsBenchmark( void )
+{
+	xTaskCreate( prvMonitorTask, "Monitor", configMINIMAL_STACK_SIZE * 2, NULL, esMONITOR_TASK_PRIORITY, NULL );
+	xTaskCreate( prvSpinTask, "Spin1", configMINIMAL_STACK_SIZE, NULL, esSPIN_TASK_PRIORITY, &( xMonitoredTasks[ 0 ] ) );
+	xTaskCreate( prvSpinTask, "Spin2", configMINIMAL_STACK_SIZE, NULL, esSPIN_TASK_PRIORITY, &( xMonitoredTasks[ 1 ] ) );
+	xTaskCreate( prvPeriodicTask, "Periodic", configMINIMAL_STACK_SIZE, NULL, esPERIODIC_TASK_PRIORITY, &( xMonitoredTasks[ 2 ] ) );
+}
+/*-----------------------------------------------------------*/
+
+#if( configGENERATE_EXECUTION_STATS == 1 )
+
+	static void prvMonitorTask( void *pvParameters )
+	{
+	static TaskStatus_t xStatus[ 16 ];
+	TaskExecutionStats_t xFirst[ esMONITORED_TASKS ], xStats[ esMONITORED_TASKS ];
+	BenchmarkStats_t xSnapshotCost, xSystemStateCost;
+	TickType_t xLastWakeTime;
+	uint64_t ullStartTime, ullTotalRunTimeNs = 0ULL;
+	uint32_t ulPoll, ulTask;
+
+		( void ) pvParameters;
+
+		xMonitoredTasks[ esSPINNING_TASKS + 1UL ] = xTaskGetIdleTaskHandle();
+		vBenchmarkStatsReset( &xSnapshotCost );
+		vBenchmarkStatsReset( &xSystemStateCost );
+
+		for( ulTask = 0UL; ulTask < esMONITORED_TASKS; ulTask++ )
+		{
+			vTaskGetExecutionStats( xMonitoredTasks[ ulTask ], &( xFirst[ ulTask ] ) );
+		}
+
+		xLastWakeTime = xTaskGetTickCount();
+
+		for( ulPoll = 0UL; ulPoll < esPOLLS; ulPoll++ )
+		{
+			vTaskDelayUntil( &xLastWakeTime, esPOLL_PERIOD );
+
+			ullStartTime = ullBenchmarkTimeNs();
+
+			for( ulTask = 0UL; ulTask < esMONITORED_TASKS; ulTask++ )
+			{
+				vTaskGetExecutionStats( xMonitoredTasks[ ulTask ], &( xStats[ ulTask ] ) );
+			}
+
+			vBenchmarkStatsAdd( &xSnapshotCost, ullBenchmarkTimeNs() - ullStartTime );
+
+			ullStartTime = ullBenchmarkTimeNs();
+			( void ) uxTaskGetSystemState( xStatus, sizeof( xStatus ) / sizeof( xStatus[ 0 ] ), NULL );
+			vBenchmarkStatsAdd( &xSystemStateCost, ullBenchmarkTimeNs() - ullStartTime );
+		}
+
+		vBenchmarkStatsPrint( "vTaskGetExecutionStats() x4", &xSnapshotCost );
+		vBenchmarkStatsPrint( "uxTaskGetSystemState()", &xSystemStateCost );
+
+		printf( "%-12s %10s %7s %10s %10s %10s\r\n", "Task", "Run ms", "Share", "Switches", "Preempted", "Blocked" );
+
+		for( ulTask = 0UL; ulTask < esMONITORED_TASKS; ulTask++ )
+		{
+			ullTotalRunTimeNs += xStats[ ulTask ].ullRunTimeNs - xFirst[ ulTask ].ullRunTimeNs;
+
+			printf( "%-12s %10.3f %6.1f%% %10lu %10lu %10lu\r\n",
+					pcTaskGetName( xMonitoredTasks[ ulTask ] ),
+					( double ) ( xStats[ ulTask ].ullRunTimeNs - xFirst[ ulTask ].ullRunTimeNs ) / 1e6,
+					( double ) ( xStats[ ulTask ].ullRunTimeNs - xFirst[ ulTask ].ullRunTimeNs ) * 100.0 / ( double ) ( xStats[ ulTask ].ullSnapshotTimeNs - xFirst[ ulTask ].ullSnapshotTimeNs ),
+					( unsigned long ) ( xStats[ ulTask ].ulContextSwitches - xFirst[ ulTask ].ulContextSwitches ),
+					( unsigned long ) ( xStats[ ulTask ].ulPreemptions - xFirst[ ulTask ].ulPreemptions ),
+					( unsigned long ) ( xStats[ ulTask ].ulVoluntaryBlocks - xFirst[ ulTask ].ulVoluntaryBlocks ) );
+		}
+
+		/* The monitor itself runs for the rest of the time. */
+		printf( "Monitored tasks ran for %.1f%% of %.3f ms\r\n",
+				( double ) ullTotalRunTimeNs * 100.0 / ( double ) ( xStats[ 0 ].ullSnapshotTimeNs - xFirst[ 0 ].ullSnapshotTimeNs ),
+				( double ) ( xStats[ 0 ].ullSnapshotTimeNs - xFirst[ 0 ].ullSnapshotTimeNs ) / 1e6 );
+
+		vTaskEndScheduler();
+	}
+
+#else /* configGENERATE_EXECUTION_STATS */
+
+	static void prvMonitorTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configGENERATE_EXECUTION_STATS set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configGENERATE_EXECUTION_STATS */
+/*-----------------------------------------------------------*/
+
+static void prvSpinTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Only preempted, or time sliced. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void *pvParameters )
+{
+uint64_t ullStartTime;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ullStartTime = ullBenchmarkTimeNs();
+
+		while( ( ullBenchmarkTimeNs() - ullStartTime ) < esBUSY_NS )
+		{
+			/* Busy. */
+		}
+
+		vTaskDelay( 1 );
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,125 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Idle wakeups benchmark.
+ *
+ * The only application task blocks for long periods at a time, so the system
+ * is idle almost all of the time.  Reports how often the thread that simulates
+ * the tick woke the host, and how much host processor time the process used,
+ * while idle.  Build with configUSE_TICKLESS_IDLE set to 1 to suppress the tick
+ * while idle.  Also checks the tick count has kept time with the host clock
+ * across the idle periods.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The time the task blocks for each time, and the number of times it does. */
+#define iwBLOCK_TIME				pdMS_TO_TICKS( 100 )
+#define iwPERIODS					( 30UL )
+
+#define iwTASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+#define iwTICK_PERIOD_NS			( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that blocks.
+ */
+static void prvBlockingTask( void *pvParameters );
+
+/*
+ * Return the host processor time used by the process in nanoseconds.
+ */
+static uint64_t prvProcessTimeNs( void );
+
+/*-----------------------------------------------------------*/
+
+void vStartIdleWakeupsBenchmark( void )
+{
+	xTaskCreate( prvBlockingTask, "Blocking", configMINIMAL_STACK_SIZE, NULL, iwTASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvProcessTimeNs( void )
+{
+struct timespec xTime;
+
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &xTime );
+	return ( ( uint64_t ) xTime.tv_sec * 1000000000ULL ) + ( uint64_t ) xTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockingTask( void *pvParameters )
+{
+TickType_t xStartTick, xElapsedTicks;
+uint64_t ullStartTime, ullStartProcessTime, ullElapsedNs, ullProcessNs;
+uint32_t ulPeriod;
+int64_t llDriftNs;
+PortTickStats_t xStartStats, xEndStats;
+
+	( void ) pvParameters;
+
+	/* Start on a tick boundary. */
+	vTaskDelay( 1 );
+	xStartTick = xTaskGetTickCount();
+	ullStartTime = ullBenchmarkTimeNs();
+	ullStartProcessTime = prvProcessTimeNs();
+	vPortGetTickStats( &xStartStats );
+
+	for( ulPeriod = 0; ulPeriod < iwPERIODS; ulPeriod++ )
+	{
+		vTaskDelay( iwBLOCK_TIME );
+	}
+
+	vPortGetTickStats( &xEndStats );
+	ullProcessNs = prvProcessTimeNs() - ullStartProcessTime;
+	ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+	xElapsedTicks = xTaskGetTickCount() - xStartTick;
+
+	/* How far the tick count has moved from the host clock, positive if the
+	tick count is behind. */
+	llDriftNs = ( int64_t ) ullElapsedNs - ( int64_t ) ( ( uint64_t ) xElapsedTicks * iwTICK_PERIOD_NS );
+
+	printf( "configUSE_TICKLESS_IDLE = %d\r\n", configUSE_TICKLESS_IDLE );
+	vBenchmarkPrintRate( "Timer wakeups", xEndStats.ulTimerWakeups - xStartStats.ulTimerWakeups, ullElapsedNs );
+	printf( "%-32s %.1f %%\r\n", "Host processor use", ( ( double ) ullProcessNs * 100.0 ) / ( double ) ullElapsedNs );
+	printf( "%-32s %lu\r\n", "Ticks", ( unsigned long ) xElapsedTicks );
+	printf( "%-32s %lld us\r\n", "Tick drift from host clock", ( long long ) ( llDriftNs / 1000LL ) );
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,297 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+/*
+ * Interrupt latency benchmark.
+ *
+ * A host thread, playing the part of a peripheral, periodically raises a
+ * simulated interrupt whose handler is busy for a while before giving a
+ * semaphore to a task, then raises a second, urgent, interrupt while the first
+ * handler is still running.  The benchmark is run twice - first with both
+ * interrupts at the default (lowest) priority, so the urgent interrupt waits
+ * for the first handler to complete, then with the urgent interrupt at a more
+ * urgent priority, so it nests within the first handler.  Reports the time from
+ * each interrupt being raised to its handler being entered, as recorded by the
+ * port, and from the first interrupt being raised to the task it unblocks
+ * running.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The simulated interrupts used, and the priority the urgent one is given in
+the second run. */
+#define ilPERIPHERAL_INTERRUPT		( 2UL )
+#define ilURGENT_INTERRUPT			( 3UL )
+#define ilURGENT_PRIORITY			( 4UL )
+
+/* How often the peripheral raises the interrupts, how long after the first it
+raises the second, and how long the handler of the first is busy for.  The
+peripheral sleeps between raising the two, so they are raised as intended on a
+host with a single processor. */
+#define ilPERIOD_NS					( 1000000ULL )
+#define ilURGENT_DELAY_NS			( 50000ULL )
+#define ilHANDLER_BUSY_NS			( 250000ULL )
+
+/* The number of interrupts timed in each run. */
+#define ilSAMPLES					( 2000UL )
+
+#define ilTASK_PRIORITY				( configMAX_PRIORITIES - 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that is unblocked by the peripheral interrupt, and that prints the
+ * results.
+ */
+static void prvLatencyTask( void *pvParameters );
+
+/*
+ * The host thread that plays the part of the peripheral.
+ */
+static void *prvPeripheralThread( void *pvParameter );
+
+/*
+ * The handlers of the two simulated interrupts.
+ */
+static uint32_t prvPeripheralInterruptHandler( void );
+static uint32_t prvUrgentInterruptHandler( void );
+
+/*
+ * Wait until ullUntilNs without sleeping, as the handler of a real interrupt
+ * would execute.
+ */
+static void prvBusyWait( uint64_t ullUntilNs );
+
+/*
+ * Sleep until ullUntilNs.
+ */
+static void prvSleepUntil( uint64_t ullUntilNs );
+
+/*
+ * Print the latency histogram recorded by the port for a simulated interrupt.
+ */
+static void prvPrintInterruptLatency( const char *pcName, uint32_t ulInterruptNumber );
+
+/*-----------------------------------------------------------*/
+
+static SemaphoreHandle_t xSemaphore = NULL;
+
+/* When the peripheral last raised its interrupt. */
+static volatile uint64_t ullPeripheralRaisedNs = 0ULL;
+
+/* Set while the peripheral interrupt handler is running, and the number of
+times the urgent interrupt handler ran while it was. */
+static volatile BaseType_t xPeripheralHandlerRunning = pdFALSE;
+static volatile uint32_t ulUrgentNested = 0UL;
+
+/* Cleared to stop the peripheral raising interrupts. */
+static volatile BaseType_t xPeripheralEnabled = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vStartInterruptLatencyBenchmark( void )
+{
+	xSemaphore = xSemaphoreCreateBinary();
+	configASSERT( xSemaphore );
+
+	vPortSetInterruptHandler( ilPERIPHERAL_INTERRUPT, prvPeripheralInterruptHandler );
+	vPortSetInterruptHandler( ilURGENT_INTERRUPT, prvUrgentInterruptHandler );
+
+	xTaskCreate( prvLatencyTask, "Latency", configMINIMAL_STACK_SIZE, NULL, ilTASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBusyWait( uint64_t ullUntilNs )
+{
+	while( ullBenchmarkTimeNs() < ullUntilNs )
+	{
+		/* Spin. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSleepUntil( uint64_t ullUntilNs )
+{
+struct timespec xWakeTime;
+
+	xWakeTime.tv_sec = ( time_t ) ( ullUntilNs / 1000000000ULL );
+	xWakeTime.tv_nsec = ( long ) ( ullUntilNs % 1000000000ULL );
+
+	while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xWakeTime, NULL ) != 0 )
+	{
+		/* Interrupted, sleep again. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheralInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* Simulate the handler having work to do before it can unblock the
+	task. */
+	xPeripheralHandlerRunning = pdTRUE;
+	prvBusyWait( ullBenchmarkTimeNs() + ilHANDLER_BUSY_NS );
+	xPeripheralHandlerRunning = pdFALSE;
+
+	xSemaphoreGiveFromISR( xSemaphore, &xHigherPriorityTaskWoken );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvUrgentInterruptHandler( void )
+{
+	/* Does not use the API, so never requires a context switch. */
+	if( xPeripheralHandlerRunning != pdFALSE )
+	{
+		ulUrgentNested++;
+	}
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvPeripheralThread( void *pvParameter )
+{
+uint64_t ullNextNs;
+
+	( void ) pvParameter;
+
+	ullNextNs = ullBenchmarkTimeNs();
+
+	while( xPeripheralEnabled != pdFALSE )
+	{
+		ullNextNs += ilPERIOD_NS;
+		prvSleepUntil( ullNextNs );
+
+		ullPeripheralRaisedNs = ullBenchmarkTimeNs();
+		vPortGenerateSimulatedInterrupt( ilPERIPHERAL_INTERRUPT );
+
+		/* Raise the urgent interrupt while the peripheral interrupt handler
+		is busy. */
+		prvSleepUntil( ullPeripheralRaisedNs + ilURGENT_DELAY_NS );
+		vPortGenerateSimulatedInterrupt( ilURGENT_INTERRUPT );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintInterruptLatency( const char *pcName, uint32_t ulInterruptNumber )
+{
+	#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+	{
+	PortInterruptLatency_t xLatency;
+	uint32_t ulBucket;
+
+		vPortGetInterruptLatency( ulInterruptNumber, &xLatency );
+		printf( "%-32s %lu interrupts, max %lu ns\r\n", pcName, ( unsigned long ) xLatency.ulCount, ( unsigned long ) xLatency.ulMaxNs );
+
+		for( ulBucket = 0UL; ulBucket < ( uint32_t ) portINTERRUPT_LATENCY_BUCKETS; ulBucket++ )
+		{
+			if( xLatency.ulBuckets[ ulBucket ] != 0UL )
+			{
+				printf( "    %10lu ns and over %10lu\r\n", ( unsigned long ) ( ulBucket == 0UL ? 0UL : ( 1UL << ulBucket ) ), ( unsigned long ) xLatency.ulBuckets[ ulBucket ] );
+			}
+		}
+	}
+	#else
+	{
+		( void ) ulInterruptNumber;
+		printf( "%-32s not recorded, configUSE_INTERRUPT_LATENCY_HISTOGRAMS is 0\r\n", pcName );
+	}
+	#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+}
+/*-----------------------------------------------------------*/
+
+static void prvLatencyTask( void *pvParameters )
+{
+pthread_t xPeripheralThread;
+BenchmarkStats_t xTaskLatency;
+uint32_t ulRun, ulSample;
+int iResult;
+
+	( void ) pvParameters;
+
+	printf( "configUSE_HANDOFF_CONTEXT_SWITCH = %d\r\n", configUSE_HANDOFF_CONTEXT_SWITCH );
+	printf( "configUSE_FIBER_TASKS = %d\r\n", configUSE_FIBER_TASKS );
+
+	for( ulRun = 0UL; ulRun < 2UL; ulRun++ )
+	{
+		if( ulRun == 0UL )
+		{
+			printf( "Equal interrupt priorities:\r\n" );
+		}
+		else
+		{
+			printf( "Urgent interrupt at priority %lu:\r\n", ( unsigned long ) ilURGENT_PRIORITY );
+			vPortSetInterruptPriority( ilURGENT_INTERRUPT, ilURGENT_PRIORITY );
+		}
+
+		#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+		{
+			vPortResetInterruptLatency( ilPERIPHERAL_INTERRUPT );
+			vPortResetInterruptLatency( ilURGENT_INTERRUPT );
+		}
+		#endif
+		vBenchmarkStatsReset( &xTaskLatency );
+		ulUrgentNested = 0UL;
+
+		xPeripheralEnabled = pdTRUE;
+		iResult = pthread_create( &xPeripheralThread, NULL, prvPeripheralThread, NULL );
+		configASSERT( iResult == 0 );
+		( void ) iResult;
+
+		for( ulSample = 0UL; ulSample < ilSAMPLES; ulSample++ )
+		{
+			xSemaphoreTake( xSemaphore, portMAX_DELAY );
+			vBenchmarkStatsAdd( &xTaskLatency, ullBenchmarkTimeNs() - ullPeripheralRaisedNs );
+		}
+
+		xPeripheralEnabled = pdFALSE;
+		pthread_join( xPeripheralThread, NULL );
+
+		prvPrintInterruptLatency( "Peripheral interrupt to handler", ilPERIPHERAL_INTERRUPT );
+		prvPrintInterruptLatency( "Urgent interrupt to handler", ilURGENT_INTERRUPT );
+		printf( "%-32s %lu\r\n", "Urgent handler nested", ( unsigned long ) ulUrgentNested );
+		vBenchmarkStatsPrint( "Peripheral interrupt to task", &xTaskLatency );
+	}
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
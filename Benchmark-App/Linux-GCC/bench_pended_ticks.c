@@ -0,0 +1,180 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Pended ticks benchmark.
+ *
+ * A task suspends the scheduler for a number of ticks, as a long heap
+ * operation or a stall of the host would, while other tasks are delayed with
+ * wake times spread over the same ticks.  The ticks that occur meanwhile are
+ * pended, and processed when the scheduler is resumed.  Reports the time
+ * xTaskResumeAll() takes to process them, for each length of the suspension,
+ * and how many of the delayed tasks woke on a later tick than the one they
+ * asked for - which should be only those whose wake time fell within the
+ * suspension.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define ptNUMBER_OF_TASKS			( 100UL )
+
+/* The suspensions measured, in ticks, each repeated ptREPEATS times. */
+#define ptFIRST_SUSPENSION			( 10UL )
+#define ptLAST_SUSPENSION			( 1000UL )
+#define ptSTEP_FACTOR				( 10UL )
+#define ptREPEATS					( 5UL )
+
+/* The delaying tasks delay for between 1 and ptMAX_DELAY ticks. */
+#define ptMAX_DELAY					( ( TickType_t ) 200 )
+
+#define ptDELAYING_TASK_PRIORITY	( tskIDLE_PRIORITY + 1 )
+#define ptCONTROL_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Suspends the scheduler for each length of time and reports the results.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * The tasks that repeatedly delay.  The parameter seeds the delays.
+ */
+static void prvDelayingTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static volatile uint32_t ulWakeups = 0UL;
+static volatile uint32_t ulLateWakeups = 0UL;
+
+/*-----------------------------------------------------------*/
+
+void vStartPendedTicksBenchmark( void )
+{
+uint32_t ulTask;
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, ptCONTROL_TASK_PRIORITY, NULL );
+
+	for( ulTask = 0UL; ulTask < ptNUMBER_OF_TASKS; ulTask++ )
+	{
+		xTaskCreate( prvDelayingTask, "Delaying", configMINIMAL_STACK_SIZE, ( void * ) ( uintptr_t ) ( ulTask + 1UL ), ptDELAYING_TASK_PRIORITY, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+uint32_t ulSuspension, ulRepeat, ulStartWakeups, ulStartLateWakeups;
+uint64_t ullStallNs, ullStart, ullNow;
+TickType_t xTicksBefore, xTicksCaughtUp;
+BenchmarkStats_t xResumeLatency;
+
+	( void ) pvParameters;
+
+	printf( "configUSE_TIMING_WHEEL = %d, configUSE_FIBER_TASKS = %d\r\n", configUSE_TIMING_WHEEL, configUSE_FIBER_TASKS );
+
+	/* Let the delaying tasks spread their wake times. */
+	vTaskDelay( ptMAX_DELAY );
+
+	for( ulSuspension = ptFIRST_SUSPENSION; ulSuspension <= ptLAST_SUSPENSION; ulSuspension *= ptSTEP_FACTOR )
+	{
+		vBenchmarkStatsReset( &xResumeLatency );
+		ullStallNs = ( uint64_t ) ulSuspension * ( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ );
+		xTicksCaughtUp = ( TickType_t ) 0;
+		ulStartWakeups = ulWakeups;
+		ulStartLateWakeups = ulLateWakeups;
+
+		for( ulRepeat = 0UL; ulRepeat < ptREPEATS; ulRepeat++ )
+		{
+			xTicksBefore = xTaskGetTickCount();
+			vTaskSuspendAll();
+			{
+				/* The tick interrupt continues, but the ticks are pended. */
+				ullStart = ullBenchmarkTimeNs();
+				do
+				{
+					ullNow = ullBenchmarkTimeNs();
+				} while( ( ullNow - ullStart ) < ullStallNs );
+			}
+			ullStart = ullBenchmarkTimeNs();
+			( void ) xTaskResumeAll();
+
+			/* Any preemption, by the tick, is of a lower priority task, so
+			happens only once this task blocks. */
+			ullNow = ullBenchmarkTimeNs();
+			vBenchmarkStatsAdd( &xResumeLatency, ullNow - ullStart );
+			xTicksCaughtUp += xTaskGetTickCount() - xTicksBefore;
+
+			/* Let the woken tasks run and delay again. */
+			vTaskDelay( ptMAX_DELAY );
+		}
+
+		printf( "Suspended for %lu ticks, %lu ticks caught up per resume, %lu of %lu wakeups late\r\n",
+				( unsigned long ) ulSuspension,
+				( unsigned long ) ( xTicksCaughtUp / ( TickType_t ) ptREPEATS ),
+				( unsigned long ) ( ulLateWakeups - ulStartLateWakeups ),
+				( unsigned long ) ( ulWakeups - ulStartWakeups ) );
+		vBenchmarkStatsPrint( "    Resume latency", &xResumeLatency );
+	}
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvDelayingTask( void *pvParameters )
+{
+uint32_t ulRandom = ( uint32_t ) ( uintptr_t ) pvParameters * 2654435761UL;
+TickType_t xDelay, xTimeToWake;
+
+	for( ;; )
+	{
+		/* xorshift32. */
+		ulRandom ^= ulRandom << 13;
+		ulRandom ^= ulRandom >> 17;
+		ulRandom ^= ulRandom << 5;
+		xDelay = ( TickType_t ) ( ulRandom % ptMAX_DELAY ) + ( TickType_t ) 1;
+
+		xTimeToWake = xTaskGetTickCount() + xDelay;
+		vTaskDelay( xDelay );
+
+		ulWakeups++;
+
+		if( xTaskGetTickCount() != xTimeToWake )
+		{
+			ulLateWakeups++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
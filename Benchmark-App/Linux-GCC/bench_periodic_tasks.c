@@ -0,0 +1,234 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Periodic tasks benchmark.
+ *
+ * Sensor tasks created with xTaskCreatePeriodic() share a period, each with
+ * its own phase, as the sensor tasks of the demos would.  The last is created
+ * by the monitor task once the scheduler has been running for a while, to show
+ * it still takes up its phase.  Every job notes the tick count, relative to
+ * the period, at which it starts, and one task overruns every so often, so
+ * misses its deadline.  Tasks of a lower priority spin in the background, so
+ * the sensors always preempt another task.  Reports the phase each task ran
+ * at, its deadline misses, and its release latency histogram.  Build with
+ * configUSE_PERIODIC_TASKS set to 1.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define ptSENSOR_TASKS				( 4UL )
+#define ptPERIOD					pdMS_TO_TICKS( 10 )
+#define ptPHASE_STEP				pdMS_TO_TICKS( 2 )
+#define ptDEADLINE					pdMS_TO_TICKS( 3 )
+#define ptRUN_TIME					pdMS_TO_TICKS( 2000 )
+#define ptLATE_SENSOR_DELAY			pdMS_TO_TICKS( 333 )
+
+/* The sensor that overruns, and how often. */
+#define ptOVERRUNNING_SENSOR		( 1UL )
+#define ptOVERRUN_EVERY				( 50UL )
+#define ptJOB_NS					( 100000ULL )
+#define ptOVERRUN_NS				( 4000000ULL )
+
+#define ptBACKGROUND_TASK_PRIORITY	( tskIDLE_PRIORITY + 1 )
+#define ptSENSOR_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+#define ptMONITOR_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Creates the last sensor, waits, then reports.
+ */
+static void prvMonitorTask( void *pvParameters );
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	/*
+	 * A periodic task, whose parameter is its index.
+	 */
+	static void prvSensorTask( void *pvParameters );
+
+#endif
+
+/*
+ * Spins.
+ */
+static void prvBackgroundTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static TaskHandle_t xSensors[ ptSENSOR_TASKS ];
+
+	/* Bit n of ulPhasesSeen[ x ] is set if sensor x started a job n ticks into
+	a period. */
+	static volatile uint32_t ulPhasesSeen[ ptSENSOR_TASKS ];
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartPeriodicTasksBenchmark( void )
+{
+	xTaskCreate( prvMonitorTask, "Monitor", configMINIMAL_STACK_SIZE * 2, NULL, ptMONITOR_TASK_PRIORITY, NULL );
+	xTaskCreate( prvBackgroundTask, "Spin1", configMINIMAL_STACK_SIZE, NULL, ptBACKGROUND_TASK_PRIORITY, NULL );
+	xTaskCreate( prvBackgroundTask, "Spin2", configMINIMAL_STACK_SIZE, NULL, ptBACKGROUND_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvMonitorTask( void *pvParameters )
+	{
+	PeriodicTaskStats_t xStats;
+	uint32_t ulSensor, ulBucket, ulPhase;
+	char cName[ configMAX_TASK_NAME_LEN ];
+
+		( void ) pvParameters;
+
+		/* The first sensors are created after the scheduler has started, but
+		before any tick, so are first released at their phase. */
+		for( ulSensor = 0UL; ulSensor < ptSENSOR_TASKS; ulSensor++ )
+		{
+			if( ulSensor == ( ptSENSOR_TASKS - 1UL ) )
+			{
+				/* The last sensor is created part way through a period. */
+				vTaskDelay( ptLATE_SENSOR_DELAY );
+			}
+
+			snprintf( cName, sizeof( cName ), "Sensor%lu", ( unsigned long ) ulSensor );
+			xTaskCreatePeriodic( prvSensorTask, cName, configMINIMAL_STACK_SIZE, ( void * ) ( size_t ) ulSensor, ptSENSOR_TASK_PRIORITY,
+								 ptPERIOD, ( TickType_t ) ulSensor * ptPHASE_STEP, ptDEADLINE, &( xSensors[ ulSensor ] ) );
+		}
+
+		vTaskDelay( ptRUN_TIME );
+
+		printf( "Period %lu ticks, deadline %lu ticks\r\n", ( unsigned long ) ptPERIOD, ( unsigned long ) ptDEADLINE );
+
+		for( ulSensor = 0UL; ulSensor < ptSENSOR_TASKS; ulSensor++ )
+		{
+			configASSERT( xTaskGetPeriodicStats( xSensors[ ulSensor ], &xStats ) == pdPASS );
+
+			printf( "%-10s phase %2lu, started at", pcTaskGetName( xSensors[ ulSensor ] ), ( unsigned long ) ( ulSensor * ptPHASE_STEP ) );
+
+			for( ulPhase = 0UL; ulPhase < ptPERIOD; ulPhase++ )
+			{
+				if( ( ulPhasesSeen[ ulSensor ] & ( 1UL << ulPhase ) ) != 0UL )
+				{
+					printf( " %lu", ( unsigned long ) ulPhase );
+				}
+			}
+
+			printf( ", releases %lu, deadline misses %lu, max latency %lu ns\r\n",
+					( unsigned long ) xStats.ulReleases,
+					( unsigned long ) xStats.ulDeadlineMisses,
+					( unsigned long ) xStats.ulMaxLatencyNs );
+
+			printf( "           latency <1us %lu", ( unsigned long ) xStats.ulLatencyBuckets[ 0 ] );
+
+			for( ulBucket = 1UL; ulBucket < configPERIODIC_TASK_LATENCY_BUCKETS; ulBucket++ )
+			{
+				if( xStats.ulLatencyBuckets[ ulBucket ] != 0UL )
+				{
+					printf( ", <%luus %lu", 1UL << ulBucket, ( unsigned long ) xStats.ulLatencyBuckets[ ulBucket ] );
+				}
+			}
+
+			printf( "\r\n" );
+		}
+
+		vTaskEndScheduler();
+	}
+
+#else /* configUSE_PERIODIC_TASKS */
+
+	static void prvMonitorTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configUSE_PERIODIC_TASKS set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvSensorTask( void *pvParameters )
+	{
+	const uint32_t ulSensor = ( uint32_t ) ( size_t ) pvParameters;
+	uint32_t ulJob = 0UL;
+	uint64_t ullStartTime, ullJobNs;
+
+		for( ;; )
+		{
+			xTaskWaitForNextPeriod();
+
+			ulPhasesSeen[ ulSensor ] |= 1UL << ( ( xTaskGetTickCount() - ( TickType_t ) configINITIAL_TICK_COUNT ) % ptPERIOD );
+			ulJob++;
+
+			if( ( ulSensor == ptOVERRUNNING_SENSOR ) && ( ( ulJob % ptOVERRUN_EVERY ) == 0UL ) )
+			{
+				ullJobNs = ptOVERRUN_NS;
+			}
+			else
+			{
+				ullJobNs = ptJOB_NS;
+			}
+
+			ullStartTime = ullBenchmarkTimeNs();
+
+			while( ( ullBenchmarkTimeNs() - ullStartTime ) < ullJobNs )
+			{
+				/* Sample the sensor. */
+			}
+		}
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+static void prvBackgroundTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		/* Only preempted, or time sliced. */
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,357 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+/*
+ * Peripheral load benchmark.
+ *
+ * Three simulated peripherals feed a task each, as in the RTOS_IPC pipeline - a
+ * UART writing bytes to a stream buffer, an ADC sending periodic samples to a
+ * queue, and a network interface writing bursts of packets to a message
+ * buffer.  Each task spends a fixed time processing every byte, sample or
+ * packet byte it receives.  The rate of all three peripherals is doubled every
+ * step until more than plSATURATION_PERCENT of what they produce is dropped,
+ * which is the point at which the tasks, the kernel and the port together can
+ * no longer keep up.  Reports, for each step, the interrupt and item rates,
+ * the proportion dropped, and the time from an ADC sample or packet being due
+ * to its task receiving it.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+/* Simulator includes. */
+#include "sim_peripheral.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The simulated interrupts used. */
+#define plUART_INTERRUPT			( 2UL )
+#define plADC_INTERRUPT				( 3UL )
+#define plNETWORK_INTERRUPT			( 4UL )
+
+/* The rates of the peripherals at the first step - a UART interrupting when
+up to 16 bytes have been received, about every millisecond, an ADC sampling at
+1kHz, and bursts of 4 packets arriving about every 4 milliseconds. */
+#define plUART_INTERVAL_NS			( 1000000ULL )
+#define plUART_JITTER_NS			( 100000ULL )
+#define plUART_MAX_BYTES			( 16 )
+#define plADC_INTERVAL_NS			( 1000000ULL )
+#define plNETWORK_INTERVAL_NS		( 50000ULL )
+#define plNETWORK_BURST_LENGTH		( 4UL )
+#define plNETWORK_BURST_INTERVAL_NS	( 4000000ULL )
+#define plNETWORK_MIN_BYTES			( 64 )
+#define plNETWORK_MAX_BYTES			( 1500 )
+
+/* The time the tasks spend processing what they receive. */
+#define plUART_NS_PER_BYTE			( 2000ULL )
+#define plADC_NS_PER_SAMPLE			( 20000ULL )
+#define plNETWORK_NS_PER_BYTE		( 20ULL )
+
+/* The sizes of the stream buffer, queue and message buffer. */
+#define plUART_BUFFER_BYTES			( 256 )
+#define plADC_QUEUE_LENGTH			( 16 )
+#define plNETWORK_BUFFER_BYTES		( 8192 )
+
+/* How long each step lasts, the most steps taken, and the proportion dropped
+at which the pipeline is considered saturated. */
+#define plSTEP_MS					( 1000 )
+#define plMAX_STEPS					( 12UL )
+#define plSATURATION_PERCENT		( 1.0 )
+
+#define plCONTROL_PRIORITY			( configMAX_PRIORITIES - 1 )
+#define plPROCESSING_PRIORITY		( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks that process what the peripherals produce.
+ */
+static void prvUARTTask( void *pvParameters );
+static void prvADCTask( void *pvParameters );
+static void prvNetworkTask( void *pvParameters );
+
+/*
+ * The task that steps the load up and prints the results.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * Create a peripheral, asserting it could be created.
+ */
+static SimPeripheralHandle_t prvCreatePeripheral( const SimPeripheralConfig_t *pxConfig );
+
+/*
+ * Wait for ullNs without sleeping, as processing data would.
+ */
+static void prvBusyWait( uint64_t ullNs );
+
+/*
+ * Return the time on the simulated clock since ullTimeNs.
+ */
+static uint64_t prvSimulatedTimeSince( uint64_t ullTimeNs );
+
+/*-----------------------------------------------------------*/
+
+static StreamBufferHandle_t xUARTBuffer = NULL;
+static QueueHandle_t xADCQueue = NULL;
+static MessageBufferHandle_t xNetworkBuffer = NULL;
+
+static SimPeripheralHandle_t xUART = NULL;
+static SimPeripheralHandle_t xADC = NULL;
+static SimPeripheralHandle_t xNetwork = NULL;
+
+/* The time from an ADC sample or packet being due to its task receiving it,
+reset by the control task at the start of each step. */
+static BenchmarkStats_t xADCLatency;
+static BenchmarkStats_t xNetworkLatency;
+
+/*-----------------------------------------------------------*/
+
+void vStartPeripheralLoadBenchmark( void )
+{
+SimPeripheralConfig_t xConfig = { 0 };
+
+	xUARTBuffer = xStreamBufferCreate( plUART_BUFFER_BYTES, 1 );
+	xADCQueue = xQueueCreate( plADC_QUEUE_LENGTH, sizeof( SimPeripheralSample_t ) );
+	xNetworkBuffer = xMessageBufferCreate( plNETWORK_BUFFER_BYTES );
+	configASSERT( xUARTBuffer && xADCQueue && xNetworkBuffer );
+
+	xConfig.eType = eSimPeripheralUART;
+	xConfig.ulInterruptNumber = plUART_INTERRUPT;
+	xConfig.ulInterruptPriority = portLOWEST_INTERRUPT_PRIORITY;
+	xConfig.eDistribution = eSimArrivalUniform;
+	xConfig.ullIntervalNs = plUART_INTERVAL_NS;
+	xConfig.ullJitterNs = plUART_JITTER_NS;
+	xConfig.xMinBytes = 1;
+	xConfig.xMaxBytes = plUART_MAX_BYTES;
+	xConfig.xStreamBuffer = xUARTBuffer;
+	xConfig.ulSeed = 1UL;
+	xUART = prvCreatePeripheral( &xConfig );
+
+	xConfig.eType = eSimPeripheralADC;
+	xConfig.ulInterruptNumber = plADC_INTERRUPT;
+	xConfig.eDistribution = eSimArrivalPeriodic;
+	xConfig.ullIntervalNs = plADC_INTERVAL_NS;
+	xConfig.ullJitterNs = 0ULL;
+	xConfig.xStreamBuffer = NULL;
+	xConfig.xQueue = xADCQueue;
+	xConfig.ulSeed = 2UL;
+	xADC = prvCreatePeripheral( &xConfig );
+
+	xConfig.eType = eSimPeripheralNetwork;
+	xConfig.ulInterruptNumber = plNETWORK_INTERRUPT;
+	xConfig.eDistribution = eSimArrivalBursty;
+	xConfig.ullIntervalNs = plNETWORK_INTERVAL_NS;
+	xConfig.ulBurstLength = plNETWORK_BURST_LENGTH;
+	xConfig.ullBurstIntervalNs = plNETWORK_BURST_INTERVAL_NS;
+	xConfig.xMinBytes = plNETWORK_MIN_BYTES;
+	xConfig.xMaxBytes = plNETWORK_MAX_BYTES;
+	xConfig.xQueue = NULL;
+	xConfig.xStreamBuffer = xNetworkBuffer;
+	xConfig.ulSeed = 3UL;
+	xNetwork = prvCreatePeripheral( &xConfig );
+
+	xTaskCreate( prvUARTTask, "UART", configMINIMAL_STACK_SIZE, NULL, plPROCESSING_PRIORITY, NULL );
+	xTaskCreate( prvADCTask, "ADC", configMINIMAL_STACK_SIZE, NULL, plPROCESSING_PRIORITY, NULL );
+	xTaskCreate( prvNetworkTask, "Network", configMINIMAL_STACK_SIZE, NULL, plPROCESSING_PRIORITY, NULL );
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, plCONTROL_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static SimPeripheralHandle_t prvCreatePeripheral( const SimPeripheralConfig_t *pxConfig )
+{
+SimPeripheralHandle_t xPeripheral;
+
+	xPeripheral = xSimPeripheralCreate( pxConfig );
+	configASSERT( xPeripheral );
+
+	return xPeripheral;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBusyWait( uint64_t ullNs )
+{
+uint64_t ullUntilNs = ullBenchmarkTimeNs() + ullNs;
+
+	while( ullBenchmarkTimeNs() < ullUntilNs )
+	{
+		/* Spin. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvSimulatedTimeSince( uint64_t ullTimeNs )
+{
+uint64_t ullNowNs = ullPortGetSimulatedTimeNs();
+
+	/* With configUSE_VIRTUAL_TIME set to 1 the simulated clock is held back
+	when the port's timer thread runs late, so can read earlier than a time
+	already read. */
+	return ( ullNowNs > ullTimeNs ) ? ( ullNowNs - ullTimeNs ) : 0ULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUARTTask( void *pvParameters )
+{
+uint8_t ucBuffer[ plUART_MAX_BYTES ];
+size_t xReceived;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xReceived = xStreamBufferReceive( xUARTBuffer, ucBuffer, sizeof( ucBuffer ), portMAX_DELAY );
+		prvBusyWait( ( uint64_t ) xReceived * plUART_NS_PER_BYTE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvADCTask( void *pvParameters )
+{
+SimPeripheralSample_t xSample;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xQueueReceive( xADCQueue, &xSample, portMAX_DELAY );
+		vBenchmarkStatsAdd( &xADCLatency, prvSimulatedTimeSince( xSample.ullTimeNs ) );
+		prvBusyWait( plADC_NS_PER_SAMPLE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvNetworkTask( void *pvParameters )
+{
+static uint8_t ucPacket[ plNETWORK_MAX_BYTES ];
+SimPeripheralPacketHeader_t *pxHeader = ( SimPeripheralPacketHeader_t * ) ucPacket;
+size_t xReceived;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xReceived = xMessageBufferReceive( xNetworkBuffer, ucPacket, sizeof( ucPacket ), portMAX_DELAY );
+		vBenchmarkStatsAdd( &xNetworkLatency, prvSimulatedTimeSince( pxHeader->ullTimeNs ) );
+		prvBusyWait( ( uint64_t ) xReceived * plNETWORK_NS_PER_BYTE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+SimPeripheralHandle_t xPeripherals[ 3 ];
+SimPeripheralStats_t xStats;
+uint64_t ullStartNs, ullElapsedNs, ullLoad = 1ULL;
+uint32_t ulStep, ulInterrupts, ulItems, ulDropped;
+double dDroppedPercent = 0.0;
+size_t x;
+
+	( void ) pvParameters;
+
+	xPeripherals[ 0 ] = xUART;
+	xPeripherals[ 1 ] = xADC;
+	xPeripherals[ 2 ] = xNetwork;
+
+	printf( "configUSE_HANDOFF_CONTEXT_SWITCH = %d\r\n", configUSE_HANDOFF_CONTEXT_SWITCH );
+	printf( "configUSE_FIBER_TASKS = %d\r\n", configUSE_FIBER_TASKS );
+	printf( "configNUMBER_OF_CORES = %d\r\n", configNUMBER_OF_CORES );
+	printf( "%-6s %14s %14s %9s %14s %14s %14s %14s\r\n", "Load", "Interrupts/s", "Items/s", "Dropped", "ADC avg ns", "ADC max ns", "Packet avg ns", "Packet max ns" );
+
+	for( x = 0; x < 3; x++ )
+	{
+		vSimPeripheralStart( xPeripherals[ x ] );
+	}
+
+	for( ulStep = 0UL; ( ulStep < plMAX_STEPS ) && ( dDroppedPercent <= plSATURATION_PERCENT ); ulStep++ )
+	{
+		vSimPeripheralSetInterval( xUART, plUART_INTERVAL_NS / ullLoad );
+		vSimPeripheralSetInterval( xADC, plADC_INTERVAL_NS / ullLoad );
+		vSimPeripheralSetInterval( xNetwork, plNETWORK_INTERVAL_NS / ullLoad );
+
+		for( x = 0; x < 3; x++ )
+		{
+			vSimPeripheralResetStats( xPeripherals[ x ] );
+		}
+		vBenchmarkStatsReset( &xADCLatency );
+		vBenchmarkStatsReset( &xNetworkLatency );
+		ullStartNs = ullPortGetSimulatedTimeNs();
+
+		vTaskDelay( pdMS_TO_TICKS( plSTEP_MS ) );
+
+		ullElapsedNs = ullPortGetSimulatedTimeNs() - ullStartNs;
+		ulInterrupts = 0UL;
+		ulItems = 0UL;
+		ulDropped = 0UL;
+
+		for( x = 0; x < 3; x++ )
+		{
+			vSimPeripheralGetStats( xPeripherals[ x ], &xStats );
+			ulInterrupts += xStats.ulInterrupts;
+			ulItems += xStats.ulItems;
+			ulDropped += xStats.ulDroppedItems;
+		}
+
+		dDroppedPercent = ( ulItems == 0UL ) ? 0.0 : ( ( double ) ulDropped * 100.0 ) / ( double ) ulItems;
+
+		printf( "x%-5llu %14.0f %14.0f %8.2f%% %14llu %14llu %14llu %14llu\r\n",
+				( unsigned long long ) ullLoad,
+				( ( double ) ulInterrupts * 1e9 ) / ( double ) ullElapsedNs,
+				( ( double ) ulItems * 1e9 ) / ( double ) ullElapsedNs,
+				dDroppedPercent,
+				( unsigned long long ) ( ( xADCLatency.ullCount == 0ULL ) ? 0ULL : xADCLatency.ullTotalNs / xADCLatency.ullCount ),
+				( unsigned long long ) xADCLatency.ullMaxNs,
+				( unsigned long long ) ( ( xNetworkLatency.ullCount == 0ULL ) ? 0ULL : xNetworkLatency.ullTotalNs / xNetworkLatency.ullCount ),
+				( unsigned long long ) xNetworkLatency.ullMaxNs );
+
+		ullLoad *= 2ULL;
+	}
+
+	if( dDroppedPercent > plSATURATION_PERCENT )
+	{
+		printf( "Saturated at load x%llu\r\n", ( unsigned long long ) ( ullLoad / 2ULL ) );
+	}
+	else
+	{
+		printf( "Not saturated at load x%llu\r\n", ( unsigned long long ) ( ullLoad / 2ULL ) );
+	}
+
+	for( x = 0; x < 3; x++ )
+	{
+		vSimPeripheralStop( xPeripherals[ x ] );
+	}
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
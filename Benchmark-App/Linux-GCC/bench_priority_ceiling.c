@@ -0,0 +1,306 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Priority ceiling benchmark.
+ *
+ * Compares mutexes that use priority inheritance with mutexes that use the
+ * priority ceiling protocol.  First times an uncontended take and give of
+ * each.  Then two low priority tasks each start a critical section guarded by
+ * a different mutex, one tick apart, and a tick later a high priority task
+ * takes both mutexes.  With priority inheritance the second low priority task
+ * preempts the first inside its critical section, so the high priority task
+ * is blocked by what is left of both critical sections, one after the other.
+ * With a ceiling the first low priority task runs at the priority of the high
+ * priority task from when it takes its mutex, so the second cannot start its
+ * critical section, and the high priority task is only blocked by the rest of
+ * the first.  Reports the time the high priority task took to obtain both
+ * mutexes.  Build with configUSE_PRIORITY_CEILING_MUTEXES set to 1.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define pcpUNCONTENDED_TAKES		( 100000UL )
+#define pcpITERATIONS				( 20UL )
+#define pcpCRITICAL_SECTION_NS		( 5000000ULL )
+
+/* A gap longer than this between two readings of the time, while executing a
+critical section, is taken to be time the task was preempted for. */
+#define pcpPREEMPTED_NS				( 20000ULL )
+
+#define pcpFIRST_LOW_TASK_PRIORITY	( tskIDLE_PRIORITY + 1 )
+#define pcpSECOND_LOW_TASK_PRIORITY	( tskIDLE_PRIORITY + 2 )
+#define pcpHIGH_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
+#define pcpCONTROL_TASK_PRIORITY	( tskIDLE_PRIORITY + 4 )
+
+/* Every task that takes the mutexes has a priority at or below the high
+priority task's. */
+#define pcpCEILING_PRIORITY			pcpHIGH_TASK_PRIORITY
+
+#define pcpMUTEXES					( 2UL )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Times uncontended takes, then runs the critical sections with each kind of
+ * mutex in turn, and reports.
+ */
+static void prvControlTask( void *pvParameters );
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	/*
+	 * A low priority task, whose parameter is the index of the mutex that guards
+	 * its critical section.
+	 */
+	static void prvLowPriorityTask( void *pvParameters );
+
+	/*
+	 * Takes both mutexes, and times how long that takes.
+	 */
+	static void prvHighPriorityTask( void *pvParameters );
+
+	/*
+	 * Execute for ullNs nanoseconds, not counting the time the calling task
+	 * is preempted for.
+	 */
+	static void prvWork( uint64_t ullNs );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xControlTask;
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	/* The mutexes the tasks use, which are those of xInheritanceMutexes then
+	those of xCeilingMutexes. */
+	static SemaphoreHandle_t xInheritanceMutexes[ pcpMUTEXES ], xCeilingMutexes[ pcpMUTEXES ];
+	static SemaphoreHandle_t * volatile pxMutexes;
+
+	static TaskHandle_t xLowPriorityTasks[ pcpMUTEXES ], xHighPriorityTask;
+
+	/* The time the high priority task last took to obtain both mutexes. */
+	static volatile uint64_t ullBlockedNs;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartPriorityCeilingBenchmark( void )
+{
+	#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+	{
+	UBaseType_t uxMutex;
+
+		for( uxMutex = 0; uxMutex < pcpMUTEXES; uxMutex++ )
+		{
+			xInheritanceMutexes[ uxMutex ] = xSemaphoreCreateMutex();
+			xCeilingMutexes[ uxMutex ] = xSemaphoreCreateMutexWithCeiling( pcpCEILING_PRIORITY );
+			configASSERT( xInheritanceMutexes[ uxMutex ] );
+			configASSERT( xCeilingMutexes[ uxMutex ] );
+		}
+
+		xTaskCreate( prvLowPriorityTask, "Low1", configMINIMAL_STACK_SIZE, ( void * ) 0, pcpFIRST_LOW_TASK_PRIORITY, &( xLowPriorityTasks[ 0 ] ) );
+		xTaskCreate( prvLowPriorityTask, "Low2", configMINIMAL_STACK_SIZE, ( void * ) 1, pcpSECOND_LOW_TASK_PRIORITY, &( xLowPriorityTasks[ 1 ] ) );
+		xTaskCreate( prvHighPriorityTask, "High", configMINIMAL_STACK_SIZE, NULL, pcpHIGH_TASK_PRIORITY, &xHighPriorityTask );
+	}
+	#endif
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, pcpCONTROL_TASK_PRIORITY, &xControlTask );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	static void prvControlTask( void *pvParameters )
+	{
+	BenchmarkStats_t xStats;
+	SemaphoreHandle_t *pxMutexSets[ 2 ] = { xInheritanceMutexes, xCeilingMutexes };
+	const char * const pcSetNames[ 2 ] = { "inheritance", "ceiling" };
+	uint64_t ullStartTime;
+	uint32_t ulIteration;
+	UBaseType_t uxSet, uxMutex;
+	char cName[ 32 ];
+
+		( void ) pvParameters;
+
+		printf( "Critical sections %llu ns, ceiling priority %lu\r\n", pcpCRITICAL_SECTION_NS, ( unsigned long ) pcpCEILING_PRIORITY );
+
+		/* A task must not take a mutex whose ceiling is below its priority. */
+		vTaskPrioritySet( NULL, pcpCEILING_PRIORITY );
+
+		for( uxSet = 0; uxSet < 2; uxSet++ )
+		{
+			ullStartTime = ullBenchmarkTimeNs();
+
+			for( ulIteration = 0; ulIteration < pcpUNCONTENDED_TAKES; ulIteration++ )
+			{
+				xSemaphoreTake( pxMutexSets[ uxSet ][ 0 ], portMAX_DELAY );
+				xSemaphoreGive( pxMutexSets[ uxSet ][ 0 ] );
+			}
+
+			snprintf( cName, sizeof( cName ), "%s take and give", pcSetNames[ uxSet ] );
+			vBenchmarkPrintRate( cName, pcpUNCONTENDED_TAKES, ullBenchmarkTimeNs() - ullStartTime );
+		}
+
+		vTaskPrioritySet( NULL, pcpCONTROL_TASK_PRIORITY );
+
+		for( uxSet = 0; uxSet < 2; uxSet++ )
+		{
+			vBenchmarkStatsReset( &xStats );
+			pxMutexes = pxMutexSets[ uxSet ];
+
+			for( ulIteration = 0; ulIteration < pcpITERATIONS; ulIteration++ )
+			{
+				/* Start the critical sections a tick apart, then release the
+				high priority task. */
+				for( uxMutex = 0; uxMutex < pcpMUTEXES; uxMutex++ )
+				{
+					xTaskNotifyGive( xLowPriorityTasks[ uxMutex ] );
+					vTaskDelay( 1 );
+				}
+
+				xTaskNotifyGive( xHighPriorityTask );
+
+				/* Wait for all three tasks to finish. */
+				for( uxMutex = 0; uxMutex <= pcpMUTEXES; uxMutex++ )
+				{
+					ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+				}
+
+				vBenchmarkStatsAdd( &xStats, ullBlockedNs );
+			}
+
+			snprintf( cName, sizeof( cName ), "%s blocking", pcSetNames[ uxSet ] );
+			vBenchmarkStatsPrint( cName, &xStats );
+		}
+
+		vTaskEndScheduler();
+	}
+
+#else /* configUSE_PRIORITY_CEILING_MUTEXES */
+
+	static void prvControlTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configUSE_PRIORITY_CEILING_MUTEXES set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	static void prvLowPriorityTask( void *pvParameters )
+	{
+	const UBaseType_t uxMutex = ( UBaseType_t ) ( size_t ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			xSemaphoreTake( pxMutexes[ uxMutex ], portMAX_DELAY );
+			prvWork( pcpCRITICAL_SECTION_NS );
+			xSemaphoreGive( pxMutexes[ uxMutex ] );
+
+			xTaskNotifyGive( xControlTask );
+		}
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	static void prvHighPriorityTask( void *pvParameters )
+	{
+	uint64_t ullStartTime;
+	UBaseType_t uxMutex;
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			ullStartTime = ullBenchmarkTimeNs();
+
+			for( uxMutex = 0; uxMutex < pcpMUTEXES; uxMutex++ )
+			{
+				xSemaphoreTake( pxMutexes[ uxMutex ], portMAX_DELAY );
+			}
+
+			ullBlockedNs = ullBenchmarkTimeNs() - ullStartTime;
+
+			for( uxMutex = pcpMUTEXES; uxMutex > 0; uxMutex-- )
+			{
+				xSemaphoreGive( pxMutexes[ uxMutex - 1 ] );
+			}
+
+			xTaskNotifyGive( xControlTask );
+		}
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	static void prvWork( uint64_t ullNs )
+	{
+	uint64_t ullExecutedNs = 0, ullLastTime, ullTime;
+
+		ullLastTime = ullBenchmarkTimeNs();
+
+		while( ullExecutedNs < ullNs )
+		{
+			ullTime = ullBenchmarkTimeNs();
+
+			if( ( ullTime - ullLastTime ) < pcpPREEMPTED_NS )
+			{
+				ullExecutedNs += ullTime - ullLastTime;
+			}
+
+			ullLastTime = ullTime;
+		}
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,270 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Priority chain benchmark.
+ *
+ * A high priority task blocks on a mutex at the head of a chain of one, two
+ * or three mutexes.  Each task in the chain holds one mutex and is blocked on
+ * the next, and the task at the tail holds the last mutex while it completes
+ * a short critical section.  A task of a priority between that of the high
+ * priority task and those of the chain becomes ready at the same time, and
+ * runs for longer than the critical section.  The time the high priority task
+ * is blocked is bounded by the critical section only if the tail of the chain
+ * inherits its priority, otherwise the other task runs first.  Reports the
+ * blocking time for each length of chain, and the priority the tail ran at.
+ * Build with configPRIORITY_INHERITANCE_CHAIN_DEPTH set to 3 or more to
+ * inherit the priority along the whole chain, or leave it at 1 to see the
+ * inversion.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define piMAX_CHAIN_LENGTH			( 3UL )
+#define piITERATIONS				( 20UL )
+#define piCRITICAL_SECTION_NS		( 1000000ULL )
+#define piINTERFERENCE_NS			( 5000000ULL )
+
+/* Chain task n holds mutex n, so the task holding the last mutex, at the tail
+of every chain, has the lowest priority. */
+#define piCHAIN_TASK_PRIORITY( n )	( ( UBaseType_t ) ( tskIDLE_PRIORITY + piMAX_CHAIN_LENGTH - ( n ) ) )
+#define piINTERFERING_TASK_PRIORITY	( tskIDLE_PRIORITY + piMAX_CHAIN_LENGTH + 1 )
+#define piHIGH_TASK_PRIORITY		( tskIDLE_PRIORITY + piMAX_CHAIN_LENGTH + 2 )
+#define piCONTROL_TASK_PRIORITY		( tskIDLE_PRIORITY + piMAX_CHAIN_LENGTH + 3 )
+
+#if( ( piMAX_CHAIN_LENGTH + 3 ) >= configMAX_PRIORITIES )
+	#error configMAX_PRIORITIES is too low for the priority chain benchmark
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Builds each chain in turn, then releases the high priority task and the
+ * interfering task, and reports.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * A task of the chain, whose parameter is the index of the mutex it holds.
+ */
+static void prvChainTask( void *pvParameters );
+
+/*
+ * Blocks on the mutex at the head of the chain, and times how long for.
+ */
+static void prvHighPriorityTask( void *pvParameters );
+
+/*
+ * Runs for longer than the critical section at the tail of the chain.
+ */
+static void prvInterferingTask( void *pvParameters );
+
+/*
+ * Run, without blocking, for ullNs nanoseconds.
+ */
+static void prvSpin( uint64_t ullNs );
+
+/*-----------------------------------------------------------*/
+
+static SemaphoreHandle_t xMutexes[ piMAX_CHAIN_LENGTH ];
+static TaskHandle_t xChainTasks[ piMAX_CHAIN_LENGTH ];
+static TaskHandle_t xControlTask, xHighPriorityTask, xInterferingTask;
+
+/* The mutex the high priority task takes, which is at the head of the chain
+being measured. */
+static volatile UBaseType_t uxHeadMutex;
+
+/* The time the high priority task was last blocked for, and the highest
+priority the tail of the chain has run its critical section at. */
+static volatile uint64_t ullBlockedNs;
+static volatile UBaseType_t uxTailPriority;
+
+/*-----------------------------------------------------------*/
+
+void vStartPriorityChainBenchmark( void )
+{
+UBaseType_t uxMutex;
+
+	for( uxMutex = 0; uxMutex < piMAX_CHAIN_LENGTH; uxMutex++ )
+	{
+		xMutexes[ uxMutex ] = xSemaphoreCreateMutex();
+		configASSERT( xMutexes[ uxMutex ] );
+		xTaskCreate( prvChainTask, "Chain", configMINIMAL_STACK_SIZE, ( void * ) ( size_t ) uxMutex, piCHAIN_TASK_PRIORITY( uxMutex ), &( xChainTasks[ uxMutex ] ) );
+	}
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, piCONTROL_TASK_PRIORITY, &xControlTask );
+	xTaskCreate( prvHighPriorityTask, "High", configMINIMAL_STACK_SIZE, NULL, piHIGH_TASK_PRIORITY, &xHighPriorityTask );
+	xTaskCreate( prvInterferingTask, "Interfere", configMINIMAL_STACK_SIZE, NULL, piINTERFERING_TASK_PRIORITY, &xInterferingTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+BenchmarkStats_t xStats;
+UBaseType_t uxLength, uxMutex;
+uint32_t ulIteration;
+char cName[ 32 ];
+
+	( void ) pvParameters;
+
+	printf( "Chain depth %lu, critical section %llu ns, interference %llu ns\r\n",
+			( unsigned long ) configPRIORITY_INHERITANCE_CHAIN_DEPTH, piCRITICAL_SECTION_NS, piINTERFERENCE_NS );
+
+	for( uxLength = 1; uxLength <= piMAX_CHAIN_LENGTH; uxLength++ )
+	{
+		vBenchmarkStatsReset( &xStats );
+		uxHeadMutex = piMAX_CHAIN_LENGTH - uxLength;
+		uxTailPriority = tskIDLE_PRIORITY;
+
+		for( ulIteration = 0; ulIteration < piITERATIONS; ulIteration++ )
+		{
+			/* Build the chain from the tail.  Each task takes its mutex, then
+			blocks on the next, which is held by a task of lower priority, or
+			at the tail blocks to wait to be released. */
+			for( uxMutex = piMAX_CHAIN_LENGTH; uxMutex > uxHeadMutex; uxMutex-- )
+			{
+				xTaskNotifyGive( xChainTasks[ uxMutex - 1 ] );
+
+				while( ( xSemaphoreGetMutexHolder( xMutexes[ uxMutex - 1 ] ) != xChainTasks[ uxMutex - 1 ] ) ||
+					   ( eTaskGetState( xChainTasks[ uxMutex - 1 ] ) != eBlocked ) )
+				{
+					vTaskDelay( 1 );
+				}
+			}
+
+			/* Release the high priority task, which blocks on the head of
+			the chain, the interfering task and the critical section of the
+			tail of the chain all at once. */
+			xTaskNotifyGive( xHighPriorityTask );
+			xTaskNotifyGive( xInterferingTask );
+			xTaskNotifyGive( xChainTasks[ piMAX_CHAIN_LENGTH - 1 ] );
+
+			/* Wait for both the high priority and interfering tasks to
+			finish. */
+			ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+			ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+			vBenchmarkStatsAdd( &xStats, ullBlockedNs );
+		}
+
+		snprintf( cName, sizeof( cName ), "%lu mutex chain blocking", ( unsigned long ) uxLength );
+		vBenchmarkStatsPrint( cName, &xStats );
+		printf( "%-32s tail ran at priority %lu of %lu\r\n", "", ( unsigned long ) uxTailPriority, ( unsigned long ) piHIGH_TASK_PRIORITY );
+	}
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvChainTask( void *pvParameters )
+{
+const UBaseType_t uxMutex = ( UBaseType_t ) ( size_t ) pvParameters;
+UBaseType_t uxPriority;
+
+	for( ;; )
+	{
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+		xSemaphoreTake( xMutexes[ uxMutex ], portMAX_DELAY );
+
+		if( uxMutex == ( piMAX_CHAIN_LENGTH - 1 ) )
+		{
+			/* The tail of the chain.  Wait, still holding the mutex, to be
+			released with the high priority task. */
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			uxPriority = uxTaskPriorityGet( NULL );
+
+			if( uxPriority > uxTailPriority )
+			{
+				uxTailPriority = uxPriority;
+			}
+
+			prvSpin( piCRITICAL_SECTION_NS );
+		}
+		else
+		{
+			xSemaphoreTake( xMutexes[ uxMutex + 1 ], portMAX_DELAY );
+			xSemaphoreGive( xMutexes[ uxMutex + 1 ] );
+		}
+
+		xSemaphoreGive( xMutexes[ uxMutex ] );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHighPriorityTask( void *pvParameters )
+{
+uint64_t ullStartTime;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+		ullStartTime = ullBenchmarkTimeNs();
+		xSemaphoreTake( xMutexes[ uxHeadMutex ], portMAX_DELAY );
+		ullBlockedNs = ullBenchmarkTimeNs() - ullStartTime;
+		xSemaphoreGive( xMutexes[ uxHeadMutex ] );
+
+		xTaskNotifyGive( xControlTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterferingTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+		prvSpin( piINTERFERENCE_NS );
+		xTaskNotifyGive( xControlTask );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpin( uint64_t ullNs )
+{
+const uint64_t ullStartTime = ullBenchmarkTimeNs();
+
+	while( ( ullBenchmarkTimeNs() - ullStartTime ) < ullNs )
+	{
+		/* Only preempted. */
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,139 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Priority span benchmark.
+ *
+ * A task at the lowest priority above that of the idle task repeatedly
+ * resumes a task at the highest priority, which notes the time and suspends
+ * itself again.  Each round trip selects the highest priority ready task
+ * twice with the whole range of priorities between the two tasks empty, so
+ * it is the case in which the generic method of task selection, which walks
+ * down the ready lists one priority at a time, is slowest.  Build with
+ * configMAX_PRIORITIES set above 32 and configUSE_PORT_OPTIMISED_TASK_SELECTION
+ * set to 0 and 1 to compare the two methods.  With more than one core the
+ * resumed task runs on another core, so the benchmark is only meaningful when
+ * configNUMBER_OF_CORES is 1.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The number of round trips timed, after the warm up ones that are not. */
+#define psWARM_UP_RESUMES			( 1000UL )
+#define psTIMED_RESUMES				( 50000UL )
+
+/* The high priority task is kept below the timer task. */
+#define psLOW_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define psHIGH_PRIORITY				( configMAX_PRIORITIES - 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that resumes the high priority task, and the task it resumes.
+ */
+static void prvResumingTask( void *pvParameters );
+static void prvResumedTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xResumedTask = NULL;
+
+/* The time at which the low priority task called vTaskResume(). */
+static volatile uint64_t ullResumeTime = 0ULL;
+
+static BenchmarkStats_t xResumeLatency;
+
+/*-----------------------------------------------------------*/
+
+void vStartPrioritySpanBenchmark( void )
+{
+	vBenchmarkStatsReset( &xResumeLatency );
+
+	xTaskCreate( prvResumingTask, "Resumer", configMINIMAL_STACK_SIZE, NULL, psLOW_PRIORITY, NULL );
+	xTaskCreate( prvResumedTask, "Resumed", configMINIMAL_STACK_SIZE, NULL, psHIGH_PRIORITY, &xResumedTask );
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumingTask( void *pvParameters )
+{
+uint32_t ulResumes;
+uint64_t ullStartTime = 0ULL, ullEndTime;
+
+	( void ) pvParameters;
+
+	for( ulResumes = 1UL; ulResumes <= ( psWARM_UP_RESUMES + psTIMED_RESUMES ); ulResumes++ )
+	{
+		if( ulResumes == psWARM_UP_RESUMES )
+		{
+			ullStartTime = ullBenchmarkTimeNs();
+		}
+
+		/* The high priority task runs, and suspends itself again, before
+		vTaskResume() returns. */
+		ullResumeTime = ullBenchmarkTimeNs();
+		vTaskResume( xResumedTask );
+	}
+
+	ullEndTime = ullBenchmarkTimeNs();
+
+	printf( "configMAX_PRIORITIES = %d\r\n", configMAX_PRIORITIES );
+	printf( "configUSE_PORT_OPTIMISED_TASK_SELECTION = %d\r\n", configUSE_PORT_OPTIMISED_TASK_SELECTION );
+	vBenchmarkPrintRate( "Resume/suspend round trips", psTIMED_RESUMES, ullEndTime - ullStartTime );
+	vBenchmarkStatsPrint( "Resume latency", &xResumeLatency );
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumedTask( void *pvParameters )
+{
+uint32_t ulResumes = 0UL;
+uint64_t ullNow;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskSuspend( NULL );
+		ullNow = ullBenchmarkTimeNs();
+
+		/* The first time the task runs it was not resumed. */
+		ulResumes++;
+		if( ( ulResumes > psWARM_UP_RESUMES ) && ( ullNow > ullResumeTime ) )
+		{
+			vBenchmarkStatsAdd( &xResumeLatency, ullNow - ullResumeTime );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
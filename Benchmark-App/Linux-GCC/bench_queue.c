@@ -0,0 +1,105 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+/*
+ * Queue benchmark.
+ *
+ * A single task repeatedly sends an item to a queue, then receives it back,
+ * neither call blocking.  Each call enters and exits a critical section but
+ * never switches task, so this measures the cost of the uncontended path
+ * through the queue API - which in the simulator is dominated by the cost of
+ * the port's critical sections.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The number of send/receive pairs timed, after the warm up pairs that are
+not. */
+#define qbWARM_UP_PAIRS				( 10000UL )
+#define qbTIMED_PAIRS				( 2000000UL )
+
+#define qbTASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that sends to, and receives from, the queue.
+ */
+static void prvQueueTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static QueueHandle_t xQueue = NULL;
+
+/*-----------------------------------------------------------*/
+
+void vStartQueueBenchmark( void )
+{
+	xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	configASSERT( xQueue );
+
+	xTaskCreate( prvQueueTask, "Queue", configMINIMAL_STACK_SIZE, NULL, qbTASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvQueueTask( void *pvParameters )
+{
+uint32_t ulPair, ulSent, ulReceived = 0UL;
+uint64_t ullStartTime = 0ULL, ullElapsed;
+
+	( void ) pvParameters;
+
+	for( ulPair = 0UL; ulPair < ( qbWARM_UP_PAIRS + qbTIMED_PAIRS ); ulPair++ )
+	{
+		if( ulPair == qbWARM_UP_PAIRS )
+		{
+			ullStartTime = ullBenchmarkTimeNs();
+		}
+
+		ulSent = ulPair;
+		xQueueSend( xQueue, &ulSent, 0 );
+		xQueueReceive( xQueue, &ulReceived, 0 );
+		configASSERT( ulReceived == ulSent );
+	}
+
+	ullElapsed = ullBenchmarkTimeNs() - ullStartTime;
+
+	printf( "configUSE_HANDOFF_CONTEXT_SWITCH = %d\r\n", configUSE_HANDOFF_CONTEXT_SWITCH );
+	printf( "configUSE_FIBER_TASKS = %d\r\n", configUSE_FIBER_TASKS );
+	vBenchmarkPrintRate( "Send/receive pairs", qbTIMED_PAIRS, ullElapsed );
+	printf( "%-32s %.1f ns\r\n", "Time per pair", ( double ) ullElapsed / ( double ) qbTIMED_PAIRS );
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,294 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Queue batches benchmark.
+ *
+ * A producer task sends numbered items to a queue and a consumer task
+ * receives them and checks they arrive in order, for each of a range of item
+ * sizes.  The items are sent and received one at a time with xQueueSend() and
+ * xQueueReceive(), then in batches of several sizes with xQueueSendMultiple()
+ * and xQueueReceiveMultiple().  Reports the throughput of each.  Build with
+ * configUSE_QUEUE_BATCHES set to 1.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define qbQUEUE_LENGTH				( 64UL )
+#define qbITEMS_PER_TEST			( 200000UL )
+#define qbMAX_ITEM_SIZE				( 256UL )
+#define qbMAX_BATCH_SIZE			( 64UL )
+
+#define qbCONSUMER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define qbPRODUCER_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define qbCONTROL_TASK_PRIORITY		( tskIDLE_PRIORITY + 3 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs each item size with each batch size, and reports.
+ */
+static void prvControlTask( void *pvParameters );
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	/*
+	 * Sends qbITEMS_PER_TEST items, uxBatchSize at a time, each time it is
+	 * notified.
+	 */
+	static void prvProducerTask( void *pvParameters );
+
+	/*
+	 * Receives qbITEMS_PER_TEST items, up to uxBatchSize at a time, each time
+	 * it is notified, checks their order, then notifies the control task.
+	 */
+	static void prvConsumerTask( void *pvParameters );
+
+	/*
+	 * Create a queue of items of uxItemSize bytes, start the producer and the
+	 * consumer, and return the time taken for the consumer to receive all
+	 * the items.
+	 */
+	static uint64_t prvRunTest( UBaseType_t uxSize, UBaseType_t uxBatch );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static QueueHandle_t xQueue;
+	static TaskHandle_t xControlTask, xConsumerTask, xProducerTask;
+
+	/* The configuration of the test being run.  A batch size of 1 sends and
+	receives with xQueueSend() and xQueueReceive(). */
+	static UBaseType_t uxItemSize, uxBatchSize;
+
+	/* Items that arrived out of order. */
+	static uint32_t ulErrors;
+
+	/* The buffers the batches are copied from and to.  They are static so
+	the task stacks do not have to hold them. */
+	static uint8_t ucProducerBuffer[ qbMAX_BATCH_SIZE * qbMAX_ITEM_SIZE ];
+	static uint8_t ucConsumerBuffer[ qbMAX_BATCH_SIZE * qbMAX_ITEM_SIZE ];
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartQueueBatchesBenchmark( void )
+{
+	#if( configUSE_QUEUE_BATCHES == 1 )
+	{
+		xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 2, NULL, qbPRODUCER_PRIORITY, &xProducerTask );
+		xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 2, NULL, qbCONSUMER_PRIORITY, &xConsumerTask );
+		xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, qbCONTROL_TASK_PRIORITY, &xControlTask );
+	}
+	#else
+	{
+		xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, qbCONTROL_TASK_PRIORITY, NULL );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvControlTask( void *pvParameters )
+	{
+	const UBaseType_t uxItemSizes[] = { 4, 32, 256 };
+	const UBaseType_t uxBatchSizes[] = { 1, 8, 64 };
+	UBaseType_t uxSize, uxBatch;
+	uint64_t ullElapsedNs;
+
+		( void ) pvParameters;
+
+		printf( "Queue of %lu items, %lu items per test\r\n", ( unsigned long ) qbQUEUE_LENGTH, ( unsigned long ) qbITEMS_PER_TEST );
+
+		for( uxSize = 0; uxSize < ( sizeof( uxItemSizes ) / sizeof( uxItemSizes[ 0 ] ) ); uxSize++ )
+		{
+			for( uxBatch = 0; uxBatch < ( sizeof( uxBatchSizes ) / sizeof( uxBatchSizes[ 0 ] ) ); uxBatch++ )
+			{
+				ullElapsedNs = prvRunTest( uxItemSizes[ uxSize ], uxBatchSizes[ uxBatch ] );
+
+				printf( "batch %2lu %4lu byte items %10.0f items/s %8.1f MB/s\r\n",
+						( unsigned long ) uxBatchSizes[ uxBatch ],
+						( unsigned long ) uxItemSizes[ uxSize ],
+						( ( double ) qbITEMS_PER_TEST * 1.0e9 ) / ( double ) ullElapsedNs,
+						( ( double ) qbITEMS_PER_TEST * ( double ) uxItemSizes[ uxSize ] * 1000.0 ) / ( double ) ullElapsedNs );
+			}
+		}
+
+		printf( "Items out of order: %lu\r\n", ( unsigned long ) ulErrors );
+
+		vTaskEndScheduler();
+	}
+
+#else /* configUSE_QUEUE_BATCHES */
+
+	static void prvControlTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configUSE_QUEUE_BATCHES set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static uint64_t prvRunTest( UBaseType_t uxSize, UBaseType_t uxBatch )
+	{
+	uint64_t ullStartTime, ullElapsedNs;
+
+		uxItemSize = uxSize;
+		uxBatchSize = uxBatch;
+		xQueue = xQueueCreate( qbQUEUE_LENGTH, uxItemSize );
+		configASSERT( xQueue );
+
+		ullStartTime = ullBenchmarkTimeNs();
+
+		/* The consumer is started first so it is waiting for the first
+		item. */
+		xTaskNotifyGive( xConsumerTask );
+		xTaskNotifyGive( xProducerTask );
+
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+		ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+
+		vQueueDelete( xQueue );
+
+		return ullElapsedNs;
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvProducerTask( void *pvParameters )
+	{
+	uint32_t ulSequence, ulItem, ulItemSequence;
+	UBaseType_t uxItems, uxSent;
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			for( ulSequence = 0; ulSequence < qbITEMS_PER_TEST; ulSequence += uxItems )
+			{
+				/* Number the items of the next batch.  The rest of each item
+				is not written, only copied. */
+				uxItems = uxBatchSize;
+
+				if( uxItems > ( qbITEMS_PER_TEST - ulSequence ) )
+				{
+					uxItems = qbITEMS_PER_TEST - ulSequence;
+				}
+
+				for( ulItem = 0; ulItem < uxItems; ulItem++ )
+				{
+					ulItemSequence = ulSequence + ulItem;
+					memcpy( &( ucProducerBuffer[ ulItem * uxItemSize ] ), &ulItemSequence, sizeof( ulItemSequence ) );
+				}
+
+				if( uxBatchSize == 1 )
+				{
+					( void ) xQueueSend( xQueue, ucProducerBuffer, portMAX_DELAY );
+				}
+				else
+				{
+					for( uxSent = 0; uxSent < uxItems; )
+					{
+						uxSent += ( UBaseType_t ) xQueueSendMultiple( xQueue, &( ucProducerBuffer[ uxSent * uxItemSize ] ), uxItems - uxSent, portMAX_DELAY );
+					}
+				}
+			}
+		}
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvConsumerTask( void *pvParameters )
+	{
+	uint32_t ulNextSequence, ulSequence;
+	UBaseType_t uxItems, uxItem;
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			for( ulNextSequence = 0; ulNextSequence < qbITEMS_PER_TEST; )
+			{
+				if( uxBatchSize == 1 )
+				{
+					( void ) xQueueReceive( xQueue, ucConsumerBuffer, portMAX_DELAY );
+					uxItems = 1;
+				}
+				else
+				{
+					uxItems = ( UBaseType_t ) xQueueReceiveMultiple( xQueue, ucConsumerBuffer, uxBatchSize, portMAX_DELAY );
+				}
+
+				for( uxItem = 0; uxItem < uxItems; uxItem++ )
+				{
+					memcpy( &ulSequence, &( ucConsumerBuffer[ uxItem * uxItemSize ] ), sizeof( ulSequence ) );
+
+					if( ulSequence != ulNextSequence )
+					{
+						ulErrors++;
+					}
+
+					ulNextSequence++;
+				}
+			}
+
+			xTaskNotifyGive( xControlTask );
+		}
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
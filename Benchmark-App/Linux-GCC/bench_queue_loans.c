@@ -0,0 +1,389 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Queue loans benchmark.
+ *
+ * A producer task sends items to a queue and a consumer task receives them,
+ * for each of a range of item sizes.  The producer writes every byte of each
+ * item and the consumer reads every byte, either in a buffer of their own
+ * that the queue copies the item to and from, or in place in the queue's
+ * storage using xQueueLoanSendSlot()/xQueueCommitSend() and
+ * xQueueLoanReceiveSlot()/xQueueReleaseReceive().  The queue is filled then
+ * emptied in turn, so the cost of the copies is not hidden by a context
+ * switch per item.  Reports the throughput of each.  Then runs a producer
+ * that sends by loan and a producer that sends by copy to the same queue at
+ * once, and checks the items from each arrive in order and intact.  Build
+ * with configUSE_QUEUE_LOANS set to 1.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define qlQUEUE_LENGTH				( 64UL )
+#define qlITEMS_PER_SIZE			( 200000UL )
+#define qlMIXED_ITEM_SIZE			( 1024UL )
+#define qlMAX_ITEM_SIZE				( 16384UL )
+#define qlPRODUCERS					( 2UL )
+
+/* The producers and the consumer share a priority, so unblocking one does not
+preempt the other.  The producers fill the queue, then the consumer empties
+it, so there are two context switches per qlQUEUE_LENGTH items rather than
+one per item, and the time taken is dominated by writing, copying and reading
+the items. */
+#define qlCONSUMER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define qlPRODUCER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define qlCONTROL_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+/* Each item starts with a header, and every byte after the header holds the
+low byte of the item's sequence number.  The item sizes are multiples of
+eight bytes. */
+typedef struct QUEUE_LOANS_ITEM_HEADER
+{
+	uint32_t ulSequence;
+	uint32_t ulProducer;
+} ItemHeader_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs each item size by copy then by loan, then the mixed producers, and
+ * reports.
+ */
+static void prvControlTask( void *pvParameters );
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	/*
+	 * Sends the number of items given by ulItemsToSend[] for the producer,
+	 * whose index is the task's parameter, each time it is notified.
+	 */
+	static void prvProducerTask( void *pvParameters );
+
+	/*
+	 * Receives the total number of items the producers send each time it is
+	 * notified, checks each, then notifies the control task.
+	 */
+	static void prvConsumerTask( void *pvParameters );
+
+	/*
+	 * Create a queue of items of uxItemSize bytes, start the producers and
+	 * the consumer, and return the time taken for the consumer to receive
+	 * all the items.
+	 */
+	static uint64_t prvRunTest( UBaseType_t uxItemSize );
+
+	/*
+	 * Write, and check, every byte of an item.
+	 */
+	static void prvFillItem( uint8_t *pucItem, uint32_t ulProducer, uint32_t ulSequence );
+	static BaseType_t prvCheckItem( const uint8_t *pucItem, uint32_t *pulNextSequences );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static QueueHandle_t xQueue;
+	static TaskHandle_t xControlTask, xConsumerTask, xProducerTasks[ qlPRODUCERS ];
+
+	/* The configuration of the test being run. */
+	static UBaseType_t uxItemSize;
+	static uint32_t ulItemsToSend[ qlPRODUCERS ];
+	static BaseType_t xProducerUsesLoans[ qlPRODUCERS ], xConsumerUsesLoans;
+
+	/* Items that arrived out of order or corrupted. */
+	static uint32_t ulErrors;
+
+	/* The buffers the items are copied from and to when not using loans.
+	They are static so the task stacks do not have to hold them. */
+	static uint8_t ucProducerBuffers[ qlPRODUCERS ][ qlMAX_ITEM_SIZE ];
+	static uint8_t ucConsumerBuffer[ qlMAX_ITEM_SIZE ];
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartQueueLoansBenchmark( void )
+{
+	#if( configUSE_QUEUE_LOANS == 1 )
+	{
+	UBaseType_t uxProducer;
+
+		for( uxProducer = 0; uxProducer < qlPRODUCERS; uxProducer++ )
+		{
+			xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 2, ( void * ) ( size_t ) uxProducer, qlPRODUCER_PRIORITY, &( xProducerTasks[ uxProducer ] ) );
+		}
+
+		xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 2, NULL, qlCONSUMER_PRIORITY, &xConsumerTask );
+		xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, qlCONTROL_TASK_PRIORITY, &xControlTask );
+	}
+	#else
+	{
+		xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, qlCONTROL_TASK_PRIORITY, NULL );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static void prvControlTask( void *pvParameters )
+	{
+	const UBaseType_t uxItemSizes[] = { 64, 1024, 16384 };
+	const char * const pcModes[ 2 ] = { "copy", "loan" };
+	UBaseType_t uxSize;
+	BaseType_t xMode;
+	uint64_t ullElapsedNs;
+
+		( void ) pvParameters;
+
+		printf( "Queue of %lu items, %lu items per test\r\n", ( unsigned long ) qlQUEUE_LENGTH, ( unsigned long ) qlITEMS_PER_SIZE );
+
+		for( uxSize = 0; uxSize < ( sizeof( uxItemSizes ) / sizeof( uxItemSizes[ 0 ] ) ); uxSize++ )
+		{
+			for( xMode = pdFALSE; xMode <= pdTRUE; xMode++ )
+			{
+				ulItemsToSend[ 0 ] = qlITEMS_PER_SIZE;
+				ulItemsToSend[ 1 ] = 0;
+				xProducerUsesLoans[ 0 ] = xMode;
+				xConsumerUsesLoans = xMode;
+
+				ullElapsedNs = prvRunTest( uxItemSizes[ uxSize ] );
+
+				printf( "%s %5lu byte items %10.0f items/s %8.1f MB/s\r\n",
+						pcModes[ xMode ],
+						( unsigned long ) uxItemSizes[ uxSize ],
+						( ( double ) qlITEMS_PER_SIZE * 1.0e9 ) / ( double ) ullElapsedNs,
+						( ( double ) qlITEMS_PER_SIZE * ( double ) uxItemSizes[ uxSize ] * 1000.0 ) / ( double ) ullElapsedNs );
+			}
+		}
+
+		/* One producer sends by loan while the other sends by copy, and the
+		consumer receives by loan, so the producers contend for the back of
+		the queue. */
+		ulItemsToSend[ 0 ] = qlITEMS_PER_SIZE;
+		ulItemsToSend[ 1 ] = qlITEMS_PER_SIZE;
+		xProducerUsesLoans[ 0 ] = pdTRUE;
+		xProducerUsesLoans[ 1 ] = pdFALSE;
+		xConsumerUsesLoans = pdTRUE;
+
+		ullElapsedNs = prvRunTest( qlMIXED_ITEM_SIZE );
+		vBenchmarkPrintRate( "mixed loan and copy senders", qlITEMS_PER_SIZE * qlPRODUCERS, ullElapsedNs );
+		printf( "Items out of order or corrupted: %lu\r\n", ( unsigned long ) ulErrors );
+
+		vTaskEndScheduler();
+	}
+
+#else /* configUSE_QUEUE_LOANS */
+
+	static void prvControlTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configUSE_QUEUE_LOANS set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static uint64_t prvRunTest( UBaseType_t uxSize )
+	{
+	uint64_t ullStartTime, ullElapsedNs;
+	UBaseType_t uxProducer;
+
+		uxItemSize = uxSize;
+		xQueue = xQueueCreate( qlQUEUE_LENGTH, uxItemSize );
+		configASSERT( xQueue );
+
+		ullStartTime = ullBenchmarkTimeNs();
+
+		/* The consumer is started first so it is waiting for the first
+		item. */
+		xTaskNotifyGive( xConsumerTask );
+
+		for( uxProducer = 0; uxProducer < qlPRODUCERS; uxProducer++ )
+		{
+			xTaskNotifyGive( xProducerTasks[ uxProducer ] );
+		}
+
+		ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+		ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+
+		vQueueDelete( xQueue );
+
+		return ullElapsedNs;
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static void prvProducerTask( void *pvParameters )
+	{
+	const uint32_t ulProducer = ( uint32_t ) ( size_t ) pvParameters;
+	uint32_t ulSequence;
+	void *pvSlot;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			for( ulSequence = 0; ulSequence < ulItemsToSend[ ulProducer ]; ulSequence++ )
+			{
+				if( xProducerUsesLoans[ ulProducer ] != pdFALSE )
+				{
+					( void ) xQueueLoanSendSlot( xQueue, &pvSlot, portMAX_DELAY );
+					prvFillItem( ( uint8_t * ) pvSlot, ulProducer, ulSequence );
+					( void ) xQueueCommitSend( xQueue );
+				}
+				else
+				{
+					prvFillItem( ucProducerBuffers[ ulProducer ], ulProducer, ulSequence );
+					( void ) xQueueSend( xQueue, ucProducerBuffers[ ulProducer ], portMAX_DELAY );
+				}
+			}
+		}
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static void prvConsumerTask( void *pvParameters )
+	{
+	uint32_t ulNextSequences[ qlPRODUCERS ];
+	uint32_t ulItem, ulItems;
+	void *pvSlot;
+
+		( void ) pvParameters;
+
+		for( ;; )
+		{
+			ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+			memset( ulNextSequences, 0x00, sizeof( ulNextSequences ) );
+			ulItems = ulItemsToSend[ 0 ] + ulItemsToSend[ 1 ];
+
+			for( ulItem = 0; ulItem < ulItems; ulItem++ )
+			{
+				if( xConsumerUsesLoans != pdFALSE )
+				{
+					( void ) xQueueLoanReceiveSlot( xQueue, &pvSlot, portMAX_DELAY );
+
+					if( prvCheckItem( ( const uint8_t * ) pvSlot, ulNextSequences ) == pdFALSE )
+					{
+						ulErrors++;
+					}
+
+					( void ) xQueueReleaseReceive( xQueue );
+				}
+				else
+				{
+					( void ) xQueueReceive( xQueue, ucConsumerBuffer, portMAX_DELAY );
+
+					if( prvCheckItem( ucConsumerBuffer, ulNextSequences ) == pdFALSE )
+					{
+						ulErrors++;
+					}
+				}
+			}
+
+			xTaskNotifyGive( xControlTask );
+		}
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_QUEUE_LOANS == 1 )
+
+	static void prvFillItem( uint8_t *pucItem, uint32_t ulProducer, uint32_t ulSequence )
+	{
+	ItemHeader_t xHeader;
+
+		xHeader.ulSequence = ulSequence;
+		xHeader.ulProducer = ulProducer;
+		memcpy( pucItem, &xHeader, sizeof( xHeader ) );
+		memset( pucItem + sizeof( xHeader ), ( int ) ( ulSequence & 0xffUL ), uxItemSize - sizeof( xHeader ) );
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvCheckItem( const uint8_t *pucItem, uint32_t *pulNextSequences )
+	{
+	ItemHeader_t xHeader;
+	UBaseType_t uxByte;
+	uint64_t ullWord, ullExpected, ullDifferences = 0ULL;
+	BaseType_t xReturn = pdTRUE;
+
+		memcpy( &xHeader, pucItem, sizeof( xHeader ) );
+
+		if( ( xHeader.ulProducer >= qlPRODUCERS ) || ( xHeader.ulSequence != pulNextSequences[ xHeader.ulProducer ] ) )
+		{
+			xReturn = pdFALSE;
+		}
+		else
+		{
+			pulNextSequences[ xHeader.ulProducer ]++;
+
+			/* Compare eight bytes at a time, without stopping at the first
+			difference, so checking an item costs about as much as reading
+			it. */
+			ullExpected = ( uint64_t ) ( xHeader.ulSequence & 0xffUL ) * 0x0101010101010101ULL;
+
+			for( uxByte = sizeof( xHeader ); uxByte < uxItemSize; uxByte += sizeof( ullWord ) )
+			{
+				memcpy( &ullWord, pucItem + uxByte, sizeof( ullWord ) );
+				ullDifferences |= ullWord ^ ullExpected;
+			}
+
+			if( ullDifferences != 0ULL )
+			{
+				xReturn = pdFALSE;
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
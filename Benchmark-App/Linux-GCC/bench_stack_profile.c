@@ -0,0 +1,266 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Stack profile benchmark.
+ *
+ * Creates a set of worker tasks, all with the same stack depth, that use
+ * different amounts of stack - each calls a function that recurses through a
+ * number of frames, each frame holding a buffer - then lets them run while the
+ * idle task samples their stacks.  Reports the peak stack use the profiler
+ * recorded for every task, with the stack depth it recommends, and the RAM
+ * those recommendations would save.  Then checks the peaks recorded for the
+ * workers, once stopped, against uxTaskGetStackHighWaterMark(), and compares
+ * the time taken to obtain the profile of every task with the time taken to
+ * obtain the high water mark of every task.  Build with
+ * configUSE_STACK_PROFILER set to 1, and with configUSE_FIBER_TASKS set to 1
+ * for the tasks to execute on the stacks being profiled.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define spWORKER_TASKS				( 16UL )
+#define spWORKER_STACK_DEPTH		( configMINIMAL_STACK_SIZE * 2 )
+#define spFRAME_BYTES				( 256UL )
+#define spRUN_TICKS					( pdMS_TO_TICKS( 500UL ) )
+#define spREPORT_REPEATS			( 1000UL )
+
+/* More than the number of tasks that will exist. */
+#define spMAX_TASKS					( spWORKER_TASKS + 8UL )
+
+#define spWORKER_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define spCONTROL_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Runs the workers, then reports the profile.
+ */
+static void prvControlTask( void *pvParameters );
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	/*
+	 * A worker, whose parameter is the number of frames it recurses through
+	 * each time it runs.
+	 */
+	static void prvWorkerTask( void *pvParameters );
+
+	/*
+	 * Recurse through ulFrames frames of spFRAME_BYTES each, writing to every
+	 * byte of each frame's buffer.
+	 */
+	static uint32_t prvUseStack( uint32_t ulFrames );
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	/* The number of frames the workers recurse through, each used by
+	spWORKER_TASKS / spFRAME_COUNTS workers. */
+	#define spFRAME_COUNTS			( 4UL )
+	static const uint32_t ulFrameCounts[ spFRAME_COUNTS ] = { 1UL, 4UL, 16UL, 32UL };
+
+	static TaskHandle_t xWorkerTasks[ spWORKER_TASKS ];
+
+	/* Written by the workers so the stack they use is not optimised away. */
+	static volatile uint32_t ulSink;
+
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vStartStackProfileBenchmark( void )
+{
+	#if( configUSE_STACK_PROFILER == 1 )
+	{
+	uint32_t ulWorker;
+	char cName[ configMAX_TASK_NAME_LEN ];
+
+		for( ulWorker = 0; ulWorker < spWORKER_TASKS; ulWorker++ )
+		{
+			snprintf( cName, sizeof( cName ), "Work%lu", ( unsigned long ) ulWorker );
+			xTaskCreate( prvWorkerTask, cName, spWORKER_STACK_DEPTH, ( void * ) ( size_t ) ulFrameCounts[ ulWorker % spFRAME_COUNTS ], spWORKER_PRIORITY, &( xWorkerTasks[ ulWorker ] ) );
+			configASSERT( xWorkerTasks[ ulWorker ] );
+		}
+	}
+	#endif
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, spCONTROL_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	static void prvControlTask( void *pvParameters )
+	{
+	static TaskStackProfile_t xProfiles[ spMAX_TASKS ];
+	UBaseType_t uxTasks, x;
+	uint32_t ulAllocatedWords = 0, ulRecommendedWords = 0, ulMatches = 0, ulWorker, ulRepeat;
+	uint64_t ullStartTime;
+
+		( void ) pvParameters;
+
+		#if( configUSE_FIBER_TASKS != 1 )
+		{
+			printf( "Tasks execute on host thread stacks, so only the words written when each task was created are found to be used\r\n" );
+		}
+		#endif
+
+		/* Let the workers use their stacks while the idle task samples them. */
+		vTaskDelay( spRUN_TICKS );
+
+		/* Stop the workers, then give the idle task time to sample every
+		task at least once more, so the peaks recorded are final. */
+		for( ulWorker = 0; ulWorker < spWORKER_TASKS; ulWorker++ )
+		{
+			vTaskSuspend( xWorkerTasks[ ulWorker ] );
+		}
+
+		vTaskDelay( ( TickType_t ) ( ( spMAX_TASKS + 1UL ) * ( configSTACK_PROFILER_SAMPLE_PERIOD + 1UL ) ) );
+
+		uxTasks = uxTaskGetStackProfile( xProfiles, spMAX_TASKS );
+		configASSERT( uxTasks < spMAX_TASKS );
+
+		printf( "%-16s %8s %8s %12s\r\n", "Task", "Depth", "Peak", "Recommended" );
+
+		for( x = 0; x < uxTasks; x++ )
+		{
+			printf( "%-16s %8lu %8lu %12lu\r\n", xProfiles[ x ].pcTaskName, ( unsigned long ) xProfiles[ x ].ulStackDepth, ( unsigned long ) xProfiles[ x ].ulPeakStackUse, ( unsigned long ) xProfiles[ x ].ulRecommendedStackDepth );
+
+			ulAllocatedWords += xProfiles[ x ].ulStackDepth;
+			ulRecommendedWords += xProfiles[ x ].ulRecommendedStackDepth;
+		}
+
+		/* The workers are no longer using their stacks, so the peaks recorded
+		for them can be checked against their high water marks. */
+		for( ulWorker = 0; ulWorker < spWORKER_TASKS; ulWorker++ )
+		{
+			for( x = 0; x < uxTasks; x++ )
+			{
+				if( ( xProfiles[ x ].xHandle == xWorkerTasks[ ulWorker ] ) && ( ( xProfiles[ x ].ulStackDepth - xProfiles[ x ].ulPeakStackUse ) == ( uint32_t ) uxTaskGetStackHighWaterMark( xWorkerTasks[ ulWorker ] ) ) )
+				{
+					ulMatches++;
+				}
+			}
+		}
+
+		printf( "Stacks allocated %lu bytes, recommended %lu bytes, %lu%% saved\r\n",
+				( unsigned long ) ( ulAllocatedWords * sizeof( StackType_t ) ),
+				( unsigned long ) ( ulRecommendedWords * sizeof( StackType_t ) ),
+				( unsigned long ) ( ( ( uint64_t ) ( ulAllocatedWords - ulRecommendedWords ) * 100ULL ) / ulAllocatedWords ) );
+		printf( "Worker peaks matching the high water mark: %lu of %lu\r\n", ( unsigned long ) ulMatches, ( unsigned long ) spWORKER_TASKS );
+
+		/* Compare the cost of the two ways of finding the stack use of every
+		task. */
+		ullStartTime = ullBenchmarkTimeNs();
+
+		for( ulRepeat = 0; ulRepeat < spREPORT_REPEATS; ulRepeat++ )
+		{
+			( void ) uxTaskGetStackProfile( xProfiles, spMAX_TASKS );
+		}
+
+		vBenchmarkPrintRate( "stack profiles of all tasks", spREPORT_REPEATS, ullBenchmarkTimeNs() - ullStartTime );
+
+		ullStartTime = ullBenchmarkTimeNs();
+
+		for( ulRepeat = 0; ulRepeat < spREPORT_REPEATS; ulRepeat++ )
+		{
+			for( x = 0; x < uxTasks; x++ )
+			{
+				( void ) uxTaskGetStackHighWaterMark( xProfiles[ x ].xHandle );
+			}
+		}
+
+		vBenchmarkPrintRate( "high water marks of all tasks", spREPORT_REPEATS, ullBenchmarkTimeNs() - ullStartTime );
+
+		vTaskEndScheduler();
+	}
+
+#else /* configUSE_STACK_PROFILER */
+
+	static void prvControlTask( void *pvParameters )
+	{
+		( void ) pvParameters;
+
+		printf( "Build with configUSE_STACK_PROFILER set to 1 to run this benchmark\r\n" );
+		vTaskEndScheduler();
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	static void prvWorkerTask( void *pvParameters )
+	{
+	const uint32_t ulFrames = ( uint32_t ) ( size_t ) pvParameters;
+
+		for( ;; )
+		{
+			ulSink = prvUseStack( ulFrames );
+			vTaskDelay( 1 );
+		}
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	static uint32_t prvUseStack( uint32_t ulFrames )
+	{
+	volatile uint8_t ucBuffer[ spFRAME_BYTES ];
+	uint32_t ulByte, ulSum = 0;
+
+		for( ulByte = 0; ulByte < spFRAME_BYTES; ulByte++ )
+		{
+			ucBuffer[ ulByte ] = ( uint8_t ) ( ulFrames + ulByte );
+		}
+
+		if( ulFrames > 1UL )
+		{
+			ulSum = prvUseStack( ulFrames - 1UL );
+		}
+
+		/* Use the buffer after the recursion returns so the call is not a
+		tail call. */
+		return ulSum + ucBuffer[ 0 ] + ucBuffer[ spFRAME_BYTES - 1UL ];
+	}
+
+#endif /* configUSE_STACK_PROFILER */
+/*-----------------------------------------------------------*/
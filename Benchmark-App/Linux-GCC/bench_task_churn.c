@@ -0,0 +1,170 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Task churn benchmark.
+ *
+ * A task repeatedly creates a group of tasks, of three different stack
+ * depths, then deletes them again before they have run.  Reports the rate at
+ * which tasks are created and deleted, and the free heap once the tasks have
+ * been deleted.  The heap is first fragmented, as it would be after running
+ * for some time, by allocating many small blocks and freeing every other one,
+ * so the heap has a long list of free blocks too small for a stack.  Build
+ * with configUSE_TASK_POOL set to 1 to reuse the TCBs and stacks of the
+ * deleted tasks rather than freeing and allocating them again, and with
+ * configUSE_FIBER_TASKS set to 1 so the cost of creating host threads does
+ * not hide that of the heap.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#define tcGROUPS					( 20000UL )
+#define tcFRAGMENTS					( 2000UL )
+#define tcFRAGMENT_SIZE				( ( size_t ) 32 )
+#define tcTASKS_PER_GROUP			( 3UL )
+
+#define tcCONTROL_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+#define tcCHURN_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Creates and deletes the tasks.
+ */
+static void prvControlTask( void *pvParameters );
+
+/*
+ * The tasks created, which never run.
+ */
+static void prvChurnTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The blocks that fragment the heap, every other one of which is freed. */
+static void *pvFragments[ tcFRAGMENTS ];
+
+static const configSTACK_DEPTH_TYPE usStackDepths[ tcTASKS_PER_GROUP ] =
+{
+	configMINIMAL_STACK_SIZE,
+	configMINIMAL_STACK_SIZE * 2,
+	configMINIMAL_STACK_SIZE * 4
+};
+
+/*-----------------------------------------------------------*/
+
+void vStartTaskChurnBenchmark( void )
+{
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, tcCONTROL_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+TaskHandle_t xTasks[ tcTASKS_PER_GROUP ];
+uint32_t ulGroup, ulTask;
+uint64_t ullStartTime, ullElapsedNs;
+
+	( void ) pvParameters;
+
+	printf( "configUSE_TASK_POOL = %d, configUSE_FIBER_TASKS = %d\r\n", configUSE_TASK_POOL, configUSE_FIBER_TASKS );
+
+	for( ulGroup = 0UL; ulGroup < tcFRAGMENTS; ulGroup++ )
+	{
+		pvFragments[ ulGroup ] = pvPortMalloc( tcFRAGMENT_SIZE );
+		configASSERT( pvFragments[ ulGroup ] );
+	}
+
+	for( ulGroup = 0UL; ulGroup < tcFRAGMENTS; ulGroup += 2UL )
+	{
+		vPortFree( pvFragments[ ulGroup ] );
+		pvFragments[ ulGroup ] = NULL;
+	}
+
+	printf( "Free heap before                 %lu bytes\r\n", ( unsigned long ) xPortGetFreeHeapSize() );
+
+	ullStartTime = ullBenchmarkTimeNs();
+
+	for( ulGroup = 0UL; ulGroup < tcGROUPS; ulGroup++ )
+	{
+		for( ulTask = 0UL; ulTask < tcTASKS_PER_GROUP; ulTask++ )
+		{
+			if( xTaskCreate( prvChurnTask, "Churn", usStackDepths[ ulTask ], NULL, tcCHURN_TASK_PRIORITY, &( xTasks[ ulTask ] ) ) != pdPASS )
+			{
+				printf( "Could not create a task\r\n" );
+				configASSERT( pdFALSE );
+			}
+		}
+
+		for( ulTask = 0UL; ulTask < tcTASKS_PER_GROUP; ulTask++ )
+		{
+			vTaskDelete( xTasks[ ulTask ] );
+		}
+	}
+
+	ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+
+	vBenchmarkPrintRate( "Task create/delete pairs", tcGROUPS * tcTASKS_PER_GROUP, ullElapsedNs );
+	printf( "Free heap after                  %lu bytes\r\n", ( unsigned long ) xPortGetFreeHeapSize() );
+
+	#if( configUSE_TASK_POOL == 1 )
+	{
+	TaskPoolStats_t xStats;
+
+		vTaskGetTaskPoolStats( &xStats );
+		printf( "Pool hits %lu, misses %lu, recycled %lu, overflows %lu, pooled %lu\r\n",
+				( unsigned long ) xStats.ulHits,
+				( unsigned long ) xStats.ulMisses,
+				( unsigned long ) xStats.ulRecycled,
+				( unsigned long ) xStats.ulOverflows,
+				( unsigned long ) xStats.uxPooledTasks );
+		printf( "Released %lu pooled tasks\r\n", ( unsigned long ) uxTaskReleaseTaskPool() );
+		printf( "Free heap after releasing        %lu bytes\r\n", ( unsigned long ) xPortGetFreeHeapSize() );
+	}
+	#endif /* configUSE_TASK_POOL */
+
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvChurnTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		vTaskSuspend( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
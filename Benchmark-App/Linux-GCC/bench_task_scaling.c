@@ -0,0 +1,143 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Task scaling benchmark.
+ *
+ * Creates a large number of tasks of equal priority, above that of the idle
+ * task, that each repeatedly call taskYIELD(), so the tasks run round robin
+ * and every yield switches to the next of them.  Reports the time taken to
+ * create the tasks, then the switch rate and latency with all of them in the
+ * Ready state.  The number of tasks can be set with -DtsNUMBER_OF_TASKS in
+ * CONFIG_FLAGS.  Build with configUSE_FIBER_TASKS set to 1 to run the tasks as
+ * fibers on one host thread rather than on a host thread each.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+#ifndef tsNUMBER_OF_TASKS
+	#define tsNUMBER_OF_TASKS		( 10000UL )
+#endif
+
+/* The number of times every task is switched to after they have all run once,
+which is not timed. */
+#define tsTIMED_ROUNDS				( 20UL )
+
+#define tsTASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The tasks that yield to each other.
+ */
+static void prvYieldingTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* The time at which the last task to yield called taskYIELD(). */
+static volatile uint64_t ullYieldTime = 0ULL;
+
+/* The number of switches performed so far, by all the tasks. */
+static volatile uint32_t ulSwitches = 0UL;
+
+static BenchmarkStats_t xSwitchLatency;
+static uint64_t ullStartTime = 0ULL;
+
+/*-----------------------------------------------------------*/
+
+void vStartTaskScalingBenchmark( void )
+{
+uint32_t ulTask;
+uint64_t ullCreateStartTime;
+
+	vBenchmarkStatsReset( &xSwitchLatency );
+
+	ullCreateStartTime = ullBenchmarkTimeNs();
+
+	for( ulTask = 0; ulTask < tsNUMBER_OF_TASKS; ulTask++ )
+	{
+		if( xTaskCreate( prvYieldingTask, "Scale", configMINIMAL_STACK_SIZE, NULL, tsTASK_PRIORITY, NULL ) != pdPASS )
+		{
+			break;
+		}
+	}
+
+	printf( "configUSE_FIBER_TASKS = %d\r\n", configUSE_FIBER_TASKS );
+	printf( "Created %lu of %lu tasks, each with a stack of %lu bytes\r\n", ( unsigned long ) ulTask, ( unsigned long ) tsNUMBER_OF_TASKS, ( unsigned long ) ( configMINIMAL_STACK_SIZE * sizeof( StackType_t ) ) );
+	vBenchmarkPrintRate( "Task creations", ulTask, ullBenchmarkTimeNs() - ullCreateStartTime );
+	configASSERT( ulTask == tsNUMBER_OF_TASKS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvYieldingTask( void *pvParameters )
+{
+uint64_t ullNow, ullThen;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ullYieldTime = ullBenchmarkTimeNs();
+		taskYIELD();
+		ullNow = ullBenchmarkTimeNs();
+
+		ulSwitches++;
+
+		/* Start timing once every task has run, so is no longer running for
+		the first time. */
+		if( ulSwitches == tsNUMBER_OF_TASKS )
+		{
+			ullStartTime = ullNow;
+		}
+		else if( ulSwitches > tsNUMBER_OF_TASKS )
+		{
+			/* A tick that preempts this task after it read the time lets
+			another task update ullYieldTime, so the sample is lost. */
+			ullThen = ullYieldTime;
+			if( ullNow > ullThen )
+			{
+				vBenchmarkStatsAdd( &xSwitchLatency, ullNow - ullThen );
+			}
+
+			if( ulSwitches == ( tsNUMBER_OF_TASKS * ( tsTIMED_ROUNDS + 1UL ) ) )
+			{
+				vBenchmarkPrintRate( "Context switches", tsNUMBER_OF_TASKS * tsTIMED_ROUNDS, ullNow - ullStartTime );
+				vBenchmarkStatsPrint( "Switch latency", &xSwitchLatency );
+				vTaskEndScheduler();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
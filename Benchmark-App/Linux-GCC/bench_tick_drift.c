@@ -0,0 +1,131 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Tick drift benchmark.
+ *
+ * A periodic task uses vTaskDelayUntil() to run on every tick for a fixed
+ * number of ticks, while a task at a lower priority keeps the processor busy.
+ * The periodic task measures how late it runs relative to the host clock each
+ * period, and at the end reports how far the tick count has drifted from the
+ * host clock, along with the tick statistics kept by the port.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The number of periods the periodic task runs for. */
+#define tdPERIODS					( 5000UL )
+
+#define tdPERIODIC_TASK_PRIORITY	( tskIDLE_PRIORITY + 2 )
+#define tdLOAD_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+
+#define tdTICK_PERIOD_NS			( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that runs periodically, and the task that loads the processor.
+ */
+static void prvPeriodicTask( void *pvParameters );
+static void prvLoadTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+static BenchmarkStats_t xWakeLateness;
+
+/*-----------------------------------------------------------*/
+
+void vStartTickDriftBenchmark( void )
+{
+	vBenchmarkStatsReset( &xWakeLateness );
+
+	xTaskCreate( prvPeriodicTask, "Periodic", configMINIMAL_STACK_SIZE, NULL, tdPERIODIC_TASK_PRIORITY, NULL );
+	xTaskCreate( prvLoadTask, "Load", configMINIMAL_STACK_SIZE, NULL, tdLOAD_TASK_PRIORITY, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void *pvParameters )
+{
+TickType_t xLastWakeTime, xStartTick;
+uint64_t ullStartTime, ullNow, ullExpected;
+uint32_t ulPeriod;
+int64_t llDriftNs;
+PortTickStats_t xTickStats;
+
+	( void ) pvParameters;
+
+	/* Start on a tick boundary. */
+	vTaskDelay( 1 );
+	xStartTick = xTaskGetTickCount();
+	xLastWakeTime = xStartTick;
+	ullStartTime = ullBenchmarkTimeNs();
+
+	for( ulPeriod = 1; ulPeriod <= tdPERIODS; ulPeriod++ )
+	{
+		vTaskDelayUntil( &xLastWakeTime, 1 );
+		ullNow = ullBenchmarkTimeNs();
+
+		ullExpected = ullStartTime + ( ( uint64_t ) ulPeriod * tdTICK_PERIOD_NS );
+		vBenchmarkStatsAdd( &xWakeLateness, ( ullNow > ullExpected ) ? ( ullNow - ullExpected ) : 0ULL );
+	}
+
+	/* How far the tick count has moved from the host clock, positive if the
+	tick count is behind. */
+	llDriftNs = ( int64_t ) ( ullNow - ullStartTime ) - ( int64_t ) ( ( uint64_t ) ( xTaskGetTickCount() - xStartTick ) * tdTICK_PERIOD_NS );
+	vPortGetTickStats( &xTickStats );
+
+	printf( "%-32s %lu of %llu ns\r\n", "Periods", ( unsigned long ) tdPERIODS, ( unsigned long long ) tdTICK_PERIOD_NS );
+	vBenchmarkStatsPrint( "Wake lateness", &xWakeLateness );
+	printf( "%-32s %lld us\r\n", "Tick drift from host clock", ( long long ) ( llDriftNs / 1000LL ) );
+	printf( "%-32s %lu\r\n", "Ticks generated", ( unsigned long ) xTickStats.ulTicks );
+	printf( "%-32s %lu\r\n", "Late ticks", ( unsigned long ) xTickStats.ulLateTicks );
+	printf( "%-32s %lu\r\n", "Missed ticks", ( unsigned long ) xTickStats.ulMissedTicks );
+	printf( "%-32s %lu us\r\n", "Max tick lateness", ( unsigned long ) xTickStats.ulMaxLatenessUs );
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadTask( void *pvParameters )
+{
+volatile uint32_t ulCount = 0UL;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		ulCount++;
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,192 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+/*
+ * Virtual time benchmark.
+ *
+ * Periodic tasks with co-prime periods, and a task unblocked by a simulated
+ * interrupt that is timed by the port to recur every two and a half ticks, run
+ * for a fixed span of simulated time while the processor is otherwise idle.
+ * Reports how much host time the span took, and how many times a periodic task
+ * was not unblocked on the tick it was due.  Build with configUSE_TICKLESS_IDLE
+ * and configUSE_VIRTUAL_TIME set to 1 to have the idle time skipped.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* The span of simulated time the benchmark runs for - much longer when it does
+not have to pass in real time. */
+#if( configUSE_VIRTUAL_TIME == 1 )
+	#define vtDURATION				pdMS_TO_TICKS( 600000UL )
+#else
+	#define vtDURATION				pdMS_TO_TICKS( 5000UL )
+#endif
+
+/* The periodic tasks, and the period of the timed interrupt. */
+#define vtPERIODIC_TASKS			( 3 )
+#define vtINTERRUPT					( 2UL )
+#define vtINTERRUPT_PERIOD_NS		( ( 5ULL * 1000000000ULL ) / ( 2ULL * ( uint64_t ) configTICK_RATE_HZ ) )
+
+#define vtCONTROL_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+#define vtINTERRUPT_TASK_PRIORITY	( tskIDLE_PRIORITY + 4 )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that times the benchmark and prints the results, the periodic
+ * tasks, and the task unblocked by the timed interrupt.
+ */
+static void prvControlTask( void *pvParameters );
+static void prvPeriodicTask( void *pvParameters );
+static void prvInterruptTask( void *pvParameters );
+
+/*
+ * The handler of the timed interrupt, which times it again.
+ */
+static uint32_t prvTimedInterruptHandler( void );
+
+/*-----------------------------------------------------------*/
+
+static const TickType_t xPeriods[ vtPERIODIC_TASKS ] = { 5, 7, 11 };
+
+static SemaphoreHandle_t xSemaphore = NULL;
+
+/* The number of times the periodic tasks were unblocked, and how many of those
+were after the tick on which they were due. */
+static volatile uint32_t ulReleases = 0UL;
+static volatile uint32_t ulLateReleases = 0UL;
+
+/* The number of times the timed interrupt was handled by the task. */
+static volatile uint32_t ulInterrupts = 0UL;
+
+/*-----------------------------------------------------------*/
+
+void vStartVirtualTimeBenchmark( void )
+{
+BaseType_t x;
+
+	xSemaphore = xSemaphoreCreateBinary();
+	configASSERT( xSemaphore );
+
+	vPortSetInterruptHandler( vtINTERRUPT, prvTimedInterruptHandler );
+
+	xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, vtCONTROL_TASK_PRIORITY, NULL );
+	xTaskCreate( prvInterruptTask, "Interrupt", configMINIMAL_STACK_SIZE, NULL, vtINTERRUPT_TASK_PRIORITY, NULL );
+
+	for( x = 0; x < vtPERIODIC_TASKS; x++ )
+	{
+		xTaskCreate( prvPeriodicTask, "Periodic", configMINIMAL_STACK_SIZE, ( void * ) &( xPeriods[ x ] ), tskIDLE_PRIORITY + 1 + ( UBaseType_t ) x, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimedInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	vPortGenerateSimulatedInterruptAfter( vtINTERRUPT, vtINTERRUPT_PERIOD_NS );
+	xSemaphoreGiveFromISR( xSemaphore, &xHigherPriorityTaskWoken );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void *pvParameters )
+{
+TickType_t xStartTick, xElapsedTicks;
+uint64_t ullStartTime, ullElapsedNs;
+
+	( void ) pvParameters;
+
+	/* Start on a tick boundary. */
+	vTaskDelay( 1 );
+	xStartTick = xTaskGetTickCount();
+	ullStartTime = ullBenchmarkTimeNs();
+	vPortGenerateSimulatedInterruptAfter( vtINTERRUPT, vtINTERRUPT_PERIOD_NS );
+
+	vTaskDelay( vtDURATION );
+
+	ullElapsedNs = ullBenchmarkTimeNs() - ullStartTime;
+	xElapsedTicks = xTaskGetTickCount() - xStartTick;
+
+	printf( "configUSE_VIRTUAL_TIME = %d\r\n", configUSE_VIRTUAL_TIME );
+	printf( "%-32s %lu ms\r\n", "Simulated time", ( unsigned long ) ( xElapsedTicks * portTICK_PERIOD_MS ) );
+	printf( "%-32s %llu ms\r\n", "Host time", ( unsigned long long ) ( ullElapsedNs / 1000000ULL ) );
+	printf( "%-32s %.1f\r\n", "Simulated time per host time", ( ( double ) xElapsedTicks * ( double ) portTICK_PERIOD_MS * 1000000.0 ) / ( double ) ullElapsedNs );
+	printf( "%-32s %lu\r\n", "Periodic task releases", ( unsigned long ) ulReleases );
+	printf( "%-32s %lu\r\n", "Late periodic task releases", ( unsigned long ) ulLateReleases );
+	printf( "%-32s %lu\r\n", "Timed interrupts", ( unsigned long ) ulInterrupts );
+	vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeriodicTask( void *pvParameters )
+{
+const TickType_t xPeriod = *( ( const TickType_t * ) pvParameters );
+TickType_t xLastWakeTime;
+
+	xLastWakeTime = xTaskGetTickCount();
+
+	for( ;; )
+	{
+		vTaskDelayUntil( &xLastWakeTime, xPeriod );
+
+		taskENTER_CRITICAL();
+		{
+			ulReleases++;
+
+			if( xTaskGetTickCount() != xLastWakeTime )
+			{
+				ulLateReleases++;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		if( xSemaphoreTake( xSemaphore, portMAX_DELAY ) == pdPASS )
+		{
+			ulInterrupts++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
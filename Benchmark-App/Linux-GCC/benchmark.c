@@ -0,0 +1,109 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <time.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/*-----------------------------------------------------------*/
+
+uint64_t ullBenchmarkTimeNs( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkStatsReset( BenchmarkStats_t *pxStats )
+{
+	pxStats->ullCount = 0ULL;
+	pxStats->ullTotalNs = 0ULL;
+	pxStats->ullMinNs = UINT64_MAX;
+	pxStats->ullMaxNs = 0ULL;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkStatsAdd( BenchmarkStats_t *pxStats, uint64_t ullSampleNs )
+{
+	pxStats->ullCount++;
+	pxStats->ullTotalNs += ullSampleNs;
+
+	if( ullSampleNs < pxStats->ullMinNs )
+	{
+		pxStats->ullMinNs = ullSampleNs;
+	}
+
+	if( ullSampleNs > pxStats->ullMaxNs )
+	{
+		pxStats->ullMaxNs = ullSampleNs;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkStatsPrint( const char *pcName, const BenchmarkStats_t *pxStats )
+{
+	if( pxStats->ullCount == 0ULL )
+	{
+		printf( "%-32s no samples\r\n", pcName );
+	}
+	else
+	{
+		printf( "%-32s samples %llu  min %llu ns  avg %llu ns  max %llu ns\r\n",
+				pcName,
+				( unsigned long long ) pxStats->ullCount,
+				( unsigned long long ) pxStats->ullMinNs,
+				( unsigned long long ) ( pxStats->ullTotalNs / pxStats->ullCount ),
+				( unsigned long long ) pxStats->ullMaxNs );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchmarkPrintRate( const char *pcName, uint64_t ullOperations, uint64_t ullElapsedNs )
+{
+double dRate = 0.0;
+
+	if( ullElapsedNs != 0ULL )
+	{
+		dRate = ( ( double ) ullOperations * 1e9 ) / ( double ) ullElapsedNs;
+	}
+
+	printf( "%-32s %llu in %.3f ms = %.0f per second\r\n",
+			pcName,
+			( unsigned long long ) ullOperations,
+			( double ) ullElapsedNs / 1e6,
+			dRate );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,89 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*
+ * Helpers shared by the benchmarks, and the entry points of the benchmarks
+ * themselves.  Each benchmark creates the tasks it needs when its start
+ * function is called, before the scheduler is started, and ends the scheduler
+ * (so the process) once it has printed its results.
+ */
+
+/* Latency statistics accumulated by a benchmark, all times in nanoseconds. */
+typedef struct BENCHMARK_STATS
+{
+	uint64_t ullCount;
+	uint64_t ullTotalNs;
+	uint64_t ullMinNs;
+	uint64_t ullMaxNs;
+} BenchmarkStats_t;
+
+/*
+ * Return the time of the host's monotonic clock in nanoseconds.
+ */
+uint64_t ullBenchmarkTimeNs( void );
+
+/*
+ * Reset, update and print a set of latency statistics.
+ */
+void vBenchmarkStatsReset( BenchmarkStats_t *pxStats );
+void vBenchmarkStatsAdd( BenchmarkStats_t *pxStats, uint64_t ullSampleNs );
+void vBenchmarkStatsPrint( const char *pcName, const BenchmarkStats_t *pxStats );
+
+/*
+ * Print a rate, in operations per second, given a number of operations and
+ * the time in nanoseconds they took.
+ */
+void vBenchmarkPrintRate( const char *pcName, uint64_t ullOperations, uint64_t ullElapsedNs );
+
+/*
+ * The benchmarks.
+ */
+void vStartContextSwitchBenchmark( void );
+void vStartTaskScalingBenchmark( void );
+void vStartTickDriftBenchmark( void );
+void vStartIdleWakeupsBenchmark( void );
+void vStartQueueBenchmark( void );
+void vStartInterruptLatencyBenchmark( void );
+void vStartVirtualTimeBenchmark( void );
+void vStartPeripheralLoadBenchmark( void );
+void vStartDelayedTasksBenchmark( void );
+void vStartPrioritySpanBenchmark( void );
+void vStartPendedTicksBenchmark( void );
+void vStartTaskChurnBenchmark( void );
+void vStartExecutionStatsBenchmark( void );
+void vStartPeriodicTasksBenchmark( void );
+void vStartPriorityChainBenchmark( void );
+void vStartPriorityCeilingBenchmark( void );
+void vStartStackProfileBenchmark( void );
+void vStartQueueLoansBenchmark( void );
+void vStartQueueBatchesBenchmark( void );
+void vStartEDFSchedulingBenchmark( void );
+
+#endif /* BENCHMARK_H */
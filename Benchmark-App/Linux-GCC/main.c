@@ -0,0 +1,186 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/******************************************************************************
+ * Entry point of the benchmark application.  Each benchmark measures one part
+ * of the kernel or of the Linux simulator port, and is selected by name on the
+ * command line - the scheduler can only be started once per process, so only
+ * one benchmark is run per invocation.  See the Makefile for how to build the
+ * same benchmarks with different kernel and port options for comparison.
+ *
+ * NOTE: Linux will not be running the FreeRTOS threads continuously, so the
+ * absolute numbers depend heavily on the host.  Compare builds on the same
+ * host only.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Benchmark includes. */
+#include "benchmark.h"
+
+/* A benchmark that can be selected from the command line. */
+typedef struct BENCHMARK_DEFINITION
+{
+	const char *pcName;
+	void ( *pvStartBenchmark )( void );
+} BenchmarkDefinition_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Prototypes for the standard FreeRTOS application hook (callback) functions
+ * implemented within this file.  See http://www.freertos.org/a00016.html .
+ */
+void vApplicationMallocFailedHook( void );
+
+/*-----------------------------------------------------------*/
+
+/* The benchmarks that can be selected from the command line. */
+static const BenchmarkDefinition_t xBenchmarks[] =
+{
+	{ "context-switch",		vStartContextSwitchBenchmark },
+	{ "task-scaling",		vStartTaskScalingBenchmark },
+	{ "tick-drift",			vStartTickDriftBenchmark },
+	{ "idle-wakeups",		vStartIdleWakeupsBenchmark },
+	{ "queue",				vStartQueueBenchmark },
+	{ "interrupt-latency",	vStartInterruptLatencyBenchmark },
+	{ "virtual-time",		vStartVirtualTimeBenchmark },
+	{ "peripheral-load",	vStartPeripheralLoadBenchmark },
+	{ "delayed-tasks",		vStartDelayedTasksBenchmark },
+	{ "priority-span",		vStartPrioritySpanBenchmark },
+	{ "pended-ticks",		vStartPendedTicksBenchmark },
+	{ "task-churn",			vStartTaskChurnBenchmark },
+	{ "execution-stats",	vStartExecutionStatsBenchmark },
+	{ "periodic-tasks",		vStartPeriodicTasksBenchmark },
+	{ "priority-chain",		vStartPriorityChainBenchmark },
+	{ "priority-ceiling",	vStartPriorityCeilingBenchmark },
+	{ "stack-profile",		vStartStackProfileBenchmark },
+	{ "queue-loans",		vStartQueueLoansBenchmark },
+	{ "queue-batches",		vStartQueueBatchesBenchmark },
+	{ "edf-scheduling",		vStartEDFSchedulingBenchmark },
+};
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char **argv )
+{
+size_t x;
+
+	/* Results are printed by tasks, make sure they are seen as soon as they
+	are printed even when the output is redirected. */
+	setvbuf( stdout, NULL, _IONBF, 0 );
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+	BaseType_t xStatus = pdPASS;
+	const char *pcLogFile = NULL;
+
+		/* Record the arrival of the ticks and the simulated interrupts, or
+		replay a recording, so two builds of the kernel can be compared against
+		exactly the same arrivals. */
+		if( ( argc == 4 ) && ( strcmp( argv[ 1 ], "--record" ) == 0 ) )
+		{
+			pcLogFile = argv[ 2 ];
+			xStatus = xPortRecordInterrupts( pcLogFile );
+			argv += 2;
+			argc -= 2;
+		}
+		else if( ( argc == 4 ) && ( strcmp( argv[ 1 ], "--replay" ) == 0 ) )
+		{
+			pcLogFile = argv[ 2 ];
+			xStatus = xPortReplayInterrupts( pcLogFile );
+			argv += 2;
+			argc -= 2;
+		}
+
+		if( xStatus != pdPASS )
+		{
+			printf( "Could not open %s\r\n", pcLogFile );
+			return EXIT_FAILURE;
+		}
+	}
+	#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+	if( argc == 2 )
+	{
+		for( x = 0; x < sizeof( xBenchmarks ) / sizeof( xBenchmarks[ 0 ] ); x++ )
+		{
+			if( strcmp( argv[ 1 ], xBenchmarks[ x ].pcName ) == 0 )
+			{
+				printf( "Running %s benchmark\r\n", xBenchmarks[ x ].pcName );
+				xBenchmarks[ x ].pvStartBenchmark();
+				vTaskStartScheduler();
+
+				/* Only reached if there was insufficient heap to start the
+				scheduler. */
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		printf( "Usage: %s [--record <log> | --replay <log>] <benchmark>, where <benchmark> is one of:\r\n", argv[ 0 ] );
+	#else
+		printf( "Usage: %s <benchmark>, where <benchmark> is one of:\r\n", argv[ 0 ] );
+	#endif
+
+	for( x = 0; x < sizeof( xBenchmarks ) / sizeof( xBenchmarks[ 0 ] ); x++ )
+	{
+		printf( "    %s\r\n", xBenchmarks[ x ].pcName );
+	}
+
+	return EXIT_FAILURE;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook( void )
+{
+	/* vApplicationMallocFailedHook() will only be called if
+	configUSE_MALLOC_FAILED_HOOK is set to 1 in FreeRTOSConfig.h.  The
+	benchmarks size the heap for their own needs, so running out is an
+	error. */
+	vAssertCalled( __LINE__, __FILE__ );
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( unsigned long ulLine, const char * const pcFileName )
+{
+	/* Called if an assertion passed to configASSERT() fails.  See
+	http://www.freertos.org/a00110.html#configASSERT for more information.
+	A benchmark that fails an assertion is not worth continuing. */
+	printf( "ASSERT! Line %ld, file %s\r\n", ulLine, pcFileName );
+	abort();
+}
+/*-----------------------------------------------------------*/
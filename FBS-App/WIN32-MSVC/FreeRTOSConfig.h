@@ -71,6 +71,13 @@
 
 #define configMAX_PRIORITIES					( 32 )
 
+/* Frame scheduler configuration options. */
+#define configUSE_FRAME_SCHEDULER				1
+#define configUSE_FRAME_OVERRUN_HOOK			1
+
+/* Limit the processing time of a runaway task. */
+#define configUSE_TASK_BUDGETS					1
+
 /* Run time stats gathering configuration options. */
 #define configGENERATE_RUN_TIME_STATS			0
 
@@ -103,6 +110,7 @@ functions anyway. */
 #define INCLUDE_xSemaphoreGetMutexHolder		1
 #define INCLUDE_xTimerPendFunctionCall			1
 #define INCLUDE_xTaskAbortDelay					1
+#define INCLUDE_xTaskGetCurrentTaskHandle		1
 
 /* It is a good idea to define configASSERT() while developing.  configASSERT()
 uses the same semantics as the standard C assert() macro. */
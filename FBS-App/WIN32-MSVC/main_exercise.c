@@ -51,40 +51,70 @@
 #include "task.h"
 #include "timers.h"
 #include "semphr.h"
+#include "frame_scheduler.h"
 
 /* Priorities at which the tasks are created.
  */
 #define workerTASK_FBS_PRIORITY		( tskIDLE_PRIORITY + 1 )
 #define schedulerTASK_FBS_PRIORITY		( tskIDLE_PRIORITY + 2 )
 
- /* Scheduler task frequency between frames
+ /* Length of each frame
   */
 #define schedulerTASK_FBS_FREQUENCY_MS   pdMS_TO_TICKS( 120UL )
+
+ /* Processing time Task5 can use in each frame before it is throttled
+  */
+#define workerTASK_FBS_BUDGET_MS   pdMS_TO_TICKS( 20UL )
   /*-----------------------------------------------------------*/
 
 /*
-* Data structure to hold number of tasks and frames; used by Scheduler task
+* Number of worker tasks and frames
 */
-struct xTaskParam {
-	uint32_t task_num;
-	uint32_t frame_num;
-};
+#define workerTASK_FBS_COUNT		6
+#define schedulerFBS_FRAME_COUNT	5
 
 /*
 * Task handles for scheduling control
 */
-TaskHandle_t xTask[6] = { 0,1,2,3,4,5 };
+TaskHandle_t xTask[workerTASK_FBS_COUNT] = { 0,1,2,3,4,5 };
+
+/*
+* Tasks released in each frame, filled in once the tasks are created.  Task5
+* never completes, so overruns frame 0.
+*/
+static TaskHandle_t xFrame0Tasks[6];
+static TaskHandle_t xFrame2Tasks[3];
+static TaskHandle_t xFrame3Tasks[2];
+static TaskHandle_t xFrame4Tasks[3];
+
+/*
+* The frame table; the frame scheduler releases the tasks of each frame from
+* the tick, so no task has to build the frames by hand
+*/
+static FrameDefinition_t xFrames[schedulerFBS_FRAME_COUNT] =
+{
+	{ schedulerTASK_FBS_FREQUENCY_MS, xFrame0Tasks, 6 },
+	{ schedulerTASK_FBS_FREQUENCY_MS, NULL, 0 },
+	{ schedulerTASK_FBS_FREQUENCY_MS, xFrame2Tasks, 3 },
+	{ schedulerTASK_FBS_FREQUENCY_MS, xFrame3Tasks, 2 },
+	{ schedulerTASK_FBS_FREQUENCY_MS, xFrame4Tasks, 3 }
+};
 
 /*
  * C function (prototype) for Worker/Scheduler tasks
  */
 static void workerTaskFBS(int32_t* pvParameter);
-static void schedulerTaskFBS(struct xTaskParam* pvParameters);
+static void schedulerTaskFBS(void* pvParameters);
+
+/*
+ * Reports, and aborts, a job that has overrun its frame.  Run by the timer
+ * task, as the overrun is detected in the tick interrupt
+ */
+static void prvHandleOverrun(void* pvTask, uint32_t ulFrame);
 
 void main_exercise( void )
 {
-	static struct xTaskParam xTaskParam = { 6, 5 };
-	static int32_t xParam[6] = { 0,1,2,3,4,5 };
+	static int32_t xParam[workerTASK_FBS_COUNT] = { 0,1,2,3,4,5 };
 
 	/*
 	 * Create the task instances.
@@ -131,10 +161,33 @@ void main_exercise( void )
 		workerTASK_FBS_PRIORITY,
 		&xTask[5]);
 
+	/*
+	 * Task5 never completes, so limit it to a share of each frame in which it
+	 * runs, leaving the rest to the tasks of the same or lower priority.
+	 */
+	vTaskSetBudget(xTask[5], workerTASK_FBS_BUDGET_MS, schedulerTASK_FBS_FREQUENCY_MS);
+
+	/*
+	 * Fill in the frames: frame 0 releases every task, frame 1 none, frames 2
+	 * and 4 tasks 0, 1 and 4, and frame 3 tasks 2 and 3.
+	 */
+	for (int i = 0; i < workerTASK_FBS_COUNT; i++)
+	{
+		xFrame0Tasks[i] = xTask[i];
+	}
+	xFrame2Tasks[0] = xTask[0];
+	xFrame2Tasks[1] = xTask[1];
+	xFrame2Tasks[2] = xTask[4];
+	xFrame3Tasks[0] = xTask[2];
+	xFrame3Tasks[1] = xTask[3];
+	xFrame4Tasks[0] = xTask[0];
+	xFrame4Tasks[1] = xTask[1];
+	xFrame4Tasks[2] = xTask[4];
+
 	xTaskCreate(schedulerTaskFBS,					/* The function that implements the scheduler task. */
 		"SchedulerTask",										/* The text name assigned to the task - for debug only as it is not used by the kernel. */
 		configMINIMAL_STACK_SIZE,				/* The size of the stack to allocate to the task. */
-		&xTaskParam,											/* The parameter passed to the task; in this case task and frame numbers*/
+		NULL,											/* The parameter passed to the task; not required */
 		schedulerTASK_FBS_PRIORITY,			/* The priority assigned to the task, in this case highest */
 		NULL);														/* The task handle; not required */
 
@@ -153,19 +206,20 @@ void main_exercise( void )
 
 static void workerTaskFBS(int32_t* pvParameter)
 {
-	TickType_t xNextWakeTime = xTaskGetTickCount();
 	int xCount;
 
 	/* If task parameter is 5 i.e if task 5 is running, then enter infinte loop,
-	* else count till 1E6, print no.of cycles counted and relative clock ticks for all other worker tasks and suspend self
+	* else count till 1E6, print no.of cycles counted and the clock tick for all other worker tasks and complete the job
 	*/
 	for (;;)
 	{
 		if (*pvParameter != 5)
 		{
 			for (xCount=0; xCount < 1e6; xCount++);
-			printf("Task%d:\tI counted %d cycles, took %d ticks\n", *pvParameter, xCount, xNextWakeTime);
-			vTaskSuspend(NULL);
+			printf("Task%d:\tI counted %d cycles, finished at tick %u\n", *pvParameter, xCount, (unsigned)xTaskGetTickCount());
+
+			/* Wait here, suspended, until released in the next frame of this task */
+			vFrameSchedulerJobComplete();
 		}
 		else
 		{
@@ -175,76 +229,60 @@ static void workerTaskFBS(int32_t* pvParameter)
 	}
 }
 
-static void schedulerTaskFBS(struct xTaskParam* pvParameters)
+static void schedulerTaskFBS(void* pvParameters)
 {
-	const TickType_t xBlockTime = schedulerTASK_FBS_FREQUENCY_MS;
-	TickType_t xNextWakeTime = xTaskGetTickCount();
-	int i = 0;
+	FrameTaskStats_t xTaskStats;
+	FrameStats_t xFrameStats;
+
+	(void)pvParameters;
 
 	/*
-	* Schedule only 5 frames. Iterate over the frames. 
-	* Check if any task has overrun, then print identifier and suspend that task.
-	* Schedule eligible tasks per frame and go into "Blocked" state.
+	* Run the 5 frames once.  The tasks are released from the tick, and
+	* overruns reported through vApplicationFrameOverrunHook(), so this task
+	* only waits for the frames to end and then prints the statistics.
 	*/
 	for (;;)
 	{
-		for (; i < pvParameters->frame_num; i++)
+		printf("Scheduling %d frames of %d ticks...\n", schedulerFBS_FRAME_COUNT, (int)schedulerTASK_FBS_FREQUENCY_MS);
+		if (xFrameSchedulerStart(xFrames, schedulerFBS_FRAME_COUNT, 1) != pdPASS)
+		{
+			printf("The frame table is not valid\n");
+			vTaskSuspend(NULL);
+		}
+
+		/* Place this task in the blocked state until the frames have ended.
+		While in the Blocked state this task will not consume any CPU time. */
+		while (xFrameSchedulerIsRunning() != pdFALSE)
 		{
-			if (i > 0)
+			vTaskDelay(schedulerTASK_FBS_FREQUENCY_MS);
+		}
+
+		printf("\n----------------------------------------------------------------------------------\n");
+		printf("Task\tReleased\tCompleted\tOverran\tSkipped\tMin slack\tMean slack\n");
+		for (int j = 0; j < workerTASK_FBS_COUNT; j++)
+		{
+			xFrameSchedulerGetTaskStats(xTask[j], &xTaskStats);
+			if (xTaskStats.ulCompletions > 0)
 			{
-				printf("Checking frame%d\n\n", i-1);
-				for (int j = 0; j < pvParameters->task_num; j++)
-				{
-					if (eTaskGetState(xTask[j]) != eSuspended)
-					{
-						printf("Task%d in frame %d was not suspended :( \n\n", j, i-1);
-						vTaskSuspend(xTask[j]);
-					}
-				}
+				printf("Task%d\t%u\t\t%u\t\t%u\t%u\t%u\t\t%u\n", j, (unsigned)xTaskStats.ulReleases, (unsigned)xTaskStats.ulCompletions,
+					(unsigned)xTaskStats.ulOverruns, (unsigned)xTaskStats.ulSkippedReleases,
+					(unsigned)xTaskStats.xMinSlack, (unsigned)(xTaskStats.ulTotalSlack / xTaskStats.ulCompletions));
 			}
 			else
 			{
-				printf("It's the very first frame\n");
+				printf("Task%d\t%u\t\t%u\t\t%u\t%u\t-\t\t-\n", j, (unsigned)xTaskStats.ulReleases, (unsigned)xTaskStats.ulCompletions,
+					(unsigned)xTaskStats.ulOverruns, (unsigned)xTaskStats.ulSkippedReleases);
 			}
+		}
 
-			printf("Scheduling for frame %d...\n", i);
-			switch (i)
-			{
-			case 0:
-				vTaskResume(xTask[0]);
-				vTaskResume(xTask[1]);
-				vTaskResume(xTask[2]);
-				vTaskResume(xTask[3]);
-				vTaskResume(xTask[4]);
-				break;
-
-			case 1:
-				break;
-
-			case 2:
-				vTaskResume(xTask[0]);
-				vTaskResume(xTask[1]);
-				vTaskResume(xTask[4]);
-				break;
-
-			case 3:
-				vTaskResume(xTask[2]);
-				vTaskResume(xTask[3]);
-				break;
-
-			case 4:
-				vTaskResume(xTask[0]);
-				vTaskResume(xTask[1]);
-				vTaskResume(xTask[4]);
-				break;
-
-			}
+		printf("\nTask5 used its budget of %d ticks %u time(s)\n", (int)workerTASK_FBS_BUDGET_MS, (unsigned)ulTaskGetBudgetExhaustions(xTask[5]));
 
-			/* Place this task in the blocked state until it is time to run again.
-			The block time is specified in ticks, pdMS_TO_TICKS() was used to
-			convert a time specified in milliseconds into a time specified in ticks.
-			While in the Blocked state this task will not consume any CPU time. */
-			vTaskDelayUntil(&xNextWakeTime, xBlockTime);
+		printf("\nFrame\tExecuted\tOverruns\tMin slack\tMean slack\n");
+		for (int i = 0; i < schedulerFBS_FRAME_COUNT; i++)
+		{
+			xFrameSchedulerGetFrameStats(i, &xFrameStats);
+			printf("%d\t%u\t\t%u\t\t%u\t\t%u\n", i, (unsigned)xFrameStats.ulExecutions, (unsigned)xFrameStats.ulOverruns,
+				(unsigned)xFrameStats.xMinSlack, (unsigned)(xFrameStats.ulTotalSlack / xFrameStats.ulExecutions));
 		}
 
 		/*
@@ -252,7 +290,7 @@ static void schedulerTaskFBS(struct xTaskParam* pvParameters)
 		*/
 		printf("\n----------------------------------------------------------------------------------\
 			\nDeleting all worker tasks and suspending self\n");
-		for (int i = 0; i <= 5; i++)
+		for (int i = 0; i < workerTASK_FBS_COUNT; i++)
 		{
 			vTaskDelete(xTask[i]);
 		}
@@ -260,4 +298,21 @@ static void schedulerTaskFBS(struct xTaskParam* pvParameters)
 	}
 }
 
+void vApplicationFrameOverrunHook(TaskHandle_t xOverrunTask, UBaseType_t uxFrame)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* Called from the tick interrupt, so leave the printing to the timer task */
+	xTimerPendFunctionCallFromISR(prvHandleOverrun, xOverrunTask, (uint32_t)uxFrame, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static void prvHandleOverrun(void* pvTask, uint32_t ulFrame)
+{
+	TaskHandle_t xOverrunTask = (TaskHandle_t)pvTask;
+
+	printf("%s in frame %u was not completed :( \n\n", pcTaskGetName(xOverrunTask), (unsigned)ulFrame);
+	vFrameSchedulerAbortJob(xOverrunTask);
+}
+
 /*-----------------------------------------------------------*/
@@ -0,0 +1,575 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "frame_scheduler.h"
+
+/* Lint e961 and e750 are suppressed as a MISRA exception justified because the
+MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined for the
+header files above, but not in this file, in order to generate the correct
+privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750. */
+
+/* This entire source file will be skipped if the application is not configured
+to include the frame scheduler functionality. */
+#if( configUSE_FRAME_SCHEDULER == 1 )
+
+/* The tick normally reaches a frame boundary exactly, but can step onto one
+when the tick has been suppressed, in which case the boundary is processed on
+the next tick.  Frame lengths are limited to half the range of the tick count
+so a boundary that has passed can be told from one that has not. */
+#define frameMAX_FRAME_LENGTH		( portMAX_DELAY >> ( TickType_t ) 1 )
+
+/* Marks a slot of the task table that does not hold a task. */
+#define frameNO_SLOT				( ( UBaseType_t ) configFRAME_SCHEDULER_MAX_TASKS )
+
+#if( configUSE_FRAME_OVERRUN_HOOK == 1 )
+
+	extern void vApplicationFrameOverrunHook( TaskHandle_t xTask, UBaseType_t uxFrame ); /*lint !e526 Symbol not defined as it is an application callback. */
+
+#endif
+
+/* The table passed to xFrameSchedulerStart().  Each task is given a slot in
+xTasks[], and each frame holds the slots of the tasks it releases. */
+PRIVILEGED_DATA static TaskHandle_t xTasks[ configFRAME_SCHEDULER_MAX_TASKS ];
+PRIVILEGED_DATA static UBaseType_t uxNumberOfTasks = ( UBaseType_t ) 0U;
+PRIVILEGED_DATA static TickType_t xFrameLengths[ configFRAME_SCHEDULER_MAX_FRAMES ];
+PRIVILEGED_DATA static uint8_t ucFrameSlots[ configFRAME_SCHEDULER_MAX_FRAMES ][ configFRAME_SCHEDULER_MAX_TASKS ];
+PRIVILEGED_DATA static UBaseType_t uxFrameTaskCounts[ configFRAME_SCHEDULER_MAX_FRAMES ];
+PRIVILEGED_DATA static UBaseType_t uxNumberOfFrames = ( UBaseType_t ) 0U;
+PRIVILEGED_DATA static UBaseType_t uxMajorCycles = ( UBaseType_t ) 0U;
+
+/* The progress through the table. */
+PRIVILEGED_DATA static volatile BaseType_t xFrameSchedulerRunning = pdFALSE;
+PRIVILEGED_DATA static BaseType_t xFrameStarted = pdFALSE;
+PRIVILEGED_DATA static UBaseType_t uxCurrentFrame = ( UBaseType_t ) 0U;
+PRIVILEGED_DATA static UBaseType_t uxCompletedCycles = ( UBaseType_t ) 0U;
+PRIVILEGED_DATA static TickType_t xNextFrameStart = ( TickType_t ) 0U;
+PRIVILEGED_DATA static TickType_t xLatestCompletion = ( TickType_t ) 0U;
+
+/* A bit for each slot, set in ulOutstandingJobs from the release of a task's
+job to its completion, and in ulOverrunJobs from the end of the frame in which
+the job was released if it was still outstanding then. */
+PRIVILEGED_DATA static uint32_t ulOutstandingJobs = 0UL;
+PRIVILEGED_DATA static uint32_t ulOverrunJobs = 0UL;
+
+PRIVILEGED_DATA static FrameTaskStats_t xTaskStats[ configFRAME_SCHEDULER_MAX_TASKS ];
+PRIVILEGED_DATA static FrameStats_t xFrameStats[ configFRAME_SCHEDULER_MAX_FRAMES ];
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the slot of xTask in the task table, or frameNO_SLOT if it is not in
+ * the table.
+ */
+static UBaseType_t prvGetSlot( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/*
+ * Count the jobs that are still outstanding at the end of the current frame
+ * as overruns, and update the statistics of the frame.
+ */
+static void prvEndFrame( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Release the tasks of the current frame, returning pdTRUE if a task that
+ * should preempt the running task was released.
+ */
+static BaseType_t prvStartFrame( void ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerStart( const FrameDefinition_t *pxFrames, UBaseType_t uxFrames, UBaseType_t uxCycles )
+{
+BaseType_t xReturn = pdPASS;
+UBaseType_t uxFrame, uxTask, uxSlot, x;
+
+	configASSERT( pxFrames );
+
+	/* The table cannot be changed while the tick is using it. */
+	if( xFrameSchedulerRunning != pdFALSE )
+	{
+		xReturn = pdFAIL;
+	}
+	else if( ( uxFrames == ( UBaseType_t ) 0U ) || ( uxFrames > ( UBaseType_t ) configFRAME_SCHEDULER_MAX_FRAMES ) )
+	{
+		xReturn = pdFAIL;
+		uxNumberOfTasks = ( UBaseType_t ) 0U;
+	}
+	else
+	{
+		/* Copy the table, giving each task a slot the first time it is
+		seen. */
+		uxNumberOfTasks = ( UBaseType_t ) 0U;
+	}
+
+	for( uxFrame = ( UBaseType_t ) 0U; ( xReturn == pdPASS ) && ( uxFrame < uxFrames ); uxFrame++ )
+	{
+		if( ( pxFrames[ uxFrame ].xFrameLength == ( TickType_t ) 0U ) ||
+			( pxFrames[ uxFrame ].xFrameLength > frameMAX_FRAME_LENGTH ) ||
+			( pxFrames[ uxFrame ].uxNumberOfTasks > ( UBaseType_t ) configFRAME_SCHEDULER_MAX_TASKS ) )
+		{
+			xReturn = pdFAIL;
+			break;
+		}
+
+		xFrameLengths[ uxFrame ] = pxFrames[ uxFrame ].xFrameLength;
+		uxFrameTaskCounts[ uxFrame ] = pxFrames[ uxFrame ].uxNumberOfTasks;
+
+		for( uxTask = ( UBaseType_t ) 0U; uxTask < pxFrames[ uxFrame ].uxNumberOfTasks; uxTask++ )
+		{
+			if( pxFrames[ uxFrame ].pxTasks[ uxTask ] == NULL )
+			{
+				xReturn = pdFAIL;
+				break;
+			}
+
+			uxSlot = prvGetSlot( pxFrames[ uxFrame ].pxTasks[ uxTask ] );
+
+			if( uxSlot == frameNO_SLOT )
+			{
+				if( uxNumberOfTasks == ( UBaseType_t ) configFRAME_SCHEDULER_MAX_TASKS )
+				{
+					xReturn = pdFAIL;
+					break;
+				}
+
+				uxSlot = uxNumberOfTasks;
+				xTasks[ uxSlot ] = pxFrames[ uxFrame ].pxTasks[ uxTask ];
+				uxNumberOfTasks++;
+			}
+
+			/* A task can only be released once per frame. */
+			for( x = ( UBaseType_t ) 0U; x < uxTask; x++ )
+			{
+				if( ucFrameSlots[ uxFrame ][ x ] == ( uint8_t ) uxSlot )
+				{
+					xReturn = pdFAIL;
+				}
+			}
+
+			ucFrameSlots[ uxFrame ][ uxTask ] = ( uint8_t ) uxSlot;
+		}
+	}
+
+	if( xReturn == pdPASS )
+	{
+		uxNumberOfFrames = uxFrames;
+		uxMajorCycles = uxCycles;
+
+		for( uxSlot = ( UBaseType_t ) 0U; uxSlot < uxNumberOfTasks; uxSlot++ )
+		{
+			xTaskStats[ uxSlot ].ulReleases = 0UL;
+			xTaskStats[ uxSlot ].ulCompletions = 0UL;
+			xTaskStats[ uxSlot ].ulOverruns = 0UL;
+			xTaskStats[ uxSlot ].ulSkippedReleases = 0UL;
+			xTaskStats[ uxSlot ].xMinSlack = portMAX_DELAY;
+			xTaskStats[ uxSlot ].ulTotalSlack = 0UL;
+
+			/* The tasks are only run when released. */
+			vTaskSuspend( xTasks[ uxSlot ] );
+		}
+
+		for( uxFrame = ( UBaseType_t ) 0U; uxFrame < uxNumberOfFrames; uxFrame++ )
+		{
+			xFrameStats[ uxFrame ].ulExecutions = 0UL;
+			xFrameStats[ uxFrame ].ulOverruns = 0UL;
+			xFrameStats[ uxFrame ].xMinSlack = portMAX_DELAY;
+			xFrameStats[ uxFrame ].ulTotalSlack = 0UL;
+		}
+
+		taskENTER_CRITICAL();
+		{
+			ulOutstandingJobs = 0UL;
+			ulOverrunJobs = 0UL;
+			uxCurrentFrame = ( UBaseType_t ) 0U;
+			uxCompletedCycles = ( UBaseType_t ) 0U;
+			xFrameStarted = pdFALSE;
+
+			/* The first frame starts on the next tick. */
+			xNextFrameStart = xTaskGetTickCount() + ( TickType_t ) 1;
+			xFrameSchedulerRunning = pdTRUE;
+		}
+		taskEXIT_CRITICAL();
+	}
+	else if( xFrameSchedulerRunning == pdFALSE )
+	{
+		/* Leave no part of an invalid table in use. */
+		uxNumberOfTasks = ( UBaseType_t ) 0U;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vFrameSchedulerStop( void )
+{
+	taskENTER_CRITICAL();
+	{
+		xFrameSchedulerRunning = pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerIsRunning( void )
+{
+	return xFrameSchedulerRunning;
+}
+/*-----------------------------------------------------------*/
+
+void vFrameSchedulerJobComplete( void )
+{
+TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+UBaseType_t uxSlot;
+uint32_t ulSlotBit;
+TickType_t xNow, xSlack;
+
+	taskENTER_CRITICAL();
+	{
+		uxSlot = prvGetSlot( xTask );
+
+		if( uxSlot != frameNO_SLOT )
+		{
+			ulSlotBit = 1UL << uxSlot;
+
+			if( ( ulOutstandingJobs & ulSlotBit ) != 0UL )
+			{
+				ulOutstandingJobs &= ~ulSlotBit;
+
+				if( ( ulOverrunJobs & ulSlotBit ) != 0UL )
+				{
+					/* The job was already counted as an overrun when its frame
+					ended. */
+					ulOverrunJobs &= ~ulSlotBit;
+				}
+				else
+				{
+					xNow = xTaskGetTickCount();
+					xSlack = xNextFrameStart - xNow;
+
+					xTaskStats[ uxSlot ].ulCompletions++;
+					xTaskStats[ uxSlot ].ulTotalSlack += ( uint32_t ) xSlack;
+
+					if( xSlack < xTaskStats[ uxSlot ].xMinSlack )
+					{
+						xTaskStats[ uxSlot ].xMinSlack = xSlack;
+					}
+
+					xLatestCompletion = xNow;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Suspend before leaving the critical section, otherwise the tick
+		could release the task again between its completion being recorded
+		and it suspending, and the release would be lost.  The switch away
+		from the task is held pending until the critical section is left. */
+		vTaskSuspend( NULL );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vFrameSchedulerAbortJob( TaskHandle_t xTask )
+{
+UBaseType_t uxSlot;
+uint32_t ulSlotBit;
+
+	configASSERT( xTask );
+
+	taskENTER_CRITICAL();
+	{
+		uxSlot = prvGetSlot( xTask );
+
+		if( uxSlot != frameNO_SLOT )
+		{
+			ulSlotBit = 1UL << uxSlot;
+			ulOutstandingJobs &= ~ulSlotBit;
+			ulOverrunJobs &= ~ulSlotBit;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* As for vFrameSchedulerJobComplete(), suspended within the critical
+		section so a release cannot be lost. */
+		vTaskSuspend( xTask );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerGetTaskStats( TaskHandle_t xTask, FrameTaskStats_t *pxStats )
+{
+BaseType_t xReturn = pdFAIL;
+UBaseType_t uxSlot;
+
+	configASSERT( pxStats );
+
+	taskENTER_CRITICAL();
+	{
+		uxSlot = prvGetSlot( xTask );
+
+		if( uxSlot != frameNO_SLOT )
+		{
+			*pxStats = xTaskStats[ uxSlot ];
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerGetFrameStats( UBaseType_t uxFrame, FrameStats_t *pxStats )
+{
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( pxStats );
+
+	taskENTER_CRITICAL();
+	{
+		if( uxFrame < uxNumberOfFrames )
+		{
+			*pxStats = xFrameStats[ uxFrame ];
+			xReturn = pdPASS;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xFrameSchedulerIncrementTick( TickType_t xConstTickCount )
+{
+BaseType_t xSwitchRequired = pdFALSE;
+
+	/* Nothing to do unless a frame boundary has been reached, or stepped
+	over while the tick was suppressed. */
+	if( ( xFrameSchedulerRunning != pdFALSE ) && ( ( TickType_t ) ( xConstTickCount - xNextFrameStart ) <= frameMAX_FRAME_LENGTH ) )
+	{
+		if( xFrameStarted != pdFALSE )
+		{
+			prvEndFrame();
+
+			uxCurrentFrame++;
+
+			if( uxCurrentFrame == uxNumberOfFrames )
+			{
+				uxCurrentFrame = ( UBaseType_t ) 0U;
+				uxCompletedCycles++;
+
+				if( uxCompletedCycles == uxMajorCycles )
+				{
+					xFrameSchedulerRunning = pdFALSE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			xFrameStarted = pdTRUE;
+		}
+
+		if( xFrameSchedulerRunning != pdFALSE )
+		{
+			xSwitchRequired = prvStartFrame();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xFrameSchedulerGetTicksToNextFrame( TickType_t xConstTickCount )
+{
+TickType_t xReturn;
+
+	if( xFrameSchedulerRunning != pdFALSE )
+	{
+		xReturn = xNextFrameStart - xConstTickCount;
+	}
+	else
+	{
+		xReturn = portMAX_DELAY;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvGetSlot( TaskHandle_t xTask )
+{
+UBaseType_t uxSlot;
+
+	for( uxSlot = ( UBaseType_t ) 0U; uxSlot < uxNumberOfTasks; uxSlot++ )
+	{
+		if( xTasks[ uxSlot ] == xTask )
+		{
+			break;
+		}
+	}
+
+	if( uxSlot == uxNumberOfTasks )
+	{
+		uxSlot = frameNO_SLOT;
+	}
+
+	return uxSlot;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEndFrame( void )
+{
+FrameStats_t * const pxFrameStats = &( xFrameStats[ uxCurrentFrame ] );
+uint32_t ulNewOverruns, ulSlotBit;
+UBaseType_t uxSlot;
+TickType_t xSlack;
+
+	/* A job that is outstanding and not already counted as an overrun must
+	have been released at the start of this frame. */
+	ulNewOverruns = ulOutstandingJobs & ~ulOverrunJobs;
+
+	if( ulNewOverruns != 0UL )
+	{
+		ulOverrunJobs |= ulNewOverruns;
+		xSlack = ( TickType_t ) 0U;
+
+		for( uxSlot = ( UBaseType_t ) 0U; uxSlot < uxNumberOfTasks; uxSlot++ )
+		{
+			ulSlotBit = 1UL << uxSlot;
+
+			if( ( ulNewOverruns & ulSlotBit ) != 0UL )
+			{
+				xTaskStats[ uxSlot ].ulOverruns++;
+				pxFrameStats->ulOverruns++;
+
+				#if( configUSE_FRAME_OVERRUN_HOOK == 1 )
+				{
+					vApplicationFrameOverrunHook( xTasks[ uxSlot ], uxCurrentFrame );
+				}
+				#endif
+			}
+		}
+	}
+	else
+	{
+		/* All the jobs released in the frame completed, the last of them at
+		xLatestCompletion, which is the start of the frame if it released
+		none. */
+		xSlack = xNextFrameStart - xLatestCompletion;
+	}
+
+	pxFrameStats->ulExecutions++;
+	pxFrameStats->ulTotalSlack += ( uint32_t ) xSlack;
+
+	if( xSlack < pxFrameStats->xMinSlack )
+	{
+		pxFrameStats->xMinSlack = xSlack;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartFrame( void )
+{
+BaseType_t xSwitchRequired = pdFALSE;
+UBaseType_t uxTask, uxSlot;
+uint32_t ulSlotBit;
+
+	/* Frames follow each other without drifting, even if this boundary is
+	being processed late. */
+	xLatestCompletion = xNextFrameStart;
+	xNextFrameStart += xFrameLengths[ uxCurrentFrame ];
+
+	for( uxTask = ( UBaseType_t ) 0U; uxTask < uxFrameTaskCounts[ uxCurrentFrame ]; uxTask++ )
+	{
+		uxSlot = ( UBaseType_t ) ucFrameSlots[ uxCurrentFrame ][ uxTask ];
+		ulSlotBit = 1UL << uxSlot;
+
+		if( ( ulOutstandingJobs & ulSlotBit ) == 0UL )
+		{
+			ulOutstandingJobs |= ulSlotBit;
+			xTaskStats[ uxSlot ].ulReleases++;
+
+			if( xTaskResumeFromISR( xTasks[ uxSlot ] ) != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* The task is still running an earlier job, which has overrun. */
+			xTaskStats[ uxSlot ].ulSkippedReleases++;
+		}
+	}
+
+	return xSwitchRequired;
+}
+
+#endif /* configUSE_FRAME_SCHEDULER == 1 */
+
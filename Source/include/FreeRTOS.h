@@ -274,6 +274,13 @@ extern "C" {
 	#define portSETUP_TCB( pxTCB ) ( void ) pxTCB
 #endif
 
+/* Called by vTaskSuspendAll() before the scheduler is suspended, for ports
+that need to know when a task changes the state of the kernel without entering
+a critical section. */
+#ifndef portTASK_SUSPEND_ALL_HOOK
+	#define portTASK_SUSPEND_ALL_HOOK()
+#endif
+
 #ifndef configQUEUE_REGISTRY_SIZE
 	#define configQUEUE_REGISTRY_SIZE 0U
 #endif
@@ -520,6 +527,14 @@ extern "C" {
 	#define traceTASK_RESUME_FROM_ISR( pxTaskToResume )
 #endif
 
+#ifndef traceTASK_BUDGET_EXHAUSTED
+	#define traceTASK_BUDGET_EXHAUSTED( pxTCB )
+#endif
+
+#ifndef traceTASK_BUDGET_REPLENISHED
+	#define traceTASK_BUDGET_REPLENISHED( pxTCB )
+#endif
+
 #ifndef traceTASK_INCREMENT_TICK
 	#define traceTASK_INCREMENT_TICK( xTickCount )
 #endif
@@ -726,12 +741,18 @@ extern "C" {
 	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )
 #endif
 
+/* A port whose portSUPPRESS_TICKS_AND_SLEEP() is worth calling for a single
+idle tick can lower the minimum. */
+#ifndef portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP
+	#define portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+#endif
+
 #ifndef configEXPECTED_IDLE_TIME_BEFORE_SLEEP
-	#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+	#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP
 #endif
 
-#if configEXPECTED_IDLE_TIME_BEFORE_SLEEP < 2
-	#error configEXPECTED_IDLE_TIME_BEFORE_SLEEP must not be less than 2
+#if configEXPECTED_IDLE_TIME_BEFORE_SLEEP < portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP
+	#error configEXPECTED_IDLE_TIME_BEFORE_SLEEP must not be less than portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP, which is 2 unless the port defines it
 #endif
 
 #ifndef configUSE_TICKLESS_IDLE
@@ -837,6 +858,108 @@ extern "C" {
 	#define configMESSAGE_BUFFER_LENGTH_TYPE size_t
 #endif
 
+#ifndef configNUMBER_OF_CORES
+	/* Defaults to 1, a single core, for backward compatibility. */
+	#define configNUMBER_OF_CORES 1
+#endif
+
+#ifndef configUSE_CORE_AFFINITY
+	#define configUSE_CORE_AFFINITY 0
+#endif
+
+#ifndef configUSE_TIMING_WHEEL
+	/* Defaults to 0, the sorted delayed task lists, for backward
+	compatibility. */
+	#define configUSE_TIMING_WHEEL 0
+#endif
+
+#ifndef configUSE_EDF_SCHEDULING
+	/* Defaults to 0, fixed priority scheduling alone, for backward
+	compatibility. */
+	#define configUSE_EDF_SCHEDULING 0
+#endif
+
+#ifndef configUSE_TASK_BUDGETS
+	#define configUSE_TASK_BUDGETS 0
+#endif
+
+#ifndef configUSE_TASK_POOL
+	#define configUSE_TASK_POOL 0
+#endif
+
+#ifndef configTASK_POOL_SIZE_CLASSES
+	#define configTASK_POOL_SIZE_CLASSES 4
+#endif
+
+#ifndef configTASK_POOL_TASKS_PER_SIZE_CLASS
+	#define configTASK_POOL_TASKS_PER_SIZE_CLASS 4
+#endif
+
+#ifndef configUSE_FRAME_SCHEDULER
+	#define configUSE_FRAME_SCHEDULER 0
+#endif
+
+#ifndef configGENERATE_EXECUTION_STATS
+	#define configGENERATE_EXECUTION_STATS 0
+#endif
+
+#ifndef configUSE_PERIODIC_TASKS
+	#define configUSE_PERIODIC_TASKS 0
+#endif
+
+#ifndef configPERIODIC_TASK_LATENCY_BUCKETS
+	#define configPERIODIC_TASK_LATENCY_BUCKETS 16
+#endif
+
+#ifndef configPRIORITY_INHERITANCE_CHAIN_DEPTH
+	/* 1 to only raise the priority of the holder of the mutex a task blocks
+	on, as the kernel always has. */
+	#define configPRIORITY_INHERITANCE_CHAIN_DEPTH 1
+#endif
+
+#ifndef configUSE_PRIORITY_CEILING_MUTEXES
+	#define configUSE_PRIORITY_CEILING_MUTEXES 0
+#endif
+
+#ifndef configUSE_QUEUE_LOANS
+	#define configUSE_QUEUE_LOANS 0
+#endif
+
+#ifndef configUSE_QUEUE_BATCHES
+	#define configUSE_QUEUE_BATCHES 0
+#endif
+
+#ifndef configUSE_STACK_PROFILER
+	#define configUSE_STACK_PROFILER 0
+#endif
+
+#ifndef configSTACK_PROFILER_SAMPLE_PERIOD
+	#define configSTACK_PROFILER_SAMPLE_PERIOD 1
+#endif
+
+#ifndef configSTACK_PROFILER_MARGIN_PERCENT
+	#define configSTACK_PROFILER_MARGIN_PERCENT 25
+#endif
+
+#ifndef portMEMORY_BARRIER
+	/* Only needed where the execution statistics of a task can be read by a
+	core, or host thread, other than the one updating them, and by SMP
+	builds. */
+	#define portMEMORY_BARRIER()
+#endif
+
+#ifndef configFRAME_SCHEDULER_MAX_FRAMES
+	#define configFRAME_SCHEDULER_MAX_FRAMES 16
+#endif
+
+#ifndef configFRAME_SCHEDULER_MAX_TASKS
+	#define configFRAME_SCHEDULER_MAX_TASKS 8
+#endif
+
+#ifndef configUSE_FRAME_OVERRUN_HOOK
+	#define configUSE_FRAME_OVERRUN_HOOK 0
+#endif
+
 /* Sanity check the configuration. */
 #if( configUSE_TICKLESS_IDLE != 0 )
 	#if( INCLUDE_vTaskSuspend != 1 )
@@ -844,14 +967,93 @@ extern "C" {
 	#endif /* INCLUDE_vTaskSuspend */
 #endif /* configUSE_TICKLESS_IDLE */
 
+#if( ( configUSE_EDF_SCHEDULING == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+	#error configUSE_EDF_SCHEDULING cannot be used when configNUMBER_OF_CORES is greater than 1, as the cores select the task to run by priority alone.
+#endif
+
+#if( configUSE_FRAME_SCHEDULER == 1 )
+	#if( ( INCLUDE_vTaskSuspend != 1 ) || ( INCLUDE_xTaskResumeFromISR != 1 ) || ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) )
+		#error INCLUDE_vTaskSuspend, INCLUDE_xTaskResumeFromISR and INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 if configUSE_FRAME_SCHEDULER is set to 1
+	#endif
+
+	#if( ( configFRAME_SCHEDULER_MAX_TASKS < 1 ) || ( configFRAME_SCHEDULER_MAX_TASKS > 32 ) )
+		#error configFRAME_SCHEDULER_MAX_TASKS must be between 1 and 32, as the jobs of the tasks are tracked in a 32 bit mask.
+	#endif
+#endif /* configUSE_FRAME_SCHEDULER */
+
+#if( configUSE_TASK_POOL == 1 )
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) || ( INCLUDE_vTaskDelete != 1 ) )
+		#error configSUPPORT_DYNAMIC_ALLOCATION and INCLUDE_vTaskDelete must be set to 1 if configUSE_TASK_POOL is set to 1
+	#endif
+
+	#if( configTASK_POOL_SIZE_CLASSES < 1 )
+		#error configTASK_POOL_SIZE_CLASSES must be at least 1 if configUSE_TASK_POOL is set to 1
+	#endif
+#endif /* configUSE_TASK_POOL */
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+	#if( configSUPPORT_DYNAMIC_ALLOCATION != 1 )
+		#error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 if configUSE_PERIODIC_TASKS is set to 1
+	#endif
+
+	#ifndef portGET_RUN_TIME_NS
+		#error If configUSE_PERIODIC_TASKS is set to 1 then portGET_RUN_TIME_NS() must be defined to return the time of a free running 64-bit clock in nanoseconds, from which the release latency of the tasks is measured.
+	#endif
+
+	#if( ( configPERIODIC_TASK_LATENCY_BUCKETS < 1 ) || ( configPERIODIC_TASK_LATENCY_BUCKETS > 32 ) )
+		#error configPERIODIC_TASK_LATENCY_BUCKETS must be between 1 and 32
+	#endif
+#endif /* configUSE_PERIODIC_TASKS */
+
+#if( configGENERATE_EXECUTION_STATS == 1 )
+	#ifndef portGET_RUN_TIME_NS
+		#error If configGENERATE_EXECUTION_STATS is set to 1 then portGET_RUN_TIME_NS() must be defined to return the time of a free running 64-bit clock in nanoseconds.
+	#endif
+#endif /* configGENERATE_EXECUTION_STATS */
+
 #if( ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 0 ) )
 	#error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
 #endif
 
+#if( configPRIORITY_INHERITANCE_CHAIN_DEPTH < 1 )
+	#error configPRIORITY_INHERITANCE_CHAIN_DEPTH must be at least 1
+#endif
+
 #if( ( configUSE_RECURSIVE_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
 	#error configUSE_MUTEXES must be set to 1 to use recursive mutexes
 #endif
 
+#if( ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) && ( configUSE_MUTEXES != 1 ) )
+	#error configUSE_MUTEXES must be set to 1 to use priority ceiling mutexes
+#endif
+
+#if( configNUMBER_OF_CORES > 1 )
+	/* A port that supports more than one core must provide the following. */
+	#if !defined( portGET_CORE_ID ) || !defined( portYIELD_CORE ) || !defined( portSET_INTERRUPT_MASK ) || !defined( portCLEAR_INTERRUPT_MASK )
+		#error The port does not support configNUMBER_OF_CORES being greater than 1 - portGET_CORE_ID(), portYIELD_CORE(), portSET_INTERRUPT_MASK() and portCLEAR_INTERRUPT_MASK() must be defined.
+	#endif
+
+	#if !defined( portGET_TASK_LOCK ) || !defined( portRELEASE_TASK_LOCK ) || !defined( portGET_ISR_LOCK ) || !defined( portRELEASE_ISR_LOCK )
+		#error The port does not support configNUMBER_OF_CORES being greater than 1 - portGET_TASK_LOCK(), portRELEASE_TASK_LOCK(), portGET_ISR_LOCK() and portRELEASE_ISR_LOCK() must be defined.
+	#endif
+
+	#if( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION must be 0 when configNUMBER_OF_CORES is greater than 1, as each core searches the ready lists for a task it can run.
+	#endif
+
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+		#error configSUPPORT_DYNAMIC_ALLOCATION must be 1 when configNUMBER_OF_CORES is greater than 1, as the idle tasks of the cores other than core 0 are created dynamically.
+	#endif
+
+	#if( ( configUSE_NEWLIB_REENTRANT == 1 ) || ( configUSE_POSIX_ERRNO == 1 ) )
+		#error configUSE_NEWLIB_REENTRANT and configUSE_POSIX_ERRNO cannot be used when configNUMBER_OF_CORES is greater than 1, as the tasks running on the cores at the same time would share one errno.
+	#endif
+
+	#if( portCRITICAL_NESTING_IN_TCB == 1 )
+		#error portCRITICAL_NESTING_IN_TCB cannot be used when configNUMBER_OF_CORES is greater than 1.
+	#endif
+#endif /* configNUMBER_OF_CORES */
+
 #ifndef configINITIAL_TICK_COUNT
 	#define configINITIAL_TICK_COUNT 0
 #endif
@@ -1044,6 +1246,39 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int				iDummy22;
 	#endif
+	#if ( configNUMBER_OF_CORES > 1 )
+		BaseType_t		xDummy23;
+		UBaseType_t		uxDummy24;
+	#endif
+	#if ( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xDummy25[ 2 ];
+	#endif
+	#if ( configUSE_TASK_BUDGETS == 1 )
+		TickType_t		xDummy26[ 4 ];
+		uint32_t		ulDummy27;
+	#endif
+	#if ( configUSE_TASK_POOL == 1 )
+		configSTACK_DEPTH_TYPE	usDummy28;
+	#endif
+	#if ( configGENERATE_EXECUTION_STATS == 1 )
+		uint32_t		ulDummy29;
+		uint64_t		ullDummy30[ 2 ];
+		uint32_t		ulDummy31[ 3 ];
+		BaseType_t		xDummy32;
+	#endif
+	#if ( configUSE_PERIODIC_TASKS == 1 )
+		TickType_t		xDummy33[ 3 ];
+		uint64_t		ullDummy34;
+		uint32_t		ulDummy35[ 3 + configPERIODIC_TASK_LATENCY_BUCKETS ];
+		uint8_t			ucDummy36;
+	#endif
+	#if ( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+		void			*pvDummy37;
+	#endif
+	#if ( configUSE_STACK_PROFILER == 1 )
+		StaticListItem_t	xDummy38;
+		uint32_t		ulDummy39[ 2 ];
+	#endif
 } StaticTask_t;
 
 /*
@@ -1070,6 +1305,10 @@ typedef struct xSTATIC_QUEUE
 		UBaseType_t uxDummy2;
 	} u;
 
+	#if ( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+		UBaseType_t uxDummy10[ 2 ];
+	#endif
+
 	StaticList_t xDummy3[ 2 ];
 	UBaseType_t uxDummy4[ 3 ];
 	uint8_t ucDummy5[ 2 ];
@@ -1087,6 +1326,10 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_LOANS == 1 )
+		void *pvDummy11[ 2 ];
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
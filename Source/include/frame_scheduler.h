@@ -0,0 +1,231 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h" must appear in source files before "include frame_scheduler.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The frame scheduler is a cyclic executive built into the tick.  The
+ * application describes a major cycle as a table of frames, each frame having
+ * a length in ticks and a list of the tasks to release at its start.  The
+ * tasks of the table are kept in the Suspended state by the frame scheduler,
+ * and released - resumed - by the tick interrupt at the start of each frame
+ * in which they appear, so no task is needed to drive the table and the
+ * releases are not delayed by one.
+ *
+ * A released task runs one job, then calls vFrameSchedulerJobComplete() to be
+ * suspended again until its next release.  A job that has not completed by
+ * the end of the frame in which it was released has overrun.  The overrun is
+ * detected, and counted, by the tick at the frame boundary, which also calls
+ * vApplicationFrameOverrunHook() if configUSE_FRAME_OVERRUN_HOOK is 1.  The
+ * overrunning task is left to run - it is up to the application to stop it,
+ * with vFrameSchedulerAbortJob() - and is not released again until its job
+ * is complete.
+ *
+ * The frame scheduler keeps, for each task, the number of jobs released,
+ * completed and overrun, and the slack - the time left in the frame when a
+ * job completed.  For each frame it keeps the number of times it was
+ * executed, the jobs that overran, and the time left once the last of its
+ * jobs completed.
+ *
+ * configUSE_FRAME_SCHEDULER must be set to 1 in FreeRTOSConfig.h for the
+ * frame scheduler to be available.  The table can hold up to
+ * configFRAME_SCHEDULER_MAX_FRAMES frames and configFRAME_SCHEDULER_MAX_TASKS
+ * different tasks.
+ */
+
+/*
+ * One frame of the table passed to xFrameSchedulerStart().
+ */
+typedef struct xFRAME_DEFINITION
+{
+	TickType_t xFrameLength;			/* The length of the frame in ticks, which must not be 0. */
+	const TaskHandle_t *pxTasks;		/* The tasks released at the start of the frame, in the order they are released. */
+	UBaseType_t uxNumberOfTasks;		/* The number of handles in pxTasks, which can be 0 for a frame that releases no tasks. */
+} FrameDefinition_t;
+
+/*
+ * The statistics kept for each task of the table.
+ */
+typedef struct xFRAME_TASK_STATS
+{
+	uint32_t ulReleases;				/* Jobs released. */
+	uint32_t ulCompletions;				/* Jobs completed within the frame in which they were released. */
+	uint32_t ulOverruns;				/* Jobs that were still running at the end of the frame in which they were released. */
+	uint32_t ulSkippedReleases;			/* Releases not made because the previous job was still running. */
+	TickType_t xMinSlack;				/* The least time left in its frame when a job completed, portMAX_DELAY if no job has completed. */
+	uint32_t ulTotalSlack;				/* The time left in their frames summed over all completed jobs, so the mean slack is ulTotalSlack / ulCompletions. */
+} FrameTaskStats_t;
+
+/*
+ * The statistics kept for each frame of the table.
+ */
+typedef struct xFRAME_STATS
+{
+	uint32_t ulExecutions;				/* The number of times the frame has ended. */
+	uint32_t ulOverruns;				/* Jobs released in the frame that overran it. */
+	TickType_t xMinSlack;				/* The least time left in the frame once all its jobs completed, 0 if one has overrun, portMAX_DELAY if the frame has not ended. */
+	uint32_t ulTotalSlack;				/* The time left summed over all executions, so the mean slack is ulTotalSlack / ulExecutions. */
+} FrameStats_t;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ BaseType_t xFrameSchedulerStart( const FrameDefinition_t *pxFrames, UBaseType_t uxNumberOfFrames, UBaseType_t uxMajorCycles );
+ </pre>
+ *
+ * Start releasing tasks from a table of frames.  The table is copied, so
+ * does not need to persist.  Every task that appears in the table is
+ * suspended, the statistics are reset, and the first frame starts on the
+ * next tick.
+ *
+ * Can be called before the scheduler is started, or from a task.  The tasks
+ * in the table must not be deleted while the frame scheduler is running.
+ *
+ * @param pxFrames The table of frames that form a major cycle.
+ *
+ * @param uxNumberOfFrames The number of frames in pxFrames, which must be
+ * between 1 and configFRAME_SCHEDULER_MAX_FRAMES.
+ *
+ * @param uxMajorCycles The number of times the table is executed before the
+ * frame scheduler stops of its own accord, or 0 to execute it until
+ * vFrameSchedulerStop() is called.
+ *
+ * @return pdPASS if the frame scheduler was started.  pdFAIL if it is already
+ * running, or the table has too many frames or tasks, a frame of length 0, or
+ * a NULL task handle.
+ */
+BaseType_t xFrameSchedulerStart( const FrameDefinition_t *pxFrames, UBaseType_t uxNumberOfFrames, UBaseType_t uxMajorCycles ) PRIVILEGED_FUNCTION;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ void vFrameSchedulerStop( void );
+ </pre>
+ *
+ * Stop releasing tasks.  Jobs that are running are left to complete, and the
+ * statistics are kept until the frame scheduler is started again.  Must be
+ * called from a task.
+ */
+void vFrameSchedulerStop( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ BaseType_t xFrameSchedulerIsRunning( void );
+ </pre>
+ *
+ * @return pdTRUE if the frame scheduler is releasing tasks, otherwise pdFALSE.
+ * The frame scheduler stops of its own accord at the end of the last major
+ * cycle requested when it was started.
+ */
+BaseType_t xFrameSchedulerIsRunning( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ void vFrameSchedulerJobComplete( void );
+ </pre>
+ *
+ * Called by a task of the table when it has completed its job.  The
+ * completion is recorded and the calling task suspended until its next
+ * release.  A task must use this function, rather than vTaskSuspend( NULL ),
+ * so it cannot miss a release made between recording its completion and
+ * suspending.
+ */
+void vFrameSchedulerJobComplete( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ void vFrameSchedulerAbortJob( TaskHandle_t xTask );
+ </pre>
+ *
+ * Suspend a task of the table whose job has overrun, so it is released
+ * again in its next frame.  As with vTaskSuspend(), the task continues from
+ * where it was suspended when it is next released.  Must be called from a
+ * task - to abort a job from vApplicationFrameOverrunHook() defer the call
+ * to the timer task with xTimerPendFunctionCallFromISR().
+ *
+ * @param xTask The task whose job is to be aborted.
+ */
+void vFrameSchedulerAbortJob( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * frame_scheduler.h
+ * <pre>
+ BaseType_t xFrameSchedulerGetTaskStats( TaskHandle_t xTask, FrameTaskStats_t *pxStats );
+ BaseType_t xFrameSchedulerGetFrameStats( UBaseType_t uxFrame, FrameStats_t *pxStats );
+ </pre>
+ *
+ * Obtain a copy of the statistics of a task of the table, or of a frame,
+ * where frames are numbered from 0 in the order they appear in the table.
+ *
+ * @return pdPASS if the statistics were copied, or pdFAIL if xTask is not in
+ * the table or uxFrame is not a frame of the table.
+ */
+BaseType_t xFrameSchedulerGetTaskStats( TaskHandle_t xTask, FrameTaskStats_t *pxStats ) PRIVILEGED_FUNCTION;
+BaseType_t xFrameSchedulerGetFrameStats( UBaseType_t uxFrame, FrameStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/*
+ * Functions beyond this part are not part of the public API and are intended
+ * for use by the kernel only.
+ */
+
+/*
+ * Called from xTaskIncrementTick() with the new tick count.  Ends the current
+ * frame and releases the tasks of the next when a frame boundary is reached.
+ * Returns pdTRUE if a task was released that should preempt the running
+ * task.
+ */
+BaseType_t xFrameSchedulerIncrementTick( TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the number of ticks until the next frame boundary, or portMAX_DELAY
+ * if the frame scheduler is not running, so the tick is not suppressed past a
+ * release.
+ */
+TickType_t xFrameSchedulerGetTicksToNextFrame( TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRAME_SCHEDULER_H */
+
+
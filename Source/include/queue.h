@@ -73,6 +73,7 @@ typedef struct QueueDefinition * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_COUNTING_SEMAPHORE	( ( uint8_t ) 2U )
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE	( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX		( ( uint8_t ) 4U )
+#define queueQUEUE_TYPE_CEILING_MUTEX		( ( uint8_t ) 5U )
 
 /**
  * queue. h
@@ -867,6 +868,245 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue, void * const pvBuffer ) PRIV
  */
 BaseType_t xQueueReceive( QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueLoanSendSlot(
+								 QueueHandle_t xQueue,
+								 void **ppvSlot,
+								 TickType_t xTicksToWait
+							);
+ BaseType_t xQueueCommitSend( QueueHandle_t xQueue );</pre>
+ *
+ * configUSE_QUEUE_LOANS must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * Send an item to the back of a queue without copying it.
+ * xQueueLoanSendSlot() obtains the space at the back of the queue the item is
+ * to occupy, into which the caller writes the item in place, then
+ * xQueueCommitSend() posts the item as if it had been sent with
+ * xQueueSendToBack().  The queue copies nothing, so sending a large item
+ * costs the same as sending a small one.
+ *
+ * xQueueLoanSendSlot() blocks while the queue is full exactly as
+ * xQueueSendToBack() does.  Once it has returned the slot is held by the
+ * caller until xQueueCommitSend() is called, and until then the queue is
+ * treated as full by everything else that sends to it - other tasks that
+ * send to the queue, including by loan, block as if it were full, and
+ * xQueueSendFromISR() fails - as the slot is the one they would write to.
+ * The slot should therefore only be held for as long as it takes to write
+ * the item.
+ *
+ * xQueueCommitSend() unblocks the highest priority task waiting to receive
+ * from the queue, or notifies the queue set the queue is a member of, as
+ * xQueueSendToBack() would, and never blocks.
+ *
+ * These functions must not be used in an interrupt service routine, and
+ * cannot be used with a semaphore or mutex as those do not hold items.
+ *
+ * @param xQueue The handle of the queue to which the item is to be sent.
+ *
+ * @param ppvSlot Set to point to the slot, of the item size defined when the
+ * queue was created, into which the item is to be written.  The slot is only
+ * valid until xQueueCommitSend() is called.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it be full.
+ *
+ * @return xQueueLoanSendSlot() returns pdPASS if a slot was obtained,
+ * otherwise errQUEUE_FULL.  xQueueCommitSend() always returns pdPASS, and
+ * must only be called after a successful call to xQueueLoanSendSlot().
+ *
+ * Example usage:
+   <pre>
+ void vSensorTask( void *pvParameters )
+ {
+ SensorFrame_t *pxFrame;
+
+	for( ;; )
+	{
+		if( xQueueLoanSendSlot( xFrameQueue, ( void ** ) &pxFrame, portMAX_DELAY ) == pdPASS )
+		{
+			// Fill the frame directly in the queue's storage.
+			vReadSensorFrame( pxFrame );
+			xQueueCommitSend( xFrameQueue );
+		}
+	}
+ }
+ </pre>
+ * \defgroup xQueueLoanSendSlot xQueueLoanSendSlot
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueLoanSendSlot( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueCommitSend( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueLoanReceiveSlot(
+								 QueueHandle_t xQueue,
+								 void **ppvSlot,
+								 TickType_t xTicksToWait
+							);
+ BaseType_t xQueueReleaseReceive( QueueHandle_t xQueue );</pre>
+ *
+ * configUSE_QUEUE_LOANS must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * Receive an item from a queue without copying it.
+ * xQueueLoanReceiveSlot() obtains the item at the front of the queue, which
+ * the caller reads in place, then xQueueReleaseReceive() removes the item
+ * from the queue as if it had been received with xQueueReceive().
+ *
+ * xQueueLoanReceiveSlot() blocks while the queue is empty exactly as
+ * xQueueReceive() does.  Once it has returned the item is held by the
+ * caller until xQueueReleaseReceive() is called, and until then the queue is
+ * treated as empty by everything else that receives from it - other tasks
+ * that receive from the queue, including by loan, block as if it were empty,
+ * and xQueueReceiveFromISR() fails.  Items can still be sent to the back of
+ * the queue, but an item sent to the front of the queue, or to overwrite the
+ * item held, is treated as if the queue were full until the item is
+ * released.  The item is still in the queue while it is held, so is what
+ * xQueuePeek() returns.
+ *
+ * xQueueReleaseReceive() unblocks the highest priority task waiting to send
+ * to the queue, as xQueueReceive() would, and never blocks.
+ *
+ * These functions must not be used in an interrupt service routine, and
+ * cannot be used with a semaphore or mutex as those do not hold items.
+ *
+ * @param xQueue The handle of the queue from which the item is to be
+ * received.
+ *
+ * @param ppvSlot Set to point to the item, which is only valid until
+ * xQueueReleaseReceive() is called.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty.
+ *
+ * @return xQueueLoanReceiveSlot() returns pdPASS if an item was obtained,
+ * otherwise errQUEUE_EMPTY.  xQueueReleaseReceive() always returns pdPASS,
+ * and must only be called after a successful call to
+ * xQueueLoanReceiveSlot().
+ *
+ * \defgroup xQueueLoanReceiveSlot xQueueLoanReceiveSlot
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueLoanReceiveSlot( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueReleaseReceive( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueSendMultiple(
+								 QueueHandle_t xQueue,
+								 const void *pvItems,
+								 UBaseType_t uxNumberOfItems,
+								 TickType_t xTicksToWait
+							);</pre>
+ *
+ * configUSE_QUEUE_BATCHES must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Send up to uxNumberOfItems items, held one after the other in pvItems, to
+ * the back of a queue.  As many of the items as there is room for are copied
+ * in a single critical section, with at most two calls to memcpy(), and the
+ * tasks waiting to receive from the queue are unblocked - one for each item
+ * sent - with at most one yield for the batch, so sending n items costs far
+ * less than n calls to xQueueSendToBack().
+ *
+ * The function blocks while the queue is full exactly as xQueueSendToBack()
+ * does, and returns as soon as it has sent at least one item, so may send
+ * fewer items than requested.  The caller sends the rest by calling the
+ * function again with the items that were not sent.  If the queue is a member
+ * of a queue set the set receives the queue's handle once for each item.
+ *
+ * This function must not be used in an interrupt service routine, and cannot
+ * be used with a semaphore or mutex as those do not hold items.
+ *
+ * @param xQueue The handle of the queue to which the items are to be sent.
+ *
+ * @param pvItems A pointer to the items, which must be uxNumberOfItems times
+ * the item size defined when the queue was created bytes long.
+ *
+ * @param uxNumberOfItems The number of items in pvItems.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it be full.
+ *
+ * @return The number of items sent, which is between 1 and uxNumberOfItems,
+ * or errQUEUE_FULL (0) if no items were sent.
+ *
+ * Example usage:
+   <pre>
+ void vProducerTask( void *pvParameters )
+ {
+ Sample_t xSamples[ 32 ];
+ UBaseType_t uxCount, uxSent;
+ BaseType_t xResult;
+
+	for( ;; )
+	{
+		uxCount = uxReadSamples( xSamples, 32 );
+
+		for( uxSent = 0; uxSent < uxCount; uxSent += ( UBaseType_t ) xResult )
+		{
+			xResult = xQueueSendMultiple( xSampleQueue, &( xSamples[ uxSent ] ), uxCount - uxSent, portMAX_DELAY );
+		}
+	}
+ }
+ </pre>
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxNumberOfItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ BaseType_t xQueueReceiveMultiple(
+								 QueueHandle_t xQueue,
+								 void *pvBuffer,
+								 UBaseType_t uxMaxItems,
+								 TickType_t xTicksToWait
+							);</pre>
+ *
+ * configUSE_QUEUE_BATCHES must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Receive up to uxMaxItems items from the front of a queue into pvBuffer, in
+ * the order xQueueReceive() would have received them.  As many items as the
+ * queue holds, up to uxMaxItems, are copied in a single critical section,
+ * with at most two calls to memcpy(), and the tasks waiting to send to the
+ * queue are unblocked - one for each item received - with at most one yield
+ * for the batch.
+ *
+ * The function blocks while the queue is empty exactly as xQueueReceive()
+ * does, and returns as soon as it has received at least one item.
+ *
+ * This function must not be used in an interrupt service routine, and cannot
+ * be used with a semaphore or mutex as those do not hold items.
+ *
+ * @param xQueue The handle of the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the items are copied,
+ * which must be uxMaxItems times the item size defined when the queue was
+ * created bytes long.
+ *
+ * @param uxMaxItems The most items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty.
+ *
+ * @return The number of items received, which is between 1 and uxMaxItems,
+ * or errQUEUE_EMPTY (0) if no items were received.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * <pre>UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue );</pre>
@@ -1419,6 +1659,14 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
 TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Use xSemaphoreCreateMutexWithCeiling() or
+ * xSemaphoreCreateMutexWithCeilingStatic() instead of calling these functions
+ * directly.
+ */
+QueueHandle_t xQueueCreateCeilingMutex( const UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateCeilingMutexStatic( const UBaseType_t uxCeilingPriority, StaticQueue_t *pxStaticQueue ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Use xSemaphoreTakeMutexRecursive() or
  * xSemaphoreGiveMutexRecursive() instead of calling these functions directly.
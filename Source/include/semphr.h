@@ -777,6 +777,97 @@ typedef QueueHandle_t SemaphoreHandle_t;
 	#define xSemaphoreCreateMutexStatic( pxMutexBuffer ) xQueueCreateMutexStatic( queueQUEUE_TYPE_MUTEX, ( pxMutexBuffer ) )
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateMutexWithCeiling( UBaseType_t uxCeilingPriority )</pre>
+ *
+ * Creates a new mutex type semaphore instance that uses the priority ceiling
+ * protocol in place of priority inheritance, and returns a handle by which the
+ * new mutex can be referenced.
+ *
+ * The task that takes the mutex is raised to uxCeilingPriority at once, and
+ * returned to its previous priority when it gives the mutex back.  The ceiling
+ * must be at least the priority of the highest priority task that takes the
+ * mutex.  No other task that takes the mutex can then run while it is held,
+ * so a task is blocked by at most one critical section of a lower priority
+ * task, however many mutexes it takes, and tasks cannot deadlock over mutexes
+ * that all have a ceiling.  As taking the mutex never has to wait for a lower
+ * priority task there is also no priority inheritance to do.  The mutex can
+ * only be found held by a task that has blocked while holding it, and then the
+ * holder does not inherit the priority of the task waiting for it.
+ *
+ * Raising the priority of the task that takes the mutex moves it between
+ * ready lists, which priority inheritance only does when the mutex is
+ * contended, so an uncontended take and give costs slightly more.
+ *
+ * Mutexes created using this function can be accessed using the
+ * xSemaphoreTake() and xSemaphoreGive() macros.  The xSemaphoreTakeRecursive()
+ * and xSemaphoreGiveRecursive() macros must not be used.  Mutexes that are
+ * held at the same time should be given back in the reverse order to which
+ * they were taken.
+ *
+ * configUSE_PRIORITY_CEILING_MUTEXES must be set to 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * @param uxCeilingPriority The priority the task holding the mutex runs at,
+ * which must be less than configMAX_PRIORITIES.  A task whose priority is
+ * above the ceiling must not take the mutex.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * semaphore is returned.  If there was not enough heap to allocate the mutex
+ * data structures then NULL is returned.
+ *
+ * Example usage:
+ <pre>
+ SemaphoreHandle_t xSemaphore;
+
+ void vATask( void * pvParameters )
+ {
+    // vATask and the other tasks that use the resource all have a priority
+    // of 3 or lower.
+    xSemaphore = xSemaphoreCreateMutexWithCeiling( 3 );
+
+    if( xSemaphore != NULL )
+    {
+        if( xSemaphoreTake( xSemaphore, portMAX_DELAY ) == pdTRUE )
+        {
+            // Access the resource, at priority 3.
+
+            xSemaphoreGive( xSemaphore );
+        }
+    }
+ }
+ </pre>
+ * \defgroup xSemaphoreCreateMutexWithCeiling xSemaphoreCreateMutexWithCeiling
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) )
+	#define xSemaphoreCreateMutexWithCeiling( uxCeilingPriority ) xQueueCreateCeilingMutex( ( uxCeilingPriority ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateMutexWithCeilingStatic( UBaseType_t uxCeilingPriority, StaticSemaphore_t *pxMutexBuffer )</pre>
+ *
+ * Creates a priority ceiling mutex, as xSemaphoreCreateMutexWithCeiling(), in
+ * memory provided by the application writer so no dynamic memory allocation
+ * is attempted.
+ *
+ * @param uxCeilingPriority The priority the task holding the mutex runs at.
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticSemaphore_t,
+ * which will be used to hold the mutex's data structure.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * mutex is returned.  If pxMutexBuffer was NULL then NULL is returned.
+ *
+ * \defgroup xSemaphoreCreateMutexWithCeilingStatic xSemaphoreCreateMutexWithCeilingStatic
+ * \ingroup Semaphores
+ */
+#if( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) )
+	#define xSemaphoreCreateMutexWithCeilingStatic( uxCeilingPriority, pxMutexBuffer ) xQueueCreateCeilingMutexStatic( ( uxCeilingPriority ), ( pxMutexBuffer ) )
+#endif
+
 
 /**
  * semphr. h
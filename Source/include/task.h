@@ -139,6 +139,50 @@ typedef struct xTASK_STATUS
 	configSTACK_DEPTH_TYPE usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* Used with the vTaskGetTaskPoolStats() function to return the statistics of the
+pool of TCBs and stacks kept for reuse. */
+typedef struct xTASK_POOL_STATS
+{
+	uint32_t ulHits;				/* The number of tasks created with the TCB and stack of a deleted task taken from the pool. */
+	uint32_t ulMisses;				/* The number of tasks created with a TCB and stack allocated from the heap, as the pool held none of the same stack depth. */
+	uint32_t ulRecycled;			/* The number of deleted tasks whose TCB and stack were added to the pool. */
+	uint32_t ulOverflows;			/* The number of deleted tasks whose TCB and stack were freed as the pool had no room for them. */
+	UBaseType_t uxPooledTasks;		/* The number of TCBs, each with its stack, held in the pool when the structure was populated. */
+} TaskPoolStats_t;
+
+/* Used with the vTaskGetExecutionStats() function to return the execution
+statistics of a task. */
+typedef struct xTASK_EXECUTION_STATS
+{
+	uint64_t ullRunTimeNs;			/* The time the task has spent in the Running state, in nanoseconds, including the time it has been running for if it is running when the structure is populated. */
+	uint64_t ullSnapshotTimeNs;		/* The time, from portGET_RUN_TIME_NS(), at which the structure was populated, so two snapshots give the share of the time between them the task was running. */
+	uint32_t ulContextSwitches;		/* The number of times the task has been switched in. */
+	uint32_t ulPreemptions;			/* The number of times the task was switched out while still able to run - preempted, time sliced, yielding or throttled. */
+	uint32_t ulVoluntaryBlocks;		/* The number of times the task was switched out having left the Ready state - blocked, delayed, suspended or deleted. */
+	BaseType_t xRunning;			/* pdTRUE if the task was in the Running state when the structure was populated, otherwise pdFALSE. */
+} TaskExecutionStats_t;
+
+/* Used with the xTaskGetPeriodicStats() function to return the statistics of a
+task created with xTaskCreatePeriodic(). */
+typedef struct xPERIODIC_TASK_STATS
+{
+	uint32_t ulReleases;			/* The number of jobs that have started. */
+	uint32_t ulDeadlineMisses;		/* The number of jobs that completed after their deadline. */
+	uint32_t ulMaxLatencyNs;		/* The longest time from the release of a job to it starting, in nanoseconds. */
+	uint32_t ulLatencyBuckets[ configPERIODIC_TASK_LATENCY_BUCKETS ];	/* ulLatencyBuckets[ 0 ] counts the jobs that started less than 1us after their release, and ulLatencyBuckets[ n ] those that started at least 2^(n-1)us, but less than 2^n us, after.  The last bucket also counts all the longer latencies. */
+} PeriodicTaskStats_t;
+
+/* Used with the uxTaskGetStackProfile() function to return the peak stack use
+of each task. */
+typedef struct xTASK_STACK_PROFILE
+{
+	TaskHandle_t xHandle;				/* The handle of the task to which the rest of the information in the structure relates. */
+	const char *pcTaskName;				/* A pointer to the task's name.  This value will be invalid if the task was deleted since the structure was populated! */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	uint32_t ulStackDepth;				/* The size of the stack the task was created with, in words. */
+	uint32_t ulPeakStackUse;			/* The most words of the stack the task has been found to use.  Equal to ulStackDepth if the stack may have overflowed. */
+	uint32_t ulRecommendedStackDepth;	/* ulPeakStackUse plus configSTACK_PROFILER_MARGIN_PERCENT percent, in words. */
+} TaskStackProfile_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -154,6 +198,14 @@ typedef enum
  */
 #define tskIDLE_PRIORITY			( ( UBaseType_t ) 0U )
 
+/**
+ * The core affinity mask of a task that can run on any core.  Only used when
+ * configNUMBER_OF_CORES is greater than 1.
+ *
+ * \ingroup TaskUtils
+ */
+#define tskNO_AFFINITY				( ( UBaseType_t ) -1 )
+
 /**
  * task. h
  *
@@ -888,6 +940,386 @@ UBaseType_t uxTaskPriorityGet( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
  */
 UBaseType_t uxTaskPriorityGetFromISR( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );</pre>
+ *
+ * configNUMBER_OF_CORES must be greater than 1, and configUSE_CORE_AFFINITY
+ * must be defined as 1, for this function to be available.
+ *
+ * Set the cores a task is allowed to run on.  Bit n of the mask allows the
+ * task to run on core n.  Tasks are created with the mask tskNO_AFFINITY, so
+ * can run on any core.  If the task is running on a core it is no longer
+ * allowed to run on it is switched out straight away.
+ *
+ * @param xTask Handle of the task to set the affinity of.  Passing a NULL
+ * handle results in the affinity of the calling task being set.
+ *
+ * @param uxCoreAffinityMask The cores the task is allowed to run on.  At
+ * least one of the bits for the configNUMBER_OF_CORES cores must be set.
+ *
+ * Example usage:
+   <pre>
+ void vAFunction( void )
+ {
+ TaskHandle_t xHandle;
+
+	 // Create a task, storing the handle.
+	 xTaskCreate( vTaskCode, "NAME", STACK_SIZE, NULL, tskIDLE_PRIORITY, &xHandle );
+
+	 // Only allow the task to run on core 1.
+	 vTaskCoreAffinitySet( xHandle, ( 1 << 1 ) );
+ }
+   </pre>
+ * \defgroup vTaskCoreAffinitySet vTaskCoreAffinitySet
+ * \ingroup TaskCtrl
+ */
+void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask );</pre>
+ *
+ * configNUMBER_OF_CORES must be greater than 1, and configUSE_CORE_AFFINITY
+ * must be defined as 1, for this function to be available.
+ *
+ * Obtain the cores a task is allowed to run on, see vTaskCoreAffinitySet().
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the affinity of the calling task being returned.
+ *
+ * @return The core affinity mask of xTask.
+ *
+ * \defgroup uxTaskCoreAffinityGet uxTaskCoreAffinityGet
+ * \ingroup TaskCtrl
+ */
+UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Give a task a relative deadline, or remove it.  The ready tasks of each
+ * priority are scheduled earliest deadline first, ahead of the tasks of that
+ * priority without a deadline.  Tasks of a higher priority still preempt
+ * tasks of a lower priority whatever their deadlines, and tasks waiting on a
+ * queue, semaphore or other event are still unblocked in priority order.
+ *
+ * The task's current deadline is set xRelativeDeadline ticks from now.  Each
+ * time the task then calls vTaskDelayUntil() its deadline is advanced to
+ * xRelativeDeadline ticks after the time it is to wake, so a periodic task
+ * with a deadline equal to its period need only call this function once.
+ *
+ * @param xTask Handle of the task to set the deadline of.  Passing a NULL
+ * handle results in the deadline of the calling task being set.
+ *
+ * @param xRelativeDeadline The time in ticks from each release of the task to
+ * its deadline, or 0 to remove the task's deadline.  Deadlines are compared
+ * with each other in a way that survives the tick count overflowing, so must
+ * always be less than portMAX_DELAY / 2 ticks apart.
+ *
+ * Example usage:
+   <pre>
+ void vPeriodicTask( void * pvParameters )
+ {
+ const TickType_t xPeriod = pdMS_TO_TICKS( 120 );
+ TickType_t xLastWakeTime = xTaskGetTickCount();
+
+	 // Each job must complete before the next is released.
+	 vTaskSetDeadline( NULL, xPeriod );
+
+	 for( ;; )
+	 {
+		 // Perform the job here.
+
+		 // Wait for the next release, which also sets the next deadline.
+		 vTaskDelayUntil( &xLastWakeTime, xPeriod );
+	 }
+ }
+   </pre>
+ * \defgroup vTaskSetDeadline vTaskSetDeadline
+ * \ingroup TaskCtrl
+ */
+void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>TickType_t xTaskGetDeadline( const TaskHandle_t xTask );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Obtain the absolute deadline of a task's current job, see
+ * vTaskSetDeadline().
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the deadline of the calling task being returned.
+ *
+ * @return The tick count by which the task's current job should complete, or
+ * portMAX_DELAY if the task does not have a deadline.
+ *
+ * \defgroup xTaskGetDeadline xTaskGetDeadline
+ * \ingroup TaskCtrl
+ */
+TickType_t xTaskGetDeadline( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ *<pre>
+ BaseType_t xTaskCreatePeriodic(	TaskFunction_t pvTaskCode,
+								const char * const pcName,
+								configSTACK_DEPTH_TYPE usStackDepth,
+								void *pvParameters,
+								UBaseType_t uxPriority,
+								TickType_t xPeriod,
+								TickType_t xPhase,
+								TickType_t xRelativeDeadline,
+								TaskHandle_t *pvCreatedTask
+							);</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Create a task, as xTaskCreate() does, whose jobs are released by the kernel
+ * every xPeriod ticks.  The task calls xTaskWaitForNextPeriod() to wait for
+ * the release of its first job, and each time it completes a job to wait for
+ * the release of the next.
+ *
+ * Releases are made at xPhase ticks after the scheduler was started plus a
+ * whole number of periods, so periodic tasks keep the phases they were
+ * created with relative to each other - however long each takes to be
+ * created or to first run.  A task created once the scheduler is running is
+ * first released at the next such time.  If that time is the tick count the
+ * task is created at, as it is for a task created with an xPhase of 0 before
+ * the scheduler is started, the first release happens at creation - the first
+ * call to xTaskWaitForNextPeriod() returns at once, and the first job's latency
+ * is measured from the call to xTaskCreatePeriodic().  Otherwise the task can
+ * run before its first release, but its first job only starts when
+ * xTaskWaitForNextPeriod() returns, so any code before that call is not part
+ * of a job.
+ *
+ * The kernel counts the jobs that complete more than xRelativeDeadline ticks
+ * after their release, and measures the time from each release to the job
+ * starting - the time from the tick interrupt that released the task to
+ * xTaskWaitForNextPeriod() returning - using the portGET_RUN_TIME_NS() clock.
+ * See xTaskGetPeriodicStats().  A job that completes after the next release
+ * time has passed is followed by the next job at once, so a task that
+ * overruns catches up, as with vTaskDelayUntil().
+ *
+ * If configUSE_EDF_SCHEDULING is 1 the task is also given a deadline, see
+ * vTaskSetDeadline(), which is advanced with each release.
+ *
+ * @param xPeriod The time in ticks between releases, which must not be 0.
+ *
+ * @param xPhase The time in ticks from the scheduler being started to the
+ * first release.
+ *
+ * @param xRelativeDeadline The time in ticks from each release to the job's
+ * deadline, which must not be greater than xPeriod, or 0 for a deadline equal
+ * to the period.
+ *
+ * The other parameters and the return value are those of xTaskCreate().
+ *
+ * Example usage:
+   <pre>
+ void vSensorTask( void * pvParameters )
+ {
+	 for( ;; )
+	 {
+		 // Wait for the release of the next job.
+		 xTaskWaitForNextPeriod();
+
+		 // Sample the sensor here.
+	 }
+ }
+
+ void vCreateSensorTasks( void )
+ {
+	 // Two sensors sampled every 100ms, the second 50ms after the first,
+	 // each sample to be taken within 20ms of its release.
+	 xTaskCreatePeriodic( vSensorTask, "Sensor1", configMINIMAL_STACK_SIZE, NULL, 2, pdMS_TO_TICKS( 100 ), 0, pdMS_TO_TICKS( 20 ), NULL );
+	 xTaskCreatePeriodic( vSensorTask, "Sensor2", configMINIMAL_STACK_SIZE, NULL, 2, pdMS_TO_TICKS( 100 ), pdMS_TO_TICKS( 50 ), pdMS_TO_TICKS( 20 ), NULL );
+ }
+   </pre>
+ * \defgroup xTaskCreatePeriodic xTaskCreatePeriodic
+ * \ingroup Tasks
+ */
+BaseType_t xTaskCreatePeriodic(	TaskFunction_t pxTaskCode,
+								const char * const pcName,	/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+								const configSTACK_DEPTH_TYPE usStackDepth,
+								void * const pvParameters,
+								UBaseType_t uxPriority,
+								TickType_t xPeriod,
+								TickType_t xPhase,
+								TickType_t xRelativeDeadline,
+								TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>BaseType_t xTaskWaitForNextPeriod( void );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Called by a task created with xTaskCreatePeriodic() to complete its current
+ * job, if it has one, and wait in the Blocked state for the release of the
+ * next.
+ *
+ * @return pdPASS if the next job has been released.  pdFAIL if the task was
+ * taken out of the Blocked state before the release, for example by
+ * xTaskAbortDelay(), in which case calling xTaskWaitForNextPeriod() again
+ * waits for the same release.
+ *
+ * \defgroup xTaskWaitForNextPeriod xTaskWaitForNextPeriod
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskWaitForNextPeriod( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>BaseType_t xTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicTaskStats_t *pxStats );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Obtain a copy of the release statistics of a task created with
+ * xTaskCreatePeriodic().  Deadline misses are detected as each job completes,
+ * so a job that has not completed is not counted, however late it is.
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the calling task being queried.
+ *
+ * @param pxStats The structure into which the statistics are written.
+ *
+ * @return pdPASS if the statistics were copied, or pdFAIL if the task was not
+ * created with xTaskCreatePeriodic().
+ *
+ * \defgroup xTaskGetPeriodicStats xTaskGetPeriodicStats
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicTaskStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskSetBudget( TaskHandle_t xTask, TickType_t xBudget, TickType_t xPeriod );</pre>
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 for this function to be
+ * available.
+ *
+ * Limit the processing time a task can use, so a task that runs away cannot
+ * starve the tasks of equal and lower priority.  Each tick interrupt charges
+ * one tick to the budget of the task that is running.  A period starts the
+ * first time a tick is charged after the budget was last replenished, and
+ * once xBudget ticks have been charged within it the task is throttled - it
+ * is taken out of the Ready state, and reported as Blocked, until the end of
+ * the period, when its budget is replenished.  The budget is also replenished
+ * if the task next runs after the end of the period.
+ *
+ * A throttled task is not readied by xTaskAbortDelay(), but can be
+ * suspended, deleted or have its priority changed.  A task that is throttled
+ * while holding a mutex keeps the mutex, so tasks that need the mutex should
+ * have the same, or no, budget.
+ *
+ * @param xTask Handle of the task to set the budget of.  Passing a NULL handle
+ * results in the budget of the calling task being set.
+ *
+ * @param xBudget The ticks the task can run for in each period, or 0 to remove
+ * the task's budget.  A throttled task is readied when its budget is set.
+ *
+ * @param xPeriod The length of the period in ticks, which must be at least
+ * xBudget and no more than portMAX_DELAY / 2.
+ *
+ * Example usage:
+   <pre>
+ void vBackgroundTask( void * pvParameters )
+ {
+	 // Use no more than 10ms of each 100ms.
+	 vTaskSetBudget( NULL, pdMS_TO_TICKS( 10 ), pdMS_TO_TICKS( 100 ) );
+
+	 for( ;; )
+	 {
+		 // Process without blocking here.
+	 }
+ }
+   </pre>
+ * \defgroup vTaskSetBudget vTaskSetBudget
+ * \ingroup TaskCtrl
+ */
+void vTaskSetBudget( TaskHandle_t xTask, TickType_t xBudget, TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>TickType_t xTaskGetBudgetRemaining( const TaskHandle_t xTask );</pre>
+ * <pre>uint32_t ulTaskGetBudgetExhaustions( const TaskHandle_t xTask );</pre>
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 for these functions to be
+ * available.
+ *
+ * Obtain the ticks left in a task's budget for the current period, or the
+ * number of times the task has been throttled, see vTaskSetBudget().
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the calling task being queried.
+ *
+ * @return xTaskGetBudgetRemaining() returns the ticks left, or portMAX_DELAY
+ * if the task does not have a budget.  ulTaskGetBudgetExhaustions() returns
+ * the number of times the task has used all of its budget.
+ *
+ * \defgroup xTaskGetBudgetRemaining xTaskGetBudgetRemaining
+ * \ingroup TaskCtrl
+ */
+TickType_t xTaskGetBudgetRemaining( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+uint32_t ulTaskGetBudgetExhaustions( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskGetTaskPoolStats( TaskPoolStats_t *pxStats );</pre>
+ *
+ * configUSE_TASK_POOL must be defined as 1 for this function to be available.
+ *
+ * When configUSE_TASK_POOL is 1 the TCB and stack of a task created with
+ * xTaskCreate() are not freed when the task is deleted, but kept in a pool,
+ * and used again by the next task created with the same stack depth.  Tasks
+ * that are created and deleted repeatedly so take neither the time to
+ * allocate and free their memory, nor fragment the heap.
+ *
+ * The pool holds tasks of up to configTASK_POOL_SIZE_CLASSES different stack
+ * depths, and up to configTASK_POOL_TASKS_PER_SIZE_CLASS tasks of each.  The
+ * memory of a task that does not fit is freed as normal.  A stack depth for
+ * which the pool holds no tasks gives way to another.  As with any deleted
+ * task, the memory is only recycled once the idle task has run, if the task
+ * deleted itself.
+ *
+ * Obtain the number of tasks created with, and without, memory from the
+ * pool, and the number of deleted tasks whose memory was, and was not, kept.
+ *
+ * @param pxStats The structure into which the statistics are written.
+ *
+ * \defgroup vTaskGetTaskPoolStats vTaskGetTaskPoolStats
+ * \ingroup TaskUtils
+ */
+void vTaskGetTaskPoolStats( TaskPoolStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskReleaseTaskPool( void );</pre>
+ *
+ * configUSE_TASK_POOL must be defined as 1 for this function to be available.
+ *
+ * Free the TCBs and stacks held in the pool, see vTaskGetTaskPoolStats(), to
+ * return the memory to the heap.  xTaskCreate() calls this function itself if
+ * the heap cannot provide the memory for a new task.
+ *
+ * @return The number of tasks whose memory was freed.
+ *
+ * \defgroup uxTaskReleaseTaskPool uxTaskReleaseTaskPool
+ * \ingroup TaskUtils
+ */
+UBaseType_t uxTaskReleaseTaskPool( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>eTaskState eTaskGetState( TaskHandle_t xTask );</pre>
@@ -1684,6 +2116,130 @@ void vTaskList( char * pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unquali
  */
 void vTaskGetRunTimeStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 
+/**
+ * task. h
+ * <PRE>void vTaskGetExecutionStats( TaskHandle_t xTask, TaskExecutionStats_t *pxStats );</PRE>
+ *
+ * configGENERATE_EXECUTION_STATS must be defined as 1 for this function to be
+ * available.  The port must then define portGET_RUN_TIME_NS() to return the
+ * time of a free running clock in nanoseconds as a uint64_t, which, unlike
+ * the counter used by configGENERATE_RUN_TIME_STATS, is not expected to
+ * overflow.
+ *
+ * Each context switch adds the time the task being switched out has run for
+ * to its total, and counts the switch as a preemption or a voluntary block
+ * depending on whether the task is still able to run.  Only switches between
+ * different tasks are counted.
+ *
+ * vTaskGetExecutionStats() copies the statistics of one task without
+ * entering a critical section or suspending the scheduler, so it can be
+ * called often, from a task or from an interrupt that can use the API,
+ * without affecting the timing of other tasks.  The statistics of each task
+ * are guarded by a sequence number that the context switch makes odd while
+ * it updates them - the copy is taken again if the sequence number was odd,
+ * or changed, so the values returned are consistent with each other.
+ *
+ * The function waits for an update in progress to complete, so must not be
+ * called from an interrupt that can nest within the context switch, as on a
+ * single core the update it interrupted could never complete.  On ports that
+ * switch context with the interrupts that can use the API masked this is
+ * never the case.
+ *
+ * Unlike uxTaskGetSystemState() this function does not find the tasks, so the
+ * caller must hold the handles of the tasks it monitors, and must not pass the
+ * handle of a task that may have been deleted.
+ *
+ * @param xTask Handle of the task to be queried.  Passing a NULL handle
+ * results in the calling task being queried.
+ *
+ * @param pxStats The structure into which the statistics are written.
+ *
+ * Example usage:
+   <pre>
+ void vMonitorTask( void *pvParameters )
+ {
+ TaskHandle_t xMonitored = ( TaskHandle_t ) pvParameters;
+ TaskExecutionStats_t xPrevious, xNow;
+ uint64_t ullLoad;
+
+	 vTaskGetExecutionStats( xMonitored, &xPrevious );
+
+	 for( ;; )
+	 {
+		 vTaskDelay( pdMS_TO_TICKS( 10 ) );
+		 vTaskGetExecutionStats( xMonitored, &xNow );
+
+		 // The share of the last 10ms the task was running, in parts per
+		 // thousand.
+		 ullLoad = ( ( xNow.ullRunTimeNs - xPrevious.ullRunTimeNs ) * 1000ULL ) / ( xNow.ullSnapshotTimeNs - xPrevious.ullSnapshotTimeNs );
+		 xPrevious = xNow;
+	 }
+ }
+   </pre>
+ * \defgroup vTaskGetExecutionStats vTaskGetExecutionStats
+ * \ingroup TaskUtils
+ */
+void vTaskGetExecutionStats( TaskHandle_t xTask, TaskExecutionStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>UBaseType_t uxTaskGetStackProfile( TaskStackProfile_t * const pxProfileArray, const UBaseType_t uxArraySize );</PRE>
+ *
+ * configUSE_STACK_PROFILER must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * The stack profiler records the peak stack use of every task over the run of
+ * the application, so the stacks can be sized from measurement rather than
+ * guessed.  The stack of each task is filled with a known value when the task
+ * is created, and the idle task samples one task at a time - at most once
+ * every configSTACK_PROFILER_SAMPLE_PERIOD ticks, taking the tasks in turn -
+ * to find how much of the stack no longer holds that value.  Only the part of
+ * the stack found unused by the previous sample is searched, so a task whose
+ * stack use has settled costs little to sample.
+ *
+ * uxTaskGetStackProfile() copies the peaks recorded so far, along with a
+ * recommended stack depth that adds configSTACK_PROFILER_MARGIN_PERCENT
+ * percent to the peak, without searching any stack itself.  The peaks are
+ * only as recent as the last time the idle task sampled each task, so the
+ * idle task must have been able to run for the profile to be complete.
+ *
+ * Like uxTaskGetStackHighWaterMark(), the profile only finds the stack use
+ * that left a word changed, and cannot find use beyond the end of the stack,
+ * so the recommended depth is a starting point to be checked with
+ * configCHECK_FOR_STACK_OVERFLOW set, not a guarantee.
+ *
+ * @param pxProfileArray An array of TaskStackProfile_t structures into which
+ * the profile of each task that has not been deleted is written.
+ *
+ * @param uxArraySize The number of structures in pxProfileArray.  If there
+ * are more tasks than that only uxArraySize of them are profiled.  Use
+ * uxTaskGetNumberOfTasks() to size the array.
+ *
+ * @return The number of TaskStackProfile_t structures that were populated.
+ *
+ * Example usage:
+   <pre>
+ void vReportStacks( void )
+ {
+ TaskStackProfile_t xProfiles[ 16 ];
+ UBaseType_t uxTasks, x;
+
+	 uxTasks = uxTaskGetStackProfile( xProfiles, 16 );
+
+	 for( x = 0; x < uxTasks; x++ )
+	 {
+		 printf( "%s: %u of %u words used, %u recommended\n", xProfiles[ x ].pcTaskName,
+				 ( unsigned ) xProfiles[ x ].ulPeakStackUse,
+				 ( unsigned ) xProfiles[ x ].ulStackDepth,
+				 ( unsigned ) xProfiles[ x ].ulRecommendedStackDepth );
+	 }
+ }
+   </pre>
+ * \defgroup uxTaskGetStackProfile uxTaskGetStackProfile
+ * \ingroup TaskUtils
+ */
+UBaseType_t uxTaskGetStackProfile( TaskStackProfile_t * const pxProfileArray, const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <PRE>BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
@@ -2323,6 +2879,23 @@ eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
  */
 TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Record the mutex the calling task is about to block
+ * on, so a priority it inherits while blocked can be passed on to the holder
+ * of that mutex.  Only available if configPRIORITY_INHERITANCE_CHAIN_DEPTH is
+ * greater than 1.
+ */
+void vTaskSetBlockedOnMutex( void *pvMutex ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Raise the calling task, which has just taken a
+ * priority ceiling mutex, to the ceiling, returning the priority it had
+ * before.  Restore the priority of the holder of a priority ceiling mutex as
+ * it gives the mutex back, returning pdTRUE if a context switch is required.
+ */
+UBaseType_t uxTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskPriorityRestoreFromCeiling( TaskHandle_t const pxMutexHolder, UBaseType_t uxCeilingPriority, UBaseType_t uxPriorityBeforeCeiling ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Same as vTaskSetTimeOutState(), but without a critial
  * section.
@@ -0,0 +1,547 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <string.h>
+#include <math.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "sim_peripheral.h"
+
+/* The range of an ADC conversion result. */
+#define simADC_RESULT_MASK				( 0xfffUL )
+
+typedef struct xSIM_PERIPHERAL
+{
+	SimPeripheralConfig_t xConfig;
+	volatile BaseType_t xRunning;
+	uint64_t ullNextDueNs;				/* When the next interrupt is due on the simulated clock. */
+	uint32_t ulRandom;					/* The state of the pseudo random number generator. */
+	uint32_t ulBurstRemaining;			/* The interrupts left in the current burst. */
+	uint32_t ulSequence;				/* Counts the bytes, samples or packets produced. */
+	uint8_t *pucBuffer;					/* Holds each write of bytes or packet while it is built. */
+	SimPeripheralStats_t xStats;
+} SimPeripheral_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The handler of each peripheral's simulated interrupt.  The port does not
+ * pass a parameter to handlers, so there is one for each peripheral that can
+ * be created.
+ */
+static uint32_t prvPeripheral0Handler( void );
+static uint32_t prvPeripheral1Handler( void );
+static uint32_t prvPeripheral2Handler( void );
+static uint32_t prvPeripheral3Handler( void );
+static uint32_t prvPeripheral4Handler( void );
+static uint32_t prvPeripheral5Handler( void );
+static uint32_t prvPeripheral6Handler( void );
+static uint32_t prvPeripheral7Handler( void );
+
+/*
+ * Called by each handler, produces everything that has become due and times
+ * the next interrupt.
+ */
+static uint32_t prvProcessInterrupt( SimPeripheral_t *pxPeripheral );
+
+/*
+ * Produce one write of bytes, sample or packet, and pass it on through the
+ * interrupt safe API.
+ */
+static void prvProduce( SimPeripheral_t *pxPeripheral, uint64_t ullDueNs, BaseType_t *pxHigherPriorityTaskWoken );
+
+/*
+ * Return the time from one interrupt to the next, drawn from the peripheral's
+ * distribution.
+ */
+static uint64_t prvNextInterval( SimPeripheral_t *pxPeripheral );
+
+/*
+ * A xorshift pseudo random number generator, and the uniform and exponential
+ * distributions drawn from it.
+ */
+static uint32_t prvRandom( SimPeripheral_t *pxPeripheral );
+static uint64_t prvRandomBetween( SimPeripheral_t *pxPeripheral, uint64_t ullMin, uint64_t ullMax );
+static uint64_t prvRandomExponential( SimPeripheral_t *pxPeripheral, uint64_t ullMean );
+
+/*-----------------------------------------------------------*/
+
+static SimPeripheral_t *pxPeripherals[ simMAX_PERIPHERALS ] = { NULL };
+
+static uint32_t (* const pxHandlers[ simMAX_PERIPHERALS ])( void ) =
+{
+	prvPeripheral0Handler, prvPeripheral1Handler, prvPeripheral2Handler, prvPeripheral3Handler,
+	prvPeripheral4Handler, prvPeripheral5Handler, prvPeripheral6Handler, prvPeripheral7Handler
+};
+
+/*-----------------------------------------------------------*/
+
+SimPeripheralHandle_t xSimPeripheralCreate( const SimPeripheralConfig_t *pxConfig )
+{
+SimPeripheral_t *pxPeripheral = NULL;
+BaseType_t xValid, xSlot;
+
+	/* Check the configuration makes sense for the type of peripheral. */
+	xValid = ( pxConfig->ulInterruptNumber > portINTERRUPT_TICK ) && ( pxConfig->ullIntervalNs != 0ULL );
+
+	switch( pxConfig->eType )
+	{
+		case eSimPeripheralUART:
+			xValid = xValid && ( pxConfig->xStreamBuffer != NULL ) && ( pxConfig->xMinBytes != 0 ) && ( pxConfig->xMinBytes <= pxConfig->xMaxBytes );
+			break;
+
+		case eSimPeripheralADC:
+			xValid = xValid && ( pxConfig->xQueue != NULL );
+			break;
+
+		case eSimPeripheralNetwork:
+			xValid = xValid && ( pxConfig->xStreamBuffer != NULL ) && ( pxConfig->xMinBytes >= sizeof( SimPeripheralPacketHeader_t ) ) && ( pxConfig->xMinBytes <= pxConfig->xMaxBytes );
+			break;
+
+		default:
+			xValid = pdFALSE;
+			break;
+	}
+
+	switch( pxConfig->eDistribution )
+	{
+		case eSimArrivalPeriodic:
+		case eSimArrivalExponential:
+			break;
+
+		case eSimArrivalUniform:
+			xValid = xValid && ( pxConfig->ullJitterNs < pxConfig->ullIntervalNs );
+			break;
+
+		case eSimArrivalBursty:
+			xValid = xValid && ( pxConfig->ulBurstLength != 0UL );
+			break;
+
+		default:
+			xValid = pdFALSE;
+			break;
+	}
+
+	configASSERT( xValid );
+
+	if( xValid != pdFALSE )
+	{
+		pxPeripheral = ( SimPeripheral_t * ) pvPortMalloc( sizeof( SimPeripheral_t ) );
+
+		if( pxPeripheral != NULL )
+		{
+			memset( ( void * ) pxPeripheral, 0x00, sizeof( SimPeripheral_t ) );
+			pxPeripheral->xConfig = *pxConfig;
+			pxPeripheral->xRunning = pdFALSE;
+			pxPeripheral->ulRandom = ( pxConfig->ulSeed != 0UL ) ? pxConfig->ulSeed : 1UL;
+			pxPeripheral->ulBurstRemaining = pxConfig->ulBurstLength;
+
+			if( pxConfig->eType != eSimPeripheralADC )
+			{
+				pxPeripheral->pucBuffer = ( uint8_t * ) pvPortMalloc( pxConfig->xMaxBytes );
+
+				if( pxPeripheral->pucBuffer == NULL )
+				{
+					vPortFree( pxPeripheral );
+					pxPeripheral = NULL;
+				}
+			}
+		}
+
+		if( pxPeripheral != NULL )
+		{
+			/* Claim a handler. */
+			taskENTER_CRITICAL();
+			{
+				for( xSlot = 0; xSlot < simMAX_PERIPHERALS; xSlot++ )
+				{
+					if( pxPeripherals[ xSlot ] == NULL )
+					{
+						pxPeripherals[ xSlot ] = pxPeripheral;
+						break;
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( xSlot < simMAX_PERIPHERALS )
+			{
+				vPortSetInterruptPriority( pxConfig->ulInterruptNumber, pxConfig->ulInterruptPriority );
+				vPortSetInterruptHandler( pxConfig->ulInterruptNumber, pxHandlers[ xSlot ] );
+			}
+			else
+			{
+				vPortFree( pxPeripheral->pucBuffer );
+				vPortFree( pxPeripheral );
+				pxPeripheral = NULL;
+			}
+		}
+	}
+
+	return pxPeripheral;
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralStart( SimPeripheralHandle_t xPeripheral )
+{
+SimPeripheral_t *pxPeripheral = xPeripheral;
+uint64_t ullIntervalNs;
+
+	configASSERT( pxPeripheral );
+
+	taskENTER_CRITICAL();
+	{
+		ullIntervalNs = prvNextInterval( pxPeripheral );
+		pxPeripheral->ullNextDueNs = ullPortGetSimulatedTimeNs() + ullIntervalNs;
+		pxPeripheral->xRunning = pdTRUE;
+		vPortGenerateSimulatedInterruptAfter( pxPeripheral->xConfig.ulInterruptNumber, ullIntervalNs );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralStop( SimPeripheralHandle_t xPeripheral )
+{
+SimPeripheral_t *pxPeripheral = xPeripheral;
+
+	configASSERT( pxPeripheral );
+
+	/* The interrupt that is already timed still occurs, but its handler
+	produces nothing and does not time another. */
+	taskENTER_CRITICAL();
+	{
+		pxPeripheral->xRunning = pdFALSE;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralSetInterval( SimPeripheralHandle_t xPeripheral, uint64_t ullIntervalNs )
+{
+SimPeripheral_t *pxPeripheral = xPeripheral;
+SimPeripheralConfig_t *pxConfig;
+double dScale;
+
+	configASSERT( pxPeripheral );
+	configASSERT( ullIntervalNs != 0ULL );
+
+	taskENTER_CRITICAL();
+	{
+		pxConfig = &( pxPeripheral->xConfig );
+		dScale = ( double ) ullIntervalNs / ( double ) pxConfig->ullIntervalNs;
+		pxConfig->ullJitterNs = ( uint64_t ) ( ( double ) pxConfig->ullJitterNs * dScale );
+		pxConfig->ullBurstIntervalNs = ( uint64_t ) ( ( double ) pxConfig->ullBurstIntervalNs * dScale );
+		pxConfig->ullIntervalNs = ullIntervalNs;
+
+		/* Rounding must not leave the jitter reaching zero. */
+		if( pxConfig->ullJitterNs >= ullIntervalNs )
+		{
+			pxConfig->ullJitterNs = ullIntervalNs - 1ULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralGetStats( SimPeripheralHandle_t xPeripheral, SimPeripheralStats_t *pxStats )
+{
+SimPeripheral_t *pxPeripheral = xPeripheral;
+
+	configASSERT( pxPeripheral );
+
+	taskENTER_CRITICAL();
+	{
+		*pxStats = pxPeripheral->xStats;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vSimPeripheralResetStats( SimPeripheralHandle_t xPeripheral )
+{
+SimPeripheral_t *pxPeripheral = xPeripheral;
+
+	configASSERT( pxPeripheral );
+
+	taskENTER_CRITICAL();
+	{
+		memset( ( void * ) &( pxPeripheral->xStats ), 0x00, sizeof( SimPeripheralStats_t ) );
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessInterrupt( SimPeripheral_t *pxPeripheral )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+UBaseType_t uxSavedInterruptStatus;
+uint64_t ullNowNs;
+
+	/* Stop the task level functions changing the peripheral while it is
+	used, including from another core. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( ( pxPeripheral != NULL ) && ( pxPeripheral->xRunning != pdFALSE ) )
+		{
+			pxPeripheral->xStats.ulInterrupts++;
+			ullNowNs = ullPortGetSimulatedTimeNs();
+
+			/* Produce everything that has become due since the handler last
+			ran, as a peripheral keeps producing whether or not its interrupt
+			is being serviced. */
+			for( ;; )
+			{
+				prvProduce( pxPeripheral, pxPeripheral->ullNextDueNs, &xHigherPriorityTaskWoken );
+				pxPeripheral->ullNextDueNs += prvNextInterval( pxPeripheral );
+
+				if( pxPeripheral->ullNextDueNs > ullNowNs )
+				{
+					break;
+				}
+
+				pxPeripheral->xStats.ulLateItems++;
+			}
+
+			vPortGenerateSimulatedInterruptAfter( pxPeripheral->xConfig.ulInterruptNumber, pxPeripheral->ullNextDueNs - ullNowNs );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProduce( SimPeripheral_t *pxPeripheral, uint64_t ullDueNs, BaseType_t *pxHigherPriorityTaskWoken )
+{
+SimPeripheralConfig_t * const pxConfig = &( pxPeripheral->xConfig );
+SimPeripheralStats_t * const pxStats = &( pxPeripheral->xStats );
+SimPeripheralSample_t xSample;
+SimPeripheralPacketHeader_t xHeader;
+size_t xBytes, xSent, x;
+
+	switch( pxConfig->eType )
+	{
+		case eSimPeripheralUART:
+			xBytes = ( size_t ) prvRandomBetween( pxPeripheral, pxConfig->xMinBytes, pxConfig->xMaxBytes );
+
+			for( x = 0; x < xBytes; x++ )
+			{
+				pxPeripheral->pucBuffer[ x ] = ( uint8_t ) pxPeripheral->ulSequence;
+				pxPeripheral->ulSequence++;
+			}
+
+			xSent = xStreamBufferSendFromISR( pxConfig->xStreamBuffer, pxPeripheral->pucBuffer, xBytes, pxHigherPriorityTaskWoken );
+
+			pxStats->ulItems++;
+			pxStats->ullBytes += xBytes;
+
+			if( xSent != xBytes )
+			{
+				pxStats->ulDroppedItems++;
+				pxStats->ullDroppedBytes += xBytes - xSent;
+			}
+			break;
+
+		case eSimPeripheralADC:
+			xSample.ulSequence = pxPeripheral->ulSequence++;
+			xSample.ulValue = prvRandom( pxPeripheral ) & simADC_RESULT_MASK;
+			xSample.ullTimeNs = ullDueNs;
+
+			pxStats->ulItems++;
+			pxStats->ullBytes += sizeof( xSample );
+
+			if( xQueueSendFromISR( pxConfig->xQueue, &xSample, pxHigherPriorityTaskWoken ) != pdPASS )
+			{
+				pxStats->ulDroppedItems++;
+				pxStats->ullDroppedBytes += sizeof( xSample );
+			}
+			break;
+
+		case eSimPeripheralNetwork:
+			xBytes = ( size_t ) prvRandomBetween( pxPeripheral, pxConfig->xMinBytes, pxConfig->xMaxBytes );
+
+			xHeader.ulSequence = pxPeripheral->ulSequence++;
+			xHeader.ulLength = ( uint32_t ) xBytes;
+			xHeader.ullTimeNs = ullDueNs;
+			memcpy( pxPeripheral->pucBuffer, &xHeader, sizeof( xHeader ) );
+			memset( pxPeripheral->pucBuffer + sizeof( xHeader ), ( int ) ( xHeader.ulSequence & 0xffUL ), xBytes - sizeof( xHeader ) );
+
+			pxStats->ulItems++;
+			pxStats->ullBytes += xBytes;
+
+			if( xMessageBufferSendFromISR( pxConfig->xStreamBuffer, pxPeripheral->pucBuffer, xBytes, pxHigherPriorityTaskWoken ) != xBytes )
+			{
+				pxStats->ulDroppedItems++;
+				pxStats->ullDroppedBytes += xBytes;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNextInterval( SimPeripheral_t *pxPeripheral )
+{
+SimPeripheralConfig_t * const pxConfig = &( pxPeripheral->xConfig );
+uint64_t ullIntervalNs;
+
+	switch( pxConfig->eDistribution )
+	{
+		case eSimArrivalUniform:
+			ullIntervalNs = prvRandomBetween( pxPeripheral, pxConfig->ullIntervalNs - pxConfig->ullJitterNs, pxConfig->ullIntervalNs + pxConfig->ullJitterNs );
+			break;
+
+		case eSimArrivalExponential:
+			ullIntervalNs = prvRandomExponential( pxPeripheral, pxConfig->ullIntervalNs );
+			break;
+
+		case eSimArrivalBursty:
+			pxPeripheral->ulBurstRemaining--;
+
+			if( pxPeripheral->ulBurstRemaining == 0UL )
+			{
+				/* The gap before the next burst. */
+				pxPeripheral->ulBurstRemaining = pxConfig->ulBurstLength;
+				ullIntervalNs = pxConfig->ullIntervalNs + prvRandomExponential( pxPeripheral, pxConfig->ullBurstIntervalNs );
+			}
+			else
+			{
+				ullIntervalNs = pxConfig->ullIntervalNs;
+			}
+			break;
+
+		case eSimArrivalPeriodic:
+		default:
+			ullIntervalNs = pxConfig->ullIntervalNs;
+			break;
+	}
+
+	/* Interrupts that are due at the same time are produced together, but the
+	simulated clock must move on between one interrupt and the next. */
+	if( ullIntervalNs == 0ULL )
+	{
+		ullIntervalNs = 1ULL;
+	}
+
+	return ullIntervalNs;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( SimPeripheral_t *pxPeripheral )
+{
+uint32_t ulRandom = pxPeripheral->ulRandom;
+
+	ulRandom ^= ulRandom << 13;
+	ulRandom ^= ulRandom >> 17;
+	ulRandom ^= ulRandom << 5;
+	pxPeripheral->ulRandom = ulRandom;
+
+	return ulRandom;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvRandomBetween( SimPeripheral_t *pxPeripheral, uint64_t ullMin, uint64_t ullMax )
+{
+uint64_t ullRandom;
+
+	ullRandom = ( ( uint64_t ) prvRandom( pxPeripheral ) << 32 ) | ( uint64_t ) prvRandom( pxPeripheral );
+
+	if( ullMax - ullMin != UINT64_MAX )
+	{
+		ullRandom = ullMin + ( ullRandom % ( ullMax - ullMin + 1ULL ) );
+	}
+
+	return ullRandom;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvRandomExponential( SimPeripheral_t *pxPeripheral, uint64_t ullMean )
+{
+double dUniform;
+
+	/* Uniformly distributed in ( 0, 1 ], so the logarithm is finite. */
+	dUniform = ( ( double ) prvRandom( pxPeripheral ) + 1.0 ) / 4294967296.0;
+
+	return ( uint64_t ) ( -log( dUniform ) * ( double ) ullMean );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral0Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 0 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral1Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 1 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral2Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 2 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral3Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 3 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral4Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 4 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral5Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 5 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral6Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 6 ] );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPeripheral7Handler( void )
+{
+	return prvProcessInterrupt( pxPeripherals[ 7 ] );
+}
+/*-----------------------------------------------------------*/
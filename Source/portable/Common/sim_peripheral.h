@@ -0,0 +1,171 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef SIM_PERIPHERAL_H
+#define SIM_PERIPHERAL_H
+
+#ifndef INC_FREERTOS_H
+	#error "include FreeRTOS.h must appear in source files before include sim_peripheral.h"
+#endif
+
+#include "queue.h"
+#include "stream_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Simulated peripherals, for use with the Linux and Windows simulator ports.
+ *
+ * Each peripheral raises its own simulated interrupt, timed on the simulated
+ * clock by vPortGenerateSimulatedInterruptAfter(), at a programmable rate and
+ * with a programmable distribution of the time between interrupts.  The
+ * interrupt handler passes what the peripheral produced to the application
+ * through the interrupt safe API, as the handler of a real peripheral would:
+ *
+ * + A UART writes a number of bytes into a stream buffer.  The bytes count up
+ *   from 0, wrapping at 256, so a reader can check none were lost.
+ *
+ * + An ADC sends a SimPeripheralSample_t to a queue.
+ *
+ * + A network interface writes a packet into a message buffer.  Each packet
+ *   starts with a SimPeripheralPacketHeader_t.
+ *
+ * Anything that does not fit in the queue or buffer is dropped and counted,
+ * as a real peripheral would overrun, so the rate can be raised until the
+ * application can no longer keep up.
+ *
+ * Interrupts that are due while the simulated interrupt cannot be processed -
+ * because it is masked, or a more urgent one is being processed - are handled
+ * together when it next can be, so the average rate is kept however late the
+ * handler runs.
+ */
+
+/* The most peripherals that can be created. */
+#define simMAX_PERIPHERALS				( 8 )
+
+/* What a peripheral produces each time it interrupts. */
+typedef enum
+{
+	eSimPeripheralUART = 0,		/* Between xMinBytes and xMaxBytes bytes, written to xStreamBuffer. */
+	eSimPeripheralADC,			/* One SimPeripheralSample_t, sent to xQueue. */
+	eSimPeripheralNetwork		/* One packet of between xMinBytes and xMaxBytes bytes, written to the message buffer xStreamBuffer. */
+} eSimPeripheralType;
+
+/* How the time between one interrupt and the next is distributed. */
+typedef enum
+{
+	eSimArrivalPeriodic = 0,	/* Always ullIntervalNs. */
+	eSimArrivalUniform,			/* Uniformly distributed between ullIntervalNs - ullJitterNs and ullIntervalNs + ullJitterNs. */
+	eSimArrivalExponential,		/* Exponentially distributed with a mean of ullIntervalNs, so interrupts arrive as a Poisson process. */
+	eSimArrivalBursty			/* Bursts of ulBurstLength interrupts ullIntervalNs apart, the start of each burst being exponentially distributed with a mean of ullBurstIntervalNs after the end of the last. */
+} eSimArrivalDistribution;
+
+typedef struct xSIM_PERIPHERAL_CONFIG
+{
+	eSimPeripheralType eType;
+	uint32_t ulInterruptNumber;				/* The simulated interrupt used, which must not be used by anything else. */
+	uint32_t ulInterruptPriority;			/* See vPortSetInterruptPriority(). */
+	eSimArrivalDistribution eDistribution;
+	uint64_t ullIntervalNs;					/* The time between interrupts, or the mean time for eSimArrivalExponential. */
+	uint64_t ullJitterNs;					/* eSimArrivalUniform only. */
+	uint32_t ulBurstLength;					/* eSimArrivalBursty only. */
+	uint64_t ullBurstIntervalNs;			/* eSimArrivalBursty only. */
+	size_t xMinBytes;						/* UART and network only, the size of each write is uniformly distributed between the two. */
+	size_t xMaxBytes;
+	QueueHandle_t xQueue;					/* ADC only. */
+	StreamBufferHandle_t xStreamBuffer;		/* UART and network only. */
+	uint32_t ulSeed;						/* Seeds the random times and sizes, so a run can be repeated. */
+} SimPeripheralConfig_t;
+
+/* The item an ADC sends to its queue. */
+typedef struct xSIM_PERIPHERAL_SAMPLE
+{
+	uint32_t ulSequence;		/* Counts up from 0 for each sample produced, including any dropped. */
+	uint32_t ulValue;			/* A pseudo random 12 bit conversion result. */
+	uint64_t ullTimeNs;			/* The simulated time the sample was due, see ullPortGetSimulatedTimeNs(). */
+} SimPeripheralSample_t;
+
+/* The start of each packet a network interface writes to its message buffer.
+The rest of the packet is filled with the low byte of ulSequence. */
+typedef struct xSIM_PERIPHERAL_PACKET_HEADER
+{
+	uint32_t ulSequence;		/* Counts up from 0 for each packet received, including any dropped. */
+	uint32_t ulLength;			/* The length of the whole packet, header included. */
+	uint64_t ullTimeNs;			/* The simulated time the packet was due. */
+} SimPeripheralPacketHeader_t;
+
+typedef struct xSIM_PERIPHERAL_STATS
+{
+	uint32_t ulInterrupts;		/* The number of times the handler has been entered. */
+	uint32_t ulLateItems;		/* Items produced by a handler entered after a later item was also due. */
+	uint32_t ulItems;			/* Bytes, samples or packets produced, including any dropped. */
+	uint32_t ulDroppedItems;	/* Samples or packets that did not fit, or writes of bytes that did not all fit. */
+	uint64_t ullBytes;			/* Bytes produced, including any dropped. */
+	uint64_t ullDroppedBytes;	/* Bytes that did not fit. */
+} SimPeripheralStats_t;
+
+struct xSIM_PERIPHERAL;
+typedef struct xSIM_PERIPHERAL * SimPeripheralHandle_t;
+
+/*
+ * Create a peripheral, installing the handler of its simulated interrupt.  The
+ * configuration is copied.  Returns NULL if the configuration is not valid,
+ * simMAX_PERIPHERALS have already been created, or there is not enough heap.
+ * Should be called before the scheduler is started or from a task.
+ */
+SimPeripheralHandle_t xSimPeripheralCreate( const SimPeripheralConfig_t *pxConfig );
+
+/*
+ * Start and stop a peripheral interrupting.  A peripheral is created stopped.
+ * Can be called before the scheduler is started, or from a task.
+ */
+void vSimPeripheralStart( SimPeripheralHandle_t xPeripheral );
+void vSimPeripheralStop( SimPeripheralHandle_t xPeripheral );
+
+/*
+ * Change ullIntervalNs, which takes effect from the next interrupt.  The
+ * jitter of eSimArrivalUniform, and the time between the bursts of
+ * eSimArrivalBursty, are scaled by the same factor, so the average rate
+ * changes in proportion whatever the distribution.  Used to step the load up
+ * while the peripheral is running.
+ */
+void vSimPeripheralSetInterval( SimPeripheralHandle_t xPeripheral, uint64_t ullIntervalNs );
+
+/*
+ * Obtain a copy of, or reset, the statistics of a peripheral.  Called from a
+ * task.
+ */
+void vSimPeripheralGetStats( SimPeripheralHandle_t xPeripheral, SimPeripheralStats_t *pxStats );
+void vSimPeripheralResetStats( SimPeripheralHandle_t xPeripheral );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_PERIPHERAL_H */
@@ -0,0 +1,3329 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portMAX_INTERRUPTS				( ( uint32_t ) sizeof( uint32_t ) * 8UL ) /* The number of bits in an uint32_t. */
+#define portNO_CRITICAL_NESTING 		( ( uint32_t ) 0 )
+
+/* The tick period in nanoseconds, and the time after which a tick is due that
+it is counted as late. */
+#define portTICK_PERIOD_NS				( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+#define portTICK_LATE_NS				( portTICK_PERIOD_NS / 2ULL )
+
+/* The signal used to park a task thread when the task it executes leaves the
+Running state.  This plays the role SuspendThread() plays in the Windows
+port. */
+#define portSUSPEND_SIGNAL				SIGUSR1
+
+/* The size of the host stack given to each thread that executes a task.  The
+FreeRTOS stack is not used to execute the task, see pxPortInitialiseStack(). */
+#define portTASK_THREAD_STACK_SIZE		( ( size_t ) 256 * 1024 )
+
+/* The owner of a lock that is not held, see vPortGetLock(). */
+#define portLOCK_FREE					( ( BaseType_t ) -1 )
+
+/* The signal used to deliver simulated interrupts to the host thread that
+executes all the tasks when configUSE_FIBER_TASKS is 1.  This plays the role of
+the interrupt line.  When configUSE_FIBER_TASKS is 0 it is only sent to the
+simulated interrupt handler thread, to preempt a less urgent handler. */
+#define portINTERRUPT_SIGNAL			SIGUSR2
+
+/* The alignment used for the xThreadState structure when it holds the context
+of a task. */
+#define portCONTEXT_ALIGNMENT_MASK		( 0x000f )
+
+/* The level at which the simulated interrupts of a priority are held, see
+ulInterruptsAtLevel[]. */
+#define portPRIORITY_TO_LEVEL( ulPriority )	( portLOWEST_INTERRUPT_PRIORITY - ( ulPriority ) )
+
+/* The levels that are not masked at the execution level ulLevel. */
+#define portUNMASKED_LEVELS( ulLevel )		( ( uint32_t ) ~( ( 1ULL << ( ulLevel ) ) - 1ULL ) )
+
+/* The execution level at which the interrupts that can call the API, those
+not more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY, are masked. */
+#define portKERNEL_EXECUTION_LEVEL		( portINTERRUPT_PRIORITY_LEVELS - ( uint32_t ) configMAX_SYSCALL_INTERRUPT_PRIORITY )
+
+/* Returned by ulPortSetInterruptMaskFromISR() when it is called from a task,
+in which case it enters a critical section instead. */
+#define portTASK_INTERRUPT_MASK			( ( UBaseType_t ) 0xffffffffUL )
+
+/* Whether the interrupts raised by other host threads are being recorded, or
+replayed, see xPortRecordInterrupts(). */
+#define portNOT_RECORDING				( 0 )
+#define portRECORDING					( 1 )
+#define portREPLAYING					( 2 )
+
+/* A record/replay log starts with these two words and the tick rate, each
+written in host byte order. */
+#define portLOG_MAGIC					( 0x52525246UL )
+#define portLOG_VERSION					( 1UL )
+
+/* The size of the buffer that holds the recorded arrivals until the timer
+thread writes them to the log file.  Must be a power of two. */
+#define portLOG_BUFFER_SIZE				( ( uint32_t ) 256 * 1024 )
+
+/* How often the replay thread checks whether the next arrival is due while
+the tasks are not passing synchronisation points, for example while the idle
+task runs. */
+#define portREPLAY_POLL_NS				( 20000L )
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+/* When configUSE_FIBER_TASKS is 1 every task executes on the thread that
+started the scheduler, each as a user mode context (a fiber) that runs on the
+task's own FreeRTOS stack.  The xThreadState structure is placed at the top of
+that stack and holds the context of the task while it is not running. */
+typedef struct
+{
+	/* The saved context of the task. */
+	ucontext_t xContext;
+
+	/* The lowest address of the task stack, used to check the stack has not
+	overflowed. */
+	StackType_t *pxEndOfStack;
+
+	/* The task function and its parameter, called when the task first runs. */
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+} xThreadState;
+
+#else /* configUSE_FIBER_TASKS */
+
+/* The Linux simulator runs each task in a thread.  The context switching is
+managed by the threads, so the task stack does not have to be managed directly,
+although the task stack is still used to hold an xThreadState structure this is
+the only thing it will ever hold.  The structure indirectly maps the task handle
+to a thread handle. */
+typedef struct
+{
+	/* Handle of the thread that executes the task. */
+	pthread_t xThread;
+
+	/* Posted to let the thread run, the thread waits on it while parked. */
+	sem_t xResume;
+
+	/* The task function and its parameter, passed to the thread on start. */
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+	/* Set to pdFALSE once the thread has exited, so it is not suspended,
+	resumed or joined again. */
+	volatile BaseType_t xThreadValid;
+
+	/* Set to make a parked thread exit rather than run when it is next
+	resumed. */
+	volatile BaseType_t xExitRequested;
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		/* Set by the thread when it parks itself after raising a simulated
+		interrupt, so the simulated interrupt handler thread knows it does not
+		need to be suspended. */
+		volatile BaseType_t xParkedOnYield;
+	#endif
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The critical nesting count of the task.  The cores run their tasks
+		at the same time, so unlike on a single core the count cannot be held
+		in one variable. */
+		volatile uint32_t ulCriticalNesting;
+
+		/* The core the thread was last resumed on. */
+		volatile BaseType_t xCoreID;
+	#endif
+
+} xThreadState;
+
+#if( configNUMBER_OF_CORES > 1 )
+
+/* The state of each core other than core 0, which is the simulated interrupt
+handler thread.  A core thread switches the task its core runs, see
+prvCoreThread(). */
+typedef struct
+{
+	/* Handle of the thread that switches the task the core runs. */
+	pthread_t xThread;
+
+	/* Posted to wake the core thread when a switch is requested. */
+	sem_t xSwitchEvent;
+
+	/* Set by vPortYieldCore(), and cleared by the core thread when it calls
+	vTaskSwitchContext(). */
+	volatile BaseType_t xSwitchRequested;
+
+	/* Posted by the task thread of the core once it has parked in response
+	to portSUSPEND_SIGNAL. */
+	sem_t xSuspendAcknowledged;
+
+	/* Incremented each time the core thread wakes, as ulInterruptsProcessed
+	is by the simulated interrupt handler thread. */
+	volatile uint32_t ulSwitchesProcessed;
+
+} xCoreState;
+
+/* One of the recursive spinlocks used by the kernel, see vPortGetLock(). */
+typedef struct
+{
+	/* The core holding the lock, or portLOCK_FREE. */
+	volatile BaseType_t xOwner;
+
+	/* The number of times the owner has taken the lock. */
+	uint32_t ulCount;
+
+} xCoreLock;
+
+#endif /* configNUMBER_OF_CORES */
+
+#endif /* configUSE_FIBER_TASKS */
+/*-----------------------------------------------------------*/
+
+/*
+ * Created as a separate thread, this function uses nanosleep() to simulate a
+ * tick interrupt being generated on an embedded target.  In this Linux
+ * environment the timer does not achieve anything approaching real time
+ * performance though.
+ */
+static void *prvSimulatedPeripheralTimer( void *pvParameter );
+
+/*
+ * Create the thread that runs prvSimulatedPeripheralTimer(), and the objects
+ * used to synchronise with it.
+ */
+static void prvStartSimulatedPeripheralTimer( void );
+
+/*
+ * Called by the timer thread when it wakes at, or after, the time the next tick
+ * is due.  Returns the number of ticks that are now due, updates the tick
+ * statistics, and moves *pullNextTickNs on to when the following tick is due.
+ */
+static uint32_t prvTicksDue( uint64_t ullNowNs, uint64_t *pullNextTickNs );
+
+/*
+ * Return the time at which the timer thread is to generate the next tick, or
+ * to wake the idle task if the tick is suppressed.  Called with xTimerMutex
+ * held.
+ */
+static uint64_t prvTimerWakeTimeNs( void );
+
+/*
+ * Return the time of the host's monotonic clock in nanoseconds.
+ */
+static uint64_t prvHostTimeNs( void );
+
+/*
+ * Return the time of the simulated clock, which the tick and the timed
+ * interrupts are generated from, in nanoseconds.  The same as the host clock
+ * unless configUSE_VIRTUAL_TIME is 1.  Called with xTimerMutex held.
+ */
+static uint64_t prvSimulatedTimeNs( void );
+
+/*
+ * Return a bit mask of the interrupts timed by
+ * vPortGenerateSimulatedInterruptAfter() that are due at ullNowNs, no longer
+ * timing them, and work out when the next of the rest is due.  Called with
+ * xTimerMutex held.
+ */
+static uint32_t prvTimedInterruptsDue( uint64_t ullNowNs );
+
+/*
+ * Raise each simulated interrupt in the bit mask ulInterrupts.
+ */
+static void prvGenerateSimulatedInterrupts( uint32_t ulInterrupts );
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+/*
+ * Called as the processing of the simulated interrupts starts, with the task
+ * parked or interrupted outside of a critical section.  Delivers the arrivals
+ * that were recorded, or are to be replayed, at the current synchronisation
+ * point - unless the interrupts being processed were raised by the task itself,
+ * which are processed on their own.
+ */
+static void prvTakeExternalInterrupts( void );
+
+/*
+ * Called as the processing of the simulated interrupts completes.  Counts the
+ * synchronisation point if the interrupts were raised by the task, and returns
+ * pdTRUE if there are more arrivals to deliver, so they are processed
+ * again.
+ */
+static BaseType_t prvEndInterruptProcessing( void );
+
+/*
+ * Returns pdTRUE if an arrival can be delivered now.
+ */
+static BaseType_t prvExternalInterruptsWaiting( void );
+
+/*
+ * Returns pdTRUE if called by the Running state task outside of a critical
+ * section while recording or replaying, in which case it is at a
+ * synchronisation point.  prvDeliverDueArrivals() then delivers any replayed
+ * arrival that is due before the task passes it.
+ */
+static BaseType_t prvAtSynchronisationPoint( void );
+static void prvDeliverDueArrivals( void );
+
+/*
+ * Encode an arrival into the log buffer, and write the buffer to the log
+ * file.
+ */
+static void prvLogValue( uint32_t *pulHead, uint64_t ullValue );
+static void prvWriteLog( void );
+static void prvFlushLog( void );
+
+/*
+ * Decode the next arrival from the log being replayed.
+ */
+static BaseType_t prvReadLogValue( uint64_t *pullValue );
+static void prvReadReplayEntry( void );
+
+/*
+ * Created instead of the timer thread when replaying, to deliver the next
+ * arrival if the tasks reach its synchronisation point, then do not pass
+ * another.  Becomes the timer thread once the whole log has been replayed.
+ */
+static void *prvReplayLoggedInterrupts( void *pvParameter );
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+/*
+ * Called by the idle task, from a critical section, to sleep until a simulated
+ * interrupt is raised.  Simulated interrupts remain masked, so the interrupt is
+ * processed when the critical section is exited.  The equivalent of a WFI
+ * instruction.
+ */
+static void prvWaitForInterrupt( void );
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+/*
+ * Process all the simulated interrupts - each represented by a bit in
+ * ulPendingInterrupts variable.
+ */
+static void prvProcessSimulatedInterrupts( void );
+
+/*
+ * Run the handlers of the pending simulated interrupts that are not masked by
+ * ulExecutionLevel, most urgent first.  Each handler runs at the level of its
+ * own priority, so only a more urgent interrupt can nest within it.  A handler
+ * that requires a context switch sets ulSwitchPending.
+ */
+static void prvRunInterruptHandlers( void );
+
+/*
+ * Set a simulated interrupt pending, noting when it was raised if
+ * configUSE_INTERRUPT_LATENCY_HISTOGRAMS is 1.
+ */
+static void prvSetInterruptPending( uint32_t ulInterruptNumber );
+
+/*
+ * Returns pdTRUE if called from a simulated interrupt handler, rather than
+ * from a task.
+ */
+static BaseType_t prvInInterruptHandler( void );
+
+/*
+ * Handler of portINTERRUPT_SIGNAL.  When configUSE_FIBER_TASKS is 1 the
+ * pending simulated interrupts are processed on the stack of the interrupted
+ * task, unless they are masked.  Otherwise the signal is only sent to the
+ * simulated interrupt handler thread, so a more urgent interrupt nests within
+ * the handler it is running.
+ */
+static void prvInterruptSignalHandler( int iSignal );
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+/*
+ * Add the time since a simulated interrupt was raised to its latency
+ * histogram.  Called as its handler is entered.
+ */
+static void prvRecordInterruptLatency( uint32_t ulInterruptNumber );
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
+/*
+ * Interrupt handlers used by the kernel itself.  These are executed from the
+ * simulated interrupt handler thread.
+ */
+static uint32_t prvProcessYieldInterrupt( void );
+static uint32_t prvProcessTickInterrupt( void );
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+/*
+ * Called on the thread that executes the tasks when a simulated interrupt is
+ * raised.  Processes the pending interrupts that are not masked, nesting them
+ * within any handler that is already running.
+ */
+static void prvProcessUnmaskedInterrupts( void );
+
+/*
+ * Entry point of the context of every task.  Called the first time the task is
+ * switched to.
+ */
+static void prvFiberEntry( void );
+
+#else /* configUSE_FIBER_TASKS */
+
+/*
+ * Entry point of every thread that executes a task.  The thread waits until
+ * the task is first selected to run before calling the task function.
+ */
+static void *prvTaskThreadEntry( void *pvParameter );
+
+/*
+ * Handler of portSUSPEND_SIGNAL.  Acknowledges the suspend request then parks
+ * the calling thread until it is resumed again.
+ */
+static void prvSuspendSignalHandler( int iSignal );
+
+/*
+ * Park the calling task thread until prvResumeThread() is called for it.  The
+ * thread exits instead of returning if the task was deleted while parked.
+ */
+static void prvWaitToRun( xThreadState *pxThreadState );
+
+/*
+ * Suspend and resume the thread that executes a task.  prvSuspendThread() does
+ * not return until the thread is parked.
+ */
+static void prvSuspendThread( void *pvTCB );
+static void prvResumeThread( void *pvTCB );
+
+/*
+ * Called from a task thread that has just raised, or unmasked, a simulated
+ * interrupt.  Does not return until the simulated interrupt handler thread has
+ * processed the interrupt, so code following a yield does not run before the
+ * context switch has occurred.  prvPrepareToWaitForInterruptProcessing() must
+ * be called first, before the simulated interrupt handler thread is signalled.
+ */
+static uint32_t prvPrepareToWaitForInterruptProcessing( void );
+static void prvWaitForInterruptProcessing( uint32_t ulProcessedCount );
+
+/*
+ * Called from a task thread when its critical nesting count has just returned
+ * to zero, to process whatever became pending for its core while the count was
+ * not zero.  Does not return until it has been processed.
+ */
+static void prvProcessMaskedInterrupts( void );
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Entry point of the thread of each core other than core 0.  Waits for the
+	 * kernel to ask the core to select a new task, then switches the task
+	 * threads over.
+	 */
+	static void *prvCoreThread( void *pvParameter );
+
+	/*
+	 * Called from a task thread as it enters the outermost critical section.
+	 * Takes the task and ISR locks, but first lets the core switch task if a
+	 * switch was requested for it while the thread was waiting for a lock, as
+	 * the kernel may have changed the state of the task in the meantime.
+	 */
+	static void prvTakeKernelLocks( void );
+
+#endif /* configNUMBER_OF_CORES */
+
+#endif /* configUSE_FIBER_TASKS */
+
+/*-----------------------------------------------------------*/
+
+/* Simulated interrupts waiting to be processed.  This is a bit mask where each
+bit represents one interrupt, so a maximum of 32 interrupts can be simulated.
+Only accessed using atomic operations. */
+static volatile uint32_t ulPendingInterrupts = 0UL;
+
+/* The number of ticks generated by the timer thread that the tick interrupt
+has not yet processed.  Only accessed using atomic operations. */
+static volatile uint32_t ulPendingTicks = 0UL;
+
+/* The simulated interrupts assigned to each priority, see
+vPortSetInterruptPriority().  Indexed by level, which is the lowest priority
+minus the priority, so the most urgent level that has a pending interrupt is
+found by counting leading zeros.  Every interrupt starts at the lowest
+priority.  Only written using atomic operations. */
+static volatile uint32_t ulInterruptsAtLevel[ portINTERRUPT_PRIORITY_LEVELS ] = { 0xffffffffUL };
+
+/* The level of each simulated interrupt, and a bit mask of the levels that
+have at least one interrupt assigned. */
+static volatile uint8_t ucInterruptLevel[ portMAX_INTERRUPTS ] = { 0 };
+static volatile uint32_t ulLevelsInUse = 0x01UL;
+
+/* Simulated interrupts at a level below this are masked.  Zero when no
+handler is running, one above the level of the handler being run, and at least
+portKERNEL_EXECUTION_LEVEL while the kernel is being accessed - the equivalent
+of the execution priority combined with BASEPRI on a Cortex-M.  Only written by
+the thread that runs the handlers. */
+static volatile uint32_t ulExecutionLevel = 0UL;
+
+/* Set by a handler that requires a context switch, and cleared as the next
+task to run is selected. */
+static volatile uint32_t ulSwitchPending = pdFALSE;
+
+/* Set while the simulated interrupts are being processed, so they are not
+processed again by a nested interrupt signal, but only nested within the
+handler being run. */
+static volatile BaseType_t xInterruptsActive = pdFALSE;
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+/* When each simulated interrupt was last raised while not already pending, and
+its latency histogram.  Only written by the thread that runs the handlers, other
+than when reset. */
+static volatile uint64_t ullInterruptRaisedNs[ portMAX_INTERRUPTS ] = { 0 };
+static PortInterruptLatency_t xInterruptLatency[ portMAX_INTERRUPTS ];
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
+/* Mutex and condition used to synchronise with the timer thread, for example
+to change when it next wakes. */
+static pthread_mutex_t xTimerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xTimerEvent;
+
+/* The time at which the next tick is due.  Protected by xTimerMutex. */
+static uint64_t ullNextTickNs = 0ULL;
+
+/* See vPortGetTickStats().  Only written with xTimerMutex held. */
+static volatile PortTickStats_t xTickStats = { 0 };
+
+/* Set while the idle task sleeps with the tick suppressed, and the time at
+which the timer thread is to wake it.  Protected by xTimerMutex.  Only used if
+configUSE_TICKLESS_IDLE is 1. */
+static BaseType_t xTicksSuppressed = pdFALSE;
+static uint64_t ullSuppressedUntilNs = 0ULL;
+
+/* The interrupts timed by vPortGenerateSimulatedInterruptAfter(), the time at
+which each is due, and the time at which the first of them is due.  Protected by
+xTimerMutex. */
+static uint32_t ulTimedInterrupts = 0UL;
+static uint64_t ullInterruptDueNs[ portMAX_INTERRUPTS ] = { 0 };
+static uint64_t ullNextInterruptDueNs = UINT64_MAX;
+
+#if( configUSE_VIRTUAL_TIME == 1 )
+
+/* How far the simulated clock is ahead of the host clock - moved on by the idle
+task, and held back when the timer thread runs late.  Protected by
+xTimerMutex. */
+static uint64_t ullSkippedNs = 0ULL;
+
+#endif /* configUSE_VIRTUAL_TIME */
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+/* See xPortRecordInterrupts() and xPortReplayInterrupts(). */
+static BaseType_t xRecordReplayMode = portNOT_RECORDING;
+
+/* The number of synchronisation points the tasks have passed.  Only written by
+the thread executing the Running state task, or by the thread processing the
+interrupts while that task is parked, using atomic operations as a task can be
+parked part way through. */
+static volatile uint64_t ullSyncPoints = 0ULL;
+
+/* Set while the interrupts raised by the Running state task itself are
+processed, the completion of which is a synchronisation point. */
+static volatile BaseType_t xSyncPointPending = pdFALSE;
+
+/* The synchronisation point of the last arrival recorded or replayed, as each
+arrival is logged relative to the one before. */
+static uint64_t ullLastSyncPoint = 0ULL;
+
+/* When recording, the interrupts raised by other host threads, and the ticks
+generated by the timer thread, that have not been delivered yet.  Only accessed
+using atomic operations. */
+static volatile uint32_t ulExternalInterrupts = 0UL;
+static volatile uint32_t ulExternalTicks = 0UL;
+
+/* When recording, the arrivals that have been encoded but not yet written to
+the log file.  The buffer is written by the thread delivering the interrupts,
+which may be doing so from a signal handler so cannot write the file itself, and
+emptied by the timer thread.  The head and tail are free running. */
+static uint8_t ucLogBuffer[ portLOG_BUFFER_SIZE ];
+static volatile uint32_t ulLogHead = 0UL;
+static volatile uint32_t ulLogTail = 0UL;
+static FILE *pxLogFile = NULL;
+static pthread_mutex_t xLogMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* When replaying, the log read from the file, how much of it has been decoded,
+and the next arrival to deliver. */
+static uint8_t *pucReplayLog = NULL;
+static size_t xReplayLogSize = 0, xReplayLogPosition = 0;
+static volatile BaseType_t xReplayEntryValid = pdFALSE;
+static volatile uint64_t ullReplaySyncPoint = 0ULL;
+static uint32_t ulReplayInterrupts = 0UL, ulReplayTicks = 0UL;
+
+/* See vPortGetRecordReplayStats(). */
+static volatile PortRecordReplayStats_t xRecordReplayStats = { 0 };
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+/* The host thread that executes all the tasks, and the simulated interrupt
+handlers. */
+static pthread_t xFiberThread;
+
+#else /* configUSE_FIBER_TASKS */
+
+/* The host thread that runs the simulated interrupt handlers. */
+static pthread_t xInterruptThread;
+
+/* Posted to inform the simulated interrupt processing thread that an interrupt
+is pending.  Only posted when the interrupt is not masked, as a critical section
+posts it as it exits if an interrupt became pending while it was masked. */
+static sem_t xInterruptEvent;
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+/* Posted when an interrupt is raised while interrupts are masked, to wake the
+idle task if it is sleeping in prvWaitForInterrupt(). */
+static sem_t xWakeEvent;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+/* Posted by a task thread once it has parked in response to
+portSUSPEND_SIGNAL. */
+static sem_t xSuspendAcknowledged;
+
+/* Incremented each time the simulated interrupt handler thread completes a
+pass over the pending interrupts. */
+static volatile uint32_t ulInterruptsProcessed = 0UL;
+
+/* The thread state of the task executed by the calling thread, or NULL if the
+calling thread is not a task thread. */
+static __thread xThreadState *pxThisThreadState = NULL;
+
+#if( configNUMBER_OF_CORES > 1 )
+
+/* The cores other than core 0.  Element 0 is not used. */
+static xCoreState xCores[ configNUMBER_OF_CORES ];
+
+/* The task lock and the ISR lock, indexed by portTASK_LOCK and portISR_LOCK. */
+static xCoreLock xLocks[ 2 ] = { { portLOCK_FREE, 0UL }, { portLOCK_FREE, 0UL } };
+
+/* The core the calling thread runs on.  The simulated interrupt handler thread
+and the thread that started the scheduler are core 0.  A task thread updates it
+each time it is resumed, which can be on a different core, but only ever while
+its critical nesting count is zero - so it cannot change while the count is
+not. */
+static __thread BaseType_t xThisCoreID = 0;
+
+/* The critical nesting count of the calling task thread, or of the other
+threads. */
+#define portCRITICAL_NESTING	( *( ( pxThisThreadState != NULL ) ? &( pxThisThreadState->ulCriticalNesting ) : &ulCriticalNesting ) )
+
+/* The critical nesting count of the task pvTCB. */
+#define portTASK_CRITICAL_NESTING( pvTCB )	( ( ( xThreadState * ) *( ( size_t * ) ( pvTCB ) ) )->ulCriticalNesting )
+
+/* The semaphore a task thread running on core xCoreID posts once parked. */
+#define portSUSPEND_ACKNOWLEDGED( xCoreID )	( ( ( xCoreID ) == 0 ) ? &xSuspendAcknowledged : &( xCores[ ( xCoreID ) ].xSuspendAcknowledged ) )
+
+#else /* configNUMBER_OF_CORES */
+
+/* All the tasks share one critical nesting count, see ulCriticalNesting. */
+#define portCRITICAL_NESTING				ulCriticalNesting
+#define portTASK_CRITICAL_NESTING( pvTCB )	ulCriticalNesting
+#define portSUSPEND_ACKNOWLEDGED( xCoreID )	( &xSuspendAcknowledged )
+
+#endif /* configNUMBER_OF_CORES */
+
+#endif /* configUSE_FIBER_TASKS */
+
+/* The critical nesting count for the currently executing task.  This is
+initialised to a non-zero value so interrupts do not become enabled during
+the initialisation phase.  As each task has its own critical nesting value
+ulCriticalNesting will get set to zero when the first task runs.  This
+initialisation is probably not critical in this simulated environment as the
+simulated interrupt handlers do not get created until the FreeRTOS scheduler is
+started anyway.  Simulated interrupts are masked while it is non-zero - it is
+only written by the thread executing the Running state task, and a task is only
+switched out while its count is zero, so one variable serves all the tasks. */
+static volatile uint32_t ulCriticalNesting = 9999UL;
+
+/* Handlers for all the simulated software interrupts.  The first two positions
+are used for the Yield and Tick interrupts so are handled slightly differently,
+all the other interrupts can be user defined. */
+static uint32_t (*ulIsrHandler[ portMAX_INTERRUPTS ])( void ) = { 0 };
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/* Pointers to the TCB of the task executing on each core.  The port only
+	switches the task of core 0 directly. */
+	extern void * volatile pxCurrentTCBs[ configNUMBER_OF_CORES ];
+	#define pxCurrentTCB	( pxCurrentTCBs[ 0 ] )
+
+#else
+
+	/* Pointer to the TCB of the currently executing task. */
+	extern void * volatile pxCurrentTCB;
+
+#endif /* configNUMBER_OF_CORES */
+
+/* Used to ensure nothing is processed during the startup sequence. */
+static volatile BaseType_t xPortRunning = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+static uint64_t prvHostTimeNs( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvSimulatedTimeNs( void )
+{
+	#if( configUSE_VIRTUAL_TIME == 1 )
+	{
+		return prvHostTimeNs() + ullSkippedNs;
+	}
+	#else
+	{
+		return prvHostTimeNs();
+	}
+	#endif /* configUSE_VIRTUAL_TIME */
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimedInterruptsDue( uint64_t ullNowNs )
+{
+uint32_t ulInterruptsDue = 0UL, ulInterruptNumber;
+
+	if( ullNowNs >= ullNextInterruptDueNs )
+	{
+		ullNextInterruptDueNs = UINT64_MAX;
+
+		for( ulInterruptNumber = 0UL; ulInterruptNumber < portMAX_INTERRUPTS; ulInterruptNumber++ )
+		{
+			if( ( ulTimedInterrupts & ( 1UL << ulInterruptNumber ) ) != 0UL )
+			{
+				if( ullInterruptDueNs[ ulInterruptNumber ] <= ullNowNs )
+				{
+					ulInterruptsDue |= ( 1UL << ulInterruptNumber );
+				}
+				else if( ullInterruptDueNs[ ulInterruptNumber ] < ullNextInterruptDueNs )
+				{
+					ullNextInterruptDueNs = ullInterruptDueNs[ ulInterruptNumber ];
+				}
+			}
+		}
+
+		ulTimedInterrupts &= ~ulInterruptsDue;
+	}
+
+	return ulInterruptsDue;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGenerateSimulatedInterrupts( uint32_t ulInterrupts )
+{
+uint32_t ulInterruptNumber;
+
+	while( ulInterrupts != 0UL )
+	{
+		ulInterruptNumber = ( uint32_t ) __builtin_ctz( ulInterrupts );
+		ulInterrupts &= ~( 1UL << ulInterruptNumber );
+		vPortGenerateSimulatedInterrupt( ulInterruptNumber );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTicksDue( uint64_t ullNowNs, uint64_t *pullNextTickNs )
+{
+uint64_t ullLatenessNs;
+uint32_t ulTicks;
+
+	/* The tick that was waited for, plus any others that also became due
+	before the thread woke. */
+	ullLatenessNs = ullNowNs - *pullNextTickNs;
+	ulTicks = ( uint32_t ) ( ullLatenessNs / portTICK_PERIOD_NS ) + 1UL;
+	*pullNextTickNs += ( uint64_t ) ulTicks * portTICK_PERIOD_NS;
+
+	xTickStats.ulTicks += ulTicks;
+	xTickStats.ulMissedTicks += ulTicks - 1UL;
+
+	if( ullLatenessNs > portTICK_LATE_NS )
+	{
+		xTickStats.ulLateTicks++;
+	}
+
+	if( ( ullLatenessNs / 1000ULL ) > xTickStats.ulMaxLatenessUs )
+	{
+		xTickStats.ulMaxLatenessUs = ( uint32_t ) ( ullLatenessNs / 1000ULL );
+	}
+
+	return ulTicks;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimerWakeTimeNs( void )
+{
+uint64_t ullWakeNs;
+
+	if( xTicksSuppressed == pdFALSE )
+	{
+		ullWakeNs = ullNextTickNs;
+	}
+	else
+	{
+		/* The idle task is sleeping, don't wake until it has to be woken. */
+		ullWakeNs = ullSuppressedUntilNs;
+	}
+
+	return ullWakeNs;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartSimulatedPeripheralTimer( void )
+{
+pthread_t xTimerThread;
+pthread_condattr_t xConditionAttributes;
+void *(*pvTimerThread)( void * ) = prvSimulatedPeripheralTimer;
+
+	/* The timer thread waits on the condition until absolute times of the
+	monotonic clock. */
+	pthread_condattr_init( &xConditionAttributes );
+	pthread_condattr_setclock( &xConditionAttributes, CLOCK_MONOTONIC );
+	pthread_cond_init( &xTimerEvent, &xConditionAttributes );
+	pthread_condattr_destroy( &xConditionAttributes );
+
+	ullNextTickNs = prvSimulatedTimeNs() + portTICK_PERIOD_NS;
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		/* When replaying, the ticks and the interrupts come from the log
+		instead. */
+		if( xRecordReplayMode == portREPLAYING )
+		{
+			pvTimerThread = prvReplayLoggedInterrupts;
+		}
+	}
+	#endif
+
+	if( pthread_create( &xTimerThread, NULL, pvTimerThread, NULL ) == 0 )
+	{
+		pthread_detach( xTimerThread );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvSimulatedPeripheralTimer( void *pvParameter )
+{
+struct timespec xWakeTime;
+uint64_t ullWakeNs, ullWaitNs, ullNowNs;
+uint32_t ulTicks = 0UL, ulInterruptsDue;
+BaseType_t xTickDue;
+
+	/* Just to prevent compiler warnings. */
+	( void ) pvParameter;
+
+	pthread_mutex_lock( &xTimerMutex );
+
+	for( ;; )
+	{
+		/* Wait until the next tick is due.  The time each tick is due is
+		relative to when the previous tick was due, not to when this thread
+		last ran, so the tick count does not drift from the host clock however
+		late the thread runs.  Also wake for the first of the timed
+		interrupts. */
+		ullWakeNs = prvTimerWakeTimeNs();
+		ullWaitNs = ( ullNextInterruptDueNs < ullWakeNs ) ? ullNextInterruptDueNs : ullWakeNs;
+
+		#if( configUSE_VIRTUAL_TIME == 1 )
+		{
+			/* The wait is timed by the host clock. */
+			ullWaitNs -= ullSkippedNs;
+		}
+		#endif /* configUSE_VIRTUAL_TIME */
+
+		xWakeTime.tv_sec = ( time_t ) ( ullWaitNs / 1000000000ULL );
+		xWakeTime.tv_nsec = ( long ) ( ullWaitNs % 1000000000ULL );
+		pthread_cond_timedwait( &xTimerEvent, &xTimerMutex, &xWakeTime );
+
+		xTickStats.ulTimerWakeups++;
+
+		/* The idle task may have suppressed, or resumed, the tick while this
+		thread waited, so the time to wake is read again. */
+		ullWakeNs = prvTimerWakeTimeNs();
+		ullNowNs = prvSimulatedTimeNs();
+
+		#if( configUSE_VIRTUAL_TIME == 1 )
+		{
+			/* If the host ran this thread late, hold the simulated clock back
+			to the time the first tick or timed interrupt was due, so they are
+			still generated one at a time, in order, rather than together.  The
+			clock can fall behind the host clock, so ullSkippedNs relies on
+			unsigned arithmetic wrapping. */
+			ullWaitNs = ( ullNextInterruptDueNs < ullWakeNs ) ? ullNextInterruptDueNs : ullWakeNs;
+
+			if( ullNowNs > ullWaitNs )
+			{
+				ullSkippedNs -= ullNowNs - ullWaitNs;
+				ullNowNs = ullWaitNs;
+			}
+		}
+		#endif /* configUSE_VIRTUAL_TIME */
+
+		ulInterruptsDue = prvTimedInterruptsDue( ullNowNs );
+		xTickDue = ( ullNowNs >= ullWakeNs ) ? pdTRUE : pdFALSE;
+
+		if( ( xTickDue == pdFALSE ) && ( ulInterruptsDue == 0UL ) )
+		{
+			/* Not due yet, or the time to wake has changed. */
+			continue;
+		}
+
+		configASSERT( xPortRunning );
+
+		if( xTickDue == pdFALSE )
+		{
+			/* Only timed interrupts are due. */
+		}
+		else if( xTicksSuppressed == pdFALSE )
+		{
+			/* If the host did not run this thread for longer than a tick
+			period more than one tick is now due.  All of them are generated by
+			the one simulated interrupt, rather than by an interrupt each, so
+			the kernel catches up in a single pass. */
+			ulTicks = prvTicksDue( ullNowNs, &ullNextTickNs );
+		}
+		else
+		{
+			/* Wake the idle task, which works out how many ticks passed while
+			it slept, so no ticks are generated here.  Don't wake again until
+			it has. */
+			ulTicks = 0UL;
+			ullSuppressedUntilNs = UINT64_MAX;
+		}
+
+		pthread_mutex_unlock( &xTimerMutex );
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* Write out the arrivals recorded since this thread last ran. */
+			if( xRecordReplayMode == portRECORDING )
+			{
+				prvWriteLog();
+			}
+		}
+		#endif
+
+		/* Generate the simulated tick event, and any timed interrupts.  This
+		thread does not execute tasks, so does not wait for the interrupts to
+		be processed. */
+		if( xTickDue != pdFALSE )
+		{
+			#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+			if( xRecordReplayMode == portRECORDING )
+			{
+				/* The ticks are held with the tick interrupt until it is
+				delivered. */
+				__atomic_fetch_add( &ulExternalTicks, ulTicks, __ATOMIC_SEQ_CST );
+			}
+			else
+			#endif
+			{
+				__atomic_fetch_add( &ulPendingTicks, ulTicks, __ATOMIC_SEQ_CST );
+			}
+
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+
+		prvGenerateSimulatedInterrupts( ulInterruptsDue );
+
+		pthread_mutex_lock( &xTimerMutex );
+	}
+
+	/* Should never reach here. */
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	/* The signal plays the role of the interrupt line, and the critical
+	nesting count that of the interrupt mask. */
+	prvProcessUnmaskedInterrupts();
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static void prvProcessUnmaskedInterrupts( void )
+{
+	if( xInterruptsActive != pdFALSE )
+	{
+		/* A handler is running, so only a more urgent interrupt is processed
+		now, nested within it. */
+		prvRunInterruptHandlers();
+	}
+	else if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+	else
+	{
+		/* The critical section masks all but the interrupts more urgent than
+		configMAX_SYSCALL_INTERRUPT_PRIORITY, which do not use the kernel so
+		cannot switch task.  The rest are processed when the critical section is
+		exited. */
+		ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+		xInterruptsActive = pdTRUE;
+		prvRunInterruptHandlers();
+		xInterruptsActive = pdFALSE;
+		ulExecutionLevel = 0UL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInInterruptHandler( void )
+{
+	/* Task code never runs while the interrupts are being processed. */
+	return xInterruptsActive;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFiberEntry( void )
+{
+xThreadState *pxThreadState = ( xThreadState * ) *( ( size_t * ) pxCurrentTCB );
+BaseType_t xExternalInterruptsWaiting = pdFALSE;
+
+	/* A task is first switched to from within prvProcessSimulatedInterrupts(),
+	so complete the processing that call would otherwise have completed. */
+	ulExecutionLevel = 0UL;
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		xExternalInterruptsWaiting = prvEndInterruptProcessing();
+	}
+	#endif
+
+	xInterruptsActive = pdFALSE;
+
+	if( ( ulPendingInterrupts != 0UL ) || ( ulSwitchPending != pdFALSE ) || ( xExternalInterruptsWaiting != pdFALSE ) )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+
+	pxThreadState->pxCode( pxThreadState->pvParameters );
+
+	/* Tasks must not return from their implementing function. */
+	configASSERT( pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+xThreadState *pxThreadState = NULL;
+int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
+
+	/* The task executes on its own stack.  The xThreadState object is placed
+	onto the top of the stack, aligned for the context it holds, and the rest
+	of the stack is used by the context itself.  Simulated interrupts are
+	processed on the stack of the interrupted task, so, as on real hardware,
+	the stack must also have room for the interrupt (signal) frame. */
+	pxThreadState = ( xThreadState * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pcTopOfStack - sizeof( xThreadState ) ) ) & ~( ( portPOINTER_SIZE_TYPE ) portCONTEXT_ALIGNMENT_MASK ) );
+	configASSERT( ( size_t ) ( ( int8_t * ) pxThreadState - ( int8_t * ) pxEndOfStack ) >= ( size_t ) MINSIGSTKSZ );
+
+	pxThreadState->pxEndOfStack = pxEndOfStack;
+	pxThreadState->pxCode = pxCode;
+	pxThreadState->pvParameters = pvParameters;
+
+	getcontext( &( pxThreadState->xContext ) );
+	pxThreadState->xContext.uc_stack.ss_sp = pxEndOfStack;
+	pxThreadState->xContext.uc_stack.ss_size = ( size_t ) ( ( int8_t * ) pxThreadState - ( int8_t * ) pxEndOfStack );
+	pxThreadState->xContext.uc_link = NULL;
+
+	/* The task may be created from a simulated interrupt handler, but must
+	not start with simulated interrupts masked by the host. */
+	sigdelset( &( pxThreadState->xContext.uc_sigmask ), portINTERRUPT_SIGNAL );
+	makecontext( &( pxThreadState->xContext ), prvFiberEntry, 0 );
+
+	return ( StackType_t * ) pxThreadState;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xInterruptAction;
+sigset_t xSignals;
+xThreadState *pxThreadState;
+int32_t lSuccess = pdPASS;
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* All the tasks execute on this thread.  The interrupt signal is blocked
+	until the first task starts, and remains blocked in the timer thread
+	created below as that inherits this thread's signal mask. */
+	xFiberThread = pthread_self();
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+	/* SA_RESTART is used so system calls made by a task are not failed by
+	the simulated interrupts, and SA_NODEFER so a more urgent interrupt can
+	nest within a handler run from the signal handler. */
+	xInterruptAction.sa_handler = prvInterruptSignalHandler;
+	xInterruptAction.sa_flags = SA_RESTART | SA_NODEFER;
+	sigemptyset( &xInterruptAction.sa_mask );
+	if( sigaction( portINTERRUPT_SIGNAL, &xInterruptAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	if( lSuccess == pdPASS )
+	{
+		xPortRunning = pdTRUE;
+
+		/* Start the thread that simulates the timer peripheral to generate
+		tick interrupts. */
+		prvStartSimulatedPeripheralTimer();
+
+		ulCriticalNesting = portNO_CRITICAL_NESTING;
+
+		/* Start the highest priority task by switching to its context, which
+		also unblocks the interrupt signal.  The context of this function is
+		not saved, so is never returned to. */
+		pxThreadState = ( xThreadState * ) *( ( size_t * ) pxCurrentTCB );
+		setcontext( &( pxThreadState->xContext ) );
+	}
+
+	/* Would not expect setcontext() to return, so should not get here. */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+#else /* configUSE_FIBER_TASKS */
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	/* Sent to this thread when an interrupt more urgent than the handler it is
+	running is raised by another thread.  The task thread is parked while the
+	interrupts are being processed, so the interrupt can nest straight away. */
+	if( xInterruptsActive != pdFALSE )
+	{
+		prvRunInterruptHandlers();
+	}
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInInterruptHandler( void )
+{
+	return ( BaseType_t ) ( pthread_equal( pthread_self(), xInterruptThread ) != 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSignalHandler( int iSignal )
+{
+xThreadState *pxThreadState = pxThisThreadState;
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	/* Tell the simulated interrupt handler thread this thread will not execute
+	any more task code, then wait to be resumed - unless the task deleted itself,
+	in which case the thread is only exiting, so must not be left parked. */
+	sem_post( portSUSPEND_ACKNOWLEDGED( xThisCoreID ) );
+
+	if( ( pxThreadState != NULL ) && ( pxThreadState->xThreadValid != pdFALSE ) )
+	{
+		prvWaitToRun( pxThreadState );
+	}
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitToRun( xThreadState *pxThreadState )
+{
+	while( sem_wait( &( pxThreadState->xResume ) ) != 0 )
+	{
+		/* Interrupted, wait again. */
+	}
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* The task may have been selected to run on a different core. */
+		xThisCoreID = pxThreadState->xCoreID;
+	}
+	#endif
+
+	if( pxThreadState->xExitRequested != pdFALSE )
+	{
+		/* The task was deleted by another task while this thread was
+		parked. */
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThreadEntry( void *pvParameter )
+{
+xThreadState *pxThreadState = ( xThreadState * ) pvParameter;
+sigset_t xSignals;
+
+	pxThisThreadState = pxThreadState;
+
+	/* Created 'suspended' - wait until the task is selected to run. */
+	prvWaitToRun( pxThreadState );
+
+	/* Only now can the thread be parked.  A suspend request made between the
+	thread being resumed and reaching this point is held pending by the signal
+	mask, and is acknowledged as soon as it is unblocked. */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portSUSPEND_SIGNAL );
+	pthread_sigmask( SIG_UNBLOCK, &xSignals, NULL );
+
+	pxThreadState->pxCode( pxThreadState->pvParameters );
+
+	/* Tasks must not return from their implementing function. */
+	configASSERT( pdFALSE );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendThread( void *pvTCB )
+{
+xThreadState *pxThreadState = ( xThreadState * ) *( ( size_t * ) pvTCB );
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		if( pxThreadState->xParkedOnYield != pdFALSE )
+		{
+			/* The thread has parked itself, or is about to, on its resume
+			semaphore, so there is nothing to suspend.  It will run again when
+			prvResumeThread() next posts the semaphore. */
+			pxThreadState->xParkedOnYield = pdFALSE;
+			return;
+		}
+	}
+	#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+
+	/* The thread will not be valid if the task deleted itself. */
+	if( pxThreadState->xThreadValid != pdFALSE )
+	{
+		pthread_kill( pxThreadState->xThread, portSUSPEND_SIGNAL );
+
+		/* Wait until the thread is actually parked, in the same way the
+		Windows port uses GetThreadContext() to synchronise with
+		SuspendThread(). */
+		while( sem_wait( portSUSPEND_ACKNOWLEDGED( xThisCoreID ) ) != 0 )
+		{
+			/* Interrupted, wait again. */
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeThread( void *pvTCB )
+{
+xThreadState *pxThreadState = ( xThreadState * ) *( ( size_t * ) pvTCB );
+
+	if( pxThreadState->xThreadValid != pdFALSE )
+	{
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The thread runs the task on the core of the calling thread. */
+			pxThreadState->xCoreID = xThisCoreID;
+		}
+		#endif
+
+		sem_post( &( pxThreadState->xResume ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+xThreadState *pxThreadState = NULL;
+int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
+pthread_attr_t xThreadAttributes;
+sigset_t xSignals, xPreviousSignals;
+int iResult;
+
+	/* In this simulated case a stack is not initialised, but instead a thread
+	is created that will execute the task being created.  The thread handles
+	the context switching itself.  The xThreadState object is placed onto
+	the stack that was created for the task - so the stack buffer is still
+	used, just not in the conventional way.  It will not be used for anything
+	other than holding this structure. */
+	pxThreadState = ( xThreadState * ) ( pcTopOfStack - sizeof( xThreadState ) );
+	pxThreadState->pxCode = pxCode;
+	pxThreadState->pvParameters = pvParameters;
+	pxThreadState->xThreadValid = pdTRUE;
+	pxThreadState->xExitRequested = pdFALSE;
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		pxThreadState->xParkedOnYield = pdFALSE;
+	}
+	#endif
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		pxThreadState->ulCriticalNesting = portNO_CRITICAL_NESTING;
+		pxThreadState->xCoreID = 0;
+	}
+	#endif
+	sem_init( &( pxThreadState->xResume ), 0, 0 );
+
+	/* The thread is created with the suspend signal blocked, see
+	prvTaskThreadEntry(). */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portSUSPEND_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+
+	/* Create the thread itself.  The thread will not execute the task until
+	prvResumeThread() is called. */
+	pthread_attr_init( &xThreadAttributes );
+	pthread_attr_setstacksize( &xThreadAttributes, portTASK_THREAD_STACK_SIZE );
+	iResult = pthread_create( &( pxThreadState->xThread ), &xThreadAttributes, prvTaskThreadEntry, pxThreadState );
+	configASSERT( iResult == 0 ); /* See comment where pthread_join() is called. */
+	pthread_attr_destroy( &xThreadAttributes );
+
+	pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+
+	( void ) iResult;
+
+	return ( StackType_t * ) pxThreadState;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xSuspendAction, xInterruptAction;
+sigset_t xSignals;
+int32_t lSuccess = pdPASS;
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* Create the semaphores that are used to synchronise all the threads. */
+	if( ( sem_init( &xInterruptEvent, 0, 0 ) != 0 ) || ( sem_init( &xSuspendAcknowledged, 0, 0 ) != 0 ) )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	#if( configUSE_TICKLESS_IDLE == 1 )
+	{
+		if( sem_init( &xWakeEvent, 0, 0 ) != 0 )
+		{
+			lSuccess = pdFAIL;
+		}
+	}
+	#endif
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+	BaseType_t xCoreID;
+
+		for( xCoreID = 1; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+		{
+			xCores[ xCoreID ].xSwitchRequested = pdFALSE;
+			xCores[ xCoreID ].ulSwitchesProcessed = 0UL;
+
+			if( ( sem_init( &( xCores[ xCoreID ].xSwitchEvent ), 0, 0 ) != 0 ) || ( sem_init( &( xCores[ xCoreID ].xSuspendAcknowledged ), 0, 0 ) != 0 ) )
+			{
+				lSuccess = pdFAIL;
+			}
+		}
+	}
+	#endif
+
+	/* Install the handler task threads use to park themselves.  SA_RESTART is
+	used so system calls made by a task are not failed by the suspension. */
+	xSuspendAction.sa_handler = prvSuspendSignalHandler;
+	xSuspendAction.sa_flags = SA_RESTART;
+	sigemptyset( &xSuspendAction.sa_mask );
+	if( sigaction( portSUSPEND_SIGNAL, &xSuspendAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	/* Install the handler used to nest a more urgent simulated interrupt
+	within the handler this thread is running.  SA_NODEFER lets an even more
+	urgent one nest within that. */
+	xInterruptThread = pthread_self();
+	xInterruptAction.sa_handler = prvInterruptSignalHandler;
+	xInterruptAction.sa_flags = SA_RESTART | SA_NODEFER;
+	sigemptyset( &xInterruptAction.sa_mask );
+	if( sigaction( portINTERRUPT_SIGNAL, &xInterruptAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	if( lSuccess == pdPASS )
+	{
+		/* Neither this thread, which becomes the simulated interrupt handler
+		thread, nor the timer thread it creates, execute task code so neither
+		must ever be parked. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portSUSPEND_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+		/* Start the thread that simulates the timer peripheral to generate
+		tick interrupts. */
+		prvStartSimulatedPeripheralTimer();
+
+		ulCriticalNesting = portNO_CRITICAL_NESTING;
+
+		/* Handle all simulated interrupts - including yield requests and
+		simulated ticks. */
+		prvProcessSimulatedInterrupts();
+	}
+
+	/* Would not expect to return from prvProcessSimulatedInterrupts(), so should
+	not get here. */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_FIBER_TASKS */
+
+static uint32_t prvProcessYieldInterrupt( void )
+{
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessTickInterrupt( void )
+{
+uint32_t ulSwitchRequired = pdFALSE, ulTicks;
+UBaseType_t uxSavedInterruptStatus;
+
+	/* Process every tick generated since the tick interrupt last ran, which is
+	more than one if the timer thread had to catch up, or the interrupt was
+	held pending by a critical section. */
+	configASSERT( xPortRunning );
+	ulTicks = __atomic_exchange_n( &ulPendingTicks, 0UL, __ATOMIC_SEQ_CST );
+
+	/* The kernel is updated with the interrupts that can use the API masked,
+	as xPortSysTickHandler() does on a Cortex-M. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	while( ulTicks > 0UL )
+	{
+		ulSwitchRequired |= ( uint32_t ) xTaskIncrementTick();
+		ulTicks--;
+	}
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ulSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetInterruptPending( uint32_t ulInterruptNumber )
+{
+	#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+	{
+		/* An interrupt raised again before it is processed is only processed
+		once, so its latency is measured from when it was first raised. */
+		if( ( ulPendingInterrupts & ( 1UL << ulInterruptNumber ) ) == 0UL )
+		{
+			ullInterruptRaisedNs[ ulInterruptNumber ] = prvHostTimeNs();
+		}
+	}
+	#endif
+
+	__atomic_fetch_or( &ulPendingInterrupts, ( 1UL << ulInterruptNumber ), __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunInterruptHandlers( void )
+{
+uint32_t ulSavedLevel = ulExecutionLevel, ulLevels, ulLevel = 0UL, ulPending, ulInterrupts, ulInterruptNumber, ulInterruptBit;
+
+	for( ;; )
+	{
+		/* Find the most urgent level that is not masked and has an interrupt
+		pending.  Only the levels in use are searched, most urgent first. */
+		ulPending = __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST );
+		ulLevels = ulLevelsInUse & portUNMASKED_LEVELS( ulSavedLevel );
+		ulInterrupts = 0UL;
+
+		while( ( ulInterrupts == 0UL ) && ( ulLevels != 0UL ) )
+		{
+			ulLevel = 31UL - ( uint32_t ) __builtin_clz( ulLevels );
+			ulInterrupts = ulPending & ulInterruptsAtLevel[ ulLevel ];
+			ulLevels &= ~( 1UL << ulLevel );
+		}
+
+		if( ulInterrupts == 0UL )
+		{
+			/* Nothing that is not masked is pending. */
+			break;
+		}
+
+		/* Interrupts of equal priority are processed in interrupt number
+		order.  Clear the pending bit before running the handler, so the
+		interrupt can be raised again by the time the handler completes - unless
+		a nested handler already has. */
+		ulInterruptNumber = ( uint32_t ) __builtin_ctz( ulInterrupts );
+		ulInterruptBit = 1UL << ulInterruptNumber;
+
+		if( ( __atomic_fetch_and( &ulPendingInterrupts, ~ulInterruptBit, __ATOMIC_SEQ_CST ) & ulInterruptBit ) == 0UL )
+		{
+			continue;
+		}
+
+		#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+		{
+			prvRecordInterruptLatency( ulInterruptNumber );
+		}
+		#endif
+
+		if( ulIsrHandler[ ulInterruptNumber ] != NULL )
+		{
+			/* Run the handler at the level of its priority, so only a more
+			urgent interrupt can nest within it. */
+			ulExecutionLevel = ulLevel + 1UL;
+			__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+			if( ulIsrHandler[ ulInterruptNumber ]() != pdFALSE )
+			{
+				ulSwitchPending = pdTRUE;
+			}
+
+			__atomic_signal_fence( __ATOMIC_SEQ_CST );
+			ulExecutionLevel = ulSavedLevel;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+static void prvRecordInterruptLatency( uint32_t ulInterruptNumber )
+{
+PortInterruptLatency_t *pxLatency = &( xInterruptLatency[ ulInterruptNumber ] );
+uint64_t ullNowNs = prvHostTimeNs(), ullRaisedNs = ullInterruptRaisedNs[ ulInterruptNumber ];
+uint32_t ulLatencyNs = 0UL;
+
+	/* The time may have been overwritten by the interrupt being raised again
+	after its pending bit was cleared, in which case the latency counts as 0. */
+	if( ullNowNs > ullRaisedNs )
+	{
+		if( ( ullNowNs - ullRaisedNs ) < ( uint64_t ) UINT32_MAX )
+		{
+			ulLatencyNs = ( uint32_t ) ( ullNowNs - ullRaisedNs );
+		}
+		else
+		{
+			ulLatencyNs = UINT32_MAX;
+		}
+	}
+
+	pxLatency->ulCount++;
+	pxLatency->ulBuckets[ 31UL - ( uint32_t ) __builtin_clz( ulLatencyNs | 1UL ) ]++;
+
+	if( ulLatencyNs > pxLatency->ulMaxNs )
+	{
+		pxLatency->ulMaxNs = ulLatencyNs;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetInterruptLatency( uint32_t ulInterruptNumber, PortInterruptLatency_t *pxLatency )
+{
+	configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		portENTER_CRITICAL();
+		*pxLatency = xInterruptLatency[ ulInterruptNumber ];
+		portEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetInterruptLatency( uint32_t ulInterruptNumber )
+{
+	configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		portENTER_CRITICAL();
+		memset( &( xInterruptLatency[ ulInterruptNumber ] ), 0x00, sizeof( PortInterruptLatency_t ) );
+		portEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority )
+{
+uint32_t ulOldLevel, ulNewLevel, ulInterruptBit;
+
+	configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+	configASSERT( ulPriority < portINTERRUPT_PRIORITY_LEVELS );
+
+	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( ulPriority < portINTERRUPT_PRIORITY_LEVELS ) )
+	{
+		ulInterruptBit = 1UL << ulInterruptNumber;
+		ulNewLevel = portPRIORITY_TO_LEVEL( ulPriority );
+
+		/* The interrupts that are not masked by a critical section can read
+		the levels at any time, so the interrupt is added to its new level
+		before it is removed from its old one, and is never at neither. */
+		portENTER_CRITICAL();
+		{
+			ulOldLevel = ucInterruptLevel[ ulInterruptNumber ];
+			__atomic_fetch_or( &( ulInterruptsAtLevel[ ulNewLevel ] ), ulInterruptBit, __ATOMIC_SEQ_CST );
+			__atomic_fetch_or( &ulLevelsInUse, ( 1UL << ulNewLevel ), __ATOMIC_SEQ_CST );
+			ucInterruptLevel[ ulInterruptNumber ] = ( uint8_t ) ulNewLevel;
+
+			if( ulOldLevel != ulNewLevel )
+			{
+				if( ( __atomic_and_fetch( &( ulInterruptsAtLevel[ ulOldLevel ] ), ~ulInterruptBit, __ATOMIC_SEQ_CST ) ) == 0UL )
+				{
+					__atomic_fetch_and( &ulLevelsInUse, ~( 1UL << ulOldLevel ), __ATOMIC_SEQ_CST );
+				}
+			}
+		}
+		portEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t ulPortSetInterruptMaskFromISR( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	if( prvInInterruptHandler() != pdFALSE )
+	{
+		/* Raise the execution level so only the interrupts that do not use
+		the API can nest. */
+		uxSavedInterruptStatus = ( UBaseType_t ) ulExecutionLevel;
+
+		if( ulExecutionLevel < portKERNEL_EXECUTION_LEVEL )
+		{
+			ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+		}
+
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The other cores may be using the kernel at the same time. */
+			vPortGetLock( portISR_LOCK );
+		}
+		#endif
+	}
+	else
+	{
+		vPortEnterCritical();
+		uxSavedInterruptStatus = portTASK_INTERRUPT_MASK;
+	}
+
+	return uxSavedInterruptStatus;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedInterruptStatus )
+{
+	if( uxSavedInterruptStatus == portTASK_INTERRUPT_MASK )
+	{
+		vPortExitCritical();
+	}
+	else
+	{
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			vPortReleaseLock( portISR_LOCK );
+		}
+		#endif
+
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		ulExecutionLevel = ( uint32_t ) uxSavedInterruptStatus;
+
+		/* Process any interrupt that became pending while it was masked and is
+		more urgent than the handler. */
+		if( ulPendingInterrupts != 0UL )
+		{
+			prvRunInterruptHandlers();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+static void prvProcessSimulatedInterrupts( void )
+{
+void *pvOldCurrentTCB;
+xThreadState *pxOldThreadState, *pxNewThreadState;
+BaseType_t xExternalInterruptsWaiting;
+
+	/* This executes on the stack of the task that was running when the
+	interrupts were raised, with the simulated interrupts unmasked and not
+	already being processed. */
+	do
+	{
+		xInterruptsActive = pdTRUE;
+		xExternalInterruptsWaiting = pdFALSE;
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			prvTakeExternalInterrupts();
+		}
+		#endif
+
+		while( ( ulPendingInterrupts != 0UL ) || ( ulSwitchPending != pdFALSE ) )
+		{
+			/* Run the handlers, most urgent first.  An interrupt raised while
+			they run is processed in the same pass. */
+			prvRunInterruptHandlers();
+
+			if( ulSwitchPending != pdFALSE )
+			{
+				/* Select the next task to run.  Only the interrupts that do not
+				use the API can nest within the switch. */
+				ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+				ulSwitchPending = pdFALSE;
+				pvOldCurrentTCB = pxCurrentTCB;
+				vTaskSwitchContext();
+
+				if( pvOldCurrentTCB != pxCurrentTCB )
+				{
+					pxOldThreadState = ( xThreadState * ) *( ( size_t * ) pvOldCurrentTCB );
+					pxNewThreadState = ( xThreadState * ) *( ( size_t * ) pxCurrentTCB );
+
+					/* The task being switched out is at about its deepest
+					stack use, as the interrupt frame is on its stack too, so
+					this is where to check the stack has not overflowed. */
+					configASSERT( ( int8_t * ) &pxOldThreadState > ( int8_t * ) pxOldThreadState->pxEndOfStack );
+
+					swapcontext( &( pxOldThreadState->xContext ), &( pxNewThreadState->xContext ) );
+
+					/* Execution continues from here when the switched out task
+					is next selected to run. */
+				}
+
+				ulExecutionLevel = 0UL;
+			}
+		}
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* This may be completing the processing started by a different
+			task, before it was switched out. */
+			xExternalInterruptsWaiting = prvEndInterruptProcessing();
+		}
+		#endif
+
+		xInterruptsActive = pdFALSE;
+
+	/* An interrupt signal received just before xInterruptsActive was cleared
+	will have left its interrupt pending. */
+	} while( ( ulPendingInterrupts != 0UL ) || ( ulSwitchPending != pdFALSE ) || ( xExternalInterruptsWaiting != pdFALSE ) );
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+	/* The context of the task is held on the task stack, so nothing other
+	than the stack needs to be freed. */
+	( void ) pvTaskToDelete;
+}
+/*-----------------------------------------------------------*/
+
+void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+	/* The task is no longer in a list the scheduler selects from, so once the
+	yield that follows this call switches away from it, its context is never
+	switched to again.  Its stack is not freed until the idle task runs, by
+	which time the context is no longer in use. */
+	( void ) pvTaskToDelete;
+	*pxPendYield = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+#else /* configUSE_FIBER_TASKS */
+
+static void prvProcessSimulatedInterrupts( void )
+{
+void *pvOldCurrentTCB;
+
+	/* Create a pending tick to ensure the first task is started as soon as
+	this thread pends. */
+	prvSetInterruptPending( portINTERRUPT_TICK );
+	sem_post( &xInterruptEvent );
+
+	xPortRunning = pdTRUE;
+
+	/* Start the highest priority task by resuming the thread associated with
+	it. */
+	prvResumeThread( pxCurrentTCB );
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+	BaseType_t xCoreID;
+	int iResult;
+
+		/* Start the other cores, each of which starts its own first task.
+		Like this thread, the core threads must never be parked, which they
+		inherit from this thread. */
+		for( xCoreID = 1; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+		{
+			iResult = pthread_create( &( xCores[ xCoreID ].xThread ), NULL, prvCoreThread, ( void * ) xCoreID );
+			configASSERT( iResult == 0 );
+			( void ) iResult;
+		}
+	}
+	#endif
+
+	for(;;)
+	{
+		/* Wait for the event that signals that a simulated interrupt should
+		be processed. */
+		while( sem_wait( &xInterruptEvent ) != 0 )
+		{
+			/* Interrupted, wait again. */
+		}
+
+		/* Unlike a Windows thread running at a lower priority on the same
+		core, the task thread would otherwise keep running in parallel with the
+		interrupt handlers, so park it for the duration of the simulated
+		interrupt. */
+		pvOldCurrentTCB = pxCurrentTCB;
+		prvSuspendThread( pvOldCurrentTCB );
+
+		if( portTASK_CRITICAL_NESTING( pvOldCurrentTCB ) != portNO_CRITICAL_NESTING )
+		{
+			/* The task was parked inside a critical section, which masks all
+			but the interrupts more urgent than
+			configMAX_SYSCALL_INTERRUPT_PRIORITY.  The rest remain pending, and
+			the task posts the event again when it exits the critical
+			section. */
+			ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+			xInterruptsActive = pdTRUE;
+			prvRunInterruptHandlers();
+			xInterruptsActive = pdFALSE;
+			ulExecutionLevel = 0UL;
+
+			prvResumeThread( pvOldCurrentTCB );
+			continue;
+		}
+
+		/* Run the handlers, most urgent first.  An interrupt raised while
+		they run is processed in the same pass, nesting within any less urgent
+		handler. */
+		xInterruptsActive = pdTRUE;
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			prvTakeExternalInterrupts();
+		}
+		#endif
+
+		prvRunInterruptHandlers();
+
+		/* Select the next task to run if a handler requires it.  Only the
+		interrupts that do not use the API can nest within the switch. */
+		ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+
+		if( ulSwitchPending != pdFALSE )
+		{
+			ulSwitchPending = pdFALSE;
+			vTaskSwitchContext();
+		}
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* Arrivals that could not be delivered with interrupts the task
+			raised itself are delivered by another pass. */
+			if( prvEndInterruptProcessing() != pdFALSE )
+			{
+				sem_post( &xInterruptEvent );
+			}
+		}
+		#endif
+
+		ulExecutionLevel = 0UL;
+		xInterruptsActive = pdFALSE;
+
+		/* Resume the thread of the task that is now in the Running state,
+		which may or may not be the thread that was parked above. */
+		ulInterruptsProcessed++;
+		prvResumeThread( pxCurrentTCB );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUMBER_OF_CORES > 1 )
+
+static void *prvCoreThread( void *pvParameter )
+{
+BaseType_t xCoreID = ( BaseType_t ) pvParameter;
+xCoreState *pxCore = &( xCores[ xCoreID ] );
+void *pvOldCurrentTCB;
+
+	xThisCoreID = xCoreID;
+
+	/* Start the task selected for this core by vTaskStartScheduler(). */
+	prvResumeThread( pxCurrentTCBs[ xCoreID ] );
+
+	for( ;; )
+	{
+		while( sem_wait( &( pxCore->xSwitchEvent ) ) != 0 )
+		{
+			/* Interrupted, wait again. */
+		}
+
+		if( pxCore->xSwitchRequested != pdFALSE )
+		{
+			/* Park the task thread, as the simulated interrupt handler thread
+			does, then switch unless the task is in a critical section - in
+			which case it posts the event again as it exits. */
+			pvOldCurrentTCB = pxCurrentTCBs[ xCoreID ];
+			prvSuspendThread( pvOldCurrentTCB );
+
+			if( portTASK_CRITICAL_NESTING( pvOldCurrentTCB ) == portNO_CRITICAL_NESTING )
+			{
+				pxCore->xSwitchRequested = pdFALSE;
+				vTaskSwitchContext();
+			}
+
+			pxCore->ulSwitchesProcessed++;
+			prvResumeThread( pxCurrentTCBs[ xCoreID ] );
+		}
+		else
+		{
+			/* The request was already handled, but a task thread may be
+			waiting for the count to change. */
+			pxCore->ulSwitchesProcessed++;
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeKernelLocks( void )
+{
+BaseType_t xSwitchRequested, xTaskLockHeld;
+
+	for( ;; )
+	{
+		/* If the task lock is already held the scheduler is suspended, so the
+		core would not switch task anyway. */
+		xTaskLockHeld = ( xLocks[ portTASK_LOCK ].xOwner == xThisCoreID ) ? pdTRUE : pdFALSE;
+
+		vPortGetLock( portTASK_LOCK );
+		vPortGetLock( portISR_LOCK );
+
+		if( xThisCoreID == 0 )
+		{
+			xSwitchRequested = ( ( __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST ) & ( 1UL << portINTERRUPT_YIELD ) ) != 0UL ) ? pdTRUE : pdFALSE;
+		}
+		else
+		{
+			xSwitchRequested = xCores[ xThisCoreID ].xSwitchRequested;
+		}
+
+		if( ( xSwitchRequested == pdFALSE ) || ( xTaskLockHeld != pdFALSE ) )
+		{
+			break;
+		}
+
+		/* Back off, and let the switch happen before trying again. */
+		vPortReleaseLock( portISR_LOCK );
+		vPortReleaseLock( portTASK_LOCK );
+		__atomic_store_n( &( pxThisThreadState->ulCriticalNesting ), portNO_CRITICAL_NESTING, __ATOMIC_SEQ_CST );
+		prvProcessMaskedInterrupts();
+		pxThisThreadState->ulCriticalNesting = portNO_CRITICAL_NESTING + 1;
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	}
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetCoreID( void )
+{
+	return xThisCoreID;
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldCore( BaseType_t xCoreID )
+{
+BaseType_t xPost;
+
+	/* A task thread running on the core itself must be in a critical section,
+	so the switch is made as it exits, see prvProcessMaskedInterrupts(). */
+	xPost = ( ( pxThisThreadState == NULL ) || ( xThisCoreID != xCoreID ) ) ? pdTRUE : pdFALSE;
+
+	if( xCoreID == 0 )
+	{
+		/* Core 0 switches task in response to the yield interrupt. */
+		prvSetInterruptPending( portINTERRUPT_YIELD );
+
+		if( xPost != pdFALSE )
+		{
+			sem_post( &xInterruptEvent );
+		}
+	}
+	else
+	{
+		__atomic_store_n( &( xCores[ xCoreID ].xSwitchRequested ), pdTRUE, __ATOMIC_SEQ_CST );
+
+		if( xPost != pdFALSE )
+		{
+			sem_post( &( xCores[ xCoreID ].xSwitchEvent ) );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetLock( BaseType_t xLock )
+{
+xCoreLock *pxLock = &( xLocks[ xLock ] );
+BaseType_t xFree;
+
+	if( pxLock->xOwner == xThisCoreID )
+	{
+		/* The lock is recursive. */
+		pxLock->ulCount++;
+	}
+	else
+	{
+		for( ;; )
+		{
+			xFree = portLOCK_FREE;
+
+			if( __atomic_compare_exchange_n( &( pxLock->xOwner ), &xFree, xThisCoreID, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) != pdFALSE )
+			{
+				break;
+			}
+
+			/* The holder may be waiting for a host CPU. */
+			sched_yield();
+		}
+
+		pxLock->ulCount = 1UL;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortReleaseLock( BaseType_t xLock )
+{
+xCoreLock *pxLock = &( xLocks[ xLock ] );
+
+	configASSERT( pxLock->xOwner == xThisCoreID );
+
+	pxLock->ulCount--;
+
+	if( pxLock->ulCount == 0UL )
+	{
+		__atomic_store_n( &( pxLock->xOwner ), portLOCK_FREE, __ATOMIC_RELEASE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t ulPortSetInterruptMask( void )
+{
+	/* Only a task thread can be switched out, so the other threads have
+	nothing to mask. */
+	if( pxThisThreadState != NULL )
+	{
+		pxThisThreadState->ulCriticalNesting++;
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	}
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxSavedInterruptStatus )
+{
+	( void ) uxSavedInterruptStatus;
+
+	if( pxThisThreadState != NULL )
+	{
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+		if( __atomic_sub_fetch( &( pxThisThreadState->ulCriticalNesting ), 1UL, __ATOMIC_SEQ_CST ) == portNO_CRITICAL_NESTING )
+		{
+			prvProcessMaskedInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_CORES */
+
+static void prvProcessMaskedInterrupts( void )
+{
+uint32_t ulProcessedCount = 0UL;
+BaseType_t xInterruptsWaiting;
+
+	#if( configNUMBER_OF_CORES > 1 )
+	if( ( pxThisThreadState != NULL ) && ( xThisCoreID != 0 ) )
+	{
+	xCoreState *pxCore = &( xCores[ xThisCoreID ] );
+
+		/* The other cores only take the switch requests made by the kernel.
+		As with an interrupt, the task must not continue until its core has
+		switched. */
+		if( pxCore->xSwitchRequested != pdFALSE )
+		{
+			ulProcessedCount = pxCore->ulSwitchesProcessed;
+			sem_post( &( pxCore->xSwitchEvent ) );
+
+			while( pxCore->ulSwitchesProcessed == ulProcessedCount )
+			{
+				sched_yield();
+			}
+		}
+	}
+	else
+	#endif /* configNUMBER_OF_CORES */
+	{
+		/* Check whether any interrupts were set pending while they were
+		masked.  The interrupt handler thread is only signalled if one was, so
+		the usual case makes no host call. */
+		xInterruptsWaiting = ( __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST ) != 0UL ) ? pdTRUE : pdFALSE;
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* Or arrived from another host thread, and are held until now. */
+			if( ( xInterruptsWaiting == pdFALSE ) && ( pxThisThreadState != NULL ) )
+			{
+				xInterruptsWaiting = prvExternalInterruptsWaiting();
+			}
+		}
+		#endif
+
+		if( xInterruptsWaiting != pdFALSE )
+		{
+			configASSERT( xPortRunning );
+
+			/* As when the interrupt is raised, a task must not continue until
+			the interrupts it unmasked have been processed. */
+			if( pxThisThreadState != NULL )
+			{
+				ulProcessedCount = prvPrepareToWaitForInterruptProcessing();
+				sem_post( &xInterruptEvent );
+				prvWaitForInterruptProcessing( ulProcessedCount );
+			}
+			else
+			{
+				sem_post( &xInterruptEvent );
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPrepareToWaitForInterruptProcessing( void )
+{
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		/* Tell the simulated interrupt handler thread that this thread will
+		park itself, so it is not sent the suspend signal. */
+		pxThisThreadState->xParkedOnYield = pdTRUE;
+	}
+	#endif
+
+	return ulInterruptsProcessed;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForInterruptProcessing( uint32_t ulProcessedCount )
+{
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		/* Park on this thread's own semaphore.  The simulated interrupt
+		handler thread posts it directly, either straight away if this task
+		remains the Running state task, or once the task is selected to run
+		again. */
+		( void ) ulProcessedCount;
+		prvWaitToRun( pxThisThreadState );
+	}
+	#else
+	{
+		/* The simulated interrupt handler thread parks this thread as it
+		starts processing the interrupt, so by the time the count changes this
+		thread has either been resumed, or not run again until the task it
+		executes was selected to run again. */
+		while( ulInterruptsProcessed == ulProcessedCount )
+		{
+			sched_yield();
+		}
+	}
+	#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+xThreadState *pxThreadState;
+int iErrorCode;
+
+	/* Remove compiler warnings if configASSERT() is not defined. */
+	( void ) iErrorCode;
+
+	/* Find the handle of the thread being deleted. */
+	pxThreadState = ( xThreadState * ) ( *( size_t *) pvTaskToDelete );
+
+	/* Check that the thread is still valid, it might have been closed by
+	vPortCloseRunningThread() - which will be the case if the task associated
+	with the thread originally deleted itself rather than being deleted by a
+	different task. */
+	if( pxThreadState->xThreadValid != pdFALSE )
+	{
+		vPortEnterCritical();
+
+		/* The thread is parked, either in prvTaskThreadEntry() or in
+		prvSuspendSignalHandler().  Ask it to exit and wait until it has, as the
+		structure it is parked on is freed along with the task stack as soon as
+		this function returns.  !!! As with TerminateThread() in the Windows
+		port, any host resource the thread held when it was parked, such as the
+		stdio lock, is never released. */
+		pxThreadState->xExitRequested = pdTRUE;
+		sem_post( &( pxThreadState->xResume ) );
+
+		iErrorCode = pthread_join( pxThreadState->xThread, NULL );
+		configASSERT( iErrorCode == 0 );
+
+		pxThreadState->xThreadValid = pdFALSE;
+
+		vPortExitCritical();
+	}
+
+	sem_destroy( &( pxThreadState->xResume ) );
+}
+/*-----------------------------------------------------------*/
+
+void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+xThreadState *pxThreadState;
+
+	/* Find the handle of the thread being deleted. */
+	pxThreadState = ( xThreadState * ) ( *( size_t *) pvTaskToDelete );
+
+	/* This function will not return, therefore a yield is set as pending to
+	ensure a context switch occurs away from this thread on the next tick. */
+	*pxPendYield = pdTRUE;
+
+	/* Mark the thread associated with this task as invalid so
+	vPortDeleteThread() does not try to terminate it, and the simulated
+	interrupt handler does not try to park it.  A suspend signal already on its
+	way is acknowledged without parking, see prvSuspendSignalHandler(), as
+	otherwise the thread would never run again and effectively be a thread and
+	memory leak. */
+	__atomic_store_n( &( pxThreadState->xThreadValid ), pdFALSE, __ATOMIC_SEQ_CST );
+	pthread_detach( pthread_self() );
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* This is called from a critical section, which must be exited before
+		the thread stops, and the core asked to select another task - the
+		task thread cannot wait for that, as its core would park it. */
+		vPortReleaseLock( portISR_LOCK );
+		vPortReleaseLock( portTASK_LOCK );
+		pxThreadState->ulCriticalNesting = portNO_CRITICAL_NESTING;
+		pxThisThreadState = NULL;
+		vPortYieldCore( xThisCoreID );
+	}
+	#else
+	{
+		/* This is called from a critical section, which must be exited before
+		the thread stops. */
+		pxThisThreadState = NULL;
+		taskEXIT_CRITICAL();
+	}
+	#endif
+
+	pthread_exit( NULL );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_FIBER_TASKS */
+
+void vPortGetTickStats( PortTickStats_t *pxStats )
+{
+	pxStats->ulTicks = xTickStats.ulTicks;
+	pxStats->ulLateTicks = xTickStats.ulLateTicks;
+	pxStats->ulMissedTicks = xTickStats.ulMissedTicks;
+	pxStats->ulMaxLatenessUs = xTickStats.ulMaxLatenessUs;
+	pxStats->ulTimerWakeups = xTickStats.ulTimerWakeups;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetSimulatedTimeNs( void )
+{
+	return prvSimulatedTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetRunTimeNs( void )
+{
+	return prvHostTimeNs();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterruptAfter( uint32_t ulInterruptNumber, uint64_t ullDelayNs )
+{
+sigset_t xSignals, xPreviousSignals;
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		/* A simulated interrupt handler that preempted this thread while it
+		held the mutex could not take it. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+		pthread_mutex_lock( &xTimerMutex );
+
+		ullInterruptDueNs[ ulInterruptNumber ] = prvSimulatedTimeNs() + ullDelayNs;
+		ulTimedInterrupts |= ( 1UL << ulInterruptNumber );
+
+		/* If it is due before the timer thread next wakes, wake it now to
+		wait for the new time. */
+		if( ullInterruptDueNs[ ulInterruptNumber ] < ullNextInterruptDueNs )
+		{
+			ullNextInterruptDueNs = ullInterruptDueNs[ ulInterruptNumber ];
+			pthread_cond_signal( &xTimerEvent );
+		}
+
+		pthread_mutex_unlock( &xTimerMutex );
+		pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+static void prvTakeExternalInterrupts( void )
+{
+uint32_t ulInterrupts = 0UL, ulTicks = 0UL, ulHead;
+
+	if( xRecordReplayMode == portNOT_RECORDING )
+	{
+		/* Interrupts raised by other host threads are delivered as they
+		arrive. */
+	}
+	else if( __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST ) != 0UL )
+	{
+		/* Only the task can have raised these, as the interrupts raised by
+		other host threads are held until they are delivered here.  They are
+		processed on their own, and the synchronisation point counted once they
+		have been, so an arrival is never delivered part way through. */
+		xSyncPointPending = pdTRUE;
+	}
+	else if( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED )
+	{
+		/* vTaskSuspendAll() is not a critical section, but an arrival is still
+		held until xTaskResumeAll() completes, as the kernel state it finds
+		would otherwise depend on how far between the two the task had got. */
+	}
+	else if( xRecordReplayMode == portRECORDING )
+	{
+		ulInterrupts = __atomic_exchange_n( &ulExternalInterrupts, 0UL, __ATOMIC_SEQ_CST );
+
+		if( ( ulInterrupts & ( 1UL << portINTERRUPT_TICK ) ) != 0UL )
+		{
+			ulTicks = __atomic_exchange_n( &ulExternalTicks, 0UL, __ATOMIC_SEQ_CST );
+		}
+
+		if( ulInterrupts != 0UL )
+		{
+			/* The entry is only made visible to the timer thread once it is
+			complete, so the log never ends part way through one. */
+			ulHead = ulLogHead;
+			prvLogValue( &ulHead, ullSyncPoints - ullLastSyncPoint );
+			prvLogValue( &ulHead, ( uint64_t ) ulInterrupts );
+
+			if( ( ulInterrupts & ( 1UL << portINTERRUPT_TICK ) ) != 0UL )
+			{
+				prvLogValue( &ulHead, ( uint64_t ) ulTicks );
+			}
+
+			__atomic_store_n( &ulLogHead, ulHead, __ATOMIC_RELEASE );
+			ullLastSyncPoint = ullSyncPoints;
+			xRecordReplayStats.ulEntries++;
+		}
+	}
+	else if( prvExternalInterruptsWaiting() != pdFALSE )
+	{
+		/* The tasks may have passed the synchronisation point the arrival was
+		recorded at if the kernel has changed since it was recorded. */
+		if( ullReplaySyncPoint < ullSyncPoints )
+		{
+			xRecordReplayStats.ulLateEntries++;
+		}
+
+		ulInterrupts = ulReplayInterrupts;
+		ulTicks = ulReplayTicks;
+		xRecordReplayStats.ulEntries++;
+		prvReadReplayEntry();
+	}
+
+	if( ulInterrupts != 0UL )
+	{
+		__atomic_fetch_add( &ulPendingTicks, ulTicks, __ATOMIC_SEQ_CST );
+
+		while( ulInterrupts != 0UL )
+		{
+			prvSetInterruptPending( ( uint32_t ) __builtin_ctz( ulInterrupts ) );
+			ulInterrupts &= ulInterrupts - 1UL;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvEndInterruptProcessing( void )
+{
+	if( xSyncPointPending != pdFALSE )
+	{
+		xSyncPointPending = pdFALSE;
+		__atomic_fetch_add( &ullSyncPoints, 1ULL, __ATOMIC_SEQ_CST );
+	}
+
+	return prvExternalInterruptsWaiting();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvExternalInterruptsWaiting( void )
+{
+BaseType_t xWaiting = pdFALSE;
+
+	if( xRecordReplayMode == portRECORDING )
+	{
+		xWaiting = ( __atomic_load_n( &ulExternalInterrupts, __ATOMIC_SEQ_CST ) != 0UL ) ? pdTRUE : pdFALSE;
+	}
+	else if( xRecordReplayMode == portREPLAYING )
+	{
+		xWaiting = ( ( xReplayEntryValid != pdFALSE ) && ( ullReplaySyncPoint <= __atomic_load_n( &ullSyncPoints, __ATOMIC_SEQ_CST ) ) ) ? pdTRUE : pdFALSE;
+	}
+
+	/* Nothing is delivered while the scheduler is suspended, see
+	prvTakeExternalInterrupts(). */
+	if( ( xWaiting != pdFALSE ) && ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) )
+	{
+		xWaiting = pdFALSE;
+	}
+
+	return xWaiting;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAtSynchronisationPoint( void )
+{
+BaseType_t xReturn = pdFALSE;
+
+	/* Only a task passes synchronisation points, and only while the interrupts
+	raised by other host threads can be delivered. */
+	if( ( xRecordReplayMode != portNOT_RECORDING ) && ( ulCriticalNesting == portNO_CRITICAL_NESTING ) )
+	{
+		#if( configUSE_FIBER_TASKS == 1 )
+		{
+			if( ( xPortRunning != pdFALSE ) && ( xInterruptsActive == pdFALSE ) && ( pthread_equal( pthread_self(), xFiberThread ) != 0 ) )
+			{
+				xReturn = pdTRUE;
+			}
+		}
+		#else
+		{
+			if( pxThisThreadState != NULL )
+			{
+				xReturn = pdTRUE;
+			}
+		}
+		#endif /* configUSE_FIBER_TASKS */
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeliverDueArrivals( void )
+{
+	/* A replayed arrival that is due must be delivered before the task passes
+	the synchronisation point, even if the replay thread has not noticed it
+	yet. */
+	while( ( xRecordReplayMode == portREPLAYING ) && ( prvExternalInterruptsWaiting() != pdFALSE ) )
+	{
+		#if( configUSE_FIBER_TASKS == 1 )
+		{
+			prvProcessSimulatedInterrupts();
+		}
+		#else
+		{
+		uint32_t ulProcessedCount;
+
+			ulProcessedCount = prvPrepareToWaitForInterruptProcessing();
+			sem_post( &xInterruptEvent );
+			prvWaitForInterruptProcessing( ulProcessedCount );
+		}
+		#endif /* configUSE_FIBER_TASKS */
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSynchronisationPoint( void )
+{
+	/* Called by vTaskSuspendAll().  An arrival due at the current
+	synchronisation point is delivered before the scheduler is suspended, and
+	none are delivered again until it is resumed, so the call does not need to
+	be counted. */
+	if( prvAtSynchronisationPoint() != pdFALSE )
+	{
+		prvDeliverDueArrivals();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLogValue( uint32_t *pulHead, uint64_t ullValue )
+{
+uint8_t ucByte;
+
+	/* Seven bits at a time, least significant first, with the top bit of each
+	byte set if another byte follows.  Most values fit in a single byte. */
+	do
+	{
+		ucByte = ( uint8_t ) ( ullValue & 0x7fULL );
+		ullValue >>= 7;
+
+		if( ullValue != 0ULL )
+		{
+			ucByte |= 0x80U;
+		}
+
+		/* The timer thread empties the buffer every tick, so it should never
+		fill. */
+		configASSERT( ( *pulHead - __atomic_load_n( &ulLogTail, __ATOMIC_ACQUIRE ) ) < portLOG_BUFFER_SIZE );
+		ucLogBuffer[ *pulHead & ( portLOG_BUFFER_SIZE - 1UL ) ] = ucByte;
+		( *pulHead )++;
+
+	} while( ullValue != 0ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteLog( void )
+{
+uint32_t ulHead, ulTail, ulBytes;
+
+	pthread_mutex_lock( &xLogMutex );
+
+	ulHead = __atomic_load_n( &ulLogHead, __ATOMIC_ACQUIRE );
+	ulTail = ulLogTail;
+
+	if( ulHead != ulTail )
+	{
+		while( ulTail != ulHead )
+		{
+			/* Up to the end of the buffer, then from the start. */
+			ulBytes = portLOG_BUFFER_SIZE - ( ulTail & ( portLOG_BUFFER_SIZE - 1UL ) );
+
+			if( ulBytes > ( ulHead - ulTail ) )
+			{
+				ulBytes = ulHead - ulTail;
+			}
+
+			fwrite( &( ucLogBuffer[ ulTail & ( portLOG_BUFFER_SIZE - 1UL ) ] ), 1, ulBytes, pxLogFile );
+			xRecordReplayStats.ulBytes += ulBytes;
+			ulTail += ulBytes;
+		}
+
+		__atomic_store_n( &ulLogTail, ulTail, __ATOMIC_RELEASE );
+
+		/* So the log is complete up to the last tick however the process is
+		stopped. */
+		fflush( pxLogFile );
+	}
+
+	pthread_mutex_unlock( &xLogMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFlushLog( void )
+{
+	/* Registered with atexit(), so the arrivals recorded since the timer
+	thread last ran are not lost when the scheduler is ended. */
+	prvWriteLog();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadLogValue( uint64_t *pullValue )
+{
+uint8_t ucByte;
+uint32_t ulShift = 0UL;
+BaseType_t xReturn = pdFAIL;
+
+	*pullValue = 0ULL;
+
+	while( ( xReplayLogPosition < xReplayLogSize ) && ( ulShift < 64UL ) )
+	{
+		ucByte = pucReplayLog[ xReplayLogPosition ];
+		xReplayLogPosition++;
+		*pullValue |= ( ( uint64_t ) ( ucByte & 0x7fU ) ) << ulShift;
+		ulShift += 7UL;
+
+		if( ( ucByte & 0x80U ) == 0U )
+		{
+			xReturn = pdPASS;
+			break;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReadReplayEntry( void )
+{
+uint64_t ullDelta, ullInterrupts, ullTicks = 0ULL;
+BaseType_t xValid;
+
+	xValid = prvReadLogValue( &ullDelta );
+
+	if( xValid != pdFAIL )
+	{
+		xValid = prvReadLogValue( &ullInterrupts );
+	}
+
+	if( ( xValid != pdFAIL ) && ( ( ullInterrupts & ( 1ULL << portINTERRUPT_TICK ) ) != 0ULL ) )
+	{
+		xValid = prvReadLogValue( &ullTicks );
+	}
+
+	if( ( xValid != pdFAIL ) && ( ullInterrupts != 0ULL ) && ( ullInterrupts <= UINT32_MAX ) )
+	{
+		ullLastSyncPoint += ullDelta;
+		ulReplayInterrupts = ( uint32_t ) ullInterrupts;
+		ulReplayTicks = ( uint32_t ) ullTicks;
+		ullReplaySyncPoint = ullLastSyncPoint;
+		xRecordReplayStats.ulBytes = ( uint32_t ) xReplayLogPosition;
+	}
+	else
+	{
+		/* The end of the log, or an entry cut short when the recording was
+		stopped. */
+		xValid = pdFALSE;
+	}
+
+	__atomic_store_n( &xReplayEntryValid, xValid, __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvReplayLoggedInterrupts( void *pvParameter )
+{
+struct timespec xPollPeriod = { 0, portREPLAY_POLL_NS };
+
+	/* Just to prevent compiler warnings. */
+	( void ) pvParameter;
+
+	/* The tasks deliver the arrivals that are due as they pass synchronisation
+	points, so this thread is only needed when they stop passing them - which
+	also stops them reaching the synchronisation point of the next arrival, so
+	simply checking periodically is enough. */
+	while( __atomic_load_n( &xReplayEntryValid, __ATOMIC_SEQ_CST ) != pdFALSE )
+	{
+		if( ( __atomic_load_n( &ulCriticalNesting, __ATOMIC_SEQ_CST ) == portNO_CRITICAL_NESTING ) && ( ullReplaySyncPoint <= __atomic_load_n( &ullSyncPoints, __ATOMIC_SEQ_CST ) ) )
+		{
+			#if( configUSE_FIBER_TASKS == 1 )
+			{
+				pthread_kill( xFiberThread, portINTERRUPT_SIGNAL );
+			}
+			#else
+			{
+				sem_post( &xInterruptEvent );
+			}
+			#endif
+		}
+
+		nanosleep( &xPollPeriod, NULL );
+	}
+
+	/* The whole log has been replayed, but the application has not
+	necessarily finished - it is likely to be further on than when the last
+	arrival was recorded, as replayed ticks arrive as fast as the tasks run.
+	Go back to generating the ticks, and delivering the interrupts raised by
+	other host threads, live, with the next tick a period from now, and become
+	the timer thread. */
+	pthread_mutex_lock( &xTimerMutex );
+	ullNextTickNs = prvSimulatedTimeNs() + portTICK_PERIOD_NS;
+	__atomic_store_n( &xRecordReplayMode, portNOT_RECORDING, __ATOMIC_SEQ_CST );
+	pthread_mutex_unlock( &xTimerMutex );
+
+	return prvSimulatedPeripheralTimer( NULL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortRecordInterrupts( const char *pcFileName )
+{
+uint32_t ulHeader[ 3 ] = { portLOG_MAGIC, portLOG_VERSION, ( uint32_t ) configTICK_RATE_HZ };
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xPortRunning == pdFALSE );
+
+	if( ( xRecordReplayMode == portNOT_RECORDING ) && ( xPortRunning == pdFALSE ) )
+	{
+		pxLogFile = fopen( pcFileName, "wb" );
+
+		if( pxLogFile != NULL )
+		{
+			if( fwrite( ulHeader, sizeof( ulHeader ), 1, pxLogFile ) == 1 )
+			{
+				xRecordReplayStats.ulBytes = ( uint32_t ) sizeof( ulHeader );
+				xRecordReplayMode = portRECORDING;
+				atexit( prvFlushLog );
+				xReturn = pdPASS;
+			}
+			else
+			{
+				fclose( pxLogFile );
+				pxLogFile = NULL;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortReplayInterrupts( const char *pcFileName )
+{
+FILE *pxFile;
+long lSize;
+uint32_t ulHeader[ 3 ];
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xPortRunning == pdFALSE );
+
+	if( ( xRecordReplayMode == portNOT_RECORDING ) && ( xPortRunning == pdFALSE ) )
+	{
+		pxFile = fopen( pcFileName, "rb" );
+
+		if( pxFile != NULL )
+		{
+			/* The log is read into memory up front, so reading it never holds
+			up the delivery of an arrival.  This uses the host heap, not the
+			FreeRTOS heap. */
+			if( ( fseek( pxFile, 0L, SEEK_END ) == 0 ) && ( ( lSize = ftell( pxFile ) ) >= ( long ) sizeof( ulHeader ) ) && ( fseek( pxFile, 0L, SEEK_SET ) == 0 ) )
+			{
+				xReplayLogSize = ( size_t ) lSize;
+				pucReplayLog = ( uint8_t * ) malloc( xReplayLogSize );
+
+				if( ( pucReplayLog != NULL ) && ( fread( pucReplayLog, 1, xReplayLogSize, pxFile ) == xReplayLogSize ) )
+				{
+					memcpy( ulHeader, pucReplayLog, sizeof( ulHeader ) );
+
+					if( ( ulHeader[ 0 ] == portLOG_MAGIC ) && ( ulHeader[ 1 ] == portLOG_VERSION ) && ( ulHeader[ 2 ] == ( uint32_t ) configTICK_RATE_HZ ) )
+					{
+						xReplayLogPosition = sizeof( ulHeader );
+						prvReadReplayEntry();
+						xRecordReplayMode = portREPLAYING;
+						xReturn = pdPASS;
+					}
+				}
+
+				if( ( xReturn == pdFAIL ) && ( pucReplayLog != NULL ) )
+				{
+					free( pucReplayLog );
+					pucReplayLog = NULL;
+				}
+			}
+
+			fclose( pxFile );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetRecordReplayStats( PortRecordReplayStats_t *pxStats )
+{
+	pxStats->ulEntries = xRecordReplayStats.ulEntries;
+	pxStats->ulLateEntries = xRecordReplayStats.ulLateEntries;
+	pxStats->ulBytes = xRecordReplayStats.ulBytes;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+static void prvWaitForInterrupt( void )
+{
+	#if( configUSE_FIBER_TASKS == 1 )
+	{
+	sigset_t xSignals, xPreviousSignals;
+
+		/* The interrupt signal is blocked while checking for a pending
+		interrupt, so a signal received after the check still ends the
+		wait. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+
+		while( ulPendingInterrupts == 0UL )
+		{
+			sigsuspend( &xPreviousSignals );
+		}
+
+		pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+	}
+	#else
+	{
+		/* An interrupt raised while this task is in the critical section
+		posts the wake event, so an interrupt raised after the check still ends
+		the wait. */
+		configASSERT( ulCriticalNesting == ( portNO_CRITICAL_NESTING + 1 ) );
+
+		while( __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST ) == 0UL )
+		{
+			sem_wait( &xWakeEvent );
+		}
+	}
+	#endif /* configUSE_FIBER_TASKS */
+}
+/*-----------------------------------------------------------*/
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+eSleepModeStatus eSleepStatus;
+uint64_t ullNowNs;
+uint32_t ulTicksElapsed = 0UL, ulTicksToStep, ulInterruptsDue;
+BaseType_t xSleep = pdTRUE;
+
+	/* Called by the idle task with the scheduler suspended.  Mask the
+	simulated interrupts, then check it is still ok to sleep. */
+	portDISABLE_INTERRUPTS();
+
+	eSleepStatus = eTaskConfirmSleepModeStatus();
+
+	if( ( eSleepStatus == eAbortSleep ) || ( ulPendingInterrupts != 0UL ) )
+	{
+		/* A task became ready, or an interrupt is pending, since the idle
+		task decided to sleep. */
+		portENABLE_INTERRUPTS();
+	}
+	else
+	{
+		/* Stop the timer thread generating ticks.  Instead it wakes this task
+		when the tick that ends the expected idle time is due - unless no task
+		is waiting for a timeout, in which case only another interrupt ends the
+		sleep. */
+		pthread_mutex_lock( &xTimerMutex );
+		xTicksSuppressed = pdTRUE;
+
+		if( eSleepStatus == eNoTasksWaitingTimeout )
+		{
+			ullSuppressedUntilNs = UINT64_MAX;
+		}
+		else
+		{
+			ullSuppressedUntilNs = ullNextTickNs + ( ( ( uint64_t ) xExpectedIdleTime - 1ULL ) * portTICK_PERIOD_NS );
+		}
+
+		#if( configUSE_VIRTUAL_TIME == 1 )
+		{
+		uint64_t ullWakeNs;
+
+			/* Rather than sleep until the host clock reaches the time at which
+			the sleep ends, move the simulated clock straight on to it - or on
+			to the first timed interrupt, if that is sooner.  Nothing timed by
+			the simulated clock can happen in between.  Only an interrupt raised
+			by another host thread can end the sleep if neither is due. */
+			ullWakeNs = ( ullNextInterruptDueNs < ullSuppressedUntilNs ) ? ullNextInterruptDueNs : ullSuppressedUntilNs;
+
+			if( ullWakeNs != UINT64_MAX )
+			{
+				ullNowNs = prvSimulatedTimeNs();
+
+				if( ullWakeNs > ullNowNs )
+				{
+					ullSkippedNs += ullWakeNs - ullNowNs;
+				}
+
+				xSleep = pdFALSE;
+			}
+		}
+		#endif /* configUSE_VIRTUAL_TIME */
+
+		if( xSleep != pdFALSE )
+		{
+			pthread_cond_signal( &xTimerEvent );
+			pthread_mutex_unlock( &xTimerMutex );
+
+			prvWaitForInterrupt();
+
+			pthread_mutex_lock( &xTimerMutex );
+		}
+
+		/* Work out how many ticks became due while sleeping, and let the
+		timer thread generate ticks again.  Timed interrupts that became due
+		are raised here, rather than by the timer thread, so they are processed
+		after the ticks that came before them. */
+		ullNowNs = prvSimulatedTimeNs();
+		ulInterruptsDue = prvTimedInterruptsDue( ullNowNs );
+
+		if( ullNowNs >= ullNextTickNs )
+		{
+			ulTicksElapsed = ( uint32_t ) ( ( ullNowNs - ullNextTickNs ) / portTICK_PERIOD_NS ) + 1UL;
+			ullNextTickNs += ( uint64_t ) ulTicksElapsed * portTICK_PERIOD_NS;
+		}
+
+		xTickStats.ulTicks += ulTicksElapsed;
+		xTicksSuppressed = pdFALSE;
+		pthread_cond_signal( &xTimerEvent );
+		pthread_mutex_unlock( &xTimerMutex );
+
+		/* Step the tick count over all but the last of the ticks that are not
+		after the expected idle time.  The rest are processed by the tick
+		interrupt, so tasks whose timeout has expired are unblocked. */
+		ulTicksToStep = ulTicksElapsed;
+		if( ulTicksToStep > ( ( uint32_t ) xExpectedIdleTime - 1UL ) )
+		{
+			ulTicksToStep = ( uint32_t ) xExpectedIdleTime - 1UL;
+		}
+
+		vTaskStepTick( ( TickType_t ) ulTicksToStep );
+
+		if( ulTicksElapsed > ulTicksToStep )
+		{
+			__atomic_fetch_add( &ulPendingTicks, ulTicksElapsed - ulTicksToStep, __ATOMIC_SEQ_CST );
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+
+		prvGenerateSimulatedInterrupts( ulInterruptsDue );
+
+		/* Process the interrupt that ended the sleep. */
+		portENABLE_INTERRUPTS();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+void vPortEndScheduler( void )
+{
+	exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_FIBER_TASKS == 1 )
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber >= portMAX_INTERRUPTS )
+	{
+		/* Not a valid interrupt number. */
+	}
+	else if( pthread_equal( pthread_self(), xFiberThread ) != 0 )
+	{
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* A task raising an interrupt is a synchronisation point, counted
+			once the interrupt has been processed. */
+			if( prvAtSynchronisationPoint() != pdFALSE )
+			{
+				prvDeliverDueArrivals();
+			}
+		}
+		#endif
+
+		/* Raised by a task, or by a simulated interrupt handler.  The
+		interrupt is processed straight away unless it is masked by a critical
+		section, or by a handler that is at least as urgent, in which case it is
+		processed when that completes. */
+		prvSetInterruptPending( ulInterruptNumber );
+		prvProcessUnmaskedInterrupts();
+	}
+	else
+	{
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		if( xRecordReplayMode == portRECORDING )
+		{
+			/* Held until it can be delivered between two synchronisation
+			points. */
+			__atomic_fetch_or( &ulExternalInterrupts, ( 1UL << ulInterruptNumber ), __ATOMIC_SEQ_CST );
+		}
+		else if( xRecordReplayMode == portREPLAYING )
+		{
+			/* The log delivers the interrupts raised by other host threads. */
+			return;
+		}
+		else
+		#endif
+		{
+			prvSetInterruptPending( ulInterruptNumber );
+		}
+
+		/* Raised by another host thread, such as the one simulating the timer
+		peripheral, so assert the interrupt line. */
+		pthread_kill( xFiberThread, portINTERRUPT_SIGNAL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	/* Only the thread that executes the tasks uses the handlers. */
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+BaseType_t xSynchronise = pdFALSE;
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		/* Entering a critical section is a synchronisation point.  Arrivals
+		that are due are delivered first, and the point counted once inside, so
+		none is delivered between the two. */
+		xSynchronise = prvAtSynchronisationPoint();
+
+		if( xSynchronise != pdFALSE )
+		{
+			prvDeliverDueArrivals();
+		}
+	}
+	#endif
+
+	/* The simulated interrupts are processed on this thread, so are masked as
+	soon as the critical nesting count is incremented.  The signal fence stops
+	the compiler moving the accesses made in the critical section above the
+	increment. */
+	ulCriticalNesting++;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		if( xSynchronise != pdFALSE )
+		{
+			__atomic_fetch_add( &ullSyncPoints, 1ULL, __ATOMIC_SEQ_CST );
+		}
+	}
+	#endif
+
+	/* Remove compiler warnings if configUSE_INTERRUPT_RECORD_REPLAY is 0. */
+	( void ) xSynchronise;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+BaseType_t xInterruptsWaiting;
+
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		ulCriticalNesting--;
+
+		/* Were any interrupts set to pending while interrupts were
+		(simulated) disabled? */
+		if( ( ulCriticalNesting == portNO_CRITICAL_NESTING ) && ( xInterruptsActive == pdFALSE ) )
+		{
+			xInterruptsWaiting = ( ulPendingInterrupts != 0UL ) ? pdTRUE : pdFALSE;
+
+			#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+			{
+				/* Or arrived from another host thread, and are held until
+				now. */
+				if( xInterruptsWaiting == pdFALSE )
+				{
+					xInterruptsWaiting = prvExternalInterruptsWaiting();
+				}
+			}
+			#endif
+
+			if( xInterruptsWaiting != pdFALSE )
+			{
+				configASSERT( xPortRunning );
+				prvProcessSimulatedInterrupts();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#else /* configUSE_FIBER_TASKS */
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+uint32_t ulProcessedCount = 0UL;
+BaseType_t xWaitForProcessing = pdFALSE;
+
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber >= portMAX_INTERRUPTS )
+	{
+		/* Not a valid interrupt number. */
+	}
+	else if( prvInInterruptHandler() != pdFALSE )
+	{
+		/* Raised by a simulated interrupt handler.  The interrupt is processed
+		straight away if it is more urgent than the handler, otherwise before
+		this thread returns to the task. */
+		prvSetInterruptPending( ulInterruptNumber );
+		prvRunInterruptHandlers();
+	}
+	#if( configNUMBER_OF_CORES > 1 )
+	else if( ( ulInterruptNumber == portINTERRUPT_YIELD ) && ( pxThisThreadState != NULL ) )
+	{
+		/* A task yielding asks its own core to switch.  Masking stops the task
+		moving to another core between finding which core it is on and the
+		request being made, and unmasking makes the switch. */
+		( void ) ulPortSetInterruptMask();
+		vPortYieldCore( xThisCoreID );
+		vPortClearInterruptMask( 0 );
+	}
+	#endif /* configNUMBER_OF_CORES */
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	else if( ( xRecordReplayMode != portNOT_RECORDING ) && ( pxThisThreadState == NULL ) )
+	{
+		/* Raised by another host thread.  When recording the interrupt is held
+		until it can be delivered between two synchronisation points, see
+		prvTakeExternalInterrupts(), and as when it is masked by a critical
+		section vPortExitCritical() posts the event if it is raised during one.
+		When replaying the log delivers these interrupts instead. */
+		if( xRecordReplayMode == portRECORDING )
+		{
+			__atomic_fetch_or( &ulExternalInterrupts, ( 1UL << ulInterruptNumber ), __ATOMIC_SEQ_CST );
+
+			if( __atomic_load_n( &ulCriticalNesting, __ATOMIC_SEQ_CST ) == portNO_CRITICAL_NESTING )
+			{
+				sem_post( &xInterruptEvent );
+			}
+		}
+	}
+	#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+	else
+	{
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* A task raising an interrupt is a synchronisation point, counted
+			once the interrupt has been processed. */
+			if( prvAtSynchronisationPoint() != pdFALSE )
+			{
+				prvDeliverDueArrivals();
+			}
+		}
+		#endif
+
+		/* A task raising an interrupt must not continue until it has been
+		processed, as the interrupt may switch it out - unless the interrupt is
+		masked by a critical section, in which case it is processed when the
+		critical section exits.  Prepare to wait before the interrupt is raised,
+		as it may be processed straight away.  All the interrupts are taken by
+		core 0, so a task running on another core does not wait. */
+		#if( configNUMBER_OF_CORES > 1 )
+		if( ( pxThisThreadState != NULL ) && ( xThisCoreID == 0 ) && ( portCRITICAL_NESTING == portNO_CRITICAL_NESTING ) )
+		#else
+		if( ( pxThisThreadState != NULL ) && ( ulCriticalNesting == portNO_CRITICAL_NESTING ) )
+		#endif
+		{
+			ulProcessedCount = prvPrepareToWaitForInterruptProcessing();
+			xWaitForProcessing = pdTRUE;
+		}
+
+		prvSetInterruptPending( ulInterruptNumber );
+
+		/* The simulated interrupt is now held pending, but don't actually
+		process it yet if it is masked.  When raised by a thread other than the
+		task thread the critical nesting count can change at any time - but it
+		is read after the pending bit is set, and vPortExitCritical() reads the
+		pending bits after clearing the count, so at least one of the two posts
+		the event.  A critical section does not mask the interrupts more urgent
+		than configMAX_SYSCALL_INTERRUPT_PRIORITY.  The count read is that of
+		the task running on core 0. */
+		if( ( __atomic_load_n( &portTASK_CRITICAL_NESTING( pxCurrentTCB ), __ATOMIC_SEQ_CST ) == portNO_CRITICAL_NESTING ) || ( ucInterruptLevel[ ulInterruptNumber ] >= portKERNEL_EXECUTION_LEVEL ) )
+		{
+			sem_post( &xInterruptEvent );
+		}
+		else
+		{
+			#if( configUSE_TICKLESS_IDLE == 1 )
+			{
+				/* The idle task may be sleeping in the critical section. */
+				sem_post( &xWakeEvent );
+			}
+			#endif
+		}
+
+		/* If the simulated interrupt handler thread is running a handler that
+		is less urgent than this interrupt, interrupt it, so this interrupt
+		nests within the handler rather than waiting for it to complete. */
+		if( ( xInterruptsActive != pdFALSE ) && ( ulExecutionLevel != 0UL ) && ( ucInterruptLevel[ ulInterruptNumber ] >= ulExecutionLevel ) )
+		{
+			pthread_kill( xInterruptThread, portINTERRUPT_SIGNAL );
+		}
+
+		if( xWaitForProcessing != pdFALSE )
+		{
+			prvWaitForInterruptProcessing( ulProcessedCount );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	/* Only the simulated interrupt handler thread uses the handlers, and
+	writing a pointer is atomic. */
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+BaseType_t xSynchronise = pdFALSE;
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		/* Entering a critical section is a synchronisation point.  Arrivals
+		that are due are delivered first, and the point counted once inside, so
+		none is delivered between the two. */
+		xSynchronise = prvAtSynchronisationPoint();
+
+		if( xSynchronise != pdFALSE )
+		{
+			prvDeliverDueArrivals();
+		}
+	}
+	#endif
+
+	/* Simulated interrupts are masked as soon as the critical nesting count is
+	incremented, as the simulated interrupt handler thread parks the task
+	thread before checking the count.  Parking at any point in the increment is
+	safe as the count is always zero when a task is switched out.  No host
+	call is made, and the signal fence stops the compiler moving the accesses
+	made in the critical section above the increment. */
+	portCRITICAL_NESTING++;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* The outermost critical section of a task also excludes the other
+		cores. */
+		if( ( pxThisThreadState != NULL ) && ( pxThisThreadState->ulCriticalNesting == ( portNO_CRITICAL_NESTING + 1 ) ) )
+		{
+			prvTakeKernelLocks();
+		}
+	}
+	#endif
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		if( xSynchronise != pdFALSE )
+		{
+			__atomic_fetch_add( &ullSyncPoints, 1ULL, __ATOMIC_SEQ_CST );
+		}
+	}
+	#endif
+
+	/* Remove compiler warnings if configUSE_INTERRUPT_RECORD_REPLAY is 0. */
+	( void ) xSynchronise;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+	if( portCRITICAL_NESTING > portNO_CRITICAL_NESTING )
+	{
+		if( portCRITICAL_NESTING == ( portNO_CRITICAL_NESTING + 1 ) )
+		{
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				/* Release the locks taken by prvTakeKernelLocks() before
+				anything that became pending is processed, as the task may be
+				switched out. */
+				if( pxThisThreadState != NULL )
+				{
+					vPortReleaseLock( portISR_LOCK );
+					vPortReleaseLock( portTASK_LOCK );
+				}
+			}
+			#endif
+
+			/* Unmask the simulated interrupts, then process any that were set
+			to pending while they were masked. */
+			__atomic_store_n( &portCRITICAL_NESTING, portNO_CRITICAL_NESTING, __ATOMIC_SEQ_CST );
+			prvProcessMaskedInterrupts();
+		}
+		else
+		{
+			/* Tick interrupts will still not be processed as the critical
+			nesting depth will not be zero. */
+			portCRITICAL_NESTING--;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_FIBER_TASKS */
@@ -0,0 +1,444 @@
+/*
+ * FreeRTOS Kernel V10.1.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+/******************************************************************************
+	Defines
+******************************************************************************/
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	size_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE size_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+
+#if( configUSE_16_BIT_TICKS == 1 )
+    typedef uint16_t TickType_t;
+    #define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+    typedef uint32_t TickType_t;
+    #define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* 32-bit tick type on a 32/64-bit architecture, so reads of the tick
+	count do not need to be guarded with a critical section. */
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Hardware specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portINLINE __inline
+
+#if defined( __x86_64__ ) || defined( __aarch64__ )
+	#define portBYTE_ALIGNMENT		8
+#else
+	#define portBYTE_ALIGNMENT		4
+#endif
+
+#define portYIELD()					vPortGenerateSimulatedInterrupt( portINTERRUPT_YIELD )
+
+/* Simulated interrupts return pdFALSE if no context switch should be performed,
+or a non-zero number if a context switch should be performed. */
+#define portYIELD_FROM_ISR( x ) ( void ) x
+#define portEND_SWITCHING_ISR( x ) portYIELD_FROM_ISR( ( x ) )
+
+void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield );
+void vPortDeleteThread( void *pvThreadToDelete );
+#define portCLEAN_UP_TCB( pxTCB )	vPortDeleteThread( pxTCB )
+#define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxPendYield ) vPortCloseRunningThread( ( pvTaskToDelete ), ( pxPendYield ) )
+#define portDISABLE_INTERRUPTS() vPortEnterCritical()
+#define portENABLE_INTERRUPTS() vPortExitCritical()
+
+/* Critical section handling. */
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+
+#define portENTER_CRITICAL()		vPortEnterCritical()
+#define portEXIT_CRITICAL()			vPortExitCritical()
+
+/* When configUSE_HANDOFF_CONTEXT_SWITCH is 1 a task thread that raises a
+simulated interrupt, for example to yield, parks itself on its own event and is
+handed control back directly by the simulated interrupt handler thread, rather
+than having to be suspended by the simulated interrupt handler thread. */
+#ifndef configUSE_HANDOFF_CONTEXT_SWITCH
+	#define configUSE_HANDOFF_CONTEXT_SWITCH 0
+#endif
+
+/* When configUSE_FIBER_TASKS is 1 all the tasks execute on a single host
+thread, each as a user mode context that runs on the task's own stack, so
+configMINIMAL_STACK_SIZE, and the stack size passed to xTaskCreate(), set the
+real stack size of the task.  Simulated interrupts are processed on the stack of
+the interrupted task, so stacks must also have room for a host signal frame. */
+#ifndef configUSE_FIBER_TASKS
+	#define configUSE_FIBER_TASKS 0
+#endif
+
+#if( configUSE_FIBER_TASKS == 1 )
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		#error configUSE_HANDOFF_CONTEXT_SWITCH cannot be used when configUSE_FIBER_TASKS is 1, as there are no task threads to hand off between.
+	#endif
+
+	/* The port uses the whole task stack, so needs to know where it ends. */
+	#define portHAS_STACK_OVERFLOW_CHECKING 1
+#endif
+
+/* When configNUMBER_OF_CORES is greater than 1 the simulated target has that
+many cores, each of which runs its own task at the same time as the others -
+on as many host CPUs as are available.  Core 0 is the core that takes all the
+simulated interrupts, processed by the simulated interrupt handler thread as
+before.  Each of the other cores has a thread of its own that only switches the
+task it runs, when the kernel asks it to by calling portYIELD_CORE().  Only
+the thread based task model supports more than one core. */
+#ifndef configNUMBER_OF_CORES
+	#define configNUMBER_OF_CORES 1
+#endif
+
+#if( configNUMBER_OF_CORES > 1 )
+	#if( configUSE_FIBER_TASKS == 1 )
+		#error configUSE_FIBER_TASKS must be set to 0 if configNUMBER_OF_CORES is greater than 1, as fibers all execute on a single host thread.
+	#endif
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		#error configUSE_HANDOFF_CONTEXT_SWITCH must be set to 0 if configNUMBER_OF_CORES is greater than 1.
+	#endif
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be set to 0 if configNUMBER_OF_CORES is greater than 1, as the idle task of one core cannot stop the tick while another core is busy.
+	#endif
+
+	#if( defined( configUSE_INTERRUPT_RECORD_REPLAY ) && ( configUSE_INTERRUPT_RECORD_REPLAY == 1 ) )
+		#error configUSE_INTERRUPT_RECORD_REPLAY must be set to 0 if configNUMBER_OF_CORES is greater than 1, as the cores do not pass the synchronisation points in a repeatable order.
+	#endif
+
+	/* The ready priorities are searched by each core in turn, so the generic
+	method must be used. */
+	#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+		#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+	#endif
+
+	/* Identify the calling core, and ask a core to select a new task to run.
+	portYIELD_CORE() does not wait for the core to switch. */
+	BaseType_t xPortGetCoreID( void );
+	void vPortYieldCore( BaseType_t xCoreID );
+	#define portGET_CORE_ID()			xPortGetCoreID()
+	#define portYIELD_CORE( xCoreID )	vPortYieldCore( xCoreID )
+
+	/* The locks that serialise access to the kernel data between the cores.
+	Both are recursive, and taken in the order task lock then ISR lock.  A
+	critical section entered by a task takes both, vTaskSuspendAll() holds the
+	task lock until the matching xTaskResumeAll(), and masking interrupts from a
+	simulated interrupt handler takes the ISR lock. */
+	#define portTASK_LOCK				( 0 )
+	#define portISR_LOCK				( 1 )
+
+	void vPortGetLock( BaseType_t xLock );
+	void vPortReleaseLock( BaseType_t xLock );
+	#define portGET_TASK_LOCK()			vPortGetLock( portTASK_LOCK )
+	#define portRELEASE_TASK_LOCK()		vPortReleaseLock( portTASK_LOCK )
+	#define portGET_ISR_LOCK()			vPortGetLock( portISR_LOCK )
+	#define portRELEASE_ISR_LOCK()		vPortReleaseLock( portISR_LOCK )
+
+	/* Mask the interrupts on the calling core, and so stop the task it runs
+	being switched out, without taking either lock. */
+	UBaseType_t ulPortSetInterruptMask( void );
+	void vPortClearInterruptMask( UBaseType_t uxSavedInterruptStatus );
+	#define portSET_INTERRUPT_MASK()		ulPortSetInterruptMask()
+	#define portCLEAR_INTERRUPT_MASK( x )	vPortClearInterruptMask( x )
+#endif /* configNUMBER_OF_CORES */
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration.  The macros below operate on a single 32 bit
+	map - above 32 priorities the kernel keeps a map of 32 bit maps, so up to
+	32 * 32 priorities can be used. */
+	#if( configMAX_PRIORITIES > 1024 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 1024.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	/* __builtin_clz() returns the number of leading zero bits, so the most
+	significant '1' is at bit position 31 minus that count. */
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( UBaseType_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+
+#endif /* taskRECORD_READY_PRIORITY */
+
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void * pvParameters )
+
+#define portINTERRUPT_YIELD				( 0UL )
+#define portINTERRUPT_TICK				( 1UL )
+
+/*
+ * Raise a simulated interrupt represented by the bit mask in ulInterruptMask.
+ * Each bit can be used to represent an individual interrupt - with the first
+ * two bits being used for the Yield and Tick interrupts respectively.
+*/
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Install an interrupt handler to be called by the simulated interrupt handler
+ * thread.  The interrupt number must be above any used by the kernel itself
+ * (at the time of writing the kernel was using interrupt numbers 0, 1, and 2
+ * as defined above).  The number must also be lower than 32.
+ *
+ * Interrupt handler functions must return a non-zero value if executing the
+ * handler resulted in a task switch being required.
+ */
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
+
+/*
+ * Simulated interrupt priorities.  As on the NVIC of a Cortex-M, a numerically
+ * lower priority is a more urgent one - 0 being the most urgent and
+ * portLOWEST_INTERRUPT_PRIORITY the least.  Every interrupt, including the
+ * yield and tick interrupts used by the kernel, starts at the lowest priority.
+ *
+ * The most urgent pending interrupt is always processed first, interrupts of
+ * equal priority in interrupt number order.  An interrupt that is more urgent
+ * than the handler being run is processed straight away, nesting within it,
+ * when it is raised by the handler or when the handler unmasks it.
+ * Interrupts raised by other host threads preempt the handler asynchronously
+ * on Linux; on Windows they are processed as soon as the handler returns.
+ *
+ * vPortSetInterruptPriority() should be called before the scheduler is started
+ * or from a task.
+ */
+#define portINTERRUPT_PRIORITY_LEVELS	( 32UL )
+#define portLOWEST_INTERRUPT_PRIORITY	( portINTERRUPT_PRIORITY_LEVELS - 1UL )
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority );
+
+/* Simulated interrupts more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY
+are never masked by the kernel, not even by a critical section, so must not
+call any FreeRTOS API function.  The default of 0 lets every simulated interrupt
+use the interrupt safe API functions. */
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+	#define configMAX_SYSCALL_INTERRUPT_PRIORITY	0
+#endif
+
+/* Called from a simulated interrupt handler, masks the interrupts that can use
+the API, as writing BASEPRI does on a Cortex-M.  Called from a task, enters a
+critical section. */
+UBaseType_t ulPortSetInterruptMaskFromISR( void );
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedInterruptStatus );
+#define portSET_INTERRUPT_MASK_FROM_ISR()		ulPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	vPortClearInterruptMaskFromISR( x )
+
+/*
+ * When configUSE_INTERRUPT_LATENCY_HISTOGRAMS is 1 the time from each simulated
+ * interrupt being raised to its handler being entered is recorded, per
+ * interrupt, in a histogram with power of two buckets.  An interrupt raised
+ * again while it is still pending is counted once, from when it was first
+ * raised.
+ */
+#ifndef configUSE_INTERRUPT_LATENCY_HISTOGRAMS
+	#define configUSE_INTERRUPT_LATENCY_HISTOGRAMS 0
+#endif
+
+#define portINTERRUPT_LATENCY_BUCKETS	( 32 )
+
+typedef struct xPORT_INTERRUPT_LATENCY
+{
+	uint32_t ulCount;		/* The number of times the handler has been entered. */
+	uint32_t ulMaxNs;		/* The longest latency, in nanoseconds. */
+	uint32_t ulBuckets[ portINTERRUPT_LATENCY_BUCKETS ];	/* ulBuckets[ n ] counts the latencies of at least 2^n, but less than 2^(n+1), nanoseconds - bucket 0 also counts latencies of 0. */
+} PortInterruptLatency_t;
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+	void vPortGetInterruptLatency( uint32_t ulInterruptNumber, PortInterruptLatency_t *pxLatency );
+	void vPortResetInterruptLatency( uint32_t ulInterruptNumber );
+#endif
+
+/*
+ * Statistics kept by the thread that simulates the tick interrupt.  The thread
+ * sleeps until the absolute time at which each tick is due, so the tick count
+ * does not drift from the host clock.  Ticks that became due while the thread
+ * was not running are generated together, by a single simulated interrupt,
+ * when it next runs.
+ */
+typedef struct xPORT_TICK_STATS
+{
+	uint32_t ulTicks;			/* The number of ticks generated. */
+	uint32_t ulLateTicks;		/* The number of ticks generated more than half a tick period after they were due. */
+	uint32_t ulMissedTicks;		/* The number of ticks not generated when due, but together with a later tick. */
+	uint32_t ulMaxLatenessUs;	/* The most a tick has been generated after it was due, in microseconds. */
+	uint32_t ulTimerWakeups;	/* The number of times the thread has woken, which is fewer than the number of ticks while the tick is suppressed. */
+} PortTickStats_t;
+
+/*
+ * Obtain a copy of the tick statistics.  The fields are updated individually,
+ * so may not all correspond to exactly the same moment.
+ */
+void vPortGetTickStats( PortTickStats_t *pxStats );
+
+/*
+ * Tickless idle.  The idle task sleeps until the next task has to be unblocked,
+ * or another simulated interrupt is raised, with the timer thread suppressing
+ * the ticks in between.
+ */
+#if( configUSE_TICKLESS_IDLE == 1 )
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+/*
+ * Virtual time.  When configUSE_VIRTUAL_TIME is 1 the simulated clock, which
+ * the tick and the timed interrupts are generated from, only keeps pace with the
+ * host clock while there is something to do.  When the idle task finds that no
+ * task can run until a timeout expires, or a timed interrupt is raised, it moves
+ * the simulated clock straight on to that time instead of sleeping.  Long idle
+ * periods then take no host time at all, while tasks are still unblocked on the
+ * same ticks, and in the same order, as they would be in real time.  An
+ * interrupt raised by another host thread is processed at whatever simulated
+ * time it arrives.
+ */
+#ifndef configUSE_VIRTUAL_TIME
+	#define configUSE_VIRTUAL_TIME 0
+#endif
+
+#if( configUSE_VIRTUAL_TIME == 1 )
+	#if( configUSE_TICKLESS_IDLE != 1 )
+		#error configUSE_TICKLESS_IDLE must be set to 1 if configUSE_VIRTUAL_TIME is 1, as the idle task moves the simulated clock on while the tick is suppressed.
+	#endif
+
+	/* Moving the simulated clock on is worthwhile even when only one tick is
+	idle. */
+	#define portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP	1
+#endif
+
+/*
+ * Raise a simulated interrupt once ullDelayNs nanoseconds have passed on the
+ * simulated clock, as a timer peripheral would.  Each interrupt can only be
+ * timed once at a time - timing it again replaces the time it is due.  Can be
+ * called from a task, a simulated interrupt handler that can use the API, or
+ * another host thread.
+ */
+void vPortGenerateSimulatedInterruptAfter( uint32_t ulInterruptNumber, uint64_t ullDelayNs );
+
+/*
+ * Return the time of the simulated clock in nanoseconds.  Only differences
+ * between two times are meaningful.  Can be called from anywhere.
+ */
+uint64_t ullPortGetSimulatedTimeNs( void );
+
+/*
+ * Return the time of the host's monotonic clock in nanoseconds, which, unlike
+ * the simulated clock, is not moved on while the idle task sleeps.  The clock
+ * of the execution statistics kept if configGENERATE_EXECUTION_STATS is 1.
+ * Can be called from anywhere.
+ */
+uint64_t ullPortGetRunTimeNs( void );
+#define portGET_RUN_TIME_NS()	ullPortGetRunTimeNs()
+
+/* The execution statistics of a task are read by host threads other than the
+one that updates them. */
+#define portMEMORY_BARRIER()	__atomic_thread_fence( __ATOMIC_SEQ_CST )
+
+/*
+ * Record and replay.  When configUSE_INTERRUPT_RECORD_REPLAY is 1 the arrival
+ * of the tick, and of every simulated interrupt raised by another host thread,
+ * can be recorded to a file by calling xPortRecordInterrupts() before the
+ * scheduler is started, then replayed by calling xPortReplayInterrupts()
+ * instead.  An arrival is recorded against the number of synchronisation points
+ * the tasks had passed when it was delivered - the outermost entries to a
+ * critical section, and the completion of the interrupts a task raises itself,
+ * such as a yield.  Interrupts raised by another host thread are only delivered
+ * between synchronisation points, and not while the scheduler is suspended, so
+ * one that is more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY waits for a
+ * critical section to exit too.
+ *
+ * When replaying, no ticks are generated and interrupts raised by other host
+ * threads are ignored.  The recorded ones are delivered at the same
+ * synchronisation points instead, so the same build of the application runs
+ * the same schedule, with the same tick count at every point, however the host
+ * schedules its threads, and as fast as the tasks execute.  Code that runs
+ * between two synchronisation points without using the API sees an arrival at
+ * a point that still depends on the host.  A changed kernel can pass a
+ * different number of synchronisation points, in which case the interrupts are
+ * delivered in the same order, with the same number of ticks, at the recorded
+ * counts - or as soon after as the count is reached.  Once the whole log has
+ * been replayed the ticks, and the interrupts raised by other host threads,
+ * are generated live again, so the application runs on to its end.
+ *
+ * Record and replay rely on the tick interrupt to move the tick count on, so
+ * cannot be used with tickless idle.
+ */
+#ifndef configUSE_INTERRUPT_RECORD_REPLAY
+	#define configUSE_INTERRUPT_RECORD_REPLAY 0
+#endif
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be set to 0 if configUSE_INTERRUPT_RECORD_REPLAY is 1, as the ticks must all be generated by the tick interrupt.
+	#endif
+
+	#if( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 )
+		#error INCLUDE_xTaskGetSchedulerState must be set to 1 if configUSE_INTERRUPT_RECORD_REPLAY is 1, as arrivals are not delivered while the scheduler is suspended.
+	#endif
+
+	typedef struct PORT_RECORD_REPLAY_STATS
+	{
+		uint32_t ulEntries;			/* The arrivals recorded, or replayed so far. */
+		uint32_t ulLateEntries;		/* Arrivals replayed after the synchronisation point they were recorded at had passed. */
+		uint32_t ulBytes;			/* The size of the log written, or read, so far. */
+	} PortRecordReplayStats_t;
+
+	/* Return pdPASS if the file could be created, or read and found to be a
+	log recorded with the same tick rate, otherwise pdFAIL.  Only one of the
+	two can be called, and only before the scheduler is started. */
+	BaseType_t xPortRecordInterrupts( const char *pcFileName );
+	BaseType_t xPortReplayInterrupts( const char *pcFileName );
+
+	void vPortGetRecordReplayStats( PortRecordReplayStats_t *pxStats );
+
+	/* vTaskSuspendAll() changes the state of the kernel without entering a
+	critical section, so is a synchronisation point too. */
+	void vPortSynchronisationPoint( void );
+	#define portTASK_SUSPEND_ALL_HOOK() vPortSynchronisationPoint()
+#endif
+
+#endif
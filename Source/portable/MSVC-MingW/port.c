@@ -27,6 +27,9 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
@@ -38,9 +41,61 @@
 	#pragma comment(lib, "winmm.lib")
 #endif
 
+/* Stops the compiler moving memory accesses across the point at which the
+simulated interrupts are masked or unmasked. */
+#ifdef __GNUC__
+	#define portCOMPILER_BARRIER()		__asm volatile( "" ::: "memory" )
+#else
+	#define portCOMPILER_BARRIER()		_ReadWriteBarrier()
+#endif
+
+/* Set ulBit to the position of the most, or least, significant set bit of the
+non-zero ulValue. */
+#ifdef __GNUC__
+	#define portMOST_SIGNIFICANT_BIT( ulBit, ulValue )	( ulBit ) = ( 31UL - ( uint32_t ) __builtin_clz( ulValue ) )
+	#define portLEAST_SIGNIFICANT_BIT( ulBit, ulValue )	( ulBit ) = ( uint32_t ) __builtin_ctz( ulValue )
+#else
+	#define portMOST_SIGNIFICANT_BIT( ulBit, ulValue )	_BitScanReverse( ( DWORD * ) &( ulBit ), ( ulValue ) )
+	#define portLEAST_SIGNIFICANT_BIT( ulBit, ulValue )	_BitScanForward( ( DWORD * ) &( ulBit ), ( ulValue ) )
+#endif
+
 #define portMAX_INTERRUPTS				( ( uint32_t ) sizeof( uint32_t ) * 8UL ) /* The number of bits in an uint32_t. */
 #define portNO_CRITICAL_NESTING 		( ( uint32_t ) 0 )
 
+/* The level at which the simulated interrupts of a priority are held, see
+ulInterruptsAtLevel[]. */
+#define portPRIORITY_TO_LEVEL( ulPriority )	( portLOWEST_INTERRUPT_PRIORITY - ( ulPriority ) )
+
+/* The levels that are not masked at the execution level ulLevel. */
+#define portUNMASKED_LEVELS( ulLevel )		( ( uint32_t ) ~( ( 1ULL << ( ulLevel ) ) - 1ULL ) )
+
+/* The execution level at which the interrupts that can call the API, those
+not more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY, are masked. */
+#define portKERNEL_EXECUTION_LEVEL		( portINTERRUPT_PRIORITY_LEVELS - ( uint32_t ) configMAX_SYSCALL_INTERRUPT_PRIORITY )
+
+/* Returned by ulPortSetInterruptMaskFromISR() when it is called from a task,
+in which case it enters a critical section instead. */
+#define portTASK_INTERRUPT_MASK			( ( UBaseType_t ) 0xffffffffUL )
+
+/* Whether the interrupts raised by other Windows threads are being recorded,
+or replayed, see xPortRecordInterrupts(). */
+#define portNOT_RECORDING				( 0 )
+#define portRECORDING					( 1 )
+#define portREPLAYING					( 2 )
+
+/* A record/replay log starts with these two words and the tick rate, each
+written in host byte order. */
+#define portLOG_MAGIC					( 0x52525246UL )
+#define portLOG_VERSION					( 1UL )
+
+/* The size of the buffer that holds the recorded arrivals until the timer
+thread writes them to the log file.  Must be a power of two. */
+#define portLOG_BUFFER_SIZE				( ( uint32_t ) 256 * 1024 )
+
+/* Read a 64-bit variable shared between threads, which a 32-bit build cannot
+do in a single access. */
+#define portREAD_64( ullValue )			( ( uint64_t ) InterlockedCompareExchange64( ( volatile LONGLONG * ) &( ullValue ), 0, 0 ) )
+
 /* The priorities at which the various components of the simulation execute. */
 #define portDELETE_SELF_THREAD_PRIORITY			 THREAD_PRIORITY_TIME_CRITICAL /* Must be highest. */
 #define portSIMULATED_INTERRUPTS_THREAD_PRIORITY THREAD_PRIORITY_TIME_CRITICAL
@@ -55,12 +110,152 @@
  */
 static DWORD WINAPI prvSimulatedPeripheralTimer( LPVOID lpParameter );
 
+/*
+ * Called by the timer thread when it wakes at, or after, the time the next tick
+ * is due.  Returns the number of ticks that are now due, updates the tick
+ * statistics, and moves *pllNextTick on to when the following tick is due.
+ * Times are in performance counter counts.
+ */
+static uint32_t prvTicksDue( LONGLONG llNow, LONGLONG *pllNextTick );
+
+/*
+ * Return the time at which the timer thread is to generate the next tick, or
+ * to wake the idle task if the tick is suppressed.  Called with pvTimerMutex
+ * held.
+ */
+static LONGLONG prvTimerWakeTime( void );
+
+/*
+ * Return the time of the simulated clock, which the tick and the timed
+ * interrupts are generated from, in performance counter counts.  The same as
+ * the performance counter unless configUSE_VIRTUAL_TIME is 1.  Called with
+ * pvTimerMutex held.
+ */
+static LONGLONG prvSimulatedTime( void );
+
+/*
+ * Return a bit mask of the interrupts timed by
+ * vPortGenerateSimulatedInterruptAfter() that are due at llNow, no longer
+ * timing them, and work out when the next of the rest is due.  Called with
+ * pvTimerMutex held.
+ */
+static uint32_t prvTimedInterruptsDue( LONGLONG llNow );
+
+/*
+ * Raise each simulated interrupt in the bit mask ulInterrupts.
+ */
+static void prvGenerateSimulatedInterrupts( uint32_t ulInterrupts );
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+/*
+ * Called by the simulated interrupt handler thread as it starts processing the
+ * simulated interrupts, with the task outside of a critical section.  Delivers
+ * the arrivals that were recorded, or are to be replayed, at the current
+ * synchronisation point - unless the interrupts being processed were raised by
+ * the task itself, which are processed on their own.
+ */
+static void prvTakeExternalInterrupts( void );
+
+/*
+ * Called as the processing of the simulated interrupts completes.  Counts the
+ * synchronisation point if the interrupts were raised by the task, and returns
+ * pdTRUE if there are more arrivals to deliver, so they are processed
+ * again.
+ */
+static BaseType_t prvEndInterruptProcessing( void );
+
+/*
+ * Returns pdTRUE if an arrival can be delivered now.
+ */
+static BaseType_t prvExternalInterruptsWaiting( void );
+
+/*
+ * Returns pdTRUE if called by the thread of the Running state task, rather than
+ * by another Windows thread.
+ */
+static BaseType_t prvIsRunningTaskThread( void );
+
+/*
+ * Returns pdTRUE if called by the thread of the Running state task outside of
+ * a critical section while recording or replaying, in which case it is at a
+ * synchronisation point.  prvDeliverDueArrivals() then delivers any replayed
+ * arrival that is due before the task passes it.
+ */
+static BaseType_t prvAtSynchronisationPoint( void );
+static void prvDeliverDueArrivals( void );
+
+/*
+ * Encode an arrival into the log buffer, and write the buffer to the log
+ * file.
+ */
+static void prvLogValue( uint32_t *pulHead, uint64_t ullValue );
+static void prvWriteLog( void );
+static void prvFlushLog( void );
+
+/*
+ * Decode the next arrival from the log being replayed.
+ */
+static BaseType_t prvReadLogValue( uint64_t *pullValue );
+static void prvReadReplayEntry( void );
+
+/*
+ * Created instead of the timer thread when replaying, to deliver the next
+ * arrival if the tasks reach its synchronisation point, then do not pass
+ * another.
+ */
+static DWORD WINAPI prvReplayLoggedInterrupts( LPVOID lpParameter );
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/*
+	 * Called by the idle task, from a critical section, to sleep until a
+	 * simulated interrupt is raised.  Simulated interrupts remain masked, so
+	 * the interrupt is processed when the critical section is exited.  The
+	 * equivalent of a WFI instruction.
+	 */
+	static void prvWaitForInterrupt( void );
+
+#endif /* configUSE_TICKLESS_IDLE */
+
 /*
  * Process all the simulated interrupts - each represented by a bit in
  * ulPendingInterrupts variable.
  */
 static void prvProcessSimulatedInterrupts( void );
 
+/*
+ * Run the handlers of the pending simulated interrupts that are not masked by
+ * ulExecutionLevel, most urgent first.  Each handler runs at the level of its
+ * own priority, so only a more urgent interrupt can nest within it.  A handler
+ * that requires a context switch sets ulSwitchPending.
+ */
+static void prvRunInterruptHandlers( void );
+
+/*
+ * Set a simulated interrupt pending, noting when it was raised if
+ * configUSE_INTERRUPT_LATENCY_HISTOGRAMS is 1.
+ */
+static void prvSetInterruptPending( uint32_t ulInterruptNumber );
+
+/*
+ * Returns pdTRUE if called from a simulated interrupt handler, rather than
+ * from a task.
+ */
+static BaseType_t prvInInterruptHandler( void );
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+	/*
+	 * Add the time since a simulated interrupt was raised to its latency
+	 * histogram.  Called as its handler is entered.
+	 */
+	static void prvRecordInterruptLatency( uint32_t ulInterruptNumber );
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
 /*
  * Interrupt handlers used by the kernel itself.  These are executed from the
  * simulated interrupt handler thread.
@@ -74,6 +269,29 @@ static uint32_t prvProcessTickInterrupt( void );
  */
 static BOOL WINAPI prvEndProcess( DWORD dwCtrlType );
 
+#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+
+	/*
+	 * Called by a thread that is about to raise, or unmask, a simulated
+	 * interrupt.  prvPrepareToPark() is called before the simulated interrupt
+	 * handler thread is signalled and returns the thread state of the calling
+	 * thread if it is the thread of the task in the Running state, or NULL if it
+	 * is not.  When not NULL, prvPark() must be called with the returned value
+	 * once the simulated interrupt handler thread has been signalled.
+	 * prvPark() returns when the simulated interrupt handler thread hands
+	 * control back to the thread.
+	 */
+	static void *prvPrepareToPark( void );
+	static void prvPark( void *pvThreadState );
+
+#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+
+/*
+ * Let the thread of the task selected to enter the Running state execute,
+ * however it was stopped.
+ */
+static void prvResumeTaskThread( void *pvTCB );
+
 /*-----------------------------------------------------------*/
 
 /* The WIN32 simulator runs each task in a thread.  The context switching is
@@ -86,29 +304,180 @@ typedef struct
 	/* Handle of the thread that executes the task. */
 	void *pvThread;
 
+	#if( ( configUSE_HANDOFF_CONTEXT_SWITCH == 1 ) || ( configUSE_INTERRUPT_RECORD_REPLAY == 1 ) )
+		/* Identifies the thread, so a thread can tell if it is the thread of
+		the task in the Running state. */
+		DWORD dwThreadId;
+	#endif
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		/* Event the thread waits on when it parks itself after raising a
+		simulated interrupt, and pdTRUE while it is parked on it rather than
+		suspended with SuspendThread(). */
+		void *pvYieldEvent;
+		volatile BaseType_t xParkedOnYield;
+	#endif
+
 } xThreadState;
 
 /* Simulated interrupts waiting to be processed.  This is a bit mask where each
-bit represents one interrupt, so a maximum of 32 interrupts can be simulated. */
+bit represents one interrupt, so a maximum of 32 interrupts can be simulated.
+Only written using interlocked operations. */
 static volatile uint32_t ulPendingInterrupts = 0UL;
 
+/* The number of ticks generated by the timer thread that the tick interrupt
+has not yet processed.  Only written using interlocked operations. */
+static volatile uint32_t ulPendingTicks = 0UL;
+
+/* The simulated interrupts assigned to each priority, see
+vPortSetInterruptPriority().  Indexed by level, which is the lowest priority
+minus the priority, so the most urgent level that has a pending interrupt is
+found by a bit scan.  Every interrupt starts at the lowest priority.  Only
+written using interlocked operations. */
+static volatile uint32_t ulInterruptsAtLevel[ portINTERRUPT_PRIORITY_LEVELS ] = { 0xffffffffUL };
+
+/* The level of each simulated interrupt, and a bit mask of the levels that
+have at least one interrupt assigned. */
+static volatile uint8_t ucInterruptLevel[ portMAX_INTERRUPTS ] = { 0 };
+static volatile uint32_t ulLevelsInUse = 0x01UL;
+
+/* Simulated interrupts at a level below this are masked.  Zero when no
+handler is running, one above the level of the handler being run, and at least
+portKERNEL_EXECUTION_LEVEL while the kernel is being accessed - the equivalent
+of the execution priority combined with BASEPRI on a Cortex-M.  Only written by
+the simulated interrupt handler thread. */
+static volatile uint32_t ulExecutionLevel = 0UL;
+
+/* Set by a handler that requires a context switch, and cleared as the next
+task to run is selected. */
+static volatile uint32_t ulSwitchPending = pdFALSE;
+
+/* Set while the simulated interrupt handler thread is running the handlers,
+and the identity of that thread. */
+static volatile BaseType_t xInterruptsActive = pdFALSE;
+static DWORD dwInterruptThreadId = 0;
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+	/* When each simulated interrupt was last raised while not already pending,
+	in performance counter counts, and its latency histogram.  Only written by
+	the simulated interrupt handler thread, other than when reset. */
+	static volatile LONGLONG llInterruptRaised[ portMAX_INTERRUPTS ] = { 0 };
+	static PortInterruptLatency_t xInterruptLatency[ portMAX_INTERRUPTS ];
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
+/* Mutex and event used to synchronise with the timer thread, for example to
+change when it next wakes. */
+static void *pvTimerMutex = NULL;
+static void *pvTimerEvent = NULL;
+
+/* The time at which the next tick is due, in performance counter counts.
+Protected by pvTimerMutex. */
+static LONGLONG llNextTick = 0;
+
+/* See vPortGetTickStats().  Only written with pvTimerMutex held. */
+static volatile PortTickStats_t xTickStats = { 0 };
+
+/* The frequency of the performance counter, and the tick period in counts of
+it. */
+static LONGLONG llCounterFrequency = 0;
+static LONGLONG llTickPeriod = 0;
+
+/* Set while the idle task sleeps with the tick suppressed, and the time at
+which the timer thread is to wake it.  Protected by pvTimerMutex.  Only used if
+configUSE_TICKLESS_IDLE is 1. */
+static BOOL xTicksSuppressed = FALSE;
+static LONGLONG llSuppressedUntil = 0;
+
+/* The interrupts timed by vPortGenerateSimulatedInterruptAfter(), the time at
+which each is due, and the time at which the first of them is due.  Protected by
+pvTimerMutex. */
+static uint32_t ulTimedInterrupts = 0UL;
+static LONGLONG llInterruptDue[ portMAX_INTERRUPTS ] = { 0 };
+static LONGLONG llNextInterruptDue = LLONG_MAX;
+
+#if( configUSE_VIRTUAL_TIME == 1 )
+
+	/* How far the simulated clock is ahead of the performance counter - moved
+	on by the idle task, and held back when the timer thread runs late.
+	Protected by pvTimerMutex. */
+	static LONGLONG llSkipped = 0;
+
+#endif /* configUSE_VIRTUAL_TIME */
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/* Set when an interrupt is raised while interrupts are masked, to wake the
+	idle task if it is sleeping in prvWaitForInterrupt(). */
+	static void *pvWakeEvent = NULL;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+	/* See xPortRecordInterrupts() and xPortReplayInterrupts(). */
+	static BaseType_t xRecordReplayMode = portNOT_RECORDING;
+
+	/* The number of synchronisation points the tasks have passed.  Only
+	written by the thread of the Running state task, or by the simulated
+	interrupt handler thread while that task is stopped, using interlocked
+	operations as a task can be stopped part way through. */
+	static volatile uint64_t ullSyncPoints = 0ULL;
+
+	/* Set while the interrupts raised by the Running state task itself are
+	processed, the completion of which is a synchronisation point. */
+	static volatile BaseType_t xSyncPointPending = pdFALSE;
+
+	/* The synchronisation point of the last arrival recorded or replayed, as
+	each arrival is logged relative to the one before. */
+	static uint64_t ullLastSyncPoint = 0ULL;
+
+	/* When recording, the interrupts raised by other Windows threads, and the
+	ticks generated by the timer thread, that have not been delivered yet.  Only
+	accessed using interlocked operations. */
+	static volatile uint32_t ulExternalInterrupts = 0UL;
+	static volatile uint32_t ulExternalTicks = 0UL;
+
+	/* When recording, the arrivals that have been encoded but not yet written
+	to the log file.  The buffer is written by the simulated interrupt handler
+	thread, which runs at too high a priority to wait for the file, and emptied
+	by the timer thread.  The head and tail are free running. */
+	static uint8_t ucLogBuffer[ portLOG_BUFFER_SIZE ];
+	static volatile uint32_t ulLogHead = 0UL;
+	static volatile uint32_t ulLogTail = 0UL;
+	static FILE *pxLogFile = NULL;
+	static void *pvLogMutex = NULL;
+
+	/* When replaying, the log read from the file, how much of it has been
+	decoded, and the next arrival to deliver. */
+	static uint8_t *pucReplayLog = NULL;
+	static size_t xReplayLogSize = 0, xReplayLogPosition = 0;
+	static volatile BaseType_t xReplayEntryValid = pdFALSE;
+	static volatile uint64_t ullReplaySyncPoint = 0ULL;
+	static uint32_t ulReplayInterrupts = 0UL, ulReplayTicks = 0UL;
+
+	/* See vPortGetRecordReplayStats(). */
+	static volatile PortRecordReplayStats_t xRecordReplayStats = { 0 };
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
 /* An event used to inform the simulated interrupt processing thread (a high
 priority thread that simulated interrupt processing) that an interrupt is
-pending. */
+pending.  Only set when the interrupt is not masked, as a critical section sets
+it as it exits if an interrupt became pending while it was masked. */
 static void *pvInterruptEvent = NULL;
 
-/* Mutex used to protect all the simulated interrupt variables that are accessed
-by multiple threads. */
-static void *pvInterruptEventMutex = NULL;
-
 /* The critical nesting count for the currently executing task.  This is
 initialised to a non-zero value so interrupts do not become enabled during
 the initialisation phase.  As each task has its own critical nesting value
 ulCriticalNesting will get set to zero when the first task runs.  This
 initialisation is probably not critical in this simulated environment as the
 simulated interrupt handlers do not get created until the FreeRTOS scheduler is
-started anyway. */
-static uint32_t ulCriticalNesting = 9999UL;
+started anyway.  Simulated interrupts are masked while it is non-zero - it is
+only written by the thread executing the Running state task, and a task is only
+switched out while its count is zero, so one variable serves all the tasks. */
+static volatile uint32_t ulCriticalNesting = 9999UL;
 
 /* Handlers for all the simulated software interrupts.  The first two positions
 are used for the Yield and Tick interrupts so are handled slightly differently,
@@ -123,63 +492,246 @@ static BaseType_t xPortRunning = pdFALSE;
 
 /*-----------------------------------------------------------*/
 
+static uint32_t prvTicksDue( LONGLONG llNow, LONGLONG *pllNextTick )
+{
+LONGLONG llLateness, llLatenessUs;
+uint32_t ulTicks;
+
+	/* The tick that was waited for, plus any others that also became due
+	before the thread woke. */
+	llLateness = llNow - *pllNextTick;
+	ulTicks = ( uint32_t ) ( llLateness / llTickPeriod ) + 1UL;
+	*pllNextTick += ( LONGLONG ) ulTicks * llTickPeriod;
+
+	xTickStats.ulTicks += ulTicks;
+	xTickStats.ulMissedTicks += ulTicks - 1UL;
+
+	if( llLateness > ( llTickPeriod / 2 ) )
+	{
+		xTickStats.ulLateTicks++;
+	}
+
+	llLatenessUs = ( llLateness * 1000000 ) / llCounterFrequency;
+	if( llLatenessUs > ( LONGLONG ) xTickStats.ulMaxLatenessUs )
+	{
+		xTickStats.ulMaxLatenessUs = ( uint32_t ) llLatenessUs;
+	}
+
+	return ulTicks;
+}
+/*-----------------------------------------------------------*/
+
+static LONGLONG prvTimerWakeTime( void )
+{
+LONGLONG llWakeTime;
+
+	if( xTicksSuppressed == FALSE )
+	{
+		llWakeTime = llNextTick;
+	}
+	else
+	{
+		/* The idle task is sleeping, don't wake until it has to be woken. */
+		llWakeTime = llSuppressedUntil;
+	}
+
+	return llWakeTime;
+}
+/*-----------------------------------------------------------*/
+
+static LONGLONG prvSimulatedTime( void )
+{
+LARGE_INTEGER xNow;
+
+	QueryPerformanceCounter( &xNow );
+
+	#if( configUSE_VIRTUAL_TIME == 1 )
+	{
+		xNow.QuadPart += llSkipped;
+	}
+	#endif /* configUSE_VIRTUAL_TIME */
+
+	return xNow.QuadPart;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTimedInterruptsDue( LONGLONG llNow )
+{
+uint32_t ulInterruptsDue = 0UL, ulInterruptNumber;
+
+	if( llNow >= llNextInterruptDue )
+	{
+		llNextInterruptDue = LLONG_MAX;
+
+		for( ulInterruptNumber = 0UL; ulInterruptNumber < portMAX_INTERRUPTS; ulInterruptNumber++ )
+		{
+			if( ( ulTimedInterrupts & ( 1UL << ulInterruptNumber ) ) != 0UL )
+			{
+				if( llInterruptDue[ ulInterruptNumber ] <= llNow )
+				{
+					ulInterruptsDue |= ( 1UL << ulInterruptNumber );
+				}
+				else if( llInterruptDue[ ulInterruptNumber ] < llNextInterruptDue )
+				{
+					llNextInterruptDue = llInterruptDue[ ulInterruptNumber ];
+				}
+			}
+		}
+
+		ulTimedInterrupts &= ~ulInterruptsDue;
+	}
+
+	return ulInterruptsDue;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGenerateSimulatedInterrupts( uint32_t ulInterrupts )
+{
+uint32_t ulInterruptNumber = 0UL;
+
+	while( ulInterrupts != 0UL )
+	{
+		portLEAST_SIGNIFICANT_BIT( ulInterruptNumber, ulInterrupts );
+		ulInterrupts &= ~( 1UL << ulInterruptNumber );
+		vPortGenerateSimulatedInterrupt( ulInterruptNumber );
+	}
+}
+/*-----------------------------------------------------------*/
+
 static DWORD WINAPI prvSimulatedPeripheralTimer( LPVOID lpParameter )
 {
-TickType_t xMinimumWindowsBlockTime;
 TIMECAPS xTimeCaps;
+LONGLONG llNow, llWakeTime, llWaitTime;
+DWORD dwSleepTime;
+uint32_t ulTicks = 0UL, ulInterruptsDue;
+BOOL xTickDue;
 
 	/* Set the timer resolution to the maximum possible. */
 	if( timeGetDevCaps( &xTimeCaps, sizeof( xTimeCaps ) ) == MMSYSERR_NOERROR )
 	{
-		xMinimumWindowsBlockTime = ( TickType_t ) xTimeCaps.wPeriodMin;
 		timeBeginPeriod( xTimeCaps.wPeriodMin );
 
 		/* Register an exit handler so the timeBeginPeriod() function can be
 		matched with a timeEndPeriod() when the application exits. */
 		SetConsoleCtrlHandler( prvEndProcess, TRUE );
 	}
-	else
-	{
-		xMinimumWindowsBlockTime = ( TickType_t ) 20;
-	}
 
 	/* Just to prevent compiler warnings. */
 	( void ) lpParameter;
 
+	WaitForSingleObject( pvTimerMutex, INFINITE );
+
 	for( ;; )
 	{
-		/* Wait until the timer expires and we can access the simulated interrupt
-		variables.  *NOTE* this is not a 'real time' way of generating tick
-		events as the next wake time should be relative to the previous wake
-		time, not the time that Sleep() is called.  It is done this way to
-		prevent overruns in this very non real time simulated/emulated
-		environment. */
-		if( portTICK_PERIOD_MS < xMinimumWindowsBlockTime )
+		/* Wait until the next tick is due.  The time each tick is due is
+		relative to when the previous tick was due, not to when this thread
+		last ran, so the tick count does not drift from the host clock however
+		late the thread runs.  Also wake for the first of the timed
+		interrupts. */
+		llWakeTime = prvTimerWakeTime();
+		llWaitTime = ( llNextInterruptDue < llWakeTime ) ? llNextInterruptDue : llWakeTime;
+		llNow = prvSimulatedTime();
+
+		#if( configUSE_VIRTUAL_TIME == 1 )
 		{
-			Sleep( xMinimumWindowsBlockTime );
+			/* If Windows ran this thread late, hold the simulated clock back
+			to the time the first tick or timed interrupt was due, so they are
+			still generated one at a time, in order, rather than together. */
+			if( llNow > llWaitTime )
+			{
+				llSkipped -= llNow - llWaitTime;
+				llNow = llWaitTime;
+			}
 		}
-		else
+		#endif /* configUSE_VIRTUAL_TIME */
+
+		if( llNow < llWaitTime )
 		{
-			Sleep( portTICK_PERIOD_MS );
+			/* Windows cannot wait until an absolute time, so wait for the
+			whole milliseconds remaining, at least one, then check again.  The
+			event is set if the time to wake changes. */
+			if( llWaitTime == LLONG_MAX )
+			{
+				dwSleepTime = INFINITE;
+			}
+			else
+			{
+				dwSleepTime = ( DWORD ) ( ( ( llWaitTime - llNow ) * 1000 ) / llCounterFrequency );
+				if( dwSleepTime == 0 )
+				{
+					dwSleepTime = 1;
+				}
+			}
+
+			ReleaseMutex( pvTimerMutex );
+			WaitForSingleObject( pvTimerEvent, dwSleepTime );
+			WaitForSingleObject( pvTimerMutex, INFINITE );
+
+			xTickStats.ulTimerWakeups++;
+			continue;
 		}
 
 		configASSERT( xPortRunning );
 
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+		ulInterruptsDue = prvTimedInterruptsDue( llNow );
+		xTickDue = ( llNow >= llWakeTime ) ? TRUE : FALSE;
 
-		/* The timer has expired, generate the simulated tick event. */
-		ulPendingInterrupts |= ( 1 << portINTERRUPT_TICK );
+		if( xTickDue == FALSE )
+		{
+			/* Only timed interrupts are due. */
+		}
+		else if( xTicksSuppressed == FALSE )
+		{
+			/* If Windows did not run this thread for longer than a tick period
+			more than one tick is now due.  All of them are generated by the
+			one simulated interrupt, rather than by an interrupt each, so the
+			kernel catches up in a single pass. */
+			ulTicks = prvTicksDue( llNow, &llNextTick );
+		}
+		else
+		{
+			/* Wake the idle task, which works out how many ticks passed while
+			it slept, so no ticks are generated here.  Don't wake again until
+			it has. */
+			ulTicks = 0UL;
+			llSuppressedUntil = LLONG_MAX;
+		}
+
+		ReleaseMutex( pvTimerMutex );
 
-		/* The interrupt is now pending - notify the simulated interrupt
-		handler thread. */
-		if( ulCriticalNesting == 0 )
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
 		{
-			SetEvent( pvInterruptEvent );
+			/* Write out the arrivals recorded since this thread last ran. */
+			if( xRecordReplayMode == portRECORDING )
+			{
+				prvWriteLog();
+			}
+		}
+		#endif
+
+		/* Generate the simulated tick event, and any timed interrupts.  This
+		thread is not a task thread, so does not park. */
+		if( xTickDue != FALSE )
+		{
+			#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+			if( xRecordReplayMode == portRECORDING )
+			{
+				/* The ticks are held with the tick interrupt until it is
+				delivered. */
+				InterlockedExchangeAdd( ( volatile LONG * ) &ulExternalTicks, ( LONG ) ulTicks );
+			}
+			else
+			#endif
+			{
+				InterlockedExchangeAdd( ( volatile LONG * ) &ulPendingTicks, ( LONG ) ulTicks );
+			}
+
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
 		}
 
-		/* Give back the mutex so the simulated interrupt handler unblocks
-		and can	access the interrupt handler variables. */
-		ReleaseMutex( pvInterruptEventMutex );
+		prvGenerateSimulatedInterrupts( ulInterruptsDue );
+
+		WaitForSingleObject( pvTimerMutex, INFINITE );
 	}
 
 	#ifdef __GNUC__
@@ -222,7 +774,22 @@ const SIZE_T xStackSize = 1024; /* Set the size to a small number which will get
 	pxThreadState = ( xThreadState * ) ( pcTopOfStack - sizeof( xThreadState ) );
 
 	/* Create the thread itself. */
-	pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, &( pxThreadState->dwThreadId ) );
+		pxThreadState->pvYieldEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+		pxThreadState->xParkedOnYield = pdFALSE;
+		configASSERT( pxThreadState->pvYieldEvent );
+	}
+	#elif( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, &( pxThreadState->dwThreadId ) );
+	}
+	#else
+	{
+		pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
+	}
+	#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
 	configASSERT( pxThreadState->pvThread ); /* See comment where TerminateThread() is called. */
 	SetThreadAffinityMask( pxThreadState->pvThread, 0x01 );
 	SetThreadPriorityBoost( pxThreadState->pvThread, TRUE );
@@ -238,6 +805,8 @@ void *pvHandle = NULL;
 int32_t lSuccess;
 xThreadState *pxThreadState = NULL;
 SYSTEM_INFO xSystemInfo;
+LARGE_INTEGER xCounterValue;
+LPTHREAD_START_ROUTINE pvTimerThread = prvSimulatedPeripheralTimer;
 
 	/* This port runs windows threads with extremely high priority.  All the
 	threads execute on the same core - to prevent locking up the host only start
@@ -265,14 +834,26 @@ SYSTEM_INFO xSystemInfo;
 
 		/* Create the events and mutexes that are used to synchronise all the
 		threads. */
-		pvInterruptEventMutex = CreateMutex( NULL, FALSE, NULL );
 		pvInterruptEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+		pvTimerMutex = CreateMutex( NULL, FALSE, NULL );
+		pvTimerEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
 
-		if( ( pvInterruptEventMutex == NULL ) || ( pvInterruptEvent == NULL ) )
+		if( ( pvInterruptEvent == NULL ) || ( pvTimerMutex == NULL ) || ( pvTimerEvent == NULL ) )
 		{
 			lSuccess = pdFAIL;
 		}
 
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			pvWakeEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+			if( pvWakeEvent == NULL )
+			{
+				lSuccess = pdFAIL;
+			}
+		}
+		#endif
+
 		/* Set the priority of this thread such that it is above the priority of
 		the threads that run tasks.  This higher priority is required to ensure
 		simulated interrupts take priority over tasks. */
@@ -291,15 +872,32 @@ SYSTEM_INFO xSystemInfo;
 		}
 		SetThreadPriorityBoost( pvHandle, TRUE );
 		SetThreadAffinityMask( pvHandle, 0x01 );
+		dwInterruptThreadId = GetCurrentThreadId();
 	}
 
 	if( lSuccess == pdPASS )
 	{
 		/* Start the thread that simulates the timer peripheral to generate
 		tick interrupts.  The priority is set below that of the simulated
-		interrupt handler so the interrupt event mutex is used for the
-		handshake / overrun protection. */
-		pvHandle = CreateThread( NULL, 0, prvSimulatedPeripheralTimer, NULL, CREATE_SUSPENDED, NULL );
+		interrupt handler.  Ticks are timed with the performance counter. */
+		QueryPerformanceFrequency( &xCounterValue );
+		llCounterFrequency = xCounterValue.QuadPart;
+		llTickPeriod = llCounterFrequency / ( LONGLONG ) configTICK_RATE_HZ;
+		QueryPerformanceCounter( &xCounterValue );
+		llNextTick = xCounterValue.QuadPart + llTickPeriod;
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* When replaying, the ticks and the interrupts come from the log
+			instead. */
+			if( xRecordReplayMode == portREPLAYING )
+			{
+				pvTimerThread = prvReplayLoggedInterrupts;
+			}
+		}
+		#endif
+
+		pvHandle = CreateThread( NULL, 0, pvTimerThread, NULL, CREATE_SUSPENDED, NULL );
 		if( pvHandle != NULL )
 		{
 			SetThreadPriority( pvHandle, portSIMULATED_TIMER_THREAD_PRIORITY );
@@ -337,112 +935,302 @@ static uint32_t prvProcessYieldInterrupt( void )
 
 static uint32_t prvProcessTickInterrupt( void )
 {
-uint32_t ulSwitchRequired;
+uint32_t ulSwitchRequired = pdFALSE, ulTicks;
+UBaseType_t uxSavedInterruptStatus;
 
-	/* Process the tick itself. */
+	/* Process every tick generated since the tick interrupt last ran, which is
+	more than one if the timer thread had to catch up, or the interrupt was
+	held pending by a critical section. */
 	configASSERT( xPortRunning );
-	ulSwitchRequired = ( uint32_t ) xTaskIncrementTick();
+	ulTicks = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulPendingTicks, 0L );
+
+	/* The kernel is updated with the interrupts that can use the API masked,
+	as xPortSysTickHandler() does on a Cortex-M. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	while( ulTicks > 0UL )
+	{
+		ulSwitchRequired |= ( uint32_t ) xTaskIncrementTick();
+		ulTicks--;
+	}
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
 	return ulSwitchRequired;
 }
 /*-----------------------------------------------------------*/
 
-static void prvProcessSimulatedInterrupts( void )
+static BaseType_t prvInInterruptHandler( void )
 {
-uint32_t ulSwitchRequired, i;
-xThreadState *pxThreadState;
-void *pvObjectList[ 2 ];
-CONTEXT xContext;
+	return ( BaseType_t ) ( GetCurrentThreadId() == dwInterruptThreadId );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetInterruptPending( uint32_t ulInterruptNumber )
+{
+	#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+	{
+	LARGE_INTEGER xNow;
 
-	/* Going to block on the mutex that ensured exclusive access to the simulated
-	interrupt objects, and the event that signals that a simulated interrupt
-	should be processed. */
-	pvObjectList[ 0 ] = pvInterruptEventMutex;
-	pvObjectList[ 1 ] = pvInterruptEvent;
+		/* An interrupt raised again before it is processed is only processed
+		once, so its latency is measured from when it was first raised. */
+		if( ( ulPendingInterrupts & ( 1UL << ulInterruptNumber ) ) == 0UL )
+		{
+			QueryPerformanceCounter( &xNow );
+			llInterruptRaised[ ulInterruptNumber ] = xNow.QuadPart;
+		}
+	}
+	#endif
 
-	/* Create a pending tick to ensure the first task is started as soon as
-	this thread pends. */
-	ulPendingInterrupts |= ( 1 << portINTERRUPT_TICK );
-	SetEvent( pvInterruptEvent );
+	InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << ulInterruptNumber ) );
+}
+/*-----------------------------------------------------------*/
 
-	xPortRunning = pdTRUE;
+static void prvRunInterruptHandlers( void )
+{
+uint32_t ulSavedLevel = ulExecutionLevel, ulLevels, ulLevel = 0UL, ulPending, ulInterrupts, ulInterruptNumber = 0UL, ulInterruptBit;
 
-	for(;;)
+	for( ;; )
 	{
-		WaitForMultipleObjects( sizeof( pvObjectList ) / sizeof( void * ), pvObjectList, TRUE, INFINITE );
-
-		/* Used to indicate whether the simulated interrupt processing has
-		necessitated a context switch to another task/thread. */
-		ulSwitchRequired = pdFALSE;
+		/* Find the most urgent level that is not masked and has an interrupt
+		pending.  Only the levels in use are searched, most urgent first. */
+		ulPending = ulPendingInterrupts;
+		ulLevels = ulLevelsInUse & portUNMASKED_LEVELS( ulSavedLevel );
+		ulInterrupts = 0UL;
 
-		/* For each interrupt we are interested in processing, each of which is
-		represented by a bit in the 32bit ulPendingInterrupts variable. */
-		for( i = 0; i < portMAX_INTERRUPTS; i++ )
+		while( ( ulInterrupts == 0UL ) && ( ulLevels != 0UL ) )
 		{
-			/* Is the simulated interrupt pending? */
-			if( ulPendingInterrupts & ( 1UL << i ) )
-			{
-				/* Is a handler installed? */
-				if( ulIsrHandler[ i ] != NULL )
-				{
-					/* Run the actual handler. */
-					if( ulIsrHandler[ i ]() != pdFALSE )
-					{
-						ulSwitchRequired |= ( 1 << i );
-					}
-				}
-
-				/* Clear the interrupt pending bit. */
-				ulPendingInterrupts &= ~( 1UL << i );
-			}
+			portMOST_SIGNIFICANT_BIT( ulLevel, ulLevels );
+			ulInterrupts = ulPending & ulInterruptsAtLevel[ ulLevel ];
+			ulLevels &= ~( 1UL << ulLevel );
 		}
 
-		if( ulSwitchRequired != pdFALSE )
+		if( ulInterrupts == 0UL )
 		{
-			void *pvOldCurrentTCB;
+			/* Nothing that is not masked is pending. */
+			break;
+		}
 
-			pvOldCurrentTCB = pxCurrentTCB;
+		/* Interrupts of equal priority are processed in interrupt number
+		order.  Clear the pending bit before running the handler, so the
+		interrupt can be raised again by the time the handler completes. */
+		portLEAST_SIGNIFICANT_BIT( ulInterruptNumber, ulInterrupts );
+		ulInterruptBit = 1UL << ulInterruptNumber;
+		InterlockedAnd( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ~ulInterruptBit );
 
-			/* Select the next task to run. */
-			vTaskSwitchContext();
+		#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+		{
+			prvRecordInterruptLatency( ulInterruptNumber );
+		}
+		#endif
 
-			/* If the task selected to enter the running state is not the task
-			that is already in the running state. */
-			if( pvOldCurrentTCB != pxCurrentTCB )
+		if( ulIsrHandler[ ulInterruptNumber ] != NULL )
+		{
+			/* Run the handler at the level of its priority, so only a more
+			urgent interrupt can nest within it. */
+			ulExecutionLevel = ulLevel + 1UL;
+			portCOMPILER_BARRIER();
+
+			if( ulIsrHandler[ ulInterruptNumber ]() != pdFALSE )
 			{
-				/* Suspend the old thread. */
-				pxThreadState = ( xThreadState *) *( ( size_t * ) pvOldCurrentTCB );
-				SuspendThread( pxThreadState->pvThread );
-
-				/* Ensure the thread is actually suspended by performing a
-				synchronous operation that can only complete when the thread is
-				actually suspended.  The below code asks for dummy register
-				data. */
-				xContext.ContextFlags = CONTEXT_INTEGER;
-				( void ) GetThreadContext( pxThreadState->pvThread, &xContext );
-
-				/* Obtain the state of the task now selected to enter the
-				Running state. */
-				pxThreadState = ( xThreadState * ) ( *( size_t *) pxCurrentTCB );
-				ResumeThread( pxThreadState->pvThread );
+				ulSwitchPending = pdTRUE;
 			}
-		}
 
-		ReleaseMutex( pvInterruptEventMutex );
+			portCOMPILER_BARRIER();
+			ulExecutionLevel = ulSavedLevel;
+		}
 	}
 }
 /*-----------------------------------------------------------*/
 
-void vPortDeleteThread( void *pvTaskToDelete )
-{
-xThreadState *pxThreadState;
-uint32_t ulErrorCode;
-
-	/* Remove compiler warnings if configASSERT() is not defined. */
-	( void ) ulErrorCode;
-
-	/* Find the handle of the thread being deleted. */
-	pxThreadState = ( xThreadState * ) ( *( size_t *) pvTaskToDelete );
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+
+	static void prvRecordInterruptLatency( uint32_t ulInterruptNumber )
+	{
+	PortInterruptLatency_t *pxLatency = &( xInterruptLatency[ ulInterruptNumber ] );
+	LARGE_INTEGER xNow;
+	LONGLONG llCounts;
+	uint32_t ulLatencyNs = 0UL, ulBucket = 0UL;
+
+		/* The time may have been overwritten by the interrupt being raised
+		again after its pending bit was cleared, in which case the latency
+		counts as 0.  Latencies of four seconds or more saturate. */
+		QueryPerformanceCounter( &xNow );
+		llCounts = xNow.QuadPart - llInterruptRaised[ ulInterruptNumber ];
+
+		if( llCounts >= ( llCounterFrequency * 4 ) )
+		{
+			ulLatencyNs = UINT32_MAX;
+		}
+		else if( llCounts > 0 )
+		{
+			ulLatencyNs = ( uint32_t ) ( ( llCounts * 1000000000LL ) / llCounterFrequency );
+		}
+
+		pxLatency->ulCount++;
+		portMOST_SIGNIFICANT_BIT( ulBucket, ulLatencyNs | 1UL );
+		pxLatency->ulBuckets[ ulBucket ]++;
+
+		if( ulLatencyNs > pxLatency->ulMaxNs )
+		{
+			pxLatency->ulMaxNs = ulLatencyNs;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetInterruptLatency( uint32_t ulInterruptNumber, PortInterruptLatency_t *pxLatency )
+	{
+		configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+
+		if( ulInterruptNumber < portMAX_INTERRUPTS )
+		{
+			portENTER_CRITICAL();
+			*pxLatency = xInterruptLatency[ ulInterruptNumber ];
+			portEXIT_CRITICAL();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortResetInterruptLatency( uint32_t ulInterruptNumber )
+	{
+		configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+
+		if( ulInterruptNumber < portMAX_INTERRUPTS )
+		{
+			portENTER_CRITICAL();
+			memset( &( xInterruptLatency[ ulInterruptNumber ] ), 0x00, sizeof( PortInterruptLatency_t ) );
+			portEXIT_CRITICAL();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_INTERRUPT_LATENCY_HISTOGRAMS */
+
+static void prvProcessSimulatedInterrupts( void )
+{
+xThreadState *pxThreadState;
+CONTEXT xContext;
+
+	/* Create a pending tick to ensure the first task is started as soon as
+	this thread pends. */
+	prvSetInterruptPending( portINTERRUPT_TICK );
+	SetEvent( pvInterruptEvent );
+
+	xPortRunning = pdTRUE;
+
+	for(;;)
+	{
+		WaitForSingleObject( pvInterruptEvent, INFINITE );
+
+		/* This thread executes on the same core as, and at a higher priority
+		than, the task threads, so the task in the Running state is not
+		executing while this thread is.  If it was stopped inside a critical
+		section all but the interrupts more urgent than
+		configMAX_SYSCALL_INTERRUPT_PRIORITY are masked - they remain pending,
+		and the task sets the event again when it exits the critical section. */
+		if( ulCriticalNesting != portNO_CRITICAL_NESTING )
+		{
+			ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+			xInterruptsActive = pdTRUE;
+			prvRunInterruptHandlers();
+			xInterruptsActive = pdFALSE;
+			ulExecutionLevel = 0UL;
+			continue;
+		}
+
+		/* Run the handlers, most urgent first.  An interrupt raised by a
+		handler is processed in the same pass, nesting within the handler if it
+		is more urgent. */
+		xInterruptsActive = pdTRUE;
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			prvTakeExternalInterrupts();
+		}
+		#endif
+
+		prvRunInterruptHandlers();
+
+		/* Only the interrupts that do not use the API can nest within the
+		switch. */
+		ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+
+		if( ulSwitchPending != pdFALSE )
+		{
+			void *pvOldCurrentTCB;
+
+			ulSwitchPending = pdFALSE;
+			pvOldCurrentTCB = pxCurrentTCB;
+
+			/* Select the next task to run. */
+			vTaskSwitchContext();
+
+			/* If the task selected to enter the running state is not the task
+			that is already in the running state. */
+			if( pvOldCurrentTCB != pxCurrentTCB )
+			{
+				pxThreadState = ( xThreadState *) *( ( size_t * ) pvOldCurrentTCB );
+
+				#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+				if( pxThreadState->xParkedOnYield == pdFALSE )
+				#endif
+				{
+					/* Suspend the old thread. */
+					SuspendThread( pxThreadState->pvThread );
+
+					/* Ensure the thread is actually suspended by performing a
+					synchronous operation that can only complete when the thread
+					is actually suspended.  The below code asks for dummy
+					register data. */
+					xContext.ContextFlags = CONTEXT_INTEGER;
+					( void ) GetThreadContext( pxThreadState->pvThread, &xContext );
+				}
+
+				/* Start the task now selected to enter the Running state. */
+				prvResumeTaskThread( pxCurrentTCB );
+			}
+		}
+
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* Arrivals that could not be delivered with interrupts the task
+			raised itself are delivered by another pass. */
+			if( prvEndInterruptProcessing() != pdFALSE )
+			{
+				SetEvent( pvInterruptEvent );
+			}
+		}
+		#endif
+
+		ulExecutionLevel = 0UL;
+		xInterruptsActive = pdFALSE;
+
+		#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		{
+			/* If the thread that raised the interrupt parked itself and its
+			task is still the Running state task, hand control straight back
+			to it. */
+			pxThreadState = ( xThreadState * ) ( *( size_t *) pxCurrentTCB );
+			if( pxThreadState->xParkedOnYield != pdFALSE )
+			{
+				prvResumeTaskThread( pxCurrentTCB );
+			}
+		}
+		#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+xThreadState *pxThreadState;
+uint32_t ulErrorCode;
+
+	/* Remove compiler warnings if configASSERT() is not defined. */
+	( void ) ulErrorCode;
+
+	/* Find the handle of the thread being deleted. */
+	pxThreadState = ( xThreadState * ) ( *( size_t *) pvTaskToDelete );
 
 	/* Check that the thread is still valid, it might have been closed by
 	vPortCloseRunningThread() - which will be the case if the task associated
@@ -450,7 +1238,7 @@ uint32_t ulErrorCode;
 	different task. */
 	if( pxThreadState->pvThread != NULL )
 	{
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+		vPortEnterCritical();
 
 		/* !!! This is not a nice way to terminate a thread, and will eventually
 		result in resources being depleted if tasks frequently delete other
@@ -462,8 +1250,15 @@ uint32_t ulErrorCode;
 		ulErrorCode = CloseHandle( pxThreadState->pvThread );
 		configASSERT( ulErrorCode );
 
-		ReleaseMutex( pvInterruptEventMutex );
+		vPortExitCritical();
+	}
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		ulErrorCode = CloseHandle( pxThreadState->pvYieldEvent );
+		configASSERT( ulErrorCode );
 	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -506,115 +1301,1056 @@ uint32_t ulErrorCode;
 }
 /*-----------------------------------------------------------*/
 
-void vPortEndScheduler( void )
+void vPortGetTickStats( PortTickStats_t *pxStats )
 {
-	exit( 0 );
+	pxStats->ulTicks = xTickStats.ulTicks;
+	pxStats->ulLateTicks = xTickStats.ulLateTicks;
+	pxStats->ulMissedTicks = xTickStats.ulMissedTicks;
+	pxStats->ulMaxLatenessUs = xTickStats.ulMaxLatenessUs;
+	pxStats->ulTimerWakeups = xTickStats.ulTimerWakeups;
 }
 /*-----------------------------------------------------------*/
 
-void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+uint64_t ullPortGetSimulatedTimeNs( void )
 {
-	configASSERT( xPortRunning );
+LARGE_INTEGER xFrequency;
+LONGLONG llNow;
+
+	QueryPerformanceFrequency( &xFrequency );
+	llNow = prvSimulatedTime();
+
+	return ( ( uint64_t ) ( llNow / xFrequency.QuadPart ) * 1000000000ULL ) + ( ( ( uint64_t ) ( llNow % xFrequency.QuadPart ) * 1000000000ULL ) / ( uint64_t ) xFrequency.QuadPart );
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortGetRunTimeNs( void )
+{
+LARGE_INTEGER xFrequency, xNow;
+
+	QueryPerformanceFrequency( &xFrequency );
+	QueryPerformanceCounter( &xNow );
+
+	/* Split the conversion so the multiplication cannot overflow. */
+	return ( ( uint64_t ) ( xNow.QuadPart / xFrequency.QuadPart ) * 1000000000ULL ) + ( ( ( uint64_t ) ( xNow.QuadPart % xFrequency.QuadPart ) * 1000000000ULL ) / ( uint64_t ) xFrequency.QuadPart );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterruptAfter( uint32_t ulInterruptNumber, uint64_t ullDelayNs )
+{
+LARGE_INTEGER xFrequency;
+LONGLONG llDelay;
 
-	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( pvInterruptEventMutex != NULL ) )
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
 	{
-		/* Yield interrupts are processed even when critical nesting is
-		non-zero. */
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
-		ulPendingInterrupts |= ( 1 << ulInterruptNumber );
+		/* The delay in performance counter counts.  The frequency is obtained
+		here as this can be called before the scheduler is started. */
+		QueryPerformanceFrequency( &xFrequency );
+		llDelay = ( LONGLONG ) ( ullDelayNs / 1000000000ULL ) * xFrequency.QuadPart;
+		llDelay += ( ( LONGLONG ) ( ullDelayNs % 1000000000ULL ) * xFrequency.QuadPart ) / 1000000000LL;
+
+		/* The mutex does not exist until the scheduler is started, but then
+		neither does the timer thread. */
+		if( pvTimerMutex != NULL )
+		{
+			WaitForSingleObject( pvTimerMutex, INFINITE );
+		}
 
-		/* The simulated interrupt is now held pending, but don't actually
-		process it yet if this call is within a critical section.  It is
-		possible for this to be in a critical section as calls to wait for
-		mutexes are accumulative. */
-		if( ulCriticalNesting == 0 )
+		llInterruptDue[ ulInterruptNumber ] = prvSimulatedTime() + llDelay;
+		ulTimedInterrupts |= ( 1UL << ulInterruptNumber );
+
+		/* If it is due before the timer thread next wakes, wake it now to
+		wait for the new time. */
+		if( llInterruptDue[ ulInterruptNumber ] < llNextInterruptDue )
 		{
-			SetEvent( pvInterruptEvent );
+			llNextInterruptDue = llInterruptDue[ ulInterruptNumber ];
+
+			if( pvTimerEvent != NULL )
+			{
+				SetEvent( pvTimerEvent );
+			}
 		}
 
-		ReleaseMutex( pvInterruptEventMutex );
+		if( pvTimerMutex != NULL )
+		{
+			ReleaseMutex( pvTimerMutex );
+		}
 	}
 }
 /*-----------------------------------------------------------*/
 
-void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+
+static void prvTakeExternalInterrupts( void )
 {
-	if( ulInterruptNumber < portMAX_INTERRUPTS )
+uint32_t ulInterrupts = 0UL, ulTicks = 0UL, ulHead, ulInterruptNumber = 0UL;
+
+	if( xRecordReplayMode == portNOT_RECORDING )
+	{
+		/* Interrupts raised by other Windows threads are delivered as they
+		arrive. */
+	}
+	else if( ulPendingInterrupts != 0UL )
+	{
+		/* Only the task can have raised these, as the interrupts raised by
+		other Windows threads are held until they are delivered here.  They are
+		processed on their own, and the synchronisation point counted once they
+		have been, so an arrival is never delivered part way through. */
+		xSyncPointPending = pdTRUE;
+	}
+	else if( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED )
+	{
+		/* vTaskSuspendAll() is not a critical section, but an arrival is still
+		held until xTaskResumeAll() completes, as the kernel state it finds
+		would otherwise depend on how far between the two the task had got. */
+	}
+	else if( xRecordReplayMode == portRECORDING )
 	{
-		if( pvInterruptEventMutex != NULL )
+		ulInterrupts = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulExternalInterrupts, 0 );
+
+		if( ( ulInterrupts & ( 1UL << portINTERRUPT_TICK ) ) != 0UL )
 		{
-			WaitForSingleObject( pvInterruptEventMutex, INFINITE );
-			ulIsrHandler[ ulInterruptNumber ] = pvHandler;
-			ReleaseMutex( pvInterruptEventMutex );
+			ulTicks = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulExternalTicks, 0 );
 		}
-		else
+
+		if( ulInterrupts != 0UL )
+		{
+			/* The entry is only made visible to the timer thread once it is
+			complete, so the log never ends part way through one. */
+			ulHead = ulLogHead;
+			prvLogValue( &ulHead, ullSyncPoints - ullLastSyncPoint );
+			prvLogValue( &ulHead, ( uint64_t ) ulInterrupts );
+
+			if( ( ulInterrupts & ( 1UL << portINTERRUPT_TICK ) ) != 0UL )
+			{
+				prvLogValue( &ulHead, ( uint64_t ) ulTicks );
+			}
+
+			InterlockedExchange( ( volatile LONG * ) &ulLogHead, ( LONG ) ulHead );
+			ullLastSyncPoint = ullSyncPoints;
+			xRecordReplayStats.ulEntries++;
+		}
+	}
+	else if( prvExternalInterruptsWaiting() != pdFALSE )
+	{
+		/* The tasks may have passed the synchronisation point the arrival was
+		recorded at if the kernel has changed since it was recorded. */
+		if( ullReplaySyncPoint < ullSyncPoints )
+		{
+			xRecordReplayStats.ulLateEntries++;
+		}
+
+		ulInterrupts = ulReplayInterrupts;
+		ulTicks = ulReplayTicks;
+		xRecordReplayStats.ulEntries++;
+		prvReadReplayEntry();
+	}
+
+	if( ulInterrupts != 0UL )
+	{
+		InterlockedExchangeAdd( ( volatile LONG * ) &ulPendingTicks, ( LONG ) ulTicks );
+
+		while( ulInterrupts != 0UL )
 		{
-			ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+			portLEAST_SIGNIFICANT_BIT( ulInterruptNumber, ulInterrupts );
+			ulInterrupts &= ~( 1UL << ulInterruptNumber );
+			prvSetInterruptPending( ulInterruptNumber );
 		}
 	}
 }
 /*-----------------------------------------------------------*/
 
-void vPortEnterCritical( void )
+static BaseType_t prvEndInterruptProcessing( void )
 {
-	if( xPortRunning == pdTRUE )
+	if( xSyncPointPending != pdFALSE )
 	{
-		/* The interrupt event mutex is held for the entire critical section,
-		effectively disabling (simulated) interrupts. */
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
-		ulCriticalNesting++;
+		xSyncPointPending = pdFALSE;
+		InterlockedIncrement64( ( volatile LONGLONG * ) &ullSyncPoints );
 	}
-	else
+
+	return prvExternalInterruptsWaiting();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvExternalInterruptsWaiting( void )
+{
+BaseType_t xWaiting = pdFALSE;
+
+	if( xRecordReplayMode == portRECORDING )
+	{
+		xWaiting = ( ulExternalInterrupts != 0UL ) ? pdTRUE : pdFALSE;
+	}
+	else if( xRecordReplayMode == portREPLAYING )
 	{
-		ulCriticalNesting++;
+		xWaiting = ( ( xReplayEntryValid != pdFALSE ) && ( portREAD_64( ullReplaySyncPoint ) <= portREAD_64( ullSyncPoints ) ) ) ? pdTRUE : pdFALSE;
 	}
+
+	/* Nothing is delivered while the scheduler is suspended, see
+	prvTakeExternalInterrupts(). */
+	if( ( xWaiting != pdFALSE ) && ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) )
+	{
+		xWaiting = pdFALSE;
+	}
+
+	return xWaiting;
 }
 /*-----------------------------------------------------------*/
 
-void vPortExitCritical( void )
+static BaseType_t prvIsRunningTaskThread( void )
 {
-int32_t lMutexNeedsReleasing;
+xThreadState *pxThreadState;
+BaseType_t xReturn = pdFALSE;
 
-	/* The interrupt event mutex should already be held by this thread as it was
-	obtained on entry to the critical section. */
+	if( ( xPortRunning == pdTRUE ) && ( pxCurrentTCB != NULL ) )
+	{
+		pxThreadState = ( xThreadState * ) ( *( size_t *) pxCurrentTCB );
 
-	lMutexNeedsReleasing = pdTRUE;
+		if( ( pxThreadState->pvThread != NULL ) && ( pxThreadState->dwThreadId == GetCurrentThreadId() ) )
+		{
+			xReturn = pdTRUE;
+		}
+	}
 
-	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvAtSynchronisationPoint( void )
+{
+BaseType_t xReturn = pdFALSE;
+
+	/* Only a task passes synchronisation points, and only while the interrupts
+	raised by other Windows threads can be delivered. */
+	if( ( xRecordReplayMode != portNOT_RECORDING ) && ( ulCriticalNesting == portNO_CRITICAL_NESTING ) )
 	{
-		if( ulCriticalNesting == ( portNO_CRITICAL_NESTING + 1 ) )
+		xReturn = prvIsRunningTaskThread();
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeliverDueArrivals( void )
+{
+void *pvParkingThreadState = NULL;
+
+	/* A replayed arrival that is due must be delivered before the task passes
+	the synchronisation point, even if the replay thread has not noticed it
+	yet.  The simulated interrupt handler thread runs on the same core at a
+	higher priority, so processes the arrival as soon as it is signalled. */
+	while( ( xRecordReplayMode == portREPLAYING ) && ( prvExternalInterruptsWaiting() != pdFALSE ) )
+	{
+		#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
 		{
-			ulCriticalNesting--;
+			pvParkingThreadState = prvPrepareToPark();
+		}
+		#endif
 
-			/* Were any interrupts set to pending while interrupts were
-			(simulated) disabled? */
-			if( ulPendingInterrupts != 0UL )
-			{
-				configASSERT( xPortRunning );
-				SetEvent( pvInterruptEvent );
+		SetEvent( pvInterruptEvent );
 
-				/* Mutex will be released now, so does not require releasing
-				on function exit. */
-				lMutexNeedsReleasing = pdFALSE;
-				ReleaseMutex( pvInterruptEventMutex );
+		#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		{
+			if( pvParkingThreadState != NULL )
+			{
+				prvPark( pvParkingThreadState );
 			}
 		}
-		else
+		#endif
+	}
+
+	/* Remove compiler warnings if configUSE_HANDOFF_CONTEXT_SWITCH is 0. */
+	( void ) pvParkingThreadState;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSynchronisationPoint( void )
+{
+	/* Called by vTaskSuspendAll().  An arrival due at the current
+	synchronisation point is delivered before the scheduler is suspended, and
+	none are delivered again until it is resumed, so the call does not need to
+	be counted. */
+	if( prvAtSynchronisationPoint() != pdFALSE )
+	{
+		prvDeliverDueArrivals();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLogValue( uint32_t *pulHead, uint64_t ullValue )
+{
+uint8_t ucByte;
+
+	/* Seven bits at a time, least significant first, with the top bit of each
+	byte set if another byte follows.  Most values fit in a single byte. */
+	do
+	{
+		ucByte = ( uint8_t ) ( ullValue & 0x7fULL );
+		ullValue >>= 7;
+
+		if( ullValue != 0ULL )
 		{
-			/* Tick interrupts will still not be processed as the critical
-			nesting depth will not be zero. */
-			ulCriticalNesting--;
+			ucByte |= 0x80U;
+		}
+
+		/* The timer thread empties the buffer every tick, so it should never
+		fill. */
+		configASSERT( ( *pulHead - ulLogTail ) < portLOG_BUFFER_SIZE );
+		ucLogBuffer[ *pulHead & ( portLOG_BUFFER_SIZE - 1UL ) ] = ucByte;
+		( *pulHead )++;
+
+	} while( ullValue != 0ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteLog( void )
+{
+uint32_t ulHead, ulTail, ulBytes;
+
+	WaitForSingleObject( pvLogMutex, INFINITE );
+
+	ulHead = ulLogHead;
+	ulTail = ulLogTail;
+	portCOMPILER_BARRIER();
+
+	if( ulHead != ulTail )
+	{
+		while( ulTail != ulHead )
+		{
+			/* Up to the end of the buffer, then from the start. */
+			ulBytes = portLOG_BUFFER_SIZE - ( ulTail & ( portLOG_BUFFER_SIZE - 1UL ) );
+
+			if( ulBytes > ( ulHead - ulTail ) )
+			{
+				ulBytes = ulHead - ulTail;
+			}
+
+			fwrite( &( ucLogBuffer[ ulTail & ( portLOG_BUFFER_SIZE - 1UL ) ] ), 1, ulBytes, pxLogFile );
+			xRecordReplayStats.ulBytes += ulBytes;
+			ulTail += ulBytes;
 		}
+
+		InterlockedExchange( ( volatile LONG * ) &ulLogTail, ( LONG ) ulTail );
+
+		/* So the log is complete up to the last tick however the process is
+		stopped. */
+		fflush( pxLogFile );
 	}
 
-	if( pvInterruptEventMutex != NULL )
+	ReleaseMutex( pvLogMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFlushLog( void )
+{
+	/* Registered with atexit(), so the arrivals recorded since the timer
+	thread last ran are not lost when the scheduler is ended. */
+	prvWriteLog();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReadLogValue( uint64_t *pullValue )
+{
+uint8_t ucByte;
+uint32_t ulShift = 0UL;
+BaseType_t xReturn = pdFAIL;
+
+	*pullValue = 0ULL;
+
+	while( ( xReplayLogPosition < xReplayLogSize ) && ( ulShift < 64UL ) )
 	{
-		if( lMutexNeedsReleasing == pdTRUE )
+		ucByte = pucReplayLog[ xReplayLogPosition ];
+		xReplayLogPosition++;
+		*pullValue |= ( ( uint64_t ) ( ucByte & 0x7fU ) ) << ulShift;
+		ulShift += 7UL;
+
+		if( ( ucByte & 0x80U ) == 0U )
 		{
-			configASSERT( xPortRunning );
-			ReleaseMutex( pvInterruptEventMutex );
+			xReturn = pdPASS;
+			break;
 		}
 	}
+
+	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
+static void prvReadReplayEntry( void )
+{
+uint64_t ullDelta, ullInterrupts, ullTicks = 0ULL;
+BaseType_t xValid;
+
+	xValid = prvReadLogValue( &ullDelta );
+
+	if( xValid != pdFAIL )
+	{
+		xValid = prvReadLogValue( &ullInterrupts );
+	}
+
+	if( ( xValid != pdFAIL ) && ( ( ullInterrupts & ( 1ULL << portINTERRUPT_TICK ) ) != 0ULL ) )
+	{
+		xValid = prvReadLogValue( &ullTicks );
+	}
+
+	if( ( xValid != pdFAIL ) && ( ullInterrupts != 0ULL ) && ( ullInterrupts <= UINT32_MAX ) )
+	{
+		ullLastSyncPoint += ullDelta;
+		ulReplayInterrupts = ( uint32_t ) ullInterrupts;
+		ulReplayTicks = ( uint32_t ) ullTicks;
+		InterlockedExchange64( ( volatile LONGLONG * ) &ullReplaySyncPoint, ( LONGLONG ) ullLastSyncPoint );
+		xRecordReplayStats.ulBytes = ( uint32_t ) xReplayLogPosition;
+	}
+	else
+	{
+		/* The end of the log, or an entry cut short when the recording was
+		stopped. */
+		xValid = pdFALSE;
+	}
+
+	InterlockedExchange( ( volatile LONG * ) &xReplayEntryValid, ( LONG ) xValid );
+}
+/*-----------------------------------------------------------*/
+
+static DWORD WINAPI prvReplayLoggedInterrupts( LPVOID lpParameter )
+{
+TIMECAPS xTimeCaps;
+
+	/* Sleep() is only as precise as the timer resolution. */
+	if( timeGetDevCaps( &xTimeCaps, sizeof( xTimeCaps ) ) == MMSYSERR_NOERROR )
+	{
+		timeBeginPeriod( xTimeCaps.wPeriodMin );
+		SetConsoleCtrlHandler( prvEndProcess, TRUE );
+	}
+
+	/* Just to prevent compiler warnings. */
+	( void ) lpParameter;
+
+	/* The tasks deliver the arrivals that are due as they pass synchronisation
+	points, so this thread is only needed when they stop passing them - which
+	also stops them reaching the synchronisation point of the next arrival, so
+	simply checking periodically is enough. */
+	while( xReplayEntryValid != pdFALSE )
+	{
+		if( ( ulCriticalNesting == portNO_CRITICAL_NESTING ) && ( portREAD_64( ullReplaySyncPoint ) <= portREAD_64( ullSyncPoints ) ) )
+		{
+			SetEvent( pvInterruptEvent );
+		}
+
+		Sleep( 1 );
+	}
+
+	/* The whole log has been replayed. */
+	vPortEndScheduler();
+
+	#ifdef __GNUC__
+		/* Should never reach here - MingW complains if you leave this line out,
+		MSVC complains if you put it in. */
+		return 0;
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortRecordInterrupts( const char *pcFileName )
+{
+uint32_t ulHeader[ 3 ] = { portLOG_MAGIC, portLOG_VERSION, ( uint32_t ) configTICK_RATE_HZ };
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xPortRunning == pdFALSE );
+
+	if( ( xRecordReplayMode == portNOT_RECORDING ) && ( xPortRunning == pdFALSE ) )
+	{
+		pvLogMutex = CreateMutex( NULL, FALSE, NULL );
+		pxLogFile = fopen( pcFileName, "wb" );
+
+		if( ( pvLogMutex != NULL ) && ( pxLogFile != NULL ) )
+		{
+			if( fwrite( ulHeader, sizeof( ulHeader ), 1, pxLogFile ) == 1 )
+			{
+				xRecordReplayStats.ulBytes = ( uint32_t ) sizeof( ulHeader );
+				xRecordReplayMode = portRECORDING;
+				atexit( prvFlushLog );
+				xReturn = pdPASS;
+			}
+		}
+
+		if( xReturn == pdFAIL )
+		{
+			if( pxLogFile != NULL )
+			{
+				fclose( pxLogFile );
+				pxLogFile = NULL;
+			}
+
+			if( pvLogMutex != NULL )
+			{
+				CloseHandle( pvLogMutex );
+				pvLogMutex = NULL;
+			}
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortReplayInterrupts( const char *pcFileName )
+{
+FILE *pxFile;
+long lSize;
+uint32_t ulHeader[ 3 ];
+BaseType_t xReturn = pdFAIL;
+
+	configASSERT( xPortRunning == pdFALSE );
+
+	if( ( xRecordReplayMode == portNOT_RECORDING ) && ( xPortRunning == pdFALSE ) )
+	{
+		pxFile = fopen( pcFileName, "rb" );
+
+		if( pxFile != NULL )
+		{
+			/* The log is read into memory up front, so reading it never holds
+			up the delivery of an arrival.  This uses the host heap, not the
+			FreeRTOS heap. */
+			if( ( fseek( pxFile, 0L, SEEK_END ) == 0 ) && ( ( lSize = ftell( pxFile ) ) >= ( long ) sizeof( ulHeader ) ) && ( fseek( pxFile, 0L, SEEK_SET ) == 0 ) )
+			{
+				xReplayLogSize = ( size_t ) lSize;
+				pucReplayLog = ( uint8_t * ) malloc( xReplayLogSize );
+
+				if( ( pucReplayLog != NULL ) && ( fread( pucReplayLog, 1, xReplayLogSize, pxFile ) == xReplayLogSize ) )
+				{
+					memcpy( ulHeader, pucReplayLog, sizeof( ulHeader ) );
+
+					if( ( ulHeader[ 0 ] == portLOG_MAGIC ) && ( ulHeader[ 1 ] == portLOG_VERSION ) && ( ulHeader[ 2 ] == ( uint32_t ) configTICK_RATE_HZ ) )
+					{
+						xReplayLogPosition = sizeof( ulHeader );
+						prvReadReplayEntry();
+						xRecordReplayMode = portREPLAYING;
+						xReturn = pdPASS;
+					}
+				}
+
+				if( ( xReturn == pdFAIL ) && ( pucReplayLog != NULL ) )
+				{
+					free( pucReplayLog );
+					pucReplayLog = NULL;
+				}
+			}
+
+			fclose( pxFile );
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetRecordReplayStats( PortRecordReplayStats_t *pxStats )
+{
+	pxStats->ulEntries = xRecordReplayStats.ulEntries;
+	pxStats->ulLateEntries = xRecordReplayStats.ulLateEntries;
+	pxStats->ulBytes = xRecordReplayStats.ulBytes;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+static void prvWaitForInterrupt( void )
+{
+	/* An interrupt raised while this task is in the critical section sets the
+	wake event, which remains set if the interrupt is raised between the check
+	and the wait. */
+	configASSERT( ulCriticalNesting == ( portNO_CRITICAL_NESTING + 1 ) );
+
+	while( ulPendingInterrupts == 0UL )
+	{
+		WaitForSingleObject( pvWakeEvent, INFINITE );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+eSleepModeStatus eSleepStatus;
+LONGLONG llNow;
+uint32_t ulTicksElapsed = 0UL, ulTicksToStep, ulInterruptsDue;
+BOOL xSleep = TRUE;
+
+	/* Called by the idle task with the scheduler suspended.  Mask the
+	simulated interrupts, then check it is still ok to sleep. */
+	portDISABLE_INTERRUPTS();
+
+	eSleepStatus = eTaskConfirmSleepModeStatus();
+
+	if( ( eSleepStatus == eAbortSleep ) || ( ulPendingInterrupts != 0UL ) )
+	{
+		/* A task became ready, or an interrupt is pending, since the idle
+		task decided to sleep. */
+		portENABLE_INTERRUPTS();
+	}
+	else
+	{
+		/* Stop the timer thread generating ticks.  Instead it wakes this task
+		when the tick that ends the expected idle time is due - unless no task
+		is waiting for a timeout, in which case only another interrupt ends the
+		sleep. */
+		WaitForSingleObject( pvTimerMutex, INFINITE );
+		xTicksSuppressed = TRUE;
+
+		if( eSleepStatus == eNoTasksWaitingTimeout )
+		{
+			llSuppressedUntil = LLONG_MAX;
+		}
+		else
+		{
+			llSuppressedUntil = llNextTick + ( ( ( LONGLONG ) xExpectedIdleTime - 1 ) * llTickPeriod );
+		}
+
+		#if( configUSE_VIRTUAL_TIME == 1 )
+		{
+		LONGLONG llWakeTime;
+
+			/* Rather than sleep until the performance counter reaches the time
+			at which the sleep ends, move the simulated clock straight on to it
+			- or on to the first timed interrupt, if that is sooner.  Nothing
+			timed by the simulated clock can happen in between.  Only an
+			interrupt raised by another Windows thread can end the sleep if
+			neither is due. */
+			llWakeTime = ( llNextInterruptDue < llSuppressedUntil ) ? llNextInterruptDue : llSuppressedUntil;
+
+			if( llWakeTime != LLONG_MAX )
+			{
+				llNow = prvSimulatedTime();
+
+				if( llWakeTime > llNow )
+				{
+					llSkipped += llWakeTime - llNow;
+				}
+
+				xSleep = FALSE;
+			}
+		}
+		#endif /* configUSE_VIRTUAL_TIME */
+
+		if( xSleep != FALSE )
+		{
+			SetEvent( pvTimerEvent );
+			ReleaseMutex( pvTimerMutex );
+
+			prvWaitForInterrupt();
+
+			WaitForSingleObject( pvTimerMutex, INFINITE );
+		}
+
+		/* Work out how many ticks became due while sleeping, and let the
+		timer thread generate ticks again.  Timed interrupts that became due
+		are raised here, rather than by the timer thread, so they are processed
+		after the ticks that came before them. */
+		llNow = prvSimulatedTime();
+		ulInterruptsDue = prvTimedInterruptsDue( llNow );
+
+		if( llNow >= llNextTick )
+		{
+			ulTicksElapsed = ( uint32_t ) ( ( llNow - llNextTick ) / llTickPeriod ) + 1UL;
+			llNextTick += ( LONGLONG ) ulTicksElapsed * llTickPeriod;
+		}
+
+		xTickStats.ulTicks += ulTicksElapsed;
+		xTicksSuppressed = FALSE;
+		SetEvent( pvTimerEvent );
+		ReleaseMutex( pvTimerMutex );
+
+		/* Step the tick count over all but the last of the ticks that are not
+		after the expected idle time.  The rest are processed by the tick
+		interrupt, so tasks whose timeout has expired are unblocked. */
+		ulTicksToStep = ulTicksElapsed;
+		if( ulTicksToStep > ( ( uint32_t ) xExpectedIdleTime - 1UL ) )
+		{
+			ulTicksToStep = ( uint32_t ) xExpectedIdleTime - 1UL;
+		}
+
+		vTaskStepTick( ( TickType_t ) ulTicksToStep );
+
+		if( ulTicksElapsed > ulTicksToStep )
+		{
+			InterlockedExchangeAdd( ( volatile LONG * ) &ulPendingTicks, ( LONG ) ( ulTicksElapsed - ulTicksToStep ) );
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+
+		prvGenerateSimulatedInterrupts( ulInterruptsDue );
+
+		/* Process the interrupt that ended the sleep. */
+		portENABLE_INTERRUPTS();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+void vPortEndScheduler( void )
+{
+	exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+void *pvParkingThreadState = NULL;
+
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber >= portMAX_INTERRUPTS )
+	{
+		/* Not a valid interrupt number. */
+	}
+	else if( prvInInterruptHandler() != pdFALSE )
+	{
+		/* Raised by a simulated interrupt handler.  The interrupt is processed
+		straight away if it is more urgent than the handler, otherwise before
+		this thread lets the task run again. */
+		prvSetInterruptPending( ulInterruptNumber );
+		prvRunInterruptHandlers();
+	}
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	else if( ( xRecordReplayMode != portNOT_RECORDING ) && ( prvIsRunningTaskThread() == pdFALSE ) )
+	{
+		/* Raised by another Windows thread.  When recording the interrupt is
+		held until it can be delivered between two synchronisation points, see
+		prvTakeExternalInterrupts(), and as when it is masked by a critical
+		section vPortExitCritical() sets the event if it is raised during one.
+		When replaying the log delivers these interrupts instead. */
+		if( xRecordReplayMode == portRECORDING )
+		{
+			InterlockedOr( ( volatile LONG * ) &ulExternalInterrupts, ( LONG ) ( 1UL << ulInterruptNumber ) );
+
+			if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+			{
+				SetEvent( pvInterruptEvent );
+			}
+		}
+	}
+	#endif /* configUSE_INTERRUPT_RECORD_REPLAY */
+	else
+	{
+		#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+		{
+			/* A task raising an interrupt is a synchronisation point, counted
+			once the interrupt has been processed. */
+			if( prvAtSynchronisationPoint() != pdFALSE )
+			{
+				prvDeliverDueArrivals();
+			}
+		}
+		#endif
+
+		#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		{
+			/* The interrupt is processed as soon as it is raised unless it is
+			masked, so the task thread prepares to park first. */
+			if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+			{
+				pvParkingThreadState = prvPrepareToPark();
+			}
+		}
+		#endif
+
+		prvSetInterruptPending( ulInterruptNumber );
+
+		/* The simulated interrupt is now held pending, but don't actually
+		process it yet if this call is within a critical section.  It is
+		possible for this to be in a critical section as calls to wait for
+		mutexes are accumulative.  When raised by a thread other than the task
+		thread the critical nesting count can change at any time - but it is
+		read after the pending bit is set, and vPortExitCritical() reads the
+		pending bits after clearing the count, so at least one of the two sets
+		the event.  A critical section does not mask the interrupts more urgent
+		than configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+		if( ( ulCriticalNesting == portNO_CRITICAL_NESTING ) || ( ucInterruptLevel[ ulInterruptNumber ] >= portKERNEL_EXECUTION_LEVEL ) )
+		{
+			SetEvent( pvInterruptEvent );
+		}
+		else
+		{
+			#if( configUSE_TICKLESS_IDLE == 1 )
+			{
+				/* The idle task may be sleeping in the critical section. */
+				SetEvent( pvWakeEvent );
+			}
+			#endif
+		}
+
+		#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+		{
+			if( pvParkingThreadState != NULL )
+			{
+				prvPark( pvParkingThreadState );
+			}
+		}
+		#endif
+	}
+
+	/* Remove compiler warnings if configUSE_HANDOFF_CONTEXT_SWITCH is 0. */
+	( void ) pvParkingThreadState;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	/* Only the simulated interrupt handler thread uses the handlers, and
+	writing a pointer is atomic. */
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority )
+{
+uint32_t ulOldLevel, ulNewLevel, ulInterruptBit;
+
+	configASSERT( ulInterruptNumber < portMAX_INTERRUPTS );
+	configASSERT( ulPriority < portINTERRUPT_PRIORITY_LEVELS );
+
+	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( ulPriority < portINTERRUPT_PRIORITY_LEVELS ) )
+	{
+		ulInterruptBit = 1UL << ulInterruptNumber;
+		ulNewLevel = portPRIORITY_TO_LEVEL( ulPriority );
+
+		/* The interrupts that are not masked by a critical section can read
+		the levels at any time, so the interrupt is added to its new level
+		before it is removed from its old one, and is never at neither. */
+		portENTER_CRITICAL();
+		{
+			ulOldLevel = ucInterruptLevel[ ulInterruptNumber ];
+			InterlockedOr( ( volatile LONG * ) &( ulInterruptsAtLevel[ ulNewLevel ] ), ( LONG ) ulInterruptBit );
+			InterlockedOr( ( volatile LONG * ) &ulLevelsInUse, ( LONG ) ( 1UL << ulNewLevel ) );
+			ucInterruptLevel[ ulInterruptNumber ] = ( uint8_t ) ulNewLevel;
+
+			if( ulOldLevel != ulNewLevel )
+			{
+				if( ( ( uint32_t ) InterlockedAnd( ( volatile LONG * ) &( ulInterruptsAtLevel[ ulOldLevel ] ), ( LONG ) ~ulInterruptBit ) & ~ulInterruptBit ) == 0UL )
+				{
+					InterlockedAnd( ( volatile LONG * ) &ulLevelsInUse, ( LONG ) ~( 1UL << ulOldLevel ) );
+				}
+			}
+		}
+		portEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t ulPortSetInterruptMaskFromISR( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	if( prvInInterruptHandler() != pdFALSE )
+	{
+		/* Raise the execution level so only the interrupts that do not use
+		the API can nest. */
+		uxSavedInterruptStatus = ( UBaseType_t ) ulExecutionLevel;
+
+		if( ulExecutionLevel < portKERNEL_EXECUTION_LEVEL )
+		{
+			ulExecutionLevel = portKERNEL_EXECUTION_LEVEL;
+		}
+
+		portCOMPILER_BARRIER();
+	}
+	else
+	{
+		vPortEnterCritical();
+		uxSavedInterruptStatus = portTASK_INTERRUPT_MASK;
+	}
+
+	return uxSavedInterruptStatus;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedInterruptStatus )
+{
+	if( uxSavedInterruptStatus == portTASK_INTERRUPT_MASK )
+	{
+		vPortExitCritical();
+	}
+	else
+	{
+		portCOMPILER_BARRIER();
+		ulExecutionLevel = ( uint32_t ) uxSavedInterruptStatus;
+
+		/* Process any interrupt that became pending while it was masked and is
+		more urgent than the handler. */
+		if( ulPendingInterrupts != 0UL )
+		{
+			prvRunInterruptHandlers();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+BaseType_t xSynchronise = pdFALSE;
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		/* Entering a critical section is a synchronisation point.  Arrivals
+		that are due are delivered first, and the point counted once inside, so
+		none is delivered between the two. */
+		xSynchronise = prvAtSynchronisationPoint();
+
+		if( xSynchronise != pdFALSE )
+		{
+			prvDeliverDueArrivals();
+		}
+	}
+	#endif
+
+	/* Simulated interrupts are masked as soon as the critical nesting count is
+	incremented, as the simulated interrupt handler thread checks the count
+	before processing them, and cannot run while the task thread is part way
+	through the increment.  No Windows call is made. */
+	ulCriticalNesting++;
+	portCOMPILER_BARRIER();
+
+	#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	{
+		if( xSynchronise != pdFALSE )
+		{
+			InterlockedIncrement64( ( volatile LONGLONG * ) &ullSyncPoints );
+		}
+	}
+	#endif
+
+	/* Remove compiler warnings if configUSE_INTERRUPT_RECORD_REPLAY is 0. */
+	( void ) xSynchronise;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+void *pvParkingThreadState = NULL;
+BaseType_t xInterruptsWaiting;
+
+	portCOMPILER_BARRIER();
+
+	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		if( ulCriticalNesting == ( portNO_CRITICAL_NESTING + 1 ) )
+		{
+			/* Unmask the simulated interrupts, then check whether any were set
+			to pending while they were masked.  The interlocked exchange orders
+			the two.  The interrupt handler thread is only signalled if one was,
+			so the usual case makes no Windows call. */
+			InterlockedExchange( ( volatile LONG * ) &ulCriticalNesting, ( LONG ) portNO_CRITICAL_NESTING );
+			xInterruptsWaiting = ( ulPendingInterrupts != 0UL ) ? pdTRUE : pdFALSE;
+
+			#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+			{
+				/* Or arrived from another Windows thread, and are held until
+				now. */
+				if( xInterruptsWaiting == pdFALSE )
+				{
+					xInterruptsWaiting = prvExternalInterruptsWaiting();
+				}
+			}
+			#endif
+
+			if( xInterruptsWaiting != pdFALSE )
+			{
+				configASSERT( xPortRunning );
+
+				#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+				{
+					pvParkingThreadState = prvPrepareToPark();
+				}
+				#endif
+
+				SetEvent( pvInterruptEvent );
+			}
+		}
+		else
+		{
+			/* Tick interrupts will still not be processed as the critical
+			nesting depth will not be zero. */
+			ulCriticalNesting--;
+		}
+	}
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		if( pvParkingThreadState != NULL )
+		{
+			prvPark( pvParkingThreadState );
+		}
+	}
+	#endif
+
+	/* Remove compiler warnings if configUSE_HANDOFF_CONTEXT_SWITCH is 0. */
+	( void ) pvParkingThreadState;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeTaskThread( void *pvTCB )
+{
+xThreadState *pxThreadState = ( xThreadState * ) ( *( size_t *) pvTCB );
+
+	#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+	{
+		if( pxThreadState->xParkedOnYield != pdFALSE )
+		{
+			/* The thread parked itself, so is waiting on its own event rather
+			than suspended. */
+			pxThreadState->xParkedOnYield = pdFALSE;
+			SetEvent( pxThreadState->pvYieldEvent );
+		}
+		else
+		{
+			ResumeThread( pxThreadState->pvThread );
+		}
+	}
+	#else
+	{
+		ResumeThread( pxThreadState->pvThread );
+	}
+	#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_HANDOFF_CONTEXT_SWITCH == 1 )
+
+	static void *prvPrepareToPark( void )
+	{
+	xThreadState *pxThreadState;
+	void *pvReturn = NULL;
+
+		/* Only the thread of the Running state task parks itself - simulated
+		interrupts can also be raised by other Windows threads, such as the
+		simulated peripheral timer. */
+		if( ( xPortRunning == pdTRUE ) && ( pxCurrentTCB != NULL ) )
+		{
+			pxThreadState = ( xThreadState * ) ( *( size_t *) pxCurrentTCB );
+
+			if( ( pxThreadState->pvThread != NULL ) && ( pxThreadState->dwThreadId == GetCurrentThreadId() ) )
+			{
+				pxThreadState->xParkedOnYield = pdTRUE;
+				pvReturn = pxThreadState;
+			}
+		}
+
+		return pvReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvPark( void *pvThreadState )
+	{
+	xThreadState *pxThreadState = ( xThreadState * ) pvThreadState;
+
+		/* The event is auto reset, so if the simulated interrupt handler thread
+		already handed control back before this thread got here the wait
+		returns immediately. */
+		WaitForSingleObject( pxThreadState->pvYieldEvent, INFINITE );
+	}
+
+#endif /* configUSE_HANDOFF_CONTEXT_SWITCH */
+/*-----------------------------------------------------------*/
+
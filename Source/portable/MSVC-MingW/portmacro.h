@@ -93,15 +93,30 @@ void vPortExitCritical( void );
 #define portENTER_CRITICAL()		vPortEnterCritical()
 #define portEXIT_CRITICAL()			vPortExitCritical()
 
+/* When configUSE_HANDOFF_CONTEXT_SWITCH is 1 a task thread that raises a
+simulated interrupt, for example to yield, parks itself on its own event and is
+handed control back directly by the simulated interrupt handler thread, rather
+than having to be suspended by the simulated interrupt handler thread. */
+#ifndef configUSE_HANDOFF_CONTEXT_SWITCH
+	#define configUSE_HANDOFF_CONTEXT_SWITCH 0
+#endif
+
+/* Only the Linux port simulates more than one core. */
+#if defined( configNUMBER_OF_CORES ) && ( configNUMBER_OF_CORES > 1 )
+	#error configNUMBER_OF_CORES must be set to 1 when using the Windows port.
+#endif
+
 #ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
 	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 #endif
 
 #if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
 
-	/* Check the configuration. */
-	#if( configMAX_PRIORITIES > 32 )
-		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	/* Check the configuration.  The macros below operate on a single 32 bit
+	map - above 32 priorities the kernel keeps a map of 32 bit maps, so up to
+	32 * 32 priorities can be used. */
+	#if( configMAX_PRIORITIES > 1024 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 1024.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
 	#endif
 
 	/* Store/clear the ready priorities in a bit map. */
@@ -153,5 +168,214 @@ void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
  */
 void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
 
+/*
+ * Simulated interrupt priorities.  As on the NVIC of a Cortex-M, a numerically
+ * lower priority is a more urgent one - 0 being the most urgent and
+ * portLOWEST_INTERRUPT_PRIORITY the least.  Every interrupt, including the
+ * yield and tick interrupts used by the kernel, starts at the lowest priority.
+ *
+ * The most urgent pending interrupt is always processed first, interrupts of
+ * equal priority in interrupt number order.  An interrupt that is more urgent
+ * than the handler being run is processed straight away, nesting within it,
+ * when it is raised by the handler or when the handler unmasks it.
+ * Interrupts raised by other host threads preempt the handler asynchronously
+ * on Linux; on Windows they are processed as soon as the handler returns.
+ *
+ * vPortSetInterruptPriority() should be called before the scheduler is started
+ * or from a task.
+ */
+#define portINTERRUPT_PRIORITY_LEVELS	( 32UL )
+#define portLOWEST_INTERRUPT_PRIORITY	( portINTERRUPT_PRIORITY_LEVELS - 1UL )
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority );
+
+/* Simulated interrupts more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY
+are never masked by the kernel, not even by a critical section, so must not
+call any FreeRTOS API function.  The default of 0 lets every simulated interrupt
+use the interrupt safe API functions. */
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+	#define configMAX_SYSCALL_INTERRUPT_PRIORITY	0
+#endif
+
+/* Called from a simulated interrupt handler, masks the interrupts that can use
+the API, as writing BASEPRI does on a Cortex-M.  Called from a task, enters a
+critical section. */
+UBaseType_t ulPortSetInterruptMaskFromISR( void );
+void vPortClearInterruptMaskFromISR( UBaseType_t uxSavedInterruptStatus );
+#define portSET_INTERRUPT_MASK_FROM_ISR()		ulPortSetInterruptMaskFromISR()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	vPortClearInterruptMaskFromISR( x )
+
+/*
+ * When configUSE_INTERRUPT_LATENCY_HISTOGRAMS is 1 the time from each simulated
+ * interrupt being raised to its handler being entered is recorded, per
+ * interrupt, in a histogram with power of two buckets.  An interrupt raised
+ * again while it is still pending is counted once, from when it was first
+ * raised.
+ */
+#ifndef configUSE_INTERRUPT_LATENCY_HISTOGRAMS
+	#define configUSE_INTERRUPT_LATENCY_HISTOGRAMS 0
+#endif
+
+#define portINTERRUPT_LATENCY_BUCKETS	( 32 )
+
+typedef struct xPORT_INTERRUPT_LATENCY
+{
+	uint32_t ulCount;		/* The number of times the handler has been entered. */
+	uint32_t ulMaxNs;		/* The longest latency, in nanoseconds. */
+	uint32_t ulBuckets[ portINTERRUPT_LATENCY_BUCKETS ];	/* ulBuckets[ n ] counts the latencies of at least 2^n, but less than 2^(n+1), nanoseconds - bucket 0 also counts latencies of 0. */
+} PortInterruptLatency_t;
+
+#if( configUSE_INTERRUPT_LATENCY_HISTOGRAMS == 1 )
+	void vPortGetInterruptLatency( uint32_t ulInterruptNumber, PortInterruptLatency_t *pxLatency );
+	void vPortResetInterruptLatency( uint32_t ulInterruptNumber );
+#endif
+
+/*
+ * Statistics kept by the thread that simulates the tick interrupt.  The thread
+ * sleeps until the absolute time at which each tick is due, so the tick count
+ * does not drift from the host clock.  Ticks that became due while the thread
+ * was not running are generated together, by a single simulated interrupt,
+ * when it next runs.
+ */
+typedef struct xPORT_TICK_STATS
+{
+	uint32_t ulTicks;			/* The number of ticks generated. */
+	uint32_t ulLateTicks;		/* The number of ticks generated more than half a tick period after they were due. */
+	uint32_t ulMissedTicks;		/* The number of ticks not generated when due, but together with a later tick. */
+	uint32_t ulMaxLatenessUs;	/* The most a tick has been generated after it was due, in microseconds. */
+	uint32_t ulTimerWakeups;	/* The number of times the thread has woken, which is fewer than the number of ticks while the tick is suppressed. */
+} PortTickStats_t;
+
+/*
+ * Obtain a copy of the tick statistics.  The fields are updated individually,
+ * so may not all correspond to exactly the same moment.
+ */
+void vPortGetTickStats( PortTickStats_t *pxStats );
+
+/*
+ * Tickless idle.  The idle task sleeps until the next task has to be unblocked,
+ * or another simulated interrupt is raised, with the timer thread suppressing
+ * the ticks in between.
+ */
+#if( configUSE_TICKLESS_IDLE == 1 )
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+
+/*
+ * Virtual time.  When configUSE_VIRTUAL_TIME is 1 the simulated clock, which
+ * the tick and the timed interrupts are generated from, only keeps pace with the
+ * host clock while there is something to do.  When the idle task finds that no
+ * task can run until a timeout expires, or a timed interrupt is raised, it moves
+ * the simulated clock straight on to that time instead of sleeping.  Long idle
+ * periods then take no host time at all, while tasks are still unblocked on the
+ * same ticks, and in the same order, as they would be in real time.  An
+ * interrupt raised by another host thread is processed at whatever simulated
+ * time it arrives.
+ */
+#ifndef configUSE_VIRTUAL_TIME
+	#define configUSE_VIRTUAL_TIME 0
+#endif
+
+#if( configUSE_VIRTUAL_TIME == 1 )
+	#if( configUSE_TICKLESS_IDLE != 1 )
+		#error configUSE_TICKLESS_IDLE must be set to 1 if configUSE_VIRTUAL_TIME is 1, as the idle task moves the simulated clock on while the tick is suppressed.
+	#endif
+
+	/* Moving the simulated clock on is worthwhile even when only one tick is
+	idle. */
+	#define portMIN_EXPECTED_IDLE_TIME_BEFORE_SLEEP	1
+#endif
+
+/*
+ * Raise a simulated interrupt once ullDelayNs nanoseconds have passed on the
+ * simulated clock, as a timer peripheral would.  Each interrupt can only be
+ * timed once at a time - timing it again replaces the time it is due.  Can be
+ * called from a task, a simulated interrupt handler that can use the API, or
+ * another host thread.
+ */
+void vPortGenerateSimulatedInterruptAfter( uint32_t ulInterruptNumber, uint64_t ullDelayNs );
+
+/*
+ * Return the time of the simulated clock in nanoseconds.  Only differences
+ * between two times are meaningful.  Can be called from anywhere.
+ */
+uint64_t ullPortGetSimulatedTimeNs( void );
+
+/*
+ * Return the time of the host's monotonic clock in nanoseconds, which, unlike
+ * the simulated clock, is not moved on while the idle task sleeps.  The clock
+ * of the execution statistics kept if configGENERATE_EXECUTION_STATS is 1.
+ * Can be called from anywhere.
+ */
+uint64_t ullPortGetRunTimeNs( void );
+#define portGET_RUN_TIME_NS()	ullPortGetRunTimeNs()
+
+/* The execution statistics of a task are read by host threads other than the
+one that updates them. */
+#define portMEMORY_BARRIER()	MemoryBarrier()
+
+/*
+ * Record and replay.  When configUSE_INTERRUPT_RECORD_REPLAY is 1 the arrival
+ * of the tick, and of every simulated interrupt raised by another host thread,
+ * can be recorded to a file by calling xPortRecordInterrupts() before the
+ * scheduler is started, then replayed by calling xPortReplayInterrupts()
+ * instead.  An arrival is recorded against the number of synchronisation points
+ * the tasks had passed when it was delivered - the outermost entries to a
+ * critical section, and the completion of the interrupts a task raises itself,
+ * such as a yield.  Interrupts raised by another host thread are only delivered
+ * between synchronisation points, and not while the scheduler is suspended, so
+ * one that is more urgent than configMAX_SYSCALL_INTERRUPT_PRIORITY waits for a
+ * critical section to exit too.
+ *
+ * When replaying, no ticks are generated and interrupts raised by other host
+ * threads are ignored.  The recorded ones are delivered at the same
+ * synchronisation points instead, so the same build of the application runs
+ * the same schedule, with the same tick count at every point, however the host
+ * schedules its threads, and as fast as the tasks execute.  Code that runs
+ * between two synchronisation points without using the API sees an arrival at
+ * a point that still depends on the host.  A changed kernel can pass a
+ * different number of synchronisation points, in which case the interrupts are
+ * delivered in the same order, with the same number of ticks, at the recorded
+ * counts - or as soon after as the count is reached.  The scheduler is ended
+ * once the whole log has been replayed.
+ *
+ * Record and replay rely on the tick interrupt to move the tick count on, so
+ * cannot be used with tickless idle.
+ */
+#ifndef configUSE_INTERRUPT_RECORD_REPLAY
+	#define configUSE_INTERRUPT_RECORD_REPLAY 0
+#endif
+
+#if( configUSE_INTERRUPT_RECORD_REPLAY == 1 )
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configUSE_TICKLESS_IDLE must be set to 0 if configUSE_INTERRUPT_RECORD_REPLAY is 1, as the ticks must all be generated by the tick interrupt.
+	#endif
+
+	#if( INCLUDE_xTaskGetSchedulerState != 1 ) && ( configUSE_TIMERS != 1 )
+		#error INCLUDE_xTaskGetSchedulerState must be set to 1 if configUSE_INTERRUPT_RECORD_REPLAY is 1, as arrivals are not delivered while the scheduler is suspended.
+	#endif
+
+	typedef struct PORT_RECORD_REPLAY_STATS
+	{
+		uint32_t ulEntries;			/* The arrivals recorded, or replayed so far. */
+		uint32_t ulLateEntries;		/* Arrivals replayed after the synchronisation point they were recorded at had passed. */
+		uint32_t ulBytes;			/* The size of the log written, or read, so far. */
+	} PortRecordReplayStats_t;
+
+	/* Return pdPASS if the file could be created, or read and found to be a
+	log recorded with the same tick rate, otherwise pdFAIL.  Only one of the
+	two can be called, and only before the scheduler is started. */
+	BaseType_t xPortRecordInterrupts( const char *pcFileName );
+	BaseType_t xPortReplayInterrupts( const char *pcFileName );
+
+	void vPortGetRecordReplayStats( PortRecordReplayStats_t *pxStats );
+
+	/* vTaskSuspendAll() changes the state of the kernel without entering a
+	critical section, so is a synchronisation point too. */
+	void vPortSynchronisationPoint( void );
+	#define portTASK_SUSPEND_ALL_HOOK() vPortSynchronisationPoint()
+#endif
+
 #endif
 
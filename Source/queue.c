@@ -74,8 +74,33 @@ typedef struct SemaphoreData
 {
 	TaskHandle_t xMutexHolder;		 /*< The handle of the task that holds the mutex. */
 	UBaseType_t uxRecursiveCallCount;/*< Maintains a count of the number of times a recursive mutex has been recursively 'taken' when the structure is used as a mutex. */
+	#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+		UBaseType_t uxCeilingPriority;		/*< The priority the holder of a priority ceiling mutex runs at, or queueNO_CEILING_PRIORITY for a mutex that uses priority inheritance. */
+		UBaseType_t uxPriorityBeforeCeiling;/*< The priority of the holder of a priority ceiling mutex when it took the mutex. */
+	#endif
 } SemaphoreData_t;
 
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+	#define queueNO_CEILING_PRIORITY		( ( UBaseType_t ) configMAX_PRIORITIES )
+	#define queueHAS_CEILING( pxQueue )		( ( pxQueue )->u.xSemaphore.uxCeilingPriority != queueNO_CEILING_PRIORITY )
+#else
+	#define queueHAS_CEILING( pxQueue )		( pdFALSE )
+#endif
+
+#if( configUSE_QUEUE_LOANS == 1 )
+	/* While the slot at the back of a queue is on loan to a sender nothing else
+	can be sent to the queue, as it would be written to the same slot.  While
+	the item at the front is on loan to a receiver nothing else can be
+	received, as the same item would be received again, and nothing can be
+	sent to the front of the queue or overwrite the item, as the queue's read
+	position is moved past the item on loan when it is released. */
+	#define queueSEND_BLOCKED_BY_LOAN( pxQueue, xCopyPosition )	( ( ( pxQueue )->pcSendLoan != NULL ) || ( ( ( xCopyPosition ) != queueSEND_TO_BACK ) && ( ( pxQueue )->pcReceiveLoan != NULL ) ) )
+	#define queueRECEIVE_BLOCKED_BY_LOAN( pxQueue )				( ( pxQueue )->pcReceiveLoan != NULL )
+#else
+	#define queueSEND_BLOCKED_BY_LOAN( pxQueue, xCopyPosition )	( pdFALSE )
+	#define queueRECEIVE_BLOCKED_BY_LOAN( pxQueue )				( pdFALSE )
+#endif
+
 /* Semaphores do not actually store or copy data, so have an item size of
 zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH ( ( UBaseType_t ) 0 )
@@ -128,6 +153,11 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_LOANS == 1 )
+		int8_t *pcSendLoan;			/*< The slot loaned by xQueueLoanSendSlot() that has not yet been committed, or NULL. */
+		int8_t *pcReceiveLoan;		/*< The item loaned by xQueueLoanReceiveSlot() that has not yet been released, or NULL. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -181,11 +211,12 @@ static void prvUnlockQueue( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 static BaseType_t prvIsQueueEmpty( const Queue_t *pxQueue ) PRIVILEGED_FUNCTION;
 
 /*
- * Uses a critical section to determine if there is any space in a queue.
+ * Uses a critical section to determine if there is any space in a queue to
+ * send an item to the position xCopyPosition.
  *
  * @return pdTRUE if there is no space, otherwise pdFALSE;
  */
-static BaseType_t prvIsQueueFull( const Queue_t *pxQueue ) PRIVILEGED_FUNCTION;
+static BaseType_t prvIsQueueFull( const Queue_t *pxQueue, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 
 /*
  * Copies an item into the queue, either at the front of the queue or the
@@ -206,6 +237,26 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_BATCHES == 1 )
+	/*
+	 * Copy uxNumberOfItems items to the back of a queue, or out of the front of
+	 * a queue, with at most two calls to memcpy() - one for the items that fit
+	 * before the end of the queue storage, and one for the items that wrap
+	 * around to its start.  The queue must have room for, or hold, the items.
+	 */
+	static void prvCopyItemsToQueue( Queue_t * const pxQueue, const void *pvItems, const UBaseType_t uxNumberOfItems ) PRIVILEGED_FUNCTION;
+	static void prvCopyItemsFromQueue( Queue_t * const pxQueue, void * const pvBuffer, const UBaseType_t uxNumberOfItems ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Unblock up to uxMaxTasks of the tasks waiting on an event list of a
+	 * queue, highest priority first.  Must be called from a critical section.
+	 *
+	 * @return pdTRUE if an unblocked task has a priority above that of the
+	 * calling task, otherwise pdFALSE.
+	 */
+	static BaseType_t prvUnblockWaitingTasks( List_t * const pxEventList, UBaseType_t uxMaxTasks ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -267,6 +318,13 @@ Queue_t * const pxQueue = xQueue;
 		pxQueue->cRxLock = queueUNLOCKED;
 		pxQueue->cTxLock = queueUNLOCKED;
 
+		#if ( configUSE_QUEUE_LOANS == 1 )
+		{
+			pxQueue->pcSendLoan = NULL;
+			pxQueue->pcReceiveLoan = NULL;
+		}
+		#endif
+
 		if( xNewQueue == pdFALSE )
 		{
 			/* If there are tasks blocked waiting to read from the queue, then
@@ -484,6 +542,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 			/* In case this is a recursive mutex. */
 			pxNewQueue->u.xSemaphore.uxRecursiveCallCount = 0;
 
+			#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+			{
+				/* Set once the mutex has been given, if it has a ceiling. */
+				pxNewQueue->u.xSemaphore.uxCeilingPriority = queueNO_CEILING_PRIORITY;
+			}
+			#endif
+
 			traceCREATE_MUTEX( pxNewQueue );
 
 			/* Start with the semaphore in the expected state. */
@@ -534,6 +599,56 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateCeilingMutex( const UBaseType_t uxCeilingPriority )
+	{
+	QueueHandle_t xNewQueue;
+
+		configASSERT( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+		xNewQueue = xQueueCreateMutex( queueQUEUE_TYPE_CEILING_MUTEX );
+
+		if( xNewQueue != NULL )
+		{
+			( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xNewQueue;
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+	QueueHandle_t xQueueCreateCeilingMutexStatic( const UBaseType_t uxCeilingPriority, StaticQueue_t *pxStaticQueue )
+	{
+	QueueHandle_t xNewQueue;
+
+		configASSERT( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+		xNewQueue = xQueueCreateMutexStatic( queueQUEUE_TYPE_CEILING_MUTEX, pxStaticQueue );
+
+		if( xNewQueue != NULL )
+		{
+			( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xNewQueue;
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
 
 	TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore )
@@ -565,7 +680,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 #endif
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
+#if ( ( configUSE_MUTEXES == 1 ) && ( ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) || ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) ) )
 
 	TaskHandle_t xQueueGetMutexHolderFromISR( QueueHandle_t xSemaphore )
 	{
@@ -771,7 +886,7 @@ Queue_t * const pxQueue = xQueue;
 			highest priority task wanting to access the queue.  If the head item
 			in the queue is to be overwritten then it does not matter if the
 			queue is full. */
-			if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+			if( ( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) ) && ( queueSEND_BLOCKED_BY_LOAN( pxQueue, xCopyPosition ) == pdFALSE ) )
 			{
 				traceQUEUE_SEND( pxQueue );
 
@@ -912,7 +1027,7 @@ Queue_t * const pxQueue = xQueue;
 		/* Update the timeout state to see if it has expired yet. */
 		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
 		{
-			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			if( prvIsQueueFull( pxQueue, xCopyPosition ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
@@ -987,7 +1102,7 @@ Queue_t * const pxQueue = xQueue;
 	post). */
 	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 	{
-		if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+		if( ( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) ) && ( queueSEND_BLOCKED_BY_LOAN( pxQueue, xCopyPosition ) == pdFALSE ) )
 		{
 			const int8_t cTxLock = pxQueue->cTxLock;
 
@@ -1302,7 +1417,7 @@ Queue_t * const pxQueue = xQueue;
 
 			/* Is there data in the queue now?  To be running the calling task
 			must be the highest priority task wanting to access the queue. */
-			if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+			if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueRECEIVE_BLOCKED_BY_LOAN( pxQueue ) == pdFALSE ) )
 			{
 				/* Data available, remove one item. */
 				prvCopyDataFromQueue( pxQueue, pvBuffer );
@@ -1411,72 +1526,157 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
-{
-BaseType_t xEntryTimeSet = pdFALSE;
-TimeOut_t xTimeOut;
-Queue_t * const pxQueue = xQueue;
+#if ( configUSE_QUEUE_LOANS == 1 )
 
-#if( configUSE_MUTEXES == 1 )
-	BaseType_t xInheritanceOccurred = pdFALSE;
-#endif
+	BaseType_t xQueueLoanSendSlot( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
 
-	/* Check the queue pointer is not NULL. */
-	configASSERT( ( pxQueue ) );
+		configASSERT( pxQueue );
+		configASSERT( ppvSlot );
 
-	/* Check this really is a semaphore, in which case the item size will be
-	0. */
-	configASSERT( pxQueue->uxItemSize == 0 );
+		/* Semaphores and mutexes have no storage to loan. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
-	/* Cannot block if the scheduler is suspended. */
-	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
-	{
-		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
-	}
-	#endif
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
 
+		/*lint -save -e904 This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Is there room on the queue now, and is the slot at the back
+				of the queue not already on loan? */
+				if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) && ( queueSEND_BLOCKED_BY_LOAN( pxQueue, queueSEND_TO_BACK ) == pdFALSE ) )
+				{
+					/* The slot is where prvCopyDataToQueue() would copy the
+					item to.  Nothing else changes until the item is
+					committed. */
+					pxQueue->pcSendLoan = pxQueue->pcWriteTo;
+					*ppvSlot = ( void * ) pxQueue->pcSendLoan;
 
-	/*lint -save -e904 This function relaxes the coding standard somewhat to allow return
-	statements within the function itself.  This is done in the interest
-	of execution time efficiency. */
-	for( ;; )
+					taskEXIT_CRITICAL();
+					return pdPASS;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_SEND_FAILED( pxQueue );
+						return errQUEUE_FULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Interrupts and other tasks can send to and receive from the queue
+			now the critical section has been exited. */
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			/* Update the timeout state to see if it has expired yet. */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* The timeout has expired. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				traceQUEUE_SEND_FAILED( pxQueue );
+				return errQUEUE_FULL;
+			}
+		} /*lint -restore */
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xQueueCommitSend( QueueHandle_t xQueue )
 	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
 		taskENTER_CRITICAL();
 		{
-			/* Semaphores are queues with an item size of 0, and where the
-			number of messages in the queue is the semaphore's count value. */
-			const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
+			/* The slot must have been loaned, and as nothing else could be
+			sent while it was on loan it is still at the back of the queue. */
+			configASSERT( pxQueue->pcSendLoan == pxQueue->pcWriteTo );
 
-			/* Is there data in the queue now?  To be running the calling task
-			must be the highest priority task wanting to access the queue. */
-			if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+			traceQUEUE_SEND( pxQueue );
+
+			/* The item is already in place, so only the rest of what
+			prvCopyDataToQueue() does for an item sent to the back is left to
+			do. */
+			pxQueue->pcSendLoan = NULL;
+			pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+			if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
 			{
-				traceQUEUE_RECEIVE( pxQueue );
+				pxQueue->pcWriteTo = pxQueue->pcHead;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-				/* Semaphores are queues with a data size of zero and where the
-				messages waiting is the semaphore's count.  Reduce the count. */
-				pxQueue->uxMessagesWaiting = uxSemaphoreCount - ( UBaseType_t ) 1;
+			pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting + ( UBaseType_t ) 1;
 
-				#if ( configUSE_MUTEXES == 1 )
+			#if ( configUSE_QUEUE_SETS == 1 )
+			{
+				if( pxQueue->pxQueueSetContainer != NULL )
 				{
-					if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+					if( prvNotifyQueueSetContainer( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
 					{
-						/* Record the information required to implement
-						priority inheritance should it become necessary. */
-						pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+						/* The queue is a member of a queue set, and posting
+						to the queue set caused a higher priority task to
+						unblock. */
+						queueYIELD_IF_USING_PREEMPTION();
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
 				}
-				#endif /* configUSE_MUTEXES */
-
-				/* Check to see if other tasks are blocked waiting to give the
-				semaphore, and if so, unblock the highest priority such task. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				else if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 				{
-					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
 						queueYIELD_IF_USING_PREEMPTION();
 					}
@@ -1489,96 +1689,750 @@ Queue_t * const pxQueue = xQueue;
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
-
-				taskEXIT_CRITICAL();
-				return pdPASS;
 			}
-			else
+			#else /* configUSE_QUEUE_SETS */
 			{
-				if( xTicksToWait == ( TickType_t ) 0 )
+				/* If there was a task waiting for data to arrive on the queue
+				then unblock it now. */
+				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 				{
-					/* For inheritance to have occurred there must have been an
-					initial timeout, and an adjusted timeout cannot become 0, as
-					if it were 0 the function would have exited. */
-					#if( configUSE_MUTEXES == 1 )
+					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
-						configASSERT( xInheritanceOccurred == pdFALSE );
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
 					}
-					#endif /* configUSE_MUTEXES */
-
-					/* The semaphore count was 0 and no block time is specified
-					(or the block time has expired) so exit now. */
-					taskEXIT_CRITICAL();
-					traceQUEUE_RECEIVE_FAILED( pxQueue );
-					return errQUEUE_EMPTY;
 				}
-				else if( xEntryTimeSet == pdFALSE )
+				else
 				{
-					/* The semaphore count was 0 and a block time was specified
-					so configure the timeout structure ready to block. */
-					vTaskInternalSetTimeOutState( &xTimeOut );
-					xEntryTimeSet = pdTRUE;
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_QUEUE_SETS */
+
+			/* A task may have blocked to send while the slot was on loan,
+			rather than because the queue was full, in which case it can send
+			now if the queue still has room. */
+			if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE ) )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
 				}
 				else
 				{
-					/* Entry time was already set. */
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 		taskEXIT_CRITICAL();
 
-		/* Interrupts and other tasks can give to and take from the semaphore
-		now the critical section has been exited. */
+		return pdPASS;
+	}
+	/*-----------------------------------------------------------*/
 
-		vTaskSuspendAll();
-		prvLockQueue( pxQueue );
+	BaseType_t xQueueLoanReceiveSlot( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
+	int8_t *pcFront;
 
-		/* Update the timeout state to see if it has expired yet. */
-		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		configASSERT( pxQueue );
+		configASSERT( ppvSlot );
+
+		/* Semaphores and mutexes have no storage to loan. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 		{
-			/* A block time is specified and not expired.  If the semaphore
-			count is 0 then enter the Blocked state to wait for a semaphore to
-			become available.  As semaphores are implemented with queues the
-			queue being empty is equivalent to the semaphore count being 0. */
-			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
-			{
-				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
 
-				#if ( configUSE_MUTEXES == 1 )
+		/*lint -save -e904  This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Is there data in the queue now, and is the item at the front
+				of the queue not already on loan? */
+				if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueRECEIVE_BLOCKED_BY_LOAN( pxQueue ) == pdFALSE ) )
 				{
-					if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+					/* The item is where prvCopyDataFromQueue() would copy it
+					from.  pcReadFrom is not moved until the item is released,
+					so the item is still the one xQueuePeek() finds. */
+					pcFront = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+					if( pcFront >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
 					{
-						taskENTER_CRITICAL();
-						{
-							xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
-						}
-						taskEXIT_CRITICAL();
+						pcFront = pxQueue->pcHead;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
-				}
-				#endif
 
-				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
-				prvUnlockQueue( pxQueue );
-				if( xTaskResumeAll() == pdFALSE )
-				{
-					portYIELD_WITHIN_API();
+					pxQueue->pcReceiveLoan = pcFront;
+					*ppvSlot = ( void * ) pcFront;
+
+					taskEXIT_CRITICAL();
+					return pdPASS;
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-			}
-			else
-			{
-				/* There was no timeout and the semaphore count was not 0, so
-				attempt to take the semaphore again. */
-				prvUnlockQueue( pxQueue );
-				( void ) xTaskResumeAll();
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_RECEIVE_FAILED( pxQueue );
+						return errQUEUE_EMPTY;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Interrupts and other tasks can send to and receive from the queue
+			now the critical section has been exited. */
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			/* Update the timeout state to see if it has expired yet. */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* The queue contains data again.  Loop back to try and
+					obtain it. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* Timed out.  If there is no data in the queue exit, otherwise
+				loop back and attempt to obtain the data. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return errQUEUE_EMPTY;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		} /*lint -restore */
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xQueueReleaseReceive( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			/* The item must have been loaned, and is still in the queue. */
+			configASSERT( pxQueue->pcReceiveLoan != NULL );
+			configASSERT( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 );
+
+			/* Remove the item as xQueueReceive() would have, without copying
+			it. */
+			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcReceiveLoan;
+			pxQueue->pcReceiveLoan = NULL;
+			traceQUEUE_RECEIVE( pxQueue );
+			pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1;
+
+			/* There is now space in the queue, were any tasks waiting to post
+			to the queue?  If so, unblock the highest priority waiting task. */
+			if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* A task may have blocked to receive while the item was on loan,
+			rather than because the queue was empty, in which case it can
+			receive now if the queue still holds an item. */
+			if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ) )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		return pdPASS;
+	}
+
+#endif /* configUSE_QUEUE_LOANS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	BaseType_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, UBaseType_t uxNumberOfItems, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
+	UBaseType_t uxItemsToSend;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvItems == NULL ) && ( uxNumberOfItems != ( UBaseType_t ) 0U ) ) );
+
+		/* Semaphores and mutexes do not hold items. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		if( uxNumberOfItems == ( UBaseType_t ) 0U )
+		{
+			return 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/*lint -save -e904 This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Is there room for at least one item on the queue now? */
+				if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) && ( queueSEND_BLOCKED_BY_LOAN( pxQueue, queueSEND_TO_BACK ) == pdFALSE ) )
+				{
+					uxItemsToSend = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+					if( uxItemsToSend > uxNumberOfItems )
+					{
+						uxItemsToSend = uxNumberOfItems;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The send is traced once for the whole batch. */
+					traceQUEUE_SEND( pxQueue );
+					prvCopyItemsToQueue( pxQueue, pvItems, uxItemsToSend );
+
+					#if ( configUSE_QUEUE_SETS == 1 )
+					{
+						if( pxQueue->pxQueueSetContainer != NULL )
+						{
+						UBaseType_t uxItem;
+
+							/* The queue set holds one handle per item, as it
+							would had the items been sent one at a time. */
+							xYieldRequired = pdFALSE;
+
+							for( uxItem = 0; uxItem < uxItemsToSend; uxItem++ )
+							{
+								if( prvNotifyQueueSetContainer( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+								{
+									xYieldRequired = pdTRUE;
+								}
+								else
+								{
+									mtCOVERAGE_TEST_MARKER();
+								}
+							}
+						}
+						else
+						{
+							xYieldRequired = prvUnblockWaitingTasks( &( pxQueue->xTasksWaitingToReceive ), uxItemsToSend );
+						}
+					}
+					#else /* configUSE_QUEUE_SETS */
+					{
+						/* Unblock as many waiting receivers as there are new
+						items, then yield at most once for all of them. */
+						xYieldRequired = prvUnblockWaitingTasks( &( pxQueue->xTasksWaitingToReceive ), uxItemsToSend );
+					}
+					#endif /* configUSE_QUEUE_SETS */
+
+					if( xYieldRequired != pdFALSE )
+					{
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					taskEXIT_CRITICAL();
+					return ( BaseType_t ) uxItemsToSend;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_SEND_FAILED( pxQueue );
+						return errQUEUE_FULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Interrupts and other tasks can send to and receive from the queue
+			now the critical section has been exited. */
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			/* Update the timeout state to see if it has expired yet. */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* The timeout has expired. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				traceQUEUE_SEND_FAILED( pxQueue );
+				return errQUEUE_FULL;
+			}
+		} /*lint -restore */
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, UBaseType_t uxMaxItems, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
+	UBaseType_t uxItemsToReceive;
+
+		configASSERT( pxQueue );
+		configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+
+		/* Semaphores and mutexes do not hold items. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		if( uxMaxItems == ( UBaseType_t ) 0U )
+		{
+			return 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/*lint -save -e904  This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* Is there at least one item in the queue now? */
+				if( ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueRECEIVE_BLOCKED_BY_LOAN( pxQueue ) == pdFALSE ) )
+				{
+					uxItemsToReceive = pxQueue->uxMessagesWaiting;
+
+					if( uxItemsToReceive > uxMaxItems )
+					{
+						uxItemsToReceive = uxMaxItems;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* The receive is traced once for the whole batch. */
+					prvCopyItemsFromQueue( pxQueue, pvBuffer, uxItemsToReceive );
+					traceQUEUE_RECEIVE( pxQueue );
+
+					/* There is now space in the queue for as many items as were
+					received, so unblock as many waiting senders, then yield at
+					most once for all of them. */
+					if( prvUnblockWaitingTasks( &( pxQueue->xTasksWaitingToSend ), uxItemsToReceive ) != pdFALSE )
+					{
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					taskEXIT_CRITICAL();
+					return ( BaseType_t ) uxItemsToReceive;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_RECEIVE_FAILED( pxQueue );
+						return errQUEUE_EMPTY;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			/* Interrupts and other tasks can send to and receive from the queue
+			now the critical section has been exited. */
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			/* Update the timeout state to see if it has expired yet. */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					/* The queue contains data again.  Loop back to try and
+					obtain it. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* Timed out.  If there is no data in the queue exit, otherwise
+				loop back and attempt to obtain the data. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return errQUEUE_EMPTY;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		} /*lint -restore */
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+Queue_t * const pxQueue = xQueue;
+
+#if( configUSE_MUTEXES == 1 )
+	BaseType_t xInheritanceOccurred = pdFALSE;
+#endif
+
+	/* Check the queue pointer is not NULL. */
+	configASSERT( ( pxQueue ) );
+
+	/* Check this really is a semaphore, in which case the item size will be
+	0. */
+	configASSERT( pxQueue->uxItemSize == 0 );
+
+	/* Cannot block if the scheduler is suspended. */
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+
+	/*lint -save -e904 This function relaxes the coding standard somewhat to allow return
+	statements within the function itself.  This is done in the interest
+	of execution time efficiency. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			/* Semaphores are queues with an item size of 0, and where the
+			number of messages in the queue is the semaphore's count value. */
+			const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
+
+			/* Is there data in the queue now?  To be running the calling task
+			must be the highest priority task wanting to access the queue. */
+			if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_RECEIVE( pxQueue );
+
+				/* Semaphores are queues with a data size of zero and where the
+				messages waiting is the semaphore's count.  Reduce the count. */
+				pxQueue->uxMessagesWaiting = uxSemaphoreCount - ( UBaseType_t ) 1;
+
+				#if ( configUSE_MUTEXES == 1 )
+				{
+					if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+					{
+						/* Record the information required to implement
+						priority inheritance should it become necessary. */
+						pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+
+						#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+						{
+							if( queueHAS_CEILING( pxQueue ) != pdFALSE )
+							{
+								pxQueue->u.xSemaphore.uxPriorityBeforeCeiling = uxTaskPriorityRaiseToCeiling( pxQueue->u.xSemaphore.uxCeilingPriority );
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_MUTEXES */
+
+				/* Check to see if other tasks are blocked waiting to give the
+				semaphore, and if so, unblock the highest priority such task. */
+				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				{
+					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+					{
+						queueYIELD_IF_USING_PREEMPTION();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				taskEXIT_CRITICAL();
+				return pdPASS;
+			}
+			else
+			{
+				if( xTicksToWait == ( TickType_t ) 0 )
+				{
+					/* For inheritance to have occurred there must have been an
+					initial timeout, and an adjusted timeout cannot become 0, as
+					if it were 0 the function would have exited. */
+					#if( configUSE_MUTEXES == 1 )
+					{
+						configASSERT( xInheritanceOccurred == pdFALSE );
+					}
+					#endif /* configUSE_MUTEXES */
+
+					/* The semaphore count was 0 and no block time is specified
+					(or the block time has expired) so exit now. */
+					taskEXIT_CRITICAL();
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return errQUEUE_EMPTY;
+				}
+				else if( xEntryTimeSet == pdFALSE )
+				{
+					/* The semaphore count was 0 and a block time was specified
+					so configure the timeout structure ready to block. */
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					/* Entry time was already set. */
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		/* Interrupts and other tasks can give to and take from the semaphore
+		now the critical section has been exited. */
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		/* Update the timeout state to see if it has expired yet. */
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			/* A block time is specified and not expired.  If the semaphore
+			count is 0 then enter the Blocked state to wait for a semaphore to
+			become available.  As semaphores are implemented with queues the
+			queue being empty is equivalent to the semaphore count being 0. */
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+
+				#if ( configUSE_MUTEXES == 1 )
+				{
+					/* The holder of a priority ceiling mutex already runs at
+					the ceiling, so does not inherit a priority. */
+					if( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( queueHAS_CEILING( pxQueue ) == pdFALSE ) )
+					{
+						taskENTER_CRITICAL();
+						{
+							xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
+
+							#if( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 )
+							{
+								/* Allows a priority this task inherits while
+								blocked to be passed on to the mutex holder. */
+								vTaskSetBlockedOnMutex( ( void * ) pxQueue );
+							}
+							#endif
+						}
+						taskEXIT_CRITICAL();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif
+
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+				{
+					/* No longer blocked on the mutex, so there is no holder
+					to pass an inherited priority on to. */
+					vTaskSetBlockedOnMutex( NULL );
+				}
+				#endif
+			}
+			else
+			{
+				/* There was no timeout and the semaphore count was not 0, so
+				attempt to take the semaphore again. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
 			}
 		}
 		else
@@ -1808,7 +2662,7 @@ Queue_t * const pxQueue = xQueue;
 		const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
 		/* Cannot block in an ISR, so check there is data available. */
-		if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+		if( ( uxMessagesWaiting > ( UBaseType_t ) 0 ) && ( queueRECEIVE_BLOCKED_BY_LOAN( pxQueue ) == pdFALSE ) )
 		{
 			const int8_t cRxLock = pxQueue->cRxLock;
 
@@ -2083,7 +2937,22 @@ UBaseType_t uxMessagesWaiting;
 			if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
 			{
 				/* The mutex is no longer being held. */
-				xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+				#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+				{
+					if( queueHAS_CEILING( pxQueue ) != pdFALSE )
+					{
+						xReturn = xTaskPriorityRestoreFromCeiling( pxQueue->u.xSemaphore.xMutexHolder, pxQueue->u.xSemaphore.uxCeilingPriority, pxQueue->u.xSemaphore.uxPriorityBeforeCeiling );
+					}
+					else
+					{
+						xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+					}
+				}
+				#else
+				{
+					xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+				}
+				#endif
 				pxQueue->u.xSemaphore.xMutexHolder = NULL;
 			}
 			else
@@ -2164,6 +3033,96 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_BATCHES == 1 )
+
+	static void prvCopyItemsToQueue( Queue_t * const pxQueue, const void *pvItems, const UBaseType_t uxNumberOfItems )
+	{
+	size_t xBytes = ( size_t ) uxNumberOfItems * ( size_t ) pxQueue->uxItemSize;
+	const size_t xBytesToEnd = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+
+		/* This function is called from a critical section. */
+
+		if( xBytes < xBytesToEnd )
+		{
+			( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			pxQueue->pcWriteTo += xBytes; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		}
+		else
+		{
+			/* The items reach, or wrap around, the end of the storage. */
+			( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytesToEnd ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			xBytes -= xBytesToEnd;
+			( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) ( ( const int8_t * ) pvItems + xBytesToEnd ), xBytes ); /*lint !e961 !e418 !e9087 !e9079 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			pxQueue->pcWriteTo = pxQueue->pcHead + xBytes; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		}
+
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting + uxNumberOfItems;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCopyItemsFromQueue( Queue_t * const pxQueue, void * const pvBuffer, const UBaseType_t uxNumberOfItems )
+	{
+	int8_t *pcFront;
+	size_t xBytes = ( size_t ) uxNumberOfItems * ( size_t ) pxQueue->uxItemSize;
+	size_t xBytesToEnd;
+
+		/* This function is called from a critical section.  pcReadFrom points
+		to the last item read, so the front item is the one after it. */
+
+		pcFront = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pcFront >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pcFront = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		xBytesToEnd = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcFront );
+
+		if( xBytes <= xBytesToEnd )
+		{
+			( void ) memcpy( pvBuffer, ( void * ) pcFront, xBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			pxQueue->u.xQueue.pcReadFrom = pcFront + ( xBytes - ( size_t ) pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		}
+		else
+		{
+			/* The items wrap around the end of the storage. */
+			( void ) memcpy( pvBuffer, ( void * ) pcFront, xBytesToEnd ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			xBytes -= xBytesToEnd;
+			( void ) memcpy( ( void * ) ( ( int8_t * ) pvBuffer + xBytesToEnd ), ( void * ) pxQueue->pcHead, xBytes ); /*lint !e961 !e418 !e9087 !e9079 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( xBytes - ( size_t ) pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		}
+
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting - uxNumberOfItems;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvUnblockWaitingTasks( List_t * const pxEventList, UBaseType_t uxMaxTasks )
+	{
+	BaseType_t xYieldRequired = pdFALSE;
+
+		while( ( uxMaxTasks > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+		{
+			if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+			{
+				xYieldRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			uxMaxTasks--;
+		}
+
+		return xYieldRequired;
+	}
+
+#endif /* configUSE_QUEUE_BATCHES */
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
 	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -2290,7 +3249,7 @@ BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		if( pxQueue->uxMessagesWaiting == ( UBaseType_t )  0 )
+		if( ( pxQueue->uxMessagesWaiting == ( UBaseType_t )  0 ) || ( queueRECEIVE_BLOCKED_BY_LOAN( pxQueue ) != pdFALSE ) )
 		{
 			xReturn = pdTRUE;
 		}
@@ -2324,13 +3283,13 @@ Queue_t * const pxQueue = xQueue;
 } /*lint !e818 xQueue could not be pointer to const because it is a typedef. */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvIsQueueFull( const Queue_t *pxQueue )
+static BaseType_t prvIsQueueFull( const Queue_t *pxQueue, const BaseType_t xCopyPosition )
 {
 BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+		if( ( ( pxQueue->uxMessagesWaiting == pxQueue->uxLength ) && ( xCopyPosition != queueOVERWRITE ) ) || ( queueSEND_BLOCKED_BY_LOAN( pxQueue, xCopyPosition ) != pdFALSE ) )
 		{
 			xReturn = pdTRUE;
 		}
@@ -2376,7 +3335,7 @@ Queue_t * const pxQueue = xQueue;
 		between the check to see if the queue is full and blocking on the queue. */
 		portDISABLE_INTERRUPTS();
 		{
-			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
 			{
 				/* The queue is full - do we want to block or just leave without
 				posting? */
@@ -38,6 +38,8 @@ task.h is included from an application file. */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "queue.h"
+#include "frame_scheduler.h"
 #include "stack_macros.h"
 
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
@@ -75,6 +77,20 @@ functions but without including stdio.h here. */
  */
 #define tskSTACK_FILL_BYTE	( 0xa5U )
 
+/* A whole stack word of tskSTACK_FILL_BYTE, so the stack profiler can compare
+a word at a time. */
+#define tskSTACK_FILL_WORD	( ( ( StackType_t ) ~( StackType_t ) 0U / ( StackType_t ) 0xffU ) * ( StackType_t ) tskSTACK_FILL_BYTE )
+
+#if( configNUMBER_OF_CORES > 1 )
+	/* Another core could delete, and so free, the task whose stack is being
+	sampled unless the sample is taken in a critical section. */
+	#define taskENTER_STACK_SAMPLE()	taskENTER_CRITICAL()
+	#define taskEXIT_STACK_SAMPLE()		taskEXIT_CRITICAL()
+#else
+	#define taskENTER_STACK_SAMPLE()	vTaskSuspendAll()
+	#define taskEXIT_STACK_SAMPLE()		( void ) xTaskResumeAll()
+#endif
+
 /* Sometimes the FreeRTOSConfig.h settings only allow a task to be created using
 dynamically allocated RAM, in which case when any task is deleted it is known
 that both the task's stack and TCB need to be freed.  Sometimes the
@@ -100,7 +116,7 @@ changed then the definition of StaticTask_t must also be updated. */
 /* If any of the following are set then task stacks are filled with a known
 value so the high water mark can be determined.  If none of the following are
 set then don't fill the stack so there is no unnecessary dependency on memset. */
-#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
+#if( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) || ( configUSE_STACK_PROFILER == 1 ) )
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	1
 #else
 	#define tskSET_NEW_STACKS_TO_KNOWN_VALUE	0
@@ -115,6 +131,19 @@ set then don't fill the stack so there is no unnecessary dependency on memset. *
 #define tskDELETED_CHAR		( 'D' )
 #define tskSUSPENDED_CHAR	( 'S' )
 
+/*
+ * Macros used to track which core, if any, a task is running on when
+ * configNUMBER_OF_CORES is greater than 1.
+ */
+#if( configNUMBER_OF_CORES > 1 )
+	#define taskTASK_NOT_RUNNING					( ( BaseType_t ) -1 )
+	#define taskTASK_IS_RUNNING( pxTCB )			( ( pxTCB )->xTaskRunState != taskTASK_NOT_RUNNING )
+	#define taskIS_RUNNING_ON_ANOTHER_CORE( pxTCB )	( ( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE ) && ( ( pxTCB )->xTaskRunState != ( BaseType_t ) portGET_CORE_ID() ) )
+#else
+	#define taskTASK_IS_RUNNING( pxTCB )			( ( pxTCB ) == pxCurrentTCB )
+	#define taskIS_RUNNING_ON_ANOTHER_CORE( pxTCB )	( pdFALSE )
+#endif
+
 /*
  * Some kernel aware debuggers require the data the debugger needs access to be
  * global, rather than file scope.
@@ -147,6 +176,14 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 	/*-----------------------------------------------------------*/
 
+	#if( configNUMBER_OF_CORES > 1 )
+
+		/* Each core searches the ready lists for the highest priority task it
+		can run, see prvSelectHighestPriorityTask(). */
+		#define taskSELECT_HIGHEST_PRIORITY_TASK()	prvSelectHighestPriorityTask( portGET_CORE_ID() )
+
+	#else
+
 	#define taskSELECT_HIGHEST_PRIORITY_TASK()															\
 	{																									\
 	UBaseType_t uxTopPriority = uxTopReadyPriority;														\
@@ -160,16 +197,19 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 																										\
 		/* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of						\
 		the	same priority get an equal share of the processor time. */									\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
+		taskSELECT_FROM_READY_LIST( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
 		uxTopReadyPriority = uxTopPriority;																\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
+	#endif /* configNUMBER_OF_CORES */
+
 	/*-----------------------------------------------------------*/
 
-	/* Define away taskRESET_READY_PRIORITY() and portRESET_READY_PRIORITY() as
-	they are only required when a port optimised method of task selection is
-	being used. */
+	/* Define away taskRESET_READY_PRIORITY(), taskCLEAR_READY_PRIORITY() and
+	portRESET_READY_PRIORITY() as they are only required when a port optimised
+	method of task selection is being used. */
 	#define taskRESET_READY_PRIORITY( uxPriority )
+	#define taskCLEAR_READY_PRIORITY( uxPriority )
 	#define portRESET_READY_PRIORITY( uxPriority, uxTopReadyPriority )
 
 #else /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
@@ -178,8 +218,52 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	performed in a way that is tailored to the particular microcontroller
 	architecture being used. */
 
-	/* A port optimised version is provided.  Call the port defined macros. */
-	#define taskRECORD_READY_PRIORITY( uxPriority )	portRECORD_READY_PRIORITY( uxPriority, uxTopReadyPriority )
+	#if( configMAX_PRIORITIES > 32 )
+
+		/* The port macros operate on a single 32 bit map, so more priorities
+		are recorded in a map of two levels.  Bit n of
+		uxReadyPriorityBits[ g ] is set if the ready list of priority
+		( 32 * g ) + n is not empty, and bit g of uxTopReadyPriority is set if
+		any bit of uxReadyPriorityBits[ g ] is set.  The highest ready priority
+		is then found with two searches, whatever the number of priorities. */
+		#define taskREADY_PRIORITY_GROUP_BITS	( 5U )
+		#define taskREADY_PRIORITY_GROUP_MASK	( ( UBaseType_t ) 0x1f )
+		#define taskREADY_PRIORITY_GROUPS		( ( configMAX_PRIORITIES + 31 ) / 32 )
+
+		#define taskRECORD_READY_PRIORITY( uxPriority )																		\
+		{																													\
+			portRECORD_READY_PRIORITY( ( uxPriority ) & taskREADY_PRIORITY_GROUP_MASK, uxReadyPriorityBits[ ( uxPriority ) >> taskREADY_PRIORITY_GROUP_BITS ] );	\
+			portRECORD_READY_PRIORITY( ( uxPriority ) >> taskREADY_PRIORITY_GROUP_BITS, uxTopReadyPriority );				\
+		}
+
+		#define taskCLEAR_READY_PRIORITY( uxPriority )																		\
+		{																													\
+			portRESET_READY_PRIORITY( ( uxPriority ) & taskREADY_PRIORITY_GROUP_MASK, uxReadyPriorityBits[ ( uxPriority ) >> taskREADY_PRIORITY_GROUP_BITS ] );	\
+																															\
+			if( uxReadyPriorityBits[ ( uxPriority ) >> taskREADY_PRIORITY_GROUP_BITS ] == ( UBaseType_t ) 0 )				\
+			{																												\
+				portRESET_READY_PRIORITY( ( uxPriority ) >> taskREADY_PRIORITY_GROUP_BITS, uxTopReadyPriority );			\
+			}																												\
+		}
+
+		#define taskGET_HIGHEST_PRIORITY( uxTopPriority )																	\
+		{																													\
+		UBaseType_t uxGroup, uxBit;																							\
+																															\
+			portGET_HIGHEST_PRIORITY( uxGroup, uxTopReadyPriority );														\
+			portGET_HIGHEST_PRIORITY( uxBit, uxReadyPriorityBits[ uxGroup ] );												\
+			( uxTopPriority ) = ( uxGroup << taskREADY_PRIORITY_GROUP_BITS ) | uxBit;										\
+		}
+
+	#else
+
+		/* A port optimised version is provided.  Call the port defined
+		macros. */
+		#define taskRECORD_READY_PRIORITY( uxPriority )		portRECORD_READY_PRIORITY( uxPriority, uxTopReadyPriority )
+		#define taskCLEAR_READY_PRIORITY( uxPriority )		portRESET_READY_PRIORITY( ( uxPriority ), uxTopReadyPriority )
+		#define taskGET_HIGHEST_PRIORITY( uxTopPriority )	portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority )
+
+	#endif /* configMAX_PRIORITIES */
 
 	/*-----------------------------------------------------------*/
 
@@ -188,9 +272,9 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	UBaseType_t uxTopPriority;																		\
 																									\
 		/* Find the highest priority list that contains ready tasks. */								\
-		portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );								\
+		taskGET_HIGHEST_PRIORITY( uxTopPriority );													\
 		configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );		\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );		\
+		taskSELECT_FROM_READY_LIST( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );		\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 	/*-----------------------------------------------------------*/
@@ -202,7 +286,7 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 	{																									\
 		if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) == ( UBaseType_t ) 0 )	\
 		{																								\
-			portRESET_READY_PRIORITY( ( uxPriority ), ( uxTopReadyPriority ) );							\
+			taskCLEAR_READY_PRIORITY( ( uxPriority ) );													\
 		}																								\
 	}
 
@@ -210,32 +294,140 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
-/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
-count overflows. */
-#define taskSWITCH_DELAYED_LISTS()																	\
-{																									\
-	List_t *pxTemp;																					\
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/* Tasks in the Blocked state with a timeout are held on a hierarchical
+	timing wheel of taskWHEEL_LEVELS levels, each of taskWHEEL_SLOTS lists.  A
+	slot at level L holds the tasks whose wake times share all but the lowest
+	L * taskWHEEL_SLOT_BITS bits, so a task is added in constant time, without
+	searching a sorted list.  The tasks in a slot are moved down the wheel when
+	the tick count reaches the first wake time the slot can hold.
+	pxDelayedTaskList only holds the tasks whose wake time has been reached, in
+	the order in which they were added, and pxOverflowDelayedTaskList the tasks
+	whose wake time has overflowed the tick count, in the same order. */
+	#define taskWHEEL_SLOT_BITS		( 5U )
+	#define taskWHEEL_SLOTS			( 1U << taskWHEEL_SLOT_BITS )
+
+	#if( configUSE_16_BIT_TICKS == 1 )
+		#define taskWHEEL_LEVELS	( 4U )
+	#else
+		#define taskWHEEL_LEVELS	( 7U )
+	#endif
+
+	/* The tasks in a list are not sorted by wake time, so must be added to the
+	end.  The index of the list is moved by the functions that walk the lists,
+	so is put back first. */
+	#define taskWHEEL_INSERT_END( pxList, pxListItem )												\
+	{																								\
+		( pxList )->pxIndex = ( ListItem_t * ) &( ( pxList )->xListEnd );							\
+		vListInsertEnd( ( pxList ), ( pxListItem ) );												\
+	}
+
+	#define taskIS_TIMING_WHEEL_LIST( pxList )														\
+		( ( ( pxList ) >= &( xTimingWheel[ 0 ][ 0 ] ) ) && ( ( pxList ) <= &( xTimingWheel[ taskWHEEL_LEVELS - 1U ][ taskWHEEL_SLOTS - 1U ] ) ) )
+
+	/* When the tick count overflows the tasks in pxOverflowDelayedTaskList are
+	placed on the wheel.  All the other delayed tasks have woken by then. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
+		configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );									\
+																									\
+		prvPlaceOverflowedTasksOnTimingWheel();														\
+		xNumOfOverflows++;																			\
+		prvResetNextTaskUnblockTime();																\
+	}
+
+#else
+
+	/* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
+	count overflows. */
+	#define taskSWITCH_DELAYED_LISTS()																\
+	{																								\
+		List_t *pxTemp;																				\
 																									\
-	/* The delayed tasks list should be empty when the lists are switched. */						\
-	configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );										\
+		/* The delayed tasks list should be empty when the lists are switched. */					\
+		configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );									\
 																									\
-	pxTemp = pxDelayedTaskList;																		\
-	pxDelayedTaskList = pxOverflowDelayedTaskList;													\
-	pxOverflowDelayedTaskList = pxTemp;																\
-	xNumOfOverflows++;																				\
-	prvResetNextTaskUnblockTime();																	\
-}
+		pxTemp = pxDelayedTaskList;																	\
+		pxDelayedTaskList = pxOverflowDelayedTaskList;												\
+		pxOverflowDelayedTaskList = pxTemp;															\
+		xNumOfOverflows++;																			\
+		prvResetNextTaskUnblockTime();																\
+	}
+
+	#define taskIS_TIMING_WHEEL_LIST( pxList )	( pdFALSE )
+
+#endif /* configUSE_TIMING_WHEEL */
 
 /*-----------------------------------------------------------*/
 
+#if( configNUMBER_OF_CORES > 1 )
+
+	/* A task made ready may be of higher priority than the task running on one
+	of the cores, which is asked to yield straight away, so the code that made
+	the task ready does not compare its priority with that of pxCurrentTCB
+	itself. */
+	#define taskYIELD_FOR_TASK( pxTCB )			prvYieldForTask( pxTCB )
+	#define taskSHOULD_PREEMPT( xCondition )	( pdFALSE )
+
+#else
+
+	#define taskYIELD_FOR_TASK( pxTCB )
+	#define taskSHOULD_PREEMPT( xCondition )	( xCondition )
+
+#endif /* configNUMBER_OF_CORES */
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	/* The ready tasks of each priority are ordered by deadline, earliest
+	first, and the task at the head of the highest priority ready list is the
+	one selected to run.  Tasks that do not have a deadline are placed after
+	those that do, in the order in which they became ready.  A task of higher
+	priority therefore still preempts a task with an earlier deadline. */
+	#define taskINSERT_INTO_READY_LIST( pxTCB )			prvInsertTaskByDeadline( pxTCB )
+	#define taskSELECT_FROM_READY_LIST( pxTCB, pxList )	( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxList )
+	#define taskIS_MORE_URGENT( pxTCB, pxOtherTCB )										\
+		( ( ( pxTCB )->uxPriority > ( pxOtherTCB )->uxPriority ) ||							\
+		  ( ( ( pxTCB )->uxPriority == ( pxOtherTCB )->uxPriority ) && ( prvDeadlineIsEarlier( ( pxTCB ), ( pxOtherTCB ) ) != pdFALSE ) ) )
+
+#else
+
+	#define taskINSERT_INTO_READY_LIST( pxTCB )			vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) )
+	#define taskSELECT_FROM_READY_LIST( pxTCB, pxList )	listGET_OWNER_OF_NEXT_ENTRY( pxTCB, pxList )
+	#define taskIS_MORE_URGENT( pxTCB, pxOtherTCB )		( ( pxTCB )->uxPriority > ( pxOtherTCB )->uxPriority )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+#if( configUSE_TASK_BUDGETS == 1 )
+	#define taskIS_THROTTLED( pxTCB )	listIS_CONTAINED_WITHIN( &xThrottledTaskList, &( ( pxTCB )->xStateListItem ) )
+#else
+	#define taskIS_THROTTLED( pxTCB )	pdFALSE
+#endif
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+	/* Values that can be assigned to the ucPeriodicState member of the TCB.
+	A task is only released by the tick while it is waiting for its release
+	in xTaskWaitForNextPeriod().  taskPERIODIC_FIRST_JOB_RELEASED is only used
+	for a first release made by xTaskCreatePeriodic(), before the task has
+	called xTaskWaitForNextPeriod(). */
+	#define taskPERIODIC_NO_JOB					( ( uint8_t ) 0 )
+	#define taskPERIODIC_WAITING_FOR_RELEASE	( ( uint8_t ) 1 )
+	#define taskPERIODIC_JOB_RUNNING			( ( uint8_t ) 2 )
+	#define taskPERIODIC_FIRST_JOB_RELEASED		( ( uint8_t ) 3 )
+
+	#define taskTICK_PERIOD_NS	( 1000000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+#endif
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
- * the task.  It is inserted at the end of the list.
+ * the task.  It is inserted at the end of the list, or in deadline order if
+ * configUSE_EDF_SCHEDULING is 1.
  */
 #define prvAddTaskToReadyList( pxTCB )																\
 	traceMOVED_TASK_TO_READY_STATE( pxTCB );														\
 	taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );												\
-	vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+	taskINSERT_INTO_READY_LIST( pxTCB );															\
+	taskYIELD_FOR_TASK( pxTCB );																	\
 	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
@@ -340,6 +532,60 @@ typedef struct tskTaskControlBlock /* The old naming convention is used to preve
 		int iTaskErrno;
 	#endif
 
+	#if( configNUMBER_OF_CORES > 1 )
+		volatile BaseType_t	xTaskRunState;	/*< The core the task is running on, or taskTASK_NOT_RUNNING. */
+		UBaseType_t		uxCoreAffinityMask;	/*< Bit n is set if the task is allowed to run on core n. */
+	#endif
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xDeadline;			/*< The tick count by which the task's current job should complete.  Only valid if xRelativeDeadline is not 0. */
+		TickType_t		xRelativeDeadline;	/*< The time from each release of the task to its deadline, or 0 if the task does not have a deadline. */
+	#endif
+
+	#if( configUSE_TASK_BUDGETS == 1 )
+		TickType_t		xBudget;			/*< The ticks the task can run for in each period, or 0 if its CPU time is not limited. */
+		TickType_t		xBudgetPeriod;		/*< The time from the first tick charged to the budget to the budget being replenished. */
+		TickType_t		xBudgetRemaining;	/*< The ticks left in the current period.  Equal to xBudget if the current period has not started. */
+		TickType_t		xBudgetPeriodStart;	/*< The tick count at which the current period started. */
+		uint32_t		ulBudgetExhaustions;/*< The number of times the task has been throttled. */
+	#endif
+
+	#if( configUSE_TASK_POOL == 1 )
+		configSTACK_DEPTH_TYPE	usStackDepth;	/*< The depth of the stack allocated to the task, so the TCB and stack can be pooled when the task is deleted. */
+	#endif
+
+	#if( configGENERATE_EXECUTION_STATS == 1 )
+		volatile uint32_t	ulStatsSequence;	/*< Odd while the execution statistics below are being updated, so they can be read without a critical section. */
+		uint64_t		ullRunTimeNs;		/*< The time the task has spent in the Running state, up to when it was last switched out. */
+		uint64_t		ullSwitchedInNs;	/*< The time at which the task was last switched in. */
+		uint32_t		ulContextSwitches;	/*< The number of times the task has been switched in. */
+		uint32_t		ulPreemptions;		/*< The number of times the task has been switched out while still able to run. */
+		uint32_t		ulVoluntaryBlocks;	/*< The number of times the task has been switched out having left the Ready state. */
+		BaseType_t		xStatsRunning;		/*< pdTRUE from when the task is switched in to when it is switched out. */
+	#endif
+
+	#if( configUSE_PERIODIC_TASKS == 1 )
+		TickType_t		xPeriod;			/*< The time between releases, or 0 if the task was not created by xTaskCreatePeriodic(). */
+		TickType_t		xReleaseDeadline;	/*< The time from each release to the deadline of the job released. */
+		TickType_t		xReleaseTime;		/*< The tick count at which the current job was released, or at which the next job is to be if the task has no current job. */
+		uint64_t		ullReleaseNs;		/*< The time, from portGET_RUN_TIME_NS(), at which the current job was released. */
+		uint32_t		ulReleases;
+		uint32_t		ulDeadlineMisses;
+		uint32_t		ulMaxReleaseLatencyNs;
+		uint32_t		ulReleaseLatencyBuckets[ configPERIODIC_TASK_LATENCY_BUCKETS ];
+		uint8_t			ucPeriodicState;	/*< One of the taskPERIODIC_ states. */
+	#endif
+
+	#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+		void			*pvBlockedOnMutex;	/*< The mutex the task last blocked on.  Only meaningful while xEventListItem is still in the mutex's event list. */
+	#endif
+
+	#if( configUSE_STACK_PROFILER == 1 )
+		ListItem_t		xStackProfileListItem;	/*< Used to reference the task from xStackProfiledTasks. */
+		uint32_t		ulStackDepth;		/*< The number of words allocated to the stack. */
+		uint32_t		ulStackPeak;		/*< The most words of the stack found to have been used, as last sampled by the idle task. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -348,7 +594,31 @@ typedef tskTCB TCB_t;
 
 /*lint -save -e956 A manual analysis and inspection has been used to determine
 which static variables must be declared volatile. */
-PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#if( configNUMBER_OF_CORES > 1 )
+
+	/* The task running on each core.  pxCurrentTCB is the task running on the
+	calling core, which is read with interrupts masked as a task could
+	otherwise be moved to another core part way through. */
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCBs[ configNUMBER_OF_CORES ] = { NULL };
+	#define pxCurrentTCB	prvGetCurrentTCB()
+
+	static portINLINE TCB_t *prvGetCurrentTCB( void )
+	{
+	TCB_t *pxTCB;
+	UBaseType_t uxSavedInterruptStatus;
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+		pxTCB = pxCurrentTCBs[ portGET_CORE_ID() ];
+		portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+
+		return pxTCB;
+	}
+
+#else
+
+	PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+
+#endif /* configNUMBER_OF_CORES */
 
 /* Lists for ready and blocked tasks. --------------------
 xDelayedTaskList1 and xDelayedTaskList2 could be move to function scople but
@@ -361,6 +631,14 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	PRIVILEGED_DATA static List_t xTimingWheel[ taskWHEEL_LEVELS ][ taskWHEEL_SLOTS ];	/*< Delayed tasks whose wake time has not been reached, see taskWHEEL_LEVELS. */
+	PRIVILEGED_DATA static uint32_t ulTimingWheelOccupied[ taskWHEEL_LEVELS ];		/*< A bit set for each slot of each level to which a task has been added.  A bit is only cleared when the slot is found empty, as tasks can be removed from a slot by other means. */
+	PRIVILEGED_DATA static TickType_t xTimingWheelTime = ( TickType_t ) configINITIAL_TICK_COUNT;	/*< The time up to which the slots of the wheel have been processed, which can lag behind the tick count. */
+
+#endif
+
 #if( INCLUDE_vTaskDelete == 1 )
 
 	PRIVILEGED_DATA static List_t xTasksWaitingTermination;				/*< Tasks that have been deleted - but their memory not yet freed. */
@@ -374,6 +652,31 @@ PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been r
 
 #endif
 
+#if( configUSE_TASK_BUDGETS == 1 )
+
+	PRIVILEGED_DATA static List_t xThrottledTaskList;					/*< Tasks that have used their budget, waiting for it to be replenished. */
+	PRIVILEGED_DATA static TickType_t xNextBudgetReplenishTime = ( TickType_t ) 0U; /*< The earliest time at which a task in xThrottledTaskList is replenished. */
+
+#endif
+
+#if( configUSE_TASK_POOL == 1 )
+
+	PRIVILEGED_DATA static List_t xTaskPools[ configTASK_POOL_SIZE_CLASSES ];	/*< The TCBs, with their stacks, of deleted tasks kept for reuse, one list for each stack depth. */
+	PRIVILEGED_DATA static configSTACK_DEPTH_TYPE usTaskPoolStackDepths[ configTASK_POOL_SIZE_CLASSES ] = { 0 }; /*< The stack depth of the tasks held in each list of xTaskPools, or 0 if the list has not been used.  An empty list can be taken over by another stack depth. */
+	PRIVILEGED_DATA static uint32_t ulTaskPoolHits = 0UL;
+	PRIVILEGED_DATA static uint32_t ulTaskPoolMisses = 0UL;
+	PRIVILEGED_DATA static uint32_t ulTaskPoolRecycled = 0UL;
+	PRIVILEGED_DATA static uint32_t ulTaskPoolOverflows = 0UL;
+
+#endif
+
+#if( configUSE_STACK_PROFILER == 1 )
+
+	PRIVILEGED_DATA static List_t xStackProfiledTasks;					/*< Every task that has not been deleted, in the order the idle task samples their stacks. */
+	PRIVILEGED_DATA static TickType_t xLastStackSampleTime = ( TickType_t ) 0U;
+
+#endif
+
 /* Global POSIX errno. Its value is changed upon context switching to match
 the errno of the currently running task. */
 #if ( configUSE_POSIX_ERRNO == 1 )
@@ -384,9 +687,22 @@ the errno of the currently running task. */
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks 	= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount 				= ( TickType_t ) configINITIAL_TICK_COUNT;
 PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority 		= tskIDLE_PRIORITY;
+
+#if( ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) && ( configMAX_PRIORITIES > 32 ) )
+
+	/* The second level of the map of ready priorities, see
+	taskRECORD_READY_PRIORITY(). */
+	PRIVILEGED_DATA static volatile UBaseType_t uxReadyPriorityBits[ taskREADY_PRIORITY_GROUPS ] = { ( UBaseType_t ) 0U };
+
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning 		= pdFALSE;
 PRIVILEGED_DATA static volatile UBaseType_t uxPendedTicks 			= ( UBaseType_t ) 0U;
-PRIVILEGED_DATA static volatile BaseType_t xYieldPending 			= pdFALSE;
+#if( configNUMBER_OF_CORES > 1 )
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPendings[ configNUMBER_OF_CORES ] = { pdFALSE };
+	#define xYieldPending	xYieldPendings[ portGET_CORE_ID() ]		/* Only accessed by the core itself with interrupts masked, or by other cores with the ISR lock held. */
+#else
+	PRIVILEGED_DATA static volatile BaseType_t xYieldPending 		= pdFALSE;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows 			= ( BaseType_t ) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber 					= ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime		= ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
@@ -402,11 +718,37 @@ when the scheduler is unsuspended.  The pending ready list itself can only be
 accessed from a critical section. */
 PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t ) pdFALSE;
 
+#if( configNUMBER_OF_CORES > 1 )
+
+	/* The core that holds the task lock, so has suspended the scheduler.  Only
+	meaningful while uxSchedulerSuspended is not zero - the scheduler being
+	suspended by one core does not stop a task on another core blocking, it
+	only holds the other core up until the lock is released.
+
+	prvSchedulerSuspendedOnThisCore() reads this without the task lock, which
+	is benign.  It is only written by the core that has just taken the task
+	lock, and is written before uxSchedulerSuspended is incremented, with a
+	barrier between the two.  A core that suspended the scheduler itself therefore
+	always reads its own ID, as no other core can write while it holds the
+	lock.  A core that did not can read an old value, or one being written by
+	another core, but once it has seen uxSchedulerSuspended non-zero that
+	value is never its own ID - its own last write was before it released the
+	lock the current holder then took - so it correctly reads the scheduler as
+	running. */
+	PRIVILEGED_DATA static volatile BaseType_t xSchedulerSuspendedCore = 0;
+
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 	/* Do not move these variables to function scope as doing so prevents the
 	code working with debuggers that need to remove the static qualifier. */
-	PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#if( configNUMBER_OF_CORES > 1 )
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTimes[ configNUMBER_OF_CORES ] = { 0UL };
+		#define ulTaskSwitchedInTime	ulTaskSwitchedInTimes[ portGET_CORE_ID() ]
+	#else
+		PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	#endif
 	PRIVILEGED_DATA static uint32_t ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
 
 #endif
@@ -479,6 +821,52 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters );
 
 #endif
 
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+	/*
+	 * Allocate a TCB and a stack of usStackDepth words from the heap, in the
+	 * order that stops the stack growing into the TCB.  Returns NULL if either
+	 * could not be allocated.
+	 */
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Obtain the memory for a task created by xTaskCreate(), from the task
+	 * pool if it is used, and initialise the TCB.  The task is not added to
+	 * the ready list.  Returns NULL if the memory could not be obtained.
+	 */
+	static TCB_t *prvCreateTask( TaskFunction_t pxTaskCode,
+								 const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+								 const configSTACK_DEPTH_TYPE usStackDepth,
+								 void * const pvParameters,
+								 UBaseType_t uxPriority,
+								 TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_TASK_POOL == 1 )
+
+	/*
+	 * Remove a TCB, with its stack, from the pool of the given stack depth.
+	 * Returns NULL if the pool holds no task of that stack depth.
+	 */
+	static TCB_t *prvTakeFromTaskPool( const configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Add the TCB, with its stack, of a deleted task that was created
+	 * dynamically to the pool.  Returns pdFALSE if the pool has no room for it,
+	 * in which case the memory must be freed.
+	 */
+	static BaseType_t prvAddToTaskPool( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+	#define taskRECYCLE_TCB( pxTCB )	prvAddToTaskPool( pxTCB )
+
+#else
+
+	#define taskRECYCLE_TCB( pxTCB )	pdFALSE
+
+#endif
+
 /*
  * Used only by the idle task.  This checks to see if anything has been placed
  * in the list of tasks waiting to be deleted.  If so the task is cleaned up
@@ -527,6 +915,18 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
 
 #endif
 
+/*
+ * Called by the idle task.  Takes the next task from xStackProfiledTasks, at
+ * most once every configSTACK_PROFILER_SAMPLE_PERIOD ticks, and updates the
+ * peak use of its stack.
+ */
+#if( configUSE_STACK_PROFILER == 1 )
+
+	static void prvSampleStackUsage( void ) PRIVILEGED_FUNCTION;
+	static void prvSampleTaskStack( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Return the amount of time, in ticks, that will pass before the kernel will
  * next move a task from the Blocked state to the Running state.
@@ -548,6 +948,137 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+/*
+ * Process ticks that were pended while the scheduler was suspended.  Rather
+ * than processing the ticks one at a time the tick count is advanced in as
+ * few steps as possible, each ending with a call to xTaskIncrementTick() that
+ * unblocks every task whose wake time has been reached in a single pass of
+ * the delayed list.  Returns pdTRUE if a context switch is required.
+ */
+static BaseType_t prvCatchUpTicks( UBaseType_t uxTicksToCatchUp ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	/*
+	 * Insert pxTCB into the ready list of its priority after the tasks with an
+	 * earlier or the same deadline.
+	 */
+	static void prvInsertTaskByDeadline( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns pdTRUE if pxTCB has a deadline and pxOtherTCB either does not or
+	 * has a later one.
+	 */
+	static BaseType_t prvDeadlineIsEarlier( const TCB_t * const pxTCB, const TCB_t * const pxOtherTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_TASK_BUDGETS == 1 )
+
+	/*
+	 * Charge a tick to the budget of a running task, moving it from the ready
+	 * list to xThrottledTaskList if the budget has been used.  Returns pdTRUE
+	 * if the task was throttled, so must be switched out.
+	 */
+	static BaseType_t prvChargeBudget( TCB_t * const pxTCB, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move the tasks in xThrottledTaskList whose budget is due to be
+	 * replenished back to the ready list.  Returns pdTRUE if a task that
+	 * should preempt the running task was readied.
+	 */
+	static BaseType_t prvReplenishBudgets( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the ticks until the budget of a throttled task is replenished.
+	 */
+	static TickType_t prvTicksToReplenish( const TCB_t * const pxTCB, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Place a task, which must not be in any state list, in
+	 * xThrottledTaskList until its budget is replenished.
+	 */
+	static void prvAddTaskToThrottledList( TCB_t * const pxTCB, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called as a suspended task is resumed.  If the task's budget was used
+	 * up and its period has not ended it is moved to xThrottledTaskList, so
+	 * suspending a throttled task does not release it, and pdTRUE returned.
+	 * Otherwise pdFALSE is returned and the task is left to be readied.
+	 */
+	static BaseType_t prvResumeThrottled( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configGENERATE_EXECUTION_STATS == 1 )
+
+	/*
+	 * Update the execution statistics of a task as it is switched out, or
+	 * in, at time ullNowNs.
+	 */
+	static void prvExecutionStatsSwitchOut( TCB_t * const pxTCB, const uint64_t ullNowNs ) PRIVILEGED_FUNCTION;
+	static void prvExecutionStatsSwitchIn( TCB_t * const pxTCB, const uint64_t ullNowNs ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+
+	/*
+	 * Called when the priority of a mutex holder has been raised or lowered
+	 * by priority inheritance.  If the holder is itself blocked on a mutex the
+	 * change is passed on to the holder of that mutex, and so on along the
+	 * chain of blocked holders.
+	 */
+	static void prvPropagateInheritedPriority( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( ( configUSE_MUTEXES == 1 ) && ( ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) || ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) ) )
+
+	/*
+	 * Set the priority of a task, which might not be the running task, moving
+	 * it to the ready list of its new priority if it is ready.
+	 */
+	static void prvSetInheritedPriority( TCB_t * const pxTCB, const UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	/*
+	 * Return the position of the lowest bit set in ulBits, which must not be
+	 * 0, in constant time.
+	 */
+	static UBaseType_t prvLowestSetBit( uint32_t ulBits ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Add a task's state list item to the slot of the timing wheel that
+	 * matches its wake time, or to the end of pxDelayedTaskList if its wake
+	 * time has been reached, and bring xNextTaskUnblockTime forward if needs
+	 * be.  The item value must hold the wake time.
+	 */
+	static void prvAddToTimingWheel( ListItem_t * const pxListItem ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Obtain the next time after xTimingWheelTime at which a slot of the wheel
+	 * has to be processed.  Returns pdFALSE if no slot holds a task.
+	 */
+	static BaseType_t prvGetNextTimingWheelEvent( TickType_t * const pxEventTime ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Process the slots of the wheel up to and including xTime, moving the
+	 * tasks whose wake time has been reached to pxDelayedTaskList.
+	 */
+	static void prvAdvanceTimingWheel( const TickType_t xTime ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called when the tick count overflows to move the tasks held in
+	 * pxOverflowDelayedTaskList onto the wheel.
+	 */
+	static void prvPlaceOverflowedTasksOnTimingWheel( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -577,6 +1108,46 @@ static void prvInitialiseNewTask( 	TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Select the highest priority ready task that is allowed to run on core
+	 * xCoreID and is not already running on another core, and make it the task
+	 * running on xCoreID.
+	 */
+	static void prvSelectHighestPriorityTask( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Called when pxTCB has been made ready.  If pxTCB is of higher priority
+	 * than the task running on a core it is allowed to run on then the core
+	 * running the lowest priority such task is asked to yield.  Must be called
+	 * from within a critical section.
+	 */
+	static void prvYieldForTask( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Ask core xCoreID to select a new task to run.  Must be called from within
+	 * a critical section.
+	 */
+	static void prvYieldCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUMBER_OF_CORES */
+
+#if( ( configNUMBER_OF_CORES > 1 ) && ( ( configASSERT_DEFINED == 1 ) || ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) )
+
+	/*
+	 * Returns pdTRUE if the scheduler was suspended by the calling core.  The
+	 * scheduler being suspended by another core does not stop this core
+	 * blocking, so uxSchedulerSuspended alone cannot be used to tell.
+	 */
+	static BaseType_t prvSchedulerSuspendedOnThisCore( void ) PRIVILEGED_FUNCTION;
+
+#else
+
+	#define prvSchedulerSuspendedOnThisCore()	( ( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE ) ? pdTRUE : pdFALSE )
+
+#endif
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -744,15 +1315,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 
-	BaseType_t xTaskCreate(	TaskFunction_t pxTaskCode,
-							const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-							const configSTACK_DEPTH_TYPE usStackDepth,
-							void * const pvParameters,
-							UBaseType_t uxPriority,
-							TaskHandle_t * const pxCreatedTask )
+	static TCB_t *prvAllocateTCBAndStack( const configSTACK_DEPTH_TYPE usStackDepth )
 	{
 	TCB_t *pxNewTCB;
-	BaseType_t xReturn;
 
 		/* If the stack grows down then allocate the stack then the TCB so the stack
 		does not grow into the TCB.  Likewise if the stack grows up then allocate
@@ -810,20 +1375,95 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB ) PRIVILEGED_FUNCTION;
 		}
 		#endif /* portSTACK_GROWTH */
 
-		if( pxNewTCB != NULL )
+		return pxNewTCB;
+	}
+	/*-----------------------------------------------------------*/
+
+	static TCB_t *prvCreateTask( TaskFunction_t pxTaskCode,
+								 const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+								 const configSTACK_DEPTH_TYPE usStackDepth,
+								 void * const pvParameters,
+								 UBaseType_t uxPriority,
+								 TaskHandle_t * const pxCreatedTask )
+	{
+	TCB_t *pxNewTCB;
+
+		#if( configUSE_TASK_POOL == 1 )
 		{
-			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+			/* Reuse the TCB and stack of a deleted task of the same stack depth
+			if there is one, so the heap is not touched. */
+			pxNewTCB = prvTakeFromTaskPool( usStackDepth );
+
+			if( pxNewTCB == NULL )
 			{
-				/* Tasks can be created statically or dynamically, so note this
-				task was created dynamically in case it is later deleted. */
-				pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
-			}
-			#endif /* configSUPPORT_STATIC_ALLOCATION */
+				pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
 
-			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
-			prvAddNewTaskToReadyList( pxNewTCB );
-			xReturn = pdPASS;
-		}
+				/* The heap may only be exhausted because of the memory held by
+				the pool, in which case free it and try again. */
+				if( ( pxNewTCB == NULL ) && ( uxTaskReleaseTaskPool() > ( UBaseType_t ) 0U ) )
+				{
+					pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
+		{
+			pxNewTCB = prvAllocateTCBAndStack( usStackDepth );
+		}
+		#endif /* configUSE_TASK_POOL */
+
+		if( pxNewTCB != NULL )
+		{
+			#if( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e9029 !e731 Macro has been consolidated for readability reasons. */
+			{
+				/* Tasks can be created statically or dynamically, so note this
+				task was created dynamically in case it is later deleted. */
+				pxNewTCB->ucStaticallyAllocated = tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB;
+			}
+			#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+			#if( configUSE_TASK_POOL == 1 )
+			{
+				pxNewTCB->usStackDepth = usStackDepth;
+			}
+			#endif
+
+			prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxNewTCB;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskCreate(	TaskFunction_t pxTaskCode,
+							const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+							const configSTACK_DEPTH_TYPE usStackDepth,
+							void * const pvParameters,
+							UBaseType_t uxPriority,
+							TaskHandle_t * const pxCreatedTask )
+	{
+	TCB_t *pxNewTCB;
+	BaseType_t xReturn;
+
+		pxNewTCB = prvCreateTask( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask );
+
+		if( pxNewTCB != NULL )
+		{
+			prvAddNewTaskToReadyList( pxNewTCB );
+			xReturn = pdPASS;
+		}
 		else
 		{
 			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
@@ -945,6 +1585,23 @@ UBaseType_t x;
 	}
 	#endif /* configUSE_MUTEXES */
 
+	#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+	{
+		pxNewTCB->pvBlockedOnMutex = NULL;
+	}
+	#endif
+
+	#if( configUSE_STACK_PROFILER == 1 )
+	{
+		/* The stack has just been filled, so only the words written by
+		pxPortInitialiseStack() will be found to have been used. */
+		vListInitialiseItem( &( pxNewTCB->xStackProfileListItem ) );
+		listSET_LIST_ITEM_OWNER( &( pxNewTCB->xStackProfileListItem ), pxNewTCB );
+		pxNewTCB->ulStackDepth = ulStackDepth;
+		pxNewTCB->ulStackPeak = 0UL;
+	}
+	#endif
+
 	vListInitialiseItem( &( pxNewTCB->xStateListItem ) );
 	vListInitialiseItem( &( pxNewTCB->xEventListItem ) );
 
@@ -974,6 +1631,40 @@ UBaseType_t x;
 	}
 	#endif /* configGENERATE_RUN_TIME_STATS */
 
+	#if( configUSE_PERIODIC_TASKS == 1 )
+	{
+		/* xTaskCreatePeriodic() sets the period once the task is
+		initialised. */
+		pxNewTCB->xPeriod = ( TickType_t ) 0;
+		pxNewTCB->xReleaseDeadline = ( TickType_t ) 0;
+		pxNewTCB->xReleaseTime = ( TickType_t ) 0;
+		pxNewTCB->ullReleaseNs = 0ULL;
+		pxNewTCB->ulReleases = 0UL;
+		pxNewTCB->ulDeadlineMisses = 0UL;
+		pxNewTCB->ulMaxReleaseLatencyNs = 0UL;
+		pxNewTCB->ucPeriodicState = taskPERIODIC_NO_JOB;
+
+		for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configPERIODIC_TASK_LATENCY_BUCKETS; x++ )
+		{
+			pxNewTCB->ulReleaseLatencyBuckets[ x ] = 0UL;
+		}
+	}
+	#endif /* configUSE_PERIODIC_TASKS */
+
+	#if( configGENERATE_EXECUTION_STATS == 1 )
+	{
+		/* The TCB may have been used by a task that was deleted, if it was
+		taken from the task pool. */
+		pxNewTCB->ulStatsSequence = 0UL;
+		pxNewTCB->ullRunTimeNs = 0ULL;
+		pxNewTCB->ullSwitchedInNs = 0ULL;
+		pxNewTCB->ulContextSwitches = 0UL;
+		pxNewTCB->ulPreemptions = 0UL;
+		pxNewTCB->ulVoluntaryBlocks = 0UL;
+		pxNewTCB->xStatsRunning = pdFALSE;
+	}
+	#endif /* configGENERATE_EXECUTION_STATS */
+
 	#if ( portUSING_MPU_WRAPPERS == 1 )
 	{
 		vPortStoreTaskMPUSettings( &( pxNewTCB->xMPUSettings ), xRegions, pxNewTCB->pxStack, ulStackDepth );
@@ -1014,6 +1705,30 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+		pxNewTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+	}
+	#endif
+
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		pxNewTCB->xDeadline = ( TickType_t ) 0;
+		pxNewTCB->xRelativeDeadline = ( TickType_t ) 0;
+	}
+	#endif
+
+	#if( configUSE_TASK_BUDGETS == 1 )
+	{
+		pxNewTCB->xBudget = ( TickType_t ) 0;
+		pxNewTCB->xBudgetPeriod = ( TickType_t ) 0;
+		pxNewTCB->xBudgetRemaining = ( TickType_t ) 0;
+		pxNewTCB->xBudgetPeriodStart = ( TickType_t ) 0;
+		pxNewTCB->ulBudgetExhaustions = 0UL;
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -1022,6 +1737,20 @@ UBaseType_t x;
 	{
 		pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters, xRunPrivileged );
 	}
+	#elif( portHAS_STACK_OVERFLOW_CHECKING == 1 )
+	{
+		/* The port also needs to know where the stack ends, so it can use, or
+		check, the whole stack. */
+		#if( portSTACK_GROWTH < 0 )
+		{
+			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxStack, pxTaskCode, pvParameters );
+		}
+		#else /* portSTACK_GROWTH */
+		{
+			pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxNewTCB->pxEndOfStack, pxTaskCode, pvParameters );
+		}
+		#endif /* portSTACK_GROWTH */
+	}
 	#else /* portUSING_MPU_WRAPPERS */
 	{
 		pxNewTCB->pxTopOfStack = pxPortInitialiseStack( pxTopOfStack, pxTaskCode, pvParameters );
@@ -1048,6 +1777,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	taskENTER_CRITICAL();
 	{
 		uxCurrentNumberOfTasks++;
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The task each core runs first is not selected until the
+			scheduler is started. */
+			if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+			{
+				prvInitialiseTaskLists();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#else
 		if( pxCurrentTCB == NULL )
 		{
 			/* There are no other tasks, or all the other tasks are in
@@ -1087,6 +1831,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#endif /* configNUMBER_OF_CORES */
 
 		uxTaskNumber++;
 
@@ -1098,6 +1843,12 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		#endif /* configUSE_TRACE_FACILITY */
 		traceTASK_CREATE( pxNewTCB );
 
+		#if( configUSE_STACK_PROFILER == 1 )
+		{
+			vListInsertEnd( &xStackProfiledTasks, &( pxNewTCB->xStackProfileListItem ) );
+		}
+		#endif
+
 		prvAddTaskToReadyList( pxNewTCB );
 
 		portSETUP_TCB( pxNewTCB );
@@ -1108,7 +1859,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	{
 		/* If the created task is of a higher priority than the current task
 		then it should run now. */
-		if( pxCurrentTCB->uxPriority < pxNewTCB->uxPriority )
+		if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxNewTCB, pxCurrentTCB ) ) )
 		{
 			taskYIELD_IF_USING_PREEMPTION();
 		}
@@ -1156,6 +1907,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 
+			#if( configUSE_STACK_PROFILER == 1 )
+			{
+				/* The stack is not sampled again, even if the task is not
+				freed until later. */
+				( void ) uxListRemove( &( pxTCB->xStackProfileListItem ) );
+			}
+			#endif
+
 			/* Increment the uxTaskNumber also so kernel aware debuggers can
 			detect that the task lists need re-generating.  This is done before
 			portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1183,6 +1942,17 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				required. */
 				portPRE_TASK_DELETE_HOOK( pxTCB, &xYieldPending );
 			}
+			#if( configNUMBER_OF_CORES > 1 )
+			else if( taskIS_RUNNING_ON_ANOTHER_CORE( pxTCB ) != pdFALSE )
+			{
+				/* The task is running on another core so cannot be freed
+				until that core has switched away from it.  Leave it for the
+				idle task to clean up, as if it had deleted itself. */
+				vListInsertEnd( &xTasksWaitingTermination, &( pxTCB->xStateListItem ) );
+				++uxDeletedTasksWaitingCleanUp;
+				prvYieldCore( pxTCB->xTaskRunState );
+			}
+			#endif /* configNUMBER_OF_CORES */
 			else
 			{
 				--uxCurrentNumberOfTasks;
@@ -1203,7 +1973,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		{
 			if( pxTCB == pxCurrentTCB )
 			{
-				configASSERT( uxSchedulerSuspended == 0 );
+				configASSERT( prvSchedulerSuspendedOnThisCore() == pdFALSE );
 				portYIELD_WITHIN_API();
 			}
 			else
@@ -1225,7 +1995,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		configASSERT( pxPreviousWakeTime );
 		configASSERT( ( xTimeIncrement > 0U ) );
-		configASSERT( uxSchedulerSuspended == 0 );
+		configASSERT( prvSchedulerSuspendedOnThisCore() == pdFALSE );
 
 		vTaskSuspendAll();
 		{
@@ -1270,6 +2040,23 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			/* Update the wake time ready for the next call. */
 			*pxPreviousWakeTime = xTimeToWake;
 
+			#if( configUSE_EDF_SCHEDULING == 1 )
+			{
+				/* The task's next job is released at the wake time, so its
+				deadline is the relative deadline after that.  The task is
+				moved to its new place in the ready list when it is next
+				switched out. */
+				if( pxCurrentTCB->xRelativeDeadline != ( TickType_t ) 0 )
+				{
+					pxCurrentTCB->xDeadline = xTimeToWake + pxCurrentTCB->xRelativeDeadline;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif
+
 			if( xShouldDelay != pdFALSE )
 			{
 				traceTASK_DELAY_UNTIL( xTimeToWake );
@@ -1309,7 +2096,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		/* A delay time of zero just forces a reschedule. */
 		if( xTicksToDelay > ( TickType_t ) 0U )
 		{
-			configASSERT( uxSchedulerSuspended == 0 );
+			configASSERT( prvSchedulerSuspendedOnThisCore() == pdFALSE );
 			vTaskSuspendAll();
 			{
 				traceTASK_DELAY();
@@ -1355,9 +2142,10 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 		configASSERT( pxTCB );
 
-		if( pxTCB == pxCurrentTCB )
+		if( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE )
 		{
-			/* The task calling this function is querying its own state. */
+			/* The task calling this function is querying its own state, or
+			the state of a task running on another core. */
 			eReturn = eRunning;
 		}
 		else
@@ -1370,13 +2158,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			}
 			taskEXIT_CRITICAL();
 
-			if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+			if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) || ( taskIS_TIMING_WHEEL_LIST( pxStateList ) != pdFALSE ) )
 			{
 				/* The task being queried is referenced from one of the Blocked
 				lists. */
 				eReturn = eBlocked;
 			}
 
+			#if( configUSE_TASK_BUDGETS == 1 )
+				else if( pxStateList == &xThrottledTaskList )
+				{
+					/* The task is waiting for its budget to be replenished. */
+					eReturn = eBlocked;
+				}
+			#endif
+
 			#if ( INCLUDE_vTaskSuspend == 1 )
 				else if( pxStateList == &xSuspendedTaskList )
 				{
@@ -1548,7 +2344,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 						/* The priority of a task other than the currently
 						running task is being raised.  Is the priority being
 						raised above that of the running task? */
-						if( uxNewPriority >= pxCurrentTCB->uxPriority )
+						if( taskSHOULD_PREEMPT( uxNewPriority >= pxCurrentTCB->uxPriority ) )
 						{
 							xYieldRequired = pdTRUE;
 						}
@@ -1571,6 +2367,13 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					is ready to execute. */
 					xYieldRequired = pdTRUE;
 				}
+				#if( configNUMBER_OF_CORES > 1 )
+				else if( taskIS_RUNNING_ON_ANOTHER_CORE( pxTCB ) != pdFALSE )
+				{
+					/* The same applies to a task running on another core. */
+					prvYieldCore( pxTCB->xTaskRunState );
+				}
+				#endif /* configNUMBER_OF_CORES */
 				else
 				{
 					/* Setting the priority of any other task down does not
@@ -1628,9 +2431,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
 					{
 						/* It is known that the task is in its ready list so
-						there is no need to check again and the port level
-						reset macro can be called directly. */
-						portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
+						there is no need to check again and the ready priority
+						can be cleared directly. */
+						taskCLEAR_READY_PRIORITY( uxPriorityUsedOnEntry );
 					}
 					else
 					{
@@ -1663,131 +2466,98 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskSuspend == 1 )
+#if( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
 
-	void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+	void vTaskCoreAffinitySet( TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask )
 	{
 	TCB_t *pxTCB;
 
 		taskENTER_CRITICAL();
 		{
-			/* If null is passed in here then it is the running task that is
-			being suspended. */
-			pxTCB = prvGetTCBFromHandle( xTaskToSuspend );
-
-			traceTASK_SUSPEND( pxTCB );
+			/* If null is passed in here then it is the affinity of the calling
+			task that is being changed. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
 
-			/* Remove task from the ready/delayed list and place in the
-			suspended list. */
-			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
-			{
-				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
-			}
-			else
+			if( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE )
 			{
-				mtCOVERAGE_TEST_MARKER();
+				/* The task must move if it is no longer allowed to run on the
+				core it is running on. */
+				if( ( uxCoreAffinityMask & ( ( UBaseType_t ) 1 << pxTCB->xTaskRunState ) ) == ( UBaseType_t ) 0 )
+				{
+					prvYieldCore( pxTCB->xTaskRunState );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
-
-			/* Is the task waiting on an event also? */
-			if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+			else if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
 			{
-				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+				/* A ready task may now be allowed to run on a core running a
+				lower priority task. */
+				prvYieldForTask( pxTCB );
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
-
-			vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
-
-			#if( configUSE_TASK_NOTIFICATIONS == 1 )
-			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
-				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
-				}
-			}
-			#endif
 		}
 		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
 
-		if( xSchedulerRunning != pdFALSE )
-		{
-			/* Reset the next expected unblock time in case it referred to the
-			task that is now in the Suspended state. */
-			taskENTER_CRITICAL();
-			{
-				prvResetNextTaskUnblockTime();
-			}
-			taskEXIT_CRITICAL();
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+	UBaseType_t uxTaskCoreAffinityGet( const TaskHandle_t xTask )
+	{
+	TCB_t const *pxTCB;
+	UBaseType_t uxCoreAffinityMask;
 
-		if( pxTCB == pxCurrentTCB )
-		{
-			if( xSchedulerRunning != pdFALSE )
-			{
-				/* The current task has just been suspended. */
-				configASSERT( uxSchedulerSuspended == 0 );
-				portYIELD_WITHIN_API();
-			}
-			else
-			{
-				/* The scheduler is not running, but the task that was pointed
-				to by pxCurrentTCB has just been suspended and pxCurrentTCB
-				must be adjusted to point to a different task. */
-				if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
-				{
-					/* No other tasks are ready, so set pxCurrentTCB back to
-					NULL so when the next task is created pxCurrentTCB will
-					be set to point to it no matter what its relative priority
-					is. */
-					pxCurrentTCB = NULL;
-				}
-				else
-				{
-					vTaskSwitchContext();
-				}
-			}
-		}
-		else
+		taskENTER_CRITICAL();
 		{
-			mtCOVERAGE_TEST_MARKER();
+			pxTCB = prvGetTCBFromHandle( xTask );
+			uxCoreAffinityMask = pxTCB->uxCoreAffinityMask;
 		}
+		taskEXIT_CRITICAL();
+
+		return uxCoreAffinityMask;
 	}
 
-#endif /* INCLUDE_vTaskSuspend */
+#endif /* ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskSuspend == 1 )
+#if( configUSE_EDF_SCHEDULING == 1 )
 
-	static BaseType_t prvTaskIsTaskSuspended( const TaskHandle_t xTask )
+	void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline )
 	{
-	BaseType_t xReturn = pdFALSE;
-	const TCB_t * const pxTCB = xTask;
-
-		/* Accesses xPendingReadyList so must be called from a critical
-		section. */
-
-		/* It does not make sense to check if the calling task is suspended. */
-		configASSERT( xTask );
+	TCB_t *pxTCB;
+	BaseType_t xYieldRequired = pdFALSE;
 
-		/* Is the task being resumed actually in the suspended list? */
-		if( listIS_CONTAINED_WITHIN( &xSuspendedTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE )
+		taskENTER_CRITICAL();
 		{
-			/* Has the task already been resumed from within an ISR? */
-			if( listIS_CONTAINED_WITHIN( &xPendingReadyList, &( pxTCB->xEventListItem ) ) == pdFALSE )
+			/* If null is passed in here then it is the deadline of the calling
+			task that is being set. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxTCB->xRelativeDeadline = xRelativeDeadline;
+			pxTCB->xDeadline = xTickCount + xRelativeDeadline;
+
+			if( pxTCB == pxCurrentTCB )
 			{
-				/* Is it in the suspended list because it is in the	Suspended
-				state, or because is is blocked with no timeout? */
-				if( listIS_CONTAINED_WITHIN( NULL, &( pxTCB->xEventListItem ) ) != pdFALSE ) /*lint !e961.  The cast is only redundant when NULL is used. */
+				/* Another ready task may now have the earlier deadline.  The
+				calling task is moved within the ready list when it is switched
+				out. */
+				xYieldRequired = pdTRUE;
+			}
+			else if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+			{
+				/* The ready list is ordered by deadline, so the task must be
+				moved within it.  The list is not left empty, so the ready
+				priority does not need resetting. */
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				prvInsertTaskByDeadline( pxTCB );
+
+				if( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) )
 				{
-					xReturn = pdTRUE;
+					xYieldRequired = pdTRUE;
 				}
 				else
 				{
@@ -1798,2009 +2568,3883 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+
+			if( ( xYieldRequired != pdFALSE ) && ( xSchedulerRunning != pdFALSE ) )
+			{
+				taskYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
 
-		return xReturn;
-	} /*lint !e818 xTask cannot be a pointer to const because it is a typedef. */
+	TickType_t xTaskGetDeadline( const TaskHandle_t xTask )
+	{
+	TCB_t const *pxTCB;
+	TickType_t xDeadline;
 
-#endif /* INCLUDE_vTaskSuspend */
-/*-----------------------------------------------------------*/
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
 
-#if ( INCLUDE_vTaskSuspend == 1 )
+			if( pxTCB->xRelativeDeadline != ( TickType_t ) 0 )
+			{
+				xDeadline = pxTCB->xDeadline;
+			}
+			else
+			{
+				xDeadline = portMAX_DELAY;
+			}
+		}
+		taskEXIT_CRITICAL();
 
-	void vTaskResume( TaskHandle_t xTaskToResume )
-	{
-	TCB_t * const pxTCB = xTaskToResume;
+		return xDeadline;
+	}
+	/*-----------------------------------------------------------*/
 
-		/* It does not make sense to resume the calling task. */
-		configASSERT( xTaskToResume );
+	static void prvInsertTaskByDeadline( TCB_t *pxTCB )
+	{
+	List_t * const pxReadyList = &( pxReadyTasksLists[ pxTCB->uxPriority ] );
+	ListItem_t const * const pxEndMarker = listGET_END_MARKER( pxReadyList );
+	ListItem_t *pxIterator;
 
-		/* The parameter cannot be NULL as it is impossible to resume the
-		currently executing task. */
-		if( ( pxTCB != pxCurrentTCB ) && ( pxTCB != NULL ) )
+		if( pxTCB->xRelativeDeadline == ( TickType_t ) 0 )
 		{
-			taskENTER_CRITICAL();
+			/* Tasks without a deadline go after all the others. */
+			pxIterator = ( ListItem_t * ) pxEndMarker;
+		}
+		else
+		{
+			for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
 			{
-				if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
-				{
-					traceTASK_RESUME( pxTCB );
-
-					/* The ready list can be accessed even if the scheduler is
-					suspended because this is inside a critical section. */
-					( void ) uxListRemove(  &( pxTCB->xStateListItem ) );
-					prvAddTaskToReadyList( pxTCB );
-
-					/* A higher priority task may have just been resumed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-					{
-						/* This yield may not cause the task just resumed to run,
-						but will leave the lists in the correct state for the
-						next yield. */
-						taskYIELD_IF_USING_PREEMPTION();
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-				}
-				else
+				if( prvDeadlineIsEarlier( pxTCB, ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) ) != pdFALSE )
 				{
-					mtCOVERAGE_TEST_MARKER();
+					break;
 				}
 			}
-			taskEXIT_CRITICAL();
+		}
+
+		/* vListInsertEnd() inserts the item before the index of the list.  The
+		index is otherwise unused, as the task to run is always taken from the
+		head of the list. */
+		pxReadyList->pxIndex = pxIterator;
+		vListInsertEnd( pxReadyList, &( pxTCB->xStateListItem ) );
+		pxReadyList->pxIndex = ( ListItem_t * ) pxEndMarker;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvDeadlineIsEarlier( const TCB_t * const pxTCB, const TCB_t * const pxOtherTCB )
+	{
+	BaseType_t xReturn;
+
+		if( pxTCB->xRelativeDeadline == ( TickType_t ) 0 )
+		{
+			xReturn = pdFALSE;
+		}
+		else if( pxOtherTCB->xRelativeDeadline == ( TickType_t ) 0 )
+		{
+			xReturn = pdTRUE;
+		}
+		else if( ( TickType_t ) ( pxTCB->xDeadline - pxOtherTCB->xDeadline ) > ( portMAX_DELAY >> 1 ) )
+		{
+			/* The deadlines are compared with each other, rather than with 0,
+			so the order is kept when the tick count overflows provided they
+			are less than half the range of TickType_t apart. */
+			xReturn = pdTRUE;
 		}
 		else
 		{
-			mtCOVERAGE_TEST_MARKER();
+			xReturn = pdFALSE;
 		}
-	}
 
-#endif /* INCLUDE_vTaskSuspend */
+		return xReturn;
+	}
 
+#endif /* configUSE_EDF_SCHEDULING */
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskResumeFromISR == 1 ) && ( INCLUDE_vTaskSuspend == 1 ) )
+#if( configUSE_PERIODIC_TASKS == 1 )
 
-	BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume )
+	BaseType_t xTaskCreatePeriodic(	TaskFunction_t pxTaskCode,
+									const char * const pcName,		/*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+									const configSTACK_DEPTH_TYPE usStackDepth,
+									void * const pvParameters,
+									UBaseType_t uxPriority,
+									TickType_t xPeriod,
+									TickType_t xPhase,
+									TickType_t xRelativeDeadline,
+									TaskHandle_t * const pxCreatedTask )
 	{
-	BaseType_t xYieldRequired = pdFALSE;
-	TCB_t * const pxTCB = xTaskToResume;
-	UBaseType_t uxSavedInterruptStatus;
+	TCB_t *pxNewTCB;
+	BaseType_t xReturn;
+	TickType_t xElapsed;
 
-		configASSERT( xTaskToResume );
+		configASSERT( xPeriod > ( TickType_t ) 0 );
+		configASSERT( xRelativeDeadline <= xPeriod );
 
-		/* RTOS ports that support interrupt nesting have the concept of a
-		maximum	system call (or maximum API call) interrupt priority.
-		Interrupts that are	above the maximum system call priority are keep
-		permanently enabled, even when the RTOS kernel is in a critical section,
-		but cannot make any calls to FreeRTOS API functions.  If configASSERT()
-		is defined in FreeRTOSConfig.h then
-		portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
-		failure if a FreeRTOS API function is called from an interrupt that has
-		been assigned a priority above the configured maximum system call
-		priority.  Only FreeRTOS functions that end in FromISR can be called
-		from interrupts	that have been assigned a priority at or (logically)
-		below the maximum system call interrupt priority.  FreeRTOS maintains a
-		separate interrupt safe API to ensure interrupt entry is as fast and as
-		simple as possible.  More information (albeit Cortex-M specific) is
-		provided on the following link:
-		https://www.freertos.org/RTOS-Cortex-M3-M4.html */
-		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+		pxNewTCB = prvCreateTask( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask );
 
-		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		if( pxNewTCB != NULL )
 		{
-			if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
+			/* The task is not in any list yet, so cannot be accessed by an
+			interrupt or another task. */
+			pxNewTCB->xPeriod = xPeriod;
+
+			if( xRelativeDeadline == ( TickType_t ) 0 )
 			{
-				traceTASK_RESUME_FROM_ISR( pxTCB );
+				pxNewTCB->xReleaseDeadline = xPeriod;
+			}
+			else
+			{
+				pxNewTCB->xReleaseDeadline = xRelativeDeadline;
+			}
 
-				/* Check the ready lists can be accessed. */
-				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
-				{
-					/* Ready lists can be accessed so move the task from the
-					suspended list to the ready list directly. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-					{
-						xYieldRequired = pdTRUE;
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+			/* The first release is xPhase after the tick count the scheduler
+			starts from, or the first whole number of periods after that which
+			has not already passed, so the releases of all the periodic tasks
+			keep their phases relative to each other.  This only holds while the
+			time since the scheduler started fits in half the range of the tick
+			count. */
+			pxNewTCB->xReleaseTime = ( TickType_t ) configINITIAL_TICK_COUNT + xPhase;
+			xElapsed = xTickCount - pxNewTCB->xReleaseTime;
 
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-					prvAddTaskToReadyList( pxTCB );
-				}
-				else
-				{
-					/* The delayed or ready lists cannot be accessed so the task
-					is held in the pending ready list until the scheduler is
-					unsuspended. */
-					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
-				}
+			if( ( xElapsed != ( TickType_t ) 0 ) && ( xElapsed <= ( portMAX_DELAY >> 1 ) ) )
+			{
+				pxNewTCB->xReleaseTime += ( ( ( xElapsed - ( TickType_t ) 1 ) / xPeriod ) + ( TickType_t ) 1 ) * xPeriod;
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
-		}
-		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
-
-		return xYieldRequired;
-	}
-
-#endif /* ( ( INCLUDE_xTaskResumeFromISR == 1 ) && ( INCLUDE_vTaskSuspend == 1 ) ) */
-/*-----------------------------------------------------------*/
-
-void vTaskStartScheduler( void )
-{
-BaseType_t xReturn;
 
-	/* Add the idle task at the lowest priority. */
-	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
-	{
-		StaticTask_t *pxIdleTaskTCBBuffer = NULL;
-		StackType_t *pxIdleTaskStackBuffer = NULL;
-		uint32_t ulIdleTaskStackSize;
+			/* If the first release is due now it is made here, rather than by
+			the task's first call to xTaskWaitForNextPeriod(), so the first
+			job's latency is measured from the task's creation, as later jobs'
+			are from the tick that released them, and the first job is counted
+			as any other. */
+			if( pxNewTCB->xReleaseTime == xTickCount )
+			{
+				pxNewTCB->ucPeriodicState = taskPERIODIC_FIRST_JOB_RELEASED;
+				pxNewTCB->ullReleaseNs = portGET_RUN_TIME_NS();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-		/* The Idle task is created using user provided RAM - obtain the
-		address of the RAM then create the idle task. */
-		vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
-		xIdleTaskHandle = xTaskCreateStatic(	prvIdleTask,
-												configIDLE_TASK_NAME,
-												ulIdleTaskStackSize,
-												( void * ) NULL, /*lint !e961.  The cast is not redundant for all compilers. */
-												portPRIVILEGE_BIT, /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
-												pxIdleTaskStackBuffer,
-												pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+			#if( configUSE_EDF_SCHEDULING == 1 )
+			{
+				/* The deadline is advanced with each release. */
+				pxNewTCB->xRelativeDeadline = pxNewTCB->xReleaseDeadline;
+				pxNewTCB->xDeadline = pxNewTCB->xReleaseTime + pxNewTCB->xReleaseDeadline;
+			}
+			#endif
 
-		if( xIdleTaskHandle != NULL )
-		{
+			prvAddNewTaskToReadyList( pxNewTCB );
 			xReturn = pdPASS;
 		}
 		else
 		{
-			xReturn = pdFAIL;
+			xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
 		}
-	}
-	#else
-	{
-		/* The Idle task is being created using dynamically allocated RAM. */
-		xReturn = xTaskCreate(	prvIdleTask,
-								configIDLE_TASK_NAME,
-								configMINIMAL_STACK_SIZE,
-								( void * ) NULL,
-								portPRIVILEGE_BIT, /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
-								&xIdleTaskHandle ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
-	}
-	#endif /* configSUPPORT_STATIC_ALLOCATION */
 
-	#if ( configUSE_TIMERS == 1 )
-	{
-		if( xReturn == pdPASS )
-		{
-			xReturn = xTimerCreateTimerTask();
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+		return xReturn;
 	}
-	#endif /* configUSE_TIMERS */
+	/*-----------------------------------------------------------*/
 
-	if( xReturn == pdPASS )
+	BaseType_t xTaskWaitForNextPeriod( void )
 	{
-		/* freertos_tasks_c_additions_init() should only be called if the user
-		definable macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is
-		the only macro called by the function. */
-		#ifdef FREERTOS_TASKS_C_ADDITIONS_INIT
-		{
-			freertos_tasks_c_additions_init();
-		}
-		#endif
+	TCB_t * const pxTCB = pxCurrentTCB;
+	BaseType_t xAlreadyYielded, xReturn;
+	TickType_t xTicksLate;
+	uint64_t ullNowNs;
+	uint32_t ulLatencyNs, ulLatencyUs;
+	UBaseType_t uxBucket;
 
-		/* Interrupts are turned off here, to ensure a tick does not occur
-		before or during the call to xPortStartScheduler().  The stacks of
-		the created tasks contain a status word with interrupts switched on
-		so interrupts will automatically get re-enabled when the first task
-		starts to run. */
-		portDISABLE_INTERRUPTS();
+		configASSERT( pxTCB->xPeriod > ( TickType_t ) 0 );
+		configASSERT( prvSchedulerSuspendedOnThisCore() == pdFALSE );
 
-		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		vTaskSuspendAll();
 		{
-			/* Switch Newlib's _impure_ptr variable to point to the _reent
-			structure specific to the task that will run first. */
-			_impure_ptr = &( pxCurrentTCB->xNewLib_reent );
-		}
-		#endif /* configUSE_NEWLIB_REENTRANT */
-
-		xNextTaskUnblockTime = portMAX_DELAY;
-		xSchedulerRunning = pdTRUE;
-		xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
+			/* Minor optimisation.  The tick count cannot change in this
+			block. */
+			const TickType_t xConstTickCount = xTickCount;
 
-		/* If configGENERATE_RUN_TIME_STATS is defined then the following
-		macro must be defined to configure the timer/counter used to generate
-		the run time counter time base.   NOTE:  If configGENERATE_RUN_TIME_STATS
-		is set to 0 and the following line fails to build then ensure you do not
-		have portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() defined in your
-		FreeRTOSConfig.h file. */
-		portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+			if( pxTCB->ucPeriodicState == taskPERIODIC_JOB_RUNNING )
+			{
+				/* The current job is complete.  Its deadline is missed if it
+				completed more than the relative deadline after its release. */
+				if( ( TickType_t ) ( xConstTickCount - pxTCB->xReleaseTime ) > pxTCB->xReleaseDeadline )
+				{
+					pxTCB->ulDeadlineMisses++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 
-		traceTASK_SWITCHED_IN();
+				pxTCB->xReleaseTime += pxTCB->xPeriod;
+				xTicksLate = xConstTickCount - pxTCB->xReleaseTime;
+			}
+			else if( pxTCB->ucPeriodicState == taskPERIODIC_FIRST_JOB_RELEASED )
+			{
+				/* The first job was released when the task was created, so
+				starts now, with the release time and deadline it was given
+				then. */
+				xTicksLate = ( TickType_t ) 0;
+			}
+			else
+			{
+				/* The task has no job to complete, so is waiting for its
+				first release, or for a release it was woken early from.  A
+				task that did not wait in time does not catch up the releases
+				it has missed, but waits for the latest. */
+				xTicksLate = xConstTickCount - pxTCB->xReleaseTime;
 
-		/* Setting up the timer tick is hardware specific and thus in the
-		portable interface. */
-		if( xPortStartScheduler() != pdFALSE )
-		{
-			/* Should not reach here as if the scheduler is running the
-			function will not return. */
-		}
-		else
-		{
-			/* Should only reach here if a task calls xTaskEndScheduler(). */
-		}
-	}
-	else
-	{
-		/* This line will only be reached if the kernel could not be started,
-		because there was not enough FreeRTOS heap to create the idle task
-		or the timer task. */
-		configASSERT( xReturn != errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY );
-	}
-
-	/* Prevent compiler warnings if INCLUDE_xTaskGetIdleTaskHandle is set to 0,
-	meaning xIdleTaskHandle is not used anywhere else. */
-	( void ) xIdleTaskHandle;
-}
-/*-----------------------------------------------------------*/
-
-void vTaskEndScheduler( void )
-{
-	/* Stop the scheduler interrupts and call the portable scheduler end
-	routine so the original ISRs can be restored if necessary.  The port
-	layer must ensure interrupts enable	bit is left in the correct state. */
-	portDISABLE_INTERRUPTS();
-	xSchedulerRunning = pdFALSE;
-	vPortEndScheduler();
-}
-/*----------------------------------------------------------*/
-
-void vTaskSuspendAll( void )
-{
-	/* A critical section is not required as the variable is of type
-	BaseType_t.  Please read Richard Barry's reply in the following link to a
-	post in the FreeRTOS support forum before reporting this as a bug! -
-	http://goo.gl/wu4acr */
-	++uxSchedulerSuspended;
-}
-/*----------------------------------------------------------*/
-
-#if ( configUSE_TICKLESS_IDLE != 0 )
-
-	static TickType_t prvGetExpectedIdleTime( void )
-	{
-	TickType_t xReturn;
-	UBaseType_t uxHigherPriorityReadyTasks = pdFALSE;
+				if( ( xTicksLate >= pxTCB->xPeriod ) && ( xTicksLate <= ( portMAX_DELAY >> 1 ) ) )
+				{
+					pxTCB->xReleaseTime += ( xTicksLate / pxTCB->xPeriod ) * pxTCB->xPeriod;
+					xTicksLate = xConstTickCount - pxTCB->xReleaseTime;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
 
-		/* uxHigherPriorityReadyTasks takes care of the case where
-		configUSE_PREEMPTION is 0, so there may be tasks above the idle priority
-		task that are in the Ready state, even though the idle task is
-		running. */
-		#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
-		{
-			if( uxTopReadyPriority > tskIDLE_PRIORITY )
+			#if( configUSE_EDF_SCHEDULING == 1 )
 			{
-				uxHigherPriorityReadyTasks = pdTRUE;
+				/* As in vTaskDelayUntil(), the deadline follows the release.
+				The task is moved to its new place in the ready list when it
+				is next switched out. */
+				if( pxTCB->xRelativeDeadline != ( TickType_t ) 0 )
+				{
+					pxTCB->xDeadline = pxTCB->xReleaseTime + pxTCB->xRelativeDeadline;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
-		}
-		#else
-		{
-			const UBaseType_t uxLeastSignificantBit = ( UBaseType_t ) 0x01;
+			#endif
 
-			/* When port optimised task selection is used the uxTopReadyPriority
-			variable is used as a bit map.  If bits other than the least
-			significant bit are set then there are tasks that have a priority
-			above the idle priority that are in the Ready state.  This takes
-			care of the case where the co-operative scheduler is in use. */
-			if( uxTopReadyPriority > uxLeastSignificantBit )
+			if( pxTCB->ucPeriodicState == taskPERIODIC_FIRST_JOB_RELEASED )
 			{
-				uxHigherPriorityReadyTasks = pdTRUE;
+				pxTCB->ucPeriodicState = taskPERIODIC_JOB_RUNNING;
+			}
+			else if( xTicksLate > ( portMAX_DELAY >> 1 ) )
+			{
+				/* The release is still to come, and is made by the tick
+				interrupt moving the task out of the delayed list. */
+				pxTCB->ucPeriodicState = taskPERIODIC_WAITING_FOR_RELEASE;
+				traceTASK_DELAY_UNTIL( pxTCB->xReleaseTime );
+				prvAddCurrentTaskToDelayedList( pxTCB->xReleaseTime - xConstTickCount, pdFALSE );
+			}
+			else
+			{
+				/* The release time has already passed, as the job that has
+				just completed overran into the next period, so the next job
+				starts now.  Its latency includes the ticks that have passed
+				since it was due. */
+				pxTCB->ucPeriodicState = taskPERIODIC_JOB_RUNNING;
+				pxTCB->ullReleaseNs = portGET_RUN_TIME_NS() - ( ( uint64_t ) xTicksLate * taskTICK_PERIOD_NS );
 			}
 		}
-		#endif
+		xAlreadyYielded = xTaskResumeAll();
 
-		if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
-		{
-			xReturn = 0;
-		}
-		else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1 )
-		{
-			/* There are other idle priority tasks in the ready state.  If
-			time slicing is used then the very next tick interrupt must be
-			processed. */
-			xReturn = 0;
-		}
-		else if( uxHigherPriorityReadyTasks != pdFALSE )
+		/* Force a reschedule if xTaskResumeAll has not already done so, we may
+		have put ourselves to sleep. */
+		if( xAlreadyYielded == pdFALSE )
 		{
-			/* There are tasks in the Ready state that have a priority above the
-			idle priority.  This path can only be reached if
-			configUSE_PREEMPTION is 0. */
-			xReturn = 0;
+			portYIELD_WITHIN_API();
 		}
 		else
 		{
-			xReturn = xNextTaskUnblockTime - xTickCount;
+			mtCOVERAGE_TEST_MARKER();
 		}
 
-		return xReturn;
-	}
-
-#endif /* configUSE_TICKLESS_IDLE */
-/*----------------------------------------------------------*/
-
-BaseType_t xTaskResumeAll( void )
-{
-TCB_t *pxTCB = NULL;
-BaseType_t xAlreadyYielded = pdFALSE;
-
-	/* If uxSchedulerSuspended is zero then this function does not match a
-	previous call to vTaskSuspendAll(). */
-	configASSERT( uxSchedulerSuspended );
-
-	/* It is possible that an ISR caused a task to be removed from an event
-	list while the scheduler was suspended.  If this was the case then the
-	removed task will have been added to the xPendingReadyList.  Once the
-	scheduler has been resumed it is safe to move all the pending ready
-	tasks from this list into their appropriate ready list. */
-	taskENTER_CRITICAL();
-	{
-		--uxSchedulerSuspended;
+		ullNowNs = portGET_RUN_TIME_NS();
 
-		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		taskENTER_CRITICAL();
 		{
-			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
+			if( pxTCB->ucPeriodicState == taskPERIODIC_JOB_RUNNING )
 			{
-				/* Move any readied tasks from the pending list into the
-				appropriate ready list. */
-				while( listLIST_IS_EMPTY( &xPendingReadyList ) == pdFALSE )
+				if( ullNowNs > pxTCB->ullReleaseNs )
 				{
-					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-					( void ) uxListRemove( &( pxTCB->xEventListItem ) );
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-					prvAddTaskToReadyList( pxTCB );
-
-					/* If the moved task has a priority higher than the current
-					task then a yield must be performed. */
-					if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-					{
-						xYieldPending = pdTRUE;
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+					ulLatencyNs = ( ( ullNowNs - pxTCB->ullReleaseNs ) < ( uint64_t ) 0xffffffffUL ) ? ( uint32_t ) ( ullNowNs - pxTCB->ullReleaseNs ) : 0xffffffffUL;
 				}
-
-				if( pxTCB != NULL )
+				else
 				{
-					/* A task was unblocked while the scheduler was suspended,
-					which may have prevented the next unblock time from being
-					re-calculated, in which case re-calculate it now.  Mainly
-					important for low power tickless implementations, where
-					this can prevent an unnecessary exit from low power
-					state. */
-					prvResetNextTaskUnblockTime();
+					ulLatencyNs = 0UL;
 				}
 
-				/* If any ticks occurred while the scheduler was suspended then
-				they should be processed now.  This ensures the tick count does
-				not	slip, and that any delayed tasks are resumed at the correct
-				time. */
-				{
-					UBaseType_t uxPendedCounts = uxPendedTicks; /* Non-volatile copy. */
-
-					if( uxPendedCounts > ( UBaseType_t ) 0U )
-					{
-						do
-						{
-							if( xTaskIncrementTick() != pdFALSE )
-							{
-								xYieldPending = pdTRUE;
-							}
-							else
-							{
-								mtCOVERAGE_TEST_MARKER();
-							}
-							--uxPendedCounts;
-						} while( uxPendedCounts > ( UBaseType_t ) 0U );
+				/* Bucket 0 counts latencies of less than 1us, and bucket n
+				latencies of less than 2^n us but not less than 2^(n-1) us. */
+				ulLatencyUs = ulLatencyNs / 1000UL;
+				uxBucket = ( UBaseType_t ) 0;
 
-						uxPendedTicks = 0;
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+				while( ( ulLatencyUs != 0UL ) && ( uxBucket < ( UBaseType_t ) ( configPERIODIC_TASK_LATENCY_BUCKETS - 1 ) ) )
+				{
+					ulLatencyUs >>= 1UL;
+					uxBucket++;
 				}
 
-				if( xYieldPending != pdFALSE )
+				pxTCB->ulReleaseLatencyBuckets[ uxBucket ]++;
+				pxTCB->ulReleases++;
+
+				if( ulLatencyNs > pxTCB->ulMaxReleaseLatencyNs )
 				{
-					#if( configUSE_PREEMPTION != 0 )
-					{
-						xAlreadyYielded = pdTRUE;
-					}
-					#endif
-					taskYIELD_IF_USING_PREEMPTION();
+					pxTCB->ulMaxReleaseLatencyNs = ulLatencyNs;
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				xReturn = pdPASS;
+			}
+			else
+			{
+				/* Woken before the release, for example by xTaskAbortDelay().
+				The task has no job, so is not released by the tick if it
+				blocks for another reason before waiting again. */
+				pxTCB->ucPeriodicState = taskPERIODIC_NO_JOB;
+				xReturn = pdFAIL;
 			}
 		}
-		else
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicTaskStats_t *pxStats )
+	{
+	TCB_t *pxTCB;
+	BaseType_t xReturn;
+	UBaseType_t uxBucket;
+
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
 		{
-			mtCOVERAGE_TEST_MARKER();
+			/* If null is passed in here then the calling task is being
+			queried. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			if( pxTCB->xPeriod != ( TickType_t ) 0 )
+			{
+				pxStats->ulReleases = pxTCB->ulReleases;
+				pxStats->ulDeadlineMisses = pxTCB->ulDeadlineMisses;
+				pxStats->ulMaxLatencyNs = pxTCB->ulMaxReleaseLatencyNs;
+
+				for( uxBucket = ( UBaseType_t ) 0; uxBucket < ( UBaseType_t ) configPERIODIC_TASK_LATENCY_BUCKETS; uxBucket++ )
+				{
+					pxStats->ulLatencyBuckets[ uxBucket ] = pxTCB->ulReleaseLatencyBuckets[ uxBucket ];
+				}
+
+				xReturn = pdPASS;
+			}
+			else
+			{
+				xReturn = pdFAIL;
+			}
 		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
 	}
-	taskEXIT_CRITICAL();
 
-	return xAlreadyYielded;
-}
+#endif /* configUSE_PERIODIC_TASKS */
 /*-----------------------------------------------------------*/
 
-TickType_t xTaskGetTickCount( void )
-{
-TickType_t xTicks;
+#if( configUSE_TASK_BUDGETS == 1 )
 
-	/* Critical section required if running on a 16 bit processor. */
-	portTICK_TYPE_ENTER_CRITICAL();
+	void vTaskSetBudget( TaskHandle_t xTask, TickType_t xBudget, TickType_t xPeriod )
 	{
-		xTicks = xTickCount;
-	}
-	portTICK_TYPE_EXIT_CRITICAL();
+	TCB_t *pxTCB;
+	BaseType_t xYieldRequired = pdFALSE;
 
-	return xTicks;
-}
-/*-----------------------------------------------------------*/
+		/* The budget must fit in the period, and the period be short enough
+		for its end to be told from its start once the tick count has
+		overflowed. */
+		configASSERT( ( xBudget == ( TickType_t ) 0 ) || ( ( xBudget <= xPeriod ) && ( xPeriod <= ( portMAX_DELAY >> 1 ) ) ) );
 
-TickType_t xTaskGetTickCountFromISR( void )
-{
-TickType_t xReturn;
-UBaseType_t uxSavedInterruptStatus;
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the budget of the calling
+			task that is being set. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxTCB->xBudget = xBudget;
+			pxTCB->xBudgetPeriod = xPeriod;
+			pxTCB->xBudgetRemaining = xBudget;
 
-	/* RTOS ports that support interrupt nesting have the concept of a maximum
-	system call (or maximum API call) interrupt priority.  Interrupts that are
-	above the maximum system call priority are kept permanently enabled, even
-	when the RTOS kernel is in a critical section, but cannot make any calls to
-	FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
-	then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
-	failure if a FreeRTOS API function is called from an interrupt that has been
-	assigned a priority above the configured maximum system call priority.
-	Only FreeRTOS functions that end in FromISR can be called from interrupts
-	that have been assigned a priority at or (logically) below the maximum
-	system call	interrupt priority.  FreeRTOS maintains a separate interrupt
-	safe API to ensure interrupt entry is as fast and as simple as possible.
-	More information (albeit Cortex-M specific) is provided on the following
-	link: https://www.freertos.org/RTOS-Cortex-M3-M4.html */
-	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+			/* A task that was throttled starts again with the new budget. */
+			if( taskIS_THROTTLED( pxTCB ) != pdFALSE )
+			{
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				prvAddTaskToReadyList( pxTCB );
 
-	uxSavedInterruptStatus = portTICK_TYPE_SET_INTERRUPT_MASK_FROM_ISR();
-	{
-		xReturn = xTickCount;
-	}
-	portTICK_TYPE_CLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+				if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
+				{
+					xYieldRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-	return xReturn;
-}
-/*-----------------------------------------------------------*/
+			if( ( xYieldRequired != pdFALSE ) && ( xSchedulerRunning != pdFALSE ) )
+			{
+				taskYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
 
-UBaseType_t uxTaskGetNumberOfTasks( void )
-{
-	/* A critical section is not required because the variables are of type
-	BaseType_t. */
-	return uxCurrentNumberOfTasks;
-}
-/*-----------------------------------------------------------*/
+	TickType_t xTaskGetBudgetRemaining( const TaskHandle_t xTask )
+	{
+	TCB_t const *pxTCB;
+	TickType_t xRemaining;
 
-char *pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-{
-TCB_t *pxTCB;
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
 
-	/* If null is passed in here then the name of the calling task is being
-	queried. */
-	pxTCB = prvGetTCBFromHandle( xTaskToQuery );
-	configASSERT( pxTCB );
-	return &( pxTCB->pcTaskName[ 0 ] );
-}
-/*-----------------------------------------------------------*/
+			if( pxTCB->xBudget != ( TickType_t ) 0 )
+			{
+				xRemaining = pxTCB->xBudgetRemaining;
+			}
+			else
+			{
+				xRemaining = portMAX_DELAY;
+			}
+		}
+		taskEXIT_CRITICAL();
 
-#if ( INCLUDE_xTaskGetHandle == 1 )
+		return xRemaining;
+	}
+	/*-----------------------------------------------------------*/
 
-	static TCB_t *prvSearchForNameWithinSingleList( List_t *pxList, const char pcNameToQuery[] )
+	uint32_t ulTaskGetBudgetExhaustions( const TaskHandle_t xTask )
 	{
-	TCB_t *pxNextTCB, *pxFirstTCB, *pxReturn = NULL;
-	UBaseType_t x;
-	char cNextChar;
-	BaseType_t xBreakLoop;
-
-		/* This function is called with the scheduler suspended. */
+	TCB_t const *pxTCB;
+	uint32_t ulExhaustions;
 
-		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+		taskENTER_CRITICAL();
 		{
-			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );  /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			pxTCB = prvGetTCBFromHandle( xTask );
+			ulExhaustions = pxTCB->ulBudgetExhaustions;
+		}
+		taskEXIT_CRITICAL();
 
-			do
+		return ulExhaustions;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvChargeBudget( TCB_t * const pxTCB, const TickType_t xConstTickCount )
+	{
+	BaseType_t xThrottled = pdFALSE;
+
+		if( pxTCB->xBudget != ( TickType_t ) 0 )
+		{
+			if( pxTCB->xBudgetRemaining == pxTCB->xBudget )
 			{
-				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				/* This is the first tick charged since the budget was last
+				replenished, so starts a new period.  The task has been running
+				since at least the previous tick. */
+				pxTCB->xBudgetPeriodStart = xConstTickCount - ( TickType_t ) 1;
+			}
+			else if( ( TickType_t ) ( xConstTickCount - pxTCB->xBudgetPeriodStart ) >= pxTCB->xBudgetPeriod )
+			{
+				/* The period ended while the task was not running. */
+				pxTCB->xBudgetRemaining = pxTCB->xBudget;
+				pxTCB->xBudgetPeriodStart = xConstTickCount - ( TickType_t ) 1;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-				/* Check each character in the name looking for a match or
-				mismatch. */
-				xBreakLoop = pdFALSE;
-				for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
-				{
-					cNextChar = pxNextTCB->pcTaskName[ x ];
+			/* The budget can already be used up if it ran out while the task
+			was not in the ready list - see below - in which case the task is
+			throttled now, without charging it again. */
+			if( pxTCB->xBudgetRemaining != ( TickType_t ) 0 )
+			{
+				pxTCB->xBudgetRemaining--;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-					if( cNextChar != pcNameToQuery[ x ] )
-					{
-						/* Characters didn't match. */
-						xBreakLoop = pdTRUE;
-					}
-					else if( cNextChar == ( char ) 0x00 )
-					{
-						/* Both strings terminated, a match must have been
-						found. */
-						pxReturn = pxNextTCB;
-						xBreakLoop = pdTRUE;
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+			/* The task is only throttled if it is still in the ready list - it
+			could be running but already on its way into the Blocked state.
+			If so it is throttled by the first tick it is charged for once it
+			is ready again within the same period. */
+			if( ( pxTCB->xBudgetRemaining == ( TickType_t ) 0 ) &&
+				( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+			{
+				traceTASK_BUDGET_EXHAUSTED( pxTCB );
+				pxTCB->ulBudgetExhaustions++;
 
-					if( xBreakLoop != pdFALSE )
-					{
-						break;
-					}
+				if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+				{
+					taskRESET_READY_PRIORITY( pxTCB->uxPriority );
 				}
-
-				if( pxReturn != NULL )
+				else
 				{
-					/* The handle has been found. */
-					break;
+					mtCOVERAGE_TEST_MARKER();
 				}
 
-			} while( pxNextTCB != pxFirstTCB );
+				prvAddTaskToThrottledList( pxTCB, xConstTickCount );
+				xThrottled = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		return xThrottled;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvAddTaskToThrottledList( TCB_t * const pxTCB, const TickType_t xConstTickCount )
+	{
+	TickType_t xTicksToReplenish;
+
+		xTicksToReplenish = prvTicksToReplenish( pxTCB, xConstTickCount );
+
+		if( ( listLIST_IS_EMPTY( &xThrottledTaskList ) != pdFALSE ) ||
+			( xTicksToReplenish < ( TickType_t ) ( xNextBudgetReplenishTime - xConstTickCount ) ) )
+		{
+			xNextBudgetReplenishTime = xConstTickCount + xTicksToReplenish;
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
 
-		return pxReturn;
+		vListInsertEnd( &xThrottledTaskList, &( pxTCB->xStateListItem ) );
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* INCLUDE_xTaskGetHandle */
-/*-----------------------------------------------------------*/
-
-#if ( INCLUDE_xTaskGetHandle == 1 )
-
-	TaskHandle_t xTaskGetHandle( const char *pcNameToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	static BaseType_t prvResumeThrottled( TCB_t * const pxTCB )
 	{
-	UBaseType_t uxQueue = configMAX_PRIORITIES;
-	TCB_t* pxTCB;
-
-		/* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
-		configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
+	BaseType_t xThrottled = pdFALSE;
+	const TickType_t xConstTickCount = xTickCount;
 
-		vTaskSuspendAll();
+		/* Called from a critical section. */
+		if( ( pxTCB->xBudget != ( TickType_t ) 0 ) && ( pxTCB->xBudgetRemaining == ( TickType_t ) 0 ) )
 		{
-			/* Search the ready lists. */
-			do
+			if( prvTicksToReplenish( pxTCB, xConstTickCount ) != ( TickType_t ) 0 )
 			{
-				uxQueue--;
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxReadyTasksLists[ uxQueue ] ), pcNameToQuery );
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+				prvAddTaskToThrottledList( pxTCB, xConstTickCount );
+				xThrottled = pdTRUE;
+			}
+			else
+			{
+				/* The period ended while the task was suspended.  The next
+				period starts when the task next runs. */
+				traceTASK_BUDGET_REPLENISHED( pxTCB );
+				pxTCB->xBudgetRemaining = pxTCB->xBudget;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-				if( pxTCB != NULL )
-				{
-					/* Found the handle. */
-					break;
-				}
+		return xThrottled;
+	}
+	/*-----------------------------------------------------------*/
 
-			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+	static BaseType_t prvReplenishBudgets( const TickType_t xConstTickCount )
+	{
+	BaseType_t xSwitchRequired = pdFALSE;
+	ListItem_t const *pxEndMarker;
+	ListItem_t *pxIterator, *pxNext;
+	TCB_t *pxTCB;
+	TickType_t xTicksToReplenish, xTicksToNext;
 
-			/* Search the delayed lists. */
-			if( pxTCB == NULL )
-			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
-			}
+		/* Few tasks are expected to be throttled at once, so the list is not
+		kept in order and is only walked when the earliest replenish time has
+		been reached, or stepped over while the tick was suppressed. */
+		if( ( listLIST_IS_EMPTY( &xThrottledTaskList ) == pdFALSE ) &&
+			( ( TickType_t ) ( xConstTickCount - xNextBudgetReplenishTime ) <= ( portMAX_DELAY >> 1 ) ) )
+		{
+			pxEndMarker = listGET_END_MARKER( &xThrottledTaskList );
+			xTicksToNext = portMAX_DELAY;
 
-			if( pxTCB == NULL )
+			for( pxIterator = listGET_HEAD_ENTRY( &xThrottledTaskList ); pxIterator != pxEndMarker; pxIterator = pxNext )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
-			}
+				pxNext = listGET_NEXT( pxIterator );
+				pxTCB = ( TCB_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+				xTicksToReplenish = prvTicksToReplenish( pxTCB, xConstTickCount );
 
-			#if ( INCLUDE_vTaskSuspend == 1 )
-			{
-				if( pxTCB == NULL )
+				if( xTicksToReplenish == ( TickType_t ) 0 )
 				{
-					/* Search the suspended list. */
-					pxTCB = prvSearchForNameWithinSingleList( &xSuspendedTaskList, pcNameToQuery );
-				}
-			}
-			#endif
+					traceTASK_BUDGET_REPLENISHED( pxTCB );
 
-			#if( INCLUDE_vTaskDelete == 1 )
-			{
-				if( pxTCB == NULL )
+					/* The next period starts when the task next runs. */
+					pxTCB->xBudgetRemaining = pxTCB->xBudget;
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					prvAddTaskToReadyList( pxTCB );
+
+					#if( configUSE_PREEMPTION == 1 )
+					{
+						if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
+						{
+							xSwitchRequired = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					#endif /* configUSE_PREEMPTION */
+				}
+				else if( xTicksToReplenish < xTicksToNext )
 				{
-					/* Search the deleted list. */
-					pxTCB = prvSearchForNameWithinSingleList( &xTasksWaitingTermination, pcNameToQuery );
+					xTicksToNext = xTicksToReplenish;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
 				}
 			}
-			#endif
+
+			xNextBudgetReplenishTime = xConstTickCount + xTicksToNext;
 		}
-		( void ) xTaskResumeAll();
 
-		return pxTCB;
+		return xSwitchRequired;
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* INCLUDE_xTaskGetHandle */
-/*-----------------------------------------------------------*/
-
-#if ( configUSE_TRACE_FACILITY == 1 )
-
-	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
+	static TickType_t prvTicksToReplenish( const TCB_t * const pxTCB, const TickType_t xConstTickCount )
 	{
-	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+	TickType_t xElapsed, xReturn;
 
-		vTaskSuspendAll();
+		xElapsed = xConstTickCount - pxTCB->xBudgetPeriodStart;
+
+		if( xElapsed >= pxTCB->xBudgetPeriod )
 		{
-			/* Is there a space in the array for each task in the system? */
-			if( uxArraySize >= uxCurrentNumberOfTasks )
-			{
-				/* Fill in an TaskStatus_t structure with information on each
-				task in the Ready state. */
-				do
-				{
-					uxQueue--;
-					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), eReady );
+			xReturn = ( TickType_t ) 0;
+		}
+		else
+		{
+			xReturn = pxTCB->xBudgetPeriod - xElapsed;
+		}
 
-				} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		return xReturn;
+	}
 
-				/* Fill in an TaskStatus_t structure with information on each
-				task in the Blocked state. */
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
 
-				#if( INCLUDE_vTaskDelete == 1 )
-				{
-					/* Fill in an TaskStatus_t structure with information on
-					each task that has been deleted but not yet cleaned up. */
-					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xTasksWaitingTermination, eDeleted );
-				}
-				#endif
+#if ( INCLUDE_vTaskSuspend == 1 )
 
-				#if ( INCLUDE_vTaskSuspend == 1 )
+	void vTaskSuspend( TaskHandle_t xTaskToSuspend )
+	{
+	TCB_t *pxTCB;
+
+		taskENTER_CRITICAL();
+		{
+			/* If null is passed in here then it is the running task that is
+			being suspended. */
+			pxTCB = prvGetTCBFromHandle( xTaskToSuspend );
+
+			traceTASK_SUSPEND( pxTCB );
+
+			/* Remove task from the ready/delayed list and place in the
+			suspended list. */
+			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+			{
+				taskRESET_READY_PRIORITY( pxTCB->uxPriority );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Is the task waiting on an event also? */
+			if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+			{
+				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
+
+			#if( configUSE_TASK_NOTIFICATIONS == 1 )
+			{
+				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
 				{
-					/* Fill in an TaskStatus_t structure with information on
-					each task in the Suspended state. */
-					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xSuspendedTaskList, eSuspended );
+					/* The task was blocked to wait for a notification, but is
+					now suspended, so no notification was received. */
+					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
 				}
-				#endif
+			}
+			#endif
 
-				#if ( configGENERATE_RUN_TIME_STATS == 1)
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				/* A task running on another core stops when that core next
+				selects a task. */
+				if( taskIS_RUNNING_ON_ANOTHER_CORE( pxTCB ) != pdFALSE )
 				{
-					if( pulTotalRunTime != NULL )
-					{
-						#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-							portALT_GET_RUN_TIME_COUNTER_VALUE( ( *pulTotalRunTime ) );
-						#else
-							*pulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
-						#endif
-					}
+					prvYieldCore( pxTCB->xTaskRunState );
 				}
-				#else
+				else
 				{
-					if( pulTotalRunTime != NULL )
-					{
-						*pulTotalRunTime = 0;
-					}
+					mtCOVERAGE_TEST_MARKER();
 				}
-				#endif
 			}
-			else
+			#endif
+		}
+		taskEXIT_CRITICAL();
+
+		if( xSchedulerRunning != pdFALSE )
+		{
+			/* Reset the next expected unblock time in case it referred to the
+			task that is now in the Suspended state. */
+			taskENTER_CRITICAL();
 			{
-				mtCOVERAGE_TEST_MARKER();
+				prvResetNextTaskUnblockTime();
 			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
 		}
-		( void ) xTaskResumeAll();
 
-		return uxTask;
+		if( pxTCB == pxCurrentTCB )
+		{
+			if( xSchedulerRunning != pdFALSE )
+			{
+				/* The current task has just been suspended. */
+				configASSERT( prvSchedulerSuspendedOnThisCore() == pdFALSE );
+				portYIELD_WITHIN_API();
+			}
+			#if( configNUMBER_OF_CORES == 1 )
+			else
+			{
+				/* The scheduler is not running, but the task that was pointed
+				to by pxCurrentTCB has just been suspended and pxCurrentTCB
+				must be adjusted to point to a different task. */
+				if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
+				{
+					/* No other tasks are ready, so set pxCurrentTCB back to
+					NULL so when the next task is created pxCurrentTCB will
+					be set to point to it no matter what its relative priority
+					is. */
+					pxCurrentTCB = NULL;
+				}
+				else
+				{
+					vTaskSwitchContext();
+				}
+			}
+			#endif /* configNUMBER_OF_CORES */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 	}
 
-#endif /* configUSE_TRACE_FACILITY */
-/*----------------------------------------------------------*/
+#endif /* INCLUDE_vTaskSuspend */
+/*-----------------------------------------------------------*/
 
-#if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+#if ( INCLUDE_vTaskSuspend == 1 )
 
-	TaskHandle_t xTaskGetIdleTaskHandle( void )
+	static BaseType_t prvTaskIsTaskSuspended( const TaskHandle_t xTask )
 	{
-		/* If xTaskGetIdleTaskHandle() is called before the scheduler has been
-		started, then xIdleTaskHandle will be NULL. */
-		configASSERT( ( xIdleTaskHandle != NULL ) );
-		return xIdleTaskHandle;
-	}
+	BaseType_t xReturn = pdFALSE;
+	const TCB_t * const pxTCB = xTask;
 
-#endif /* INCLUDE_xTaskGetIdleTaskHandle */
-/*----------------------------------------------------------*/
+		/* Accesses xPendingReadyList so must be called from a critical
+		section. */
 
-/* This conditional compilation should use inequality to 0, not equality to 1.
-This is to ensure vTaskStepTick() is available when user defined low power mode
-implementations require configUSE_TICKLESS_IDLE to be set to a value other than
-1. */
-#if ( configUSE_TICKLESS_IDLE != 0 )
+		/* It does not make sense to check if the calling task is suspended. */
+		configASSERT( xTask );
 
-	void vTaskStepTick( const TickType_t xTicksToJump )
-	{
-		/* Correct the tick count value after a period during which the tick
-		was suppressed.  Note this does *not* call the tick hook function for
-		each stepped tick. */
-		configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
-		xTickCount += xTicksToJump;
-		traceINCREASE_TICK_COUNT( xTicksToJump );
-	}
+		/* Is the task being resumed actually in the suspended list? */
+		if( listIS_CONTAINED_WITHIN( &xSuspendedTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE )
+		{
+			/* Has the task already been resumed from within an ISR? */
+			if( listIS_CONTAINED_WITHIN( &xPendingReadyList, &( pxTCB->xEventListItem ) ) == pdFALSE )
+			{
+				/* Is it in the suspended list because it is in the	Suspended
+				state, or because is is blocked with no timeout? */
+				if( listIS_CONTAINED_WITHIN( NULL, &( pxTCB->xEventListItem ) ) != pdFALSE ) /*lint !e961.  The cast is only redundant when NULL is used. */
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 
-#endif /* configUSE_TICKLESS_IDLE */
-/*----------------------------------------------------------*/
+		return xReturn;
+	} /*lint !e818 xTask cannot be a pointer to const because it is a typedef. */
 
-#if ( INCLUDE_xTaskAbortDelay == 1 )
+#endif /* INCLUDE_vTaskSuspend */
+/*-----------------------------------------------------------*/
 
-	BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+#if ( INCLUDE_vTaskSuspend == 1 )
+
+	void vTaskResume( TaskHandle_t xTaskToResume )
 	{
-	TCB_t *pxTCB = xTask;
-	BaseType_t xReturn;
+	TCB_t * const pxTCB = xTaskToResume;
 
-		configASSERT( pxTCB );
+		/* It does not make sense to resume the calling task. */
+		configASSERT( xTaskToResume );
 
-		vTaskSuspendAll();
+		/* The parameter cannot be NULL as it is impossible to resume the
+		currently executing task. */
+		if( ( pxTCB != pxCurrentTCB ) && ( pxTCB != NULL ) )
 		{
-			/* A task can only be prematurely removed from the Blocked state if
-			it is actually in the Blocked state. */
-			if( eTaskGetState( xTask ) == eBlocked )
+			taskENTER_CRITICAL();
 			{
-				xReturn = pdPASS;
-
-				/* Remove the reference to the task from the blocked list.  An
-				interrupt won't touch the xStateListItem because the
-				scheduler is suspended. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-
-				/* Is the task waiting on an event also?  If so remove it from
-				the event list too.  Interrupts can touch the event list item,
-				even though the scheduler is suspended, so a critical section
-				is used. */
-				taskENTER_CRITICAL();
+				if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
 				{
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					traceTASK_RESUME( pxTCB );
+
+					#if( configUSE_TASK_BUDGETS == 1 )
+					if( prvResumeThrottled( pxTCB ) != pdFALSE )
 					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
-						pxTCB->ucDelayAborted = pdTRUE;
+						/* A task that was throttled when it was suspended
+						stays throttled until its budget is replenished. */
+						mtCOVERAGE_TEST_MARKER();
 					}
 					else
+					#endif /* configUSE_TASK_BUDGETS */
 					{
-						mtCOVERAGE_TEST_MARKER();
+						/* The ready list can be accessed even if the scheduler
+						is suspended because this is inside a critical
+						section. */
+						( void ) uxListRemove(  &( pxTCB->xStateListItem ) );
+						prvAddTaskToReadyList( pxTCB );
+
+						/* A higher priority task may have just been resumed. */
+						if( taskSHOULD_PREEMPT( pxTCB->uxPriority >= pxCurrentTCB->uxPriority ) )
+						{
+							/* This yield may not cause the task just resumed
+							to run, but will leave the lists in the correct
+							state for the next yield. */
+							taskYIELD_IF_USING_PREEMPTION();
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 					}
 				}
-				taskEXIT_CRITICAL();
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
 
-				/* Place the unblocked task into the appropriate ready list. */
-				prvAddTaskToReadyList( pxTCB );
+#endif /* INCLUDE_vTaskSuspend */
 
-				/* A task being unblocked cannot cause an immediate context
-				switch if preemption is turned off. */
-				#if (  configUSE_PREEMPTION == 1 )
+/*-----------------------------------------------------------*/
+
+#if ( ( INCLUDE_xTaskResumeFromISR == 1 ) && ( INCLUDE_vTaskSuspend == 1 ) )
+
+	BaseType_t xTaskResumeFromISR( TaskHandle_t xTaskToResume )
+	{
+	BaseType_t xYieldRequired = pdFALSE;
+	TCB_t * const pxTCB = xTaskToResume;
+	UBaseType_t uxSavedInterruptStatus;
+
+		configASSERT( xTaskToResume );
+
+		/* RTOS ports that support interrupt nesting have the concept of a
+		maximum	system call (or maximum API call) interrupt priority.
+		Interrupts that are	above the maximum system call priority are keep
+		permanently enabled, even when the RTOS kernel is in a critical section,
+		but cannot make any calls to FreeRTOS API functions.  If configASSERT()
+		is defined in FreeRTOSConfig.h then
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
+		failure if a FreeRTOS API function is called from an interrupt that has
+		been assigned a priority above the configured maximum system call
+		priority.  Only FreeRTOS functions that end in FromISR can be called
+		from interrupts	that have been assigned a priority at or (logically)
+		below the maximum system call interrupt priority.  FreeRTOS maintains a
+		separate interrupt safe API to ensure interrupt entry is as fast and as
+		simple as possible.  More information (albeit Cortex-M specific) is
+		provided on the following link:
+		https://www.freertos.org/RTOS-Cortex-M3-M4.html */
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
+			{
+				traceTASK_RESUME_FROM_ISR( pxTCB );
+
+				/* Check the ready lists can be accessed. */
+				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 				{
-					/* Preemption is on, but a context switch should only be
-					performed if the unblocked task has a priority that is
-					equal to or higher than the currently executing task. */
-					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					#if( configUSE_TASK_BUDGETS == 1 )
+					if( prvResumeThrottled( pxTCB ) != pdFALSE )
 					{
-						/* Pend the yield to be performed when the scheduler
-						is unsuspended. */
-						xYieldPending = pdTRUE;
+						/* The task stays throttled until its budget is
+						replenished. */
+						mtCOVERAGE_TEST_MARKER();
 					}
 					else
+					#endif /* configUSE_TASK_BUDGETS */
 					{
-						mtCOVERAGE_TEST_MARKER();
+						/* Ready lists can be accessed so move the task from
+						the suspended list to the ready list directly. */
+						if( taskSHOULD_PREEMPT( pxTCB->uxPriority >= pxCurrentTCB->uxPriority ) )
+						{
+							xYieldRequired = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+						prvAddTaskToReadyList( pxTCB );
 					}
 				}
-				#endif /* configUSE_PREEMPTION */
+				else
+				{
+					/* The delayed or ready lists cannot be accessed so the task
+					is held in the pending ready list until the scheduler is
+					unsuspended. */
+					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+				}
 			}
 			else
 			{
-				xReturn = pdFAIL;
+				mtCOVERAGE_TEST_MARKER();
 			}
 		}
-		( void ) xTaskResumeAll();
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-		return xReturn;
+		return xYieldRequired;
 	}
 
-#endif /* INCLUDE_xTaskAbortDelay */
-/*----------------------------------------------------------*/
+#endif /* ( ( INCLUDE_xTaskResumeFromISR == 1 ) && ( INCLUDE_vTaskSuspend == 1 ) ) */
+/*-----------------------------------------------------------*/
 
-BaseType_t xTaskIncrementTick( void )
+void vTaskStartScheduler( void )
 {
-TCB_t * pxTCB;
-TickType_t xItemValue;
-BaseType_t xSwitchRequired = pdFALSE;
+BaseType_t xReturn;
 
-	/* Called by the portable layer each time a tick interrupt occurs.
-	Increments the tick then checks to see if the new tick value will cause any
-	tasks to be unblocked. */
-	traceTASK_INCREMENT_TICK( xTickCount );
-	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+	/* Add the idle task at the lowest priority. */
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 	{
-		/* Minor optimisation.  The tick count cannot change in this
-		block. */
-		const TickType_t xConstTickCount = xTickCount + ( TickType_t ) 1;
+		StaticTask_t *pxIdleTaskTCBBuffer = NULL;
+		StackType_t *pxIdleTaskStackBuffer = NULL;
+		uint32_t ulIdleTaskStackSize;
 
-		/* Increment the RTOS tick, switching the delayed and overflowed
-		delayed lists if it wraps to 0. */
-		xTickCount = xConstTickCount;
+		/* The Idle task is created using user provided RAM - obtain the
+		address of the RAM then create the idle task. */
+		vApplicationGetIdleTaskMemory( &pxIdleTaskTCBBuffer, &pxIdleTaskStackBuffer, &ulIdleTaskStackSize );
+		xIdleTaskHandle = xTaskCreateStatic(	prvIdleTask,
+												configIDLE_TASK_NAME,
+												ulIdleTaskStackSize,
+												( void * ) NULL, /*lint !e961.  The cast is not redundant for all compilers. */
+												portPRIVILEGE_BIT, /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
+												pxIdleTaskStackBuffer,
+												pxIdleTaskTCBBuffer ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
 
-		if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
+		if( xIdleTaskHandle != NULL )
 		{
-			taskSWITCH_DELAYED_LISTS();
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+	#else
+	{
+		/* The Idle task is being created using dynamically allocated RAM. */
+		xReturn = xTaskCreate(	prvIdleTask,
+								configIDLE_TASK_NAME,
+								configMINIMAL_STACK_SIZE,
+								( void * ) NULL,
+								portPRIVILEGE_BIT, /* In effect ( tskIDLE_PRIORITY | portPRIVILEGE_BIT ), but tskIDLE_PRIORITY is zero. */
+								&xIdleTaskHandle ); /*lint !e961 MISRA exception, justified as it is not a redundant explicit cast to all supported compilers. */
+	}
+	#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+	#if ( configUSE_TIMERS == 1 )
+	{
+		if( xReturn == pdPASS )
+		{
+			xReturn = xTimerCreateTimerTask();
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
+	}
+	#endif /* configUSE_TIMERS */
 
-		/* See if this tick has made a timeout expire.  Tasks are stored in
-		the	queue in the order of their wake time - meaning once one task
-		has been found whose block time has not expired there is no need to
-		look any further down the list. */
-		if( xConstTickCount >= xNextTaskUnblockTime )
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+	BaseType_t xCoreID;
+	TaskHandle_t xCoreIdleTaskHandle;
+	char cIdleName[ configMAX_TASK_NAME_LEN ];
+	UBaseType_t x;
+
+		/* Each core has its own idle task, which can only run on that core so
+		every core always has a task to run.  The idle tasks for the cores other
+		than core 0 are named after the idle task with the core number
+		appended. */
+		if( xReturn == pdPASS )
 		{
-			for( ;; )
+			xIdleTaskHandle->uxCoreAffinityMask = ( UBaseType_t ) 1;
+		}
+
+		for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
+		{
+			cIdleName[ x ] = configIDLE_TASK_NAME[ x ];
+
+			if( cIdleName[ x ] == ( char ) 0x00 )
 			{
-				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+				break;
+			}
+		}
+
+		if( x > ( UBaseType_t ) ( configMAX_TASK_NAME_LEN - 2 ) )
+		{
+			x = ( UBaseType_t ) ( configMAX_TASK_NAME_LEN - 2 );
+		}
+
+		cIdleName[ x + 1 ] = ( char ) 0x00;
+
+		for( xCoreID = 1; ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( xReturn == pdPASS ); xCoreID++ )
+		{
+			cIdleName[ x ] = ( char ) ( '0' + xCoreID );
+			xReturn = xTaskCreate( prvIdleTask, cIdleName, configMINIMAL_STACK_SIZE, ( void * ) NULL, portPRIVILEGE_BIT, &xCoreIdleTaskHandle );
+
+			if( xReturn == pdPASS )
+			{
+				xCoreIdleTaskHandle->uxCoreAffinityMask = ( ( UBaseType_t ) 1 ) << xCoreID;
+			}
+		}
+	}
+	#endif /* configNUMBER_OF_CORES */
+
+	if( xReturn == pdPASS )
+	{
+		/* freertos_tasks_c_additions_init() should only be called if the user
+		definable macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is
+		the only macro called by the function. */
+		#ifdef FREERTOS_TASKS_C_ADDITIONS_INIT
+		{
+			freertos_tasks_c_additions_init();
+		}
+		#endif
+
+		/* Interrupts are turned off here, to ensure a tick does not occur
+		before or during the call to xPortStartScheduler().  The stacks of
+		the created tasks contain a status word with interrupts switched on
+		so interrupts will automatically get re-enabled when the first task
+		starts to run. */
+		portDISABLE_INTERRUPTS();
+
+		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		{
+			/* Switch Newlib's _impure_ptr variable to point to the _reent
+			structure specific to the task that will run first. */
+			_impure_ptr = &( pxCurrentTCB->xNewLib_reent );
+		}
+		#endif /* configUSE_NEWLIB_REENTRANT */
+
+		xNextTaskUnblockTime = portMAX_DELAY;
+		xSchedulerRunning = pdTRUE;
+		xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
+
+		/* If configGENERATE_RUN_TIME_STATS is defined then the following
+		macro must be defined to configure the timer/counter used to generate
+		the run time counter time base.   NOTE:  If configGENERATE_RUN_TIME_STATS
+		is set to 0 and the following line fails to build then ensure you do not
+		have portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() defined in your
+		FreeRTOSConfig.h file. */
+		portCONFIGURE_TIMER_FOR_RUN_TIME_STATS();
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+		BaseType_t xCoreID;
+
+			/* Choose the task each core runs first. */
+			for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+			{
+				prvSelectHighestPriorityTask( xCoreID );
+			}
+		}
+		#endif /* configNUMBER_OF_CORES */
+
+		#if( configGENERATE_EXECUTION_STATS == 1 )
+		{
+		const uint64_t ullNowNs = portGET_RUN_TIME_NS();
+
+			/* The tasks that run first are not switched in by
+			vTaskSwitchContext(). */
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+			BaseType_t xCoreID;
+
+				for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
 				{
-					/* The delayed list is empty.  Set xNextTaskUnblockTime
-					to the maximum possible value so it is extremely
-					unlikely that the
-					if( xTickCount >= xNextTaskUnblockTime ) test will pass
-					next time through. */
-					xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-					break;
+					prvExecutionStatsSwitchIn( pxCurrentTCBs[ xCoreID ], ullNowNs );
 				}
-				else
-				{
-					/* The delayed list is not empty, get the value of the
-					item at the head of the delayed list.  This is the time
-					at which the task at the head of the delayed list must
-					be removed from the Blocked state. */
-					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+			}
+			#else
+			{
+				prvExecutionStatsSwitchIn( pxCurrentTCB, ullNowNs );
+			}
+			#endif /* configNUMBER_OF_CORES */
+		}
+		#endif /* configGENERATE_EXECUTION_STATS */
+
+		traceTASK_SWITCHED_IN();
+
+		/* Setting up the timer tick is hardware specific and thus in the
+		portable interface. */
+		if( xPortStartScheduler() != pdFALSE )
+		{
+			/* Should not reach here as if the scheduler is running the
+			function will not return. */
+		}
+		else
+		{
+			/* Should only reach here if a task calls xTaskEndScheduler(). */
+		}
+	}
+	else
+	{
+		/* This line will only be reached if the kernel could not be started,
+		because there was not enough FreeRTOS heap to create the idle task
+		or the timer task. */
+		configASSERT( xReturn != errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY );
+	}
+
+	/* Prevent compiler warnings if INCLUDE_xTaskGetIdleTaskHandle is set to 0,
+	meaning xIdleTaskHandle is not used anywhere else. */
+	( void ) xIdleTaskHandle;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskEndScheduler( void )
+{
+	/* Stop the scheduler interrupts and call the portable scheduler end
+	routine so the original ISRs can be restored if necessary.  The port
+	layer must ensure interrupts enable	bit is left in the correct state. */
+	portDISABLE_INTERRUPTS();
+	xSchedulerRunning = pdFALSE;
+	vPortEndScheduler();
+}
+/*----------------------------------------------------------*/
+
+void vTaskSuspendAll( void )
+{
+	/* A critical section is not required as the variable is of type
+	BaseType_t.  Please read Richard Barry's reply in the following link to a
+	post in the FreeRTOS support forum before reporting this as a bug! -
+	http://goo.gl/wu4acr */
+	portTASK_SUSPEND_ALL_HOOK();
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* The task lock stops the other cores entering a region in which the
+		scheduler is suspended, and is held until xTaskResumeAll() is called.
+		The critical section stops this core switching task while the lock is
+		being taken. */
+		taskENTER_CRITICAL();
+		portGET_TASK_LOCK();
+		xSchedulerSuspendedCore = portGET_CORE_ID();
+		portMEMORY_BARRIER();
+		++uxSchedulerSuspended;
+		taskEXIT_CRITICAL();
+	}
+	#else
+	{
+		++uxSchedulerSuspended;
+	}
+	#endif /* configNUMBER_OF_CORES */
+}
+/*----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	static TickType_t prvGetExpectedIdleTime( void )
+	{
+	TickType_t xReturn;
+	UBaseType_t uxHigherPriorityReadyTasks = pdFALSE;
+
+		/* uxHigherPriorityReadyTasks takes care of the case where
+		configUSE_PREEMPTION is 0, so there may be tasks above the idle priority
+		task that are in the Ready state, even though the idle task is
+		running. */
+		#if( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+		{
+			if( uxTopReadyPriority > tskIDLE_PRIORITY )
+			{
+				uxHigherPriorityReadyTasks = pdTRUE;
+			}
+		}
+		#else
+		{
+			const UBaseType_t uxLeastSignificantBit = ( UBaseType_t ) 0x01;
+
+			/* When port optimised task selection is used the uxTopReadyPriority
+			variable is used as a bit map.  If bits other than the least
+			significant bit are set then there are tasks that have a priority
+			above the idle priority that are in the Ready state.  This takes
+			care of the case where the co-operative scheduler is in use. */
+			#if( configMAX_PRIORITIES > 32 )
+			{
+				/* The least significant bit of uxTopReadyPriority covers the
+				lowest 32 priorities, so their own map is checked too. */
+				if( ( uxTopReadyPriority > uxLeastSignificantBit ) || ( uxReadyPriorityBits[ 0 ] > uxLeastSignificantBit ) )
+				{
+					uxHigherPriorityReadyTasks = pdTRUE;
+				}
+			}
+			#else
+			{
+				if( uxTopReadyPriority > uxLeastSignificantBit )
+				{
+					uxHigherPriorityReadyTasks = pdTRUE;
+				}
+			}
+			#endif
+		}
+		#endif
+
+		if( pxCurrentTCB->uxPriority > tskIDLE_PRIORITY )
+		{
+			xReturn = 0;
+		}
+		else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1 )
+		{
+			/* There are other idle priority tasks in the ready state.  If
+			time slicing is used then the very next tick interrupt must be
+			processed. */
+			xReturn = 0;
+		}
+		else if( uxHigherPriorityReadyTasks != pdFALSE )
+		{
+			/* There are tasks in the Ready state that have a priority above the
+			idle priority.  This path can only be reached if
+			configUSE_PREEMPTION is 0. */
+			xReturn = 0;
+		}
+		else
+		{
+			xReturn = xNextTaskUnblockTime - xTickCount;
+
+			#if( configUSE_FRAME_SCHEDULER == 1 )
+			{
+				/* Wake in time to release the tasks of the next frame. */
+				TickType_t xTicksToNextFrame = xFrameSchedulerGetTicksToNextFrame( xTickCount );
+
+				if( xTicksToNextFrame < xReturn )
+				{
+					xReturn = xTicksToNextFrame;
+				}
+			}
+			#endif /* configUSE_FRAME_SCHEDULER */
+
+			#if( configUSE_TASK_BUDGETS == 1 )
+			{
+				/* Wake in time to ready the throttled tasks. */
+				if( ( listLIST_IS_EMPTY( &xThrottledTaskList ) == pdFALSE ) &&
+					( ( TickType_t ) ( xNextBudgetReplenishTime - xTickCount ) < xReturn ) )
+				{
+					xReturn = xNextBudgetReplenishTime - xTickCount;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_TASK_BUDGETS */
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*----------------------------------------------------------*/
+
+BaseType_t xTaskResumeAll( void )
+{
+TCB_t *pxTCB = NULL;
+BaseType_t xAlreadyYielded = pdFALSE;
+
+	/* If uxSchedulerSuspended is zero then this function does not match a
+	previous call to vTaskSuspendAll(). */
+	configASSERT( uxSchedulerSuspended );
+
+	/* It is possible that an ISR caused a task to be removed from an event
+	list while the scheduler was suspended.  If this was the case then the
+	removed task will have been added to the xPendingReadyList.  Once the
+	scheduler has been resumed it is safe to move all the pending ready
+	tasks from this list into their appropriate ready list. */
+	taskENTER_CRITICAL();
+	{
+		--uxSchedulerSuspended;
+
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
+			{
+				/* Move any readied tasks from the pending list into the
+				appropriate ready list. */
+				while( listLIST_IS_EMPTY( &xPendingReadyList ) == pdFALSE )
+				{
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xPendingReadyList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					prvAddTaskToReadyList( pxTCB );
+
+					/* If the moved task has a priority higher than the current
+					task then a yield must be performed. */
+					if( taskSHOULD_PREEMPT( pxTCB->uxPriority >= pxCurrentTCB->uxPriority ) )
+					{
+						xYieldPending = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				if( pxTCB != NULL )
+				{
+					/* A task was unblocked while the scheduler was suspended,
+					which may have prevented the next unblock time from being
+					re-calculated, in which case re-calculate it now.  Mainly
+					important for low power tickless implementations, where
+					this can prevent an unnecessary exit from low power
+					state. */
+					prvResetNextTaskUnblockTime();
+				}
+
+				/* If any ticks occurred while the scheduler was suspended then
+				they should be processed now.  This ensures the tick count does
+				not	slip, and that any delayed tasks are resumed at the correct
+				time. */
+				{
+					UBaseType_t uxPendedCounts = uxPendedTicks; /* Non-volatile copy. */
+
+					if( uxPendedCounts > ( UBaseType_t ) 0U )
+					{
+						if( prvCatchUpTicks( uxPendedCounts ) != pdFALSE )
+						{
+							xYieldPending = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						uxPendedTicks = 0;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				#if( configNUMBER_OF_CORES > 1 )
+				{
+				BaseType_t xCoreID;
+
+					/* Other cores may have tried to switch task while the
+					scheduler was suspended, or been asked to switch by the
+					tasks readied above - let them switch now. */
+					for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+					{
+						if( ( xCoreID != ( BaseType_t ) portGET_CORE_ID() ) && ( xYieldPendings[ xCoreID ] != pdFALSE ) )
+						{
+							portYIELD_CORE( xCoreID );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+				}
+				#endif /* configNUMBER_OF_CORES */
+
+				if( xYieldPending != pdFALSE )
+				{
+					#if( configUSE_PREEMPTION != 0 )
+					{
+						xAlreadyYielded = pdTRUE;
+					}
+					#endif
+					taskYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* Release the task lock taken by vTaskSuspendAll(). */
+			portRELEASE_TASK_LOCK();
+		}
+		#endif
+	}
+	taskEXIT_CRITICAL();
+
+	return xAlreadyYielded;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCount( void )
+{
+TickType_t xTicks;
+
+	/* Critical section required if running on a 16 bit processor. */
+	portTICK_TYPE_ENTER_CRITICAL();
+	{
+		xTicks = xTickCount;
+	}
+	portTICK_TYPE_EXIT_CRITICAL();
+
+	return xTicks;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+TickType_t xReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	/* RTOS ports that support interrupt nesting have the concept of a maximum
+	system call (or maximum API call) interrupt priority.  Interrupts that are
+	above the maximum system call priority are kept permanently enabled, even
+	when the RTOS kernel is in a critical section, but cannot make any calls to
+	FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
+	then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
+	failure if a FreeRTOS API function is called from an interrupt that has been
+	assigned a priority above the configured maximum system call priority.
+	Only FreeRTOS functions that end in FromISR can be called from interrupts
+	that have been assigned a priority at or (logically) below the maximum
+	system call	interrupt priority.  FreeRTOS maintains a separate interrupt
+	safe API to ensure interrupt entry is as fast and as simple as possible.
+	More information (albeit Cortex-M specific) is provided on the following
+	link: https://www.freertos.org/RTOS-Cortex-M3-M4.html */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portTICK_TYPE_SET_INTERRUPT_MASK_FROM_ISR();
+	{
+		xReturn = xTickCount;
+	}
+	portTICK_TYPE_CLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTaskGetNumberOfTasks( void )
+{
+	/* A critical section is not required because the variables are of type
+	BaseType_t. */
+	return uxCurrentNumberOfTasks;
+}
+/*-----------------------------------------------------------*/
+
+char *pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+{
+TCB_t *pxTCB;
+
+	/* If null is passed in here then the name of the calling task is being
+	queried. */
+	pxTCB = prvGetTCBFromHandle( xTaskToQuery );
+	configASSERT( pxTCB );
+	return &( pxTCB->pcTaskName[ 0 ] );
+}
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskGetHandle == 1 )
+
+	static TCB_t *prvSearchForNameWithinSingleList( List_t *pxList, const char pcNameToQuery[] )
+	{
+	TCB_t *pxNextTCB, *pxFirstTCB, *pxReturn = NULL;
+	UBaseType_t x;
+	char cNextChar;
+	BaseType_t xBreakLoop;
+
+		/* This function is called with the scheduler suspended. */
+
+		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+		{
+			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList );  /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			do
+			{
+				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+				/* Check each character in the name looking for a match or
+				mismatch. */
+				xBreakLoop = pdFALSE;
+				for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
+				{
+					cNextChar = pxNextTCB->pcTaskName[ x ];
+
+					if( cNextChar != pcNameToQuery[ x ] )
+					{
+						/* Characters didn't match. */
+						xBreakLoop = pdTRUE;
+					}
+					else if( cNextChar == ( char ) 0x00 )
+					{
+						/* Both strings terminated, a match must have been
+						found. */
+						pxReturn = pxNextTCB;
+						xBreakLoop = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					if( xBreakLoop != pdFALSE )
+					{
+						break;
+					}
+				}
+
+				if( pxReturn != NULL )
+				{
+					/* The handle has been found. */
+					break;
+				}
+
+			} while( pxNextTCB != pxFirstTCB );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxReturn;
+	}
+
+#endif /* INCLUDE_xTaskGetHandle */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskGetHandle == 1 )
+
+	TaskHandle_t xTaskGetHandle( const char *pcNameToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	{
+	UBaseType_t uxQueue = configMAX_PRIORITIES;
+	TCB_t* pxTCB;
+
+		/* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
+		configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
+
+		vTaskSuspendAll();
+		{
+			/* Search the ready lists. */
+			do
+			{
+				uxQueue--;
+				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxReadyTasksLists[ uxQueue ] ), pcNameToQuery );
+
+				if( pxTCB != NULL )
+				{
+					/* Found the handle. */
+					break;
+				}
+
+			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+			/* Search the delayed lists. */
+			if( pxTCB == NULL )
+			{
+				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+			}
+
+			if( pxTCB == NULL )
+			{
+				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+			}
+
+			#if( configUSE_TIMING_WHEEL == 1 )
+			{
+			UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = 0U; ( uxLevel < taskWHEEL_LEVELS ) && ( pxTCB == NULL ); uxLevel++ )
+				{
+					for( uxSlot = 0U; ( uxSlot < taskWHEEL_SLOTS ) && ( pxTCB == NULL ); uxSlot++ )
+					{
+						pxTCB = prvSearchForNameWithinSingleList( &( xTimingWheel[ uxLevel ][ uxSlot ] ), pcNameToQuery );
+					}
+				}
+			}
+			#endif
+
+			#if ( INCLUDE_vTaskSuspend == 1 )
+			{
+				if( pxTCB == NULL )
+				{
+					/* Search the suspended list. */
+					pxTCB = prvSearchForNameWithinSingleList( &xSuspendedTaskList, pcNameToQuery );
+				}
+			}
+			#endif
+
+			#if( INCLUDE_vTaskDelete == 1 )
+			{
+				if( pxTCB == NULL )
+				{
+					/* Search the deleted list. */
+					pxTCB = prvSearchForNameWithinSingleList( &xTasksWaitingTermination, pcNameToQuery );
+				}
+			}
+			#endif
+		}
+		( void ) xTaskResumeAll();
+
+		return pxTCB;
+	}
+
+#endif /* INCLUDE_xTaskGetHandle */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
+	{
+	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+
+		vTaskSuspendAll();
+		{
+			/* Is there a space in the array for each task in the system? */
+			if( uxArraySize >= uxCurrentNumberOfTasks )
+			{
+				/* Fill in an TaskStatus_t structure with information on each
+				task in the Ready state. */
+				do
+				{
+					uxQueue--;
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( pxReadyTasksLists[ uxQueue ] ), eReady );
+
+				} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+				/* Fill in an TaskStatus_t structure with information on each
+				task in the Blocked state. */
+				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
+				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+
+				#if( configUSE_TIMING_WHEEL == 1 )
+				{
+				UBaseType_t uxLevel, uxSlot;
+
+					for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+					{
+						for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+						{
+							uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xTimingWheel[ uxLevel ][ uxSlot ] ), eBlocked );
+						}
+					}
+				}
+				#endif
+
+				#if( INCLUDE_vTaskDelete == 1 )
+				{
+					/* Fill in an TaskStatus_t structure with information on
+					each task that has been deleted but not yet cleaned up. */
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xTasksWaitingTermination, eDeleted );
+				}
+				#endif
+
+				#if ( INCLUDE_vTaskSuspend == 1 )
+				{
+					/* Fill in an TaskStatus_t structure with information on
+					each task in the Suspended state. */
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xSuspendedTaskList, eSuspended );
+				}
+				#endif
+
+				#if ( configGENERATE_RUN_TIME_STATS == 1)
+				{
+					if( pulTotalRunTime != NULL )
+					{
+						#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+							portALT_GET_RUN_TIME_COUNTER_VALUE( ( *pulTotalRunTime ) );
+						#else
+							*pulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+						#endif
+					}
+				}
+				#else
+				{
+					if( pulTotalRunTime != NULL )
+					{
+						*pulTotalRunTime = 0;
+					}
+				}
+				#endif
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxTask;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
+
+	TaskHandle_t xTaskGetIdleTaskHandle( void )
+	{
+		/* If xTaskGetIdleTaskHandle() is called before the scheduler has been
+		started, then xIdleTaskHandle will be NULL. */
+		configASSERT( ( xIdleTaskHandle != NULL ) );
+		return xIdleTaskHandle;
+	}
+
+#endif /* INCLUDE_xTaskGetIdleTaskHandle */
+/*----------------------------------------------------------*/
+
+/* This conditional compilation should use inequality to 0, not equality to 1.
+This is to ensure vTaskStepTick() is available when user defined low power mode
+implementations require configUSE_TICKLESS_IDLE to be set to a value other than
+1. */
+#if ( configUSE_TICKLESS_IDLE != 0 )
+
+	void vTaskStepTick( const TickType_t xTicksToJump )
+	{
+		/* Correct the tick count value after a period during which the tick
+		was suppressed.  Note this does *not* call the tick hook function for
+		each stepped tick. */
+		configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
+		xTickCount += xTicksToJump;
+		traceINCREASE_TICK_COUNT( xTicksToJump );
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*----------------------------------------------------------*/
+
+#if ( INCLUDE_xTaskAbortDelay == 1 )
+
+	BaseType_t xTaskAbortDelay( TaskHandle_t xTask )
+	{
+	TCB_t *pxTCB = xTask;
+	BaseType_t xReturn;
+
+		configASSERT( pxTCB );
+
+		vTaskSuspendAll();
+		{
+			/* A task can only be prematurely removed from the Blocked state if
+			it is actually in the Blocked state, and not just waiting for its
+			budget to be replenished. */
+			if( ( eTaskGetState( xTask ) == eBlocked ) && ( taskIS_THROTTLED( pxTCB ) == pdFALSE ) )
+			{
+				xReturn = pdPASS;
+
+				/* Remove the reference to the task from the blocked list.  An
+				interrupt won't touch the xStateListItem because the
+				scheduler is suspended. */
+				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+				/* Is the task waiting on an event also?  If so remove it from
+				the event list too.  Interrupts can touch the event list item,
+				even though the scheduler is suspended, so a critical section
+				is used. */
+				taskENTER_CRITICAL();
+				{
+					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					{
+						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+						pxTCB->ucDelayAborted = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				taskEXIT_CRITICAL();
+
+				/* Place the unblocked task into the appropriate ready list. */
+				prvAddTaskToReadyList( pxTCB );
+
+				/* A task being unblocked cannot cause an immediate context
+				switch if preemption is turned off. */
+				#if (  configUSE_PREEMPTION == 1 )
+				{
+					/* Preemption is on, but a context switch should only be
+					performed if the unblocked task has a priority that is
+					equal to or higher than the currently executing task. */
+					if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
+					{
+						/* Pend the yield to be performed when the scheduler
+						is unsuspended. */
+						xYieldPending = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				#endif /* configUSE_PREEMPTION */
+			}
+			else
+			{
+				xReturn = pdFAIL;
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return xReturn;
+	}
+
+#endif /* INCLUDE_xTaskAbortDelay */
+/*----------------------------------------------------------*/
+
+static BaseType_t prvCatchUpTicks( UBaseType_t uxTicksToCatchUp )
+{
+BaseType_t xSwitchRequired = pdFALSE;
+TickType_t xStep, xTicksToLimit;
+
+	/* uxPendedTicks is still non-zero, so xTaskIncrementTick() does not call
+	the tick hook for the ticks processed here. */
+	while( uxTicksToCatchUp > ( UBaseType_t ) 0U )
+	{
+		if( uxTicksToCatchUp < ( UBaseType_t ) portMAX_DELAY )
+		{
+			xStep = ( TickType_t ) uxTicksToCatchUp;
+		}
+		else
+		{
+			xStep = portMAX_DELAY;
+		}
+
+		/* Stop at the last tick before the tick count overflows, so the tasks
+		in the current delayed list are unblocked before the delayed lists are
+		switched, then process the tick that overflows it on its own. */
+		xTicksToLimit = portMAX_DELAY - xTickCount;
+		if( xTicksToLimit == ( TickType_t ) 0 )
+		{
+			xStep = ( TickType_t ) 1;
+		}
+		else if( xTicksToLimit < xStep )
+		{
+			xStep = xTicksToLimit;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		#if( configUSE_FRAME_SCHEDULER == 1 )
+		{
+			/* Stop at the next frame boundary, so the frame ends, and the
+			tasks of the next are released, on the tick they would have been
+			had the scheduler not been suspended. */
+			xTicksToLimit = xFrameSchedulerGetTicksToNextFrame( xTickCount );
+			if( ( xTicksToLimit != ( TickType_t ) 0 ) && ( xTicksToLimit < xStep ) )
+			{
+				xStep = xTicksToLimit;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_FRAME_SCHEDULER */
+
+		#if( configUSE_TASK_BUDGETS == 1 )
+		{
+			/* The task that suspended the scheduler kept running, so every
+			pended tick is charged to it, and it is throttled on the tick its
+			budget is used.  Such a task is charged one tick at a time. */
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+			BaseType_t xCoreID;
+
+				for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+				{
+					if( pxCurrentTCBs[ xCoreID ]->xBudget != ( TickType_t ) 0 )
+					{
+						xStep = ( TickType_t ) 1;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			#else
+			{
+				if( pxCurrentTCB->xBudget != ( TickType_t ) 0 )
+				{
+					xStep = ( TickType_t ) 1;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configNUMBER_OF_CORES */
+		}
+		#endif /* configUSE_TASK_BUDGETS */
+
+		/* Nothing happens on the ticks before the last of the step, so the
+		tick count is moved on to the tick before it, and the last is processed
+		as normal.  Tasks whose wake time fell on the skipped ticks are still
+		in the delayed list, in the order they were due to wake, so are moved
+		to their ready lists in that order. */
+		if( xStep > ( TickType_t ) 1 )
+		{
+			xTickCount += ( xStep - ( TickType_t ) 1 );
+			traceINCREASE_TICK_COUNT( xStep - ( TickType_t ) 1 );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xTaskIncrementTick() != pdFALSE )
+		{
+			xSwitchRequired = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		uxTicksToCatchUp -= ( UBaseType_t ) xStep;
+	}
+
+	return xSwitchRequired;
+}
+/*----------------------------------------------------------*/
+
+BaseType_t xTaskIncrementTick( void )
+{
+TCB_t * pxTCB;
+TickType_t xItemValue;
+BaseType_t xSwitchRequired = pdFALSE;
+
+	/* Called by the portable layer each time a tick interrupt occurs.
+	Increments the tick then checks to see if the new tick value will cause any
+	tasks to be unblocked. */
+	traceTASK_INCREMENT_TICK( xTickCount );
+	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+	{
+		/* Minor optimisation.  The tick count cannot change in this
+		block. */
+		const TickType_t xConstTickCount = xTickCount + ( TickType_t ) 1;
+
+		/* Increment the RTOS tick, switching the delayed and overflowed
+		delayed lists if it wraps to 0. */
+		xTickCount = xConstTickCount;
+
+		if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
+		{
+			taskSWITCH_DELAYED_LISTS();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* See if this tick has made a timeout expire.  Tasks are stored in
+		the	queue in the order of their wake time - meaning once one task
+		has been found whose block time has not expired there is no need to
+		look any further down the list. */
+		if( xConstTickCount >= xNextTaskUnblockTime )
+		{
+			#if( configUSE_TIMING_WHEEL == 1 )
+			{
+				/* Move the tasks whose wake time has been reached from the
+				wheel to pxDelayedTaskList. */
+				prvAdvanceTimingWheel( xConstTickCount );
+			}
+			#endif
+
+			for( ;; )
+			{
+				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+				{
+					#if( configUSE_TIMING_WHEEL == 1 )
+					{
+						/* Tasks may remain on the wheel. */
+						prvResetNextTaskUnblockTime();
+					}
+					#else
+					{
+						/* The delayed list is empty.  Set xNextTaskUnblockTime
+						to the maximum possible value so it is extremely
+						unlikely that the
+						if( xTickCount >= xNextTaskUnblockTime ) test will pass
+						next time through. */
+						xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+					}
+					#endif
+					break;
+				}
+				else
+				{
+					/* The delayed list is not empty, get the value of the
+					item at the head of the delayed list.  This is the time
+					at which the task at the head of the delayed list must
+					be removed from the Blocked state. */
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+					if( xConstTickCount < xItemValue )
+					{
+						/* It is not time to unblock this item yet, but the
+						item value is the time at which the task at the head
+						of the blocked list must be removed from the Blocked
+						state -	so record the item value in
+						xNextTaskUnblockTime. */
+						xNextTaskUnblockTime = xItemValue;
+						break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* It is time to remove the item from the Blocked state. */
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+					/* Is the task waiting on an event also?  If so remove
+					it from the event list. */
+					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					{
+						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* Place the unblocked task into the appropriate ready
+					list. */
+					prvAddTaskToReadyList( pxTCB );
+
+					#if( configUSE_PERIODIC_TASKS == 1 )
+					{
+						/* A periodic task woken while waiting for its release
+						has been released, so note when to measure the time
+						it takes to start running. */
+						if( pxTCB->ucPeriodicState == taskPERIODIC_WAITING_FOR_RELEASE )
+						{
+							pxTCB->ucPeriodicState = taskPERIODIC_JOB_RUNNING;
+							pxTCB->ullReleaseNs = portGET_RUN_TIME_NS();
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					#endif /* configUSE_PERIODIC_TASKS */
+
+					/* A task being unblocked cannot cause an immediate
+					context switch if preemption is turned off. */
+					#if (  configUSE_PREEMPTION == 1 )
+					{
+						/* Preemption is on, but a context switch should
+						only be performed if the unblocked task has a
+						priority that is equal to or higher than the
+						currently executing task. */
+						if( taskSHOULD_PREEMPT( pxTCB->uxPriority >= pxCurrentTCB->uxPriority ) )
+						{
+							xSwitchRequired = pdTRUE;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					#endif /* configUSE_PREEMPTION */
+				}
+			}
+		}
+
+		#if( configUSE_FRAME_SCHEDULER == 1 )
+		{
+			/* Release the tasks of the next frame if a frame boundary has been
+			reached.  This also runs as pended ticks are unwound, so a boundary
+			is not missed while the scheduler is suspended. */
+			if( xFrameSchedulerIncrementTick( xConstTickCount ) != pdFALSE )
+			{
+				#if( configUSE_PREEMPTION == 1 )
+				{
+					xSwitchRequired = pdTRUE;
+				}
+				#endif /* configUSE_PREEMPTION */
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_FRAME_SCHEDULER */
+
+		#if( configUSE_TASK_BUDGETS == 1 )
+		{
+			/* Charge the tick to the running task, which is switched out
+			whether or not preemption is used if it has used its budget, then
+			ready any throttled tasks whose budget is replenished. */
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+			BaseType_t xCoreID;
+
+				for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+				{
+					if( prvChargeBudget( pxCurrentTCBs[ xCoreID ], xConstTickCount ) != pdFALSE )
+					{
+						prvYieldCore( xCoreID );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			#else
+			{
+				if( prvChargeBudget( pxCurrentTCB, xConstTickCount ) != pdFALSE )
+				{
+					xSwitchRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configNUMBER_OF_CORES */
+
+			if( prvReplenishBudgets( xConstTickCount ) != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_TASK_BUDGETS */
+
+		/* Tasks of equal priority to the currently running task will share
+		processing time (time slice) if preemption is on, and the application
+		writer has not explicitly turned time slicing off. */
+		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+		{
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+			BaseType_t xCoreID, xOtherCoreID;
+			UBaseType_t uxPriority, uxRunning;
+
+				/* A core shares its time with the ready tasks of the same
+				priority only if there are more of them than there are cores
+				already running a task of that priority. */
+				for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+				{
+					uxPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+					uxRunning = ( UBaseType_t ) 0;
+
+					for( xOtherCoreID = 0; xOtherCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xOtherCoreID++ )
+					{
+						if( pxCurrentTCBs[ xOtherCoreID ]->uxPriority == uxPriority )
+						{
+							uxRunning++;
+						}
+					}
+
+					if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxPriority ] ) ) > uxRunning )
+					{
+						prvYieldCore( xCoreID );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			#else
+			{
+				if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+				{
+					xSwitchRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configNUMBER_OF_CORES */
+		}
+		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+
+		#if ( configUSE_TICK_HOOK == 1 )
+		{
+			/* Guard against the tick hook being called when the pended tick
+			count is being unwound (when the scheduler is being unlocked). */
+			if( uxPendedTicks == ( UBaseType_t ) 0U )
+			{
+				vApplicationTickHook();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_TICK_HOOK */
+	}
+	else
+	{
+		++uxPendedTicks;
+
+		/* The tick hook gets called at regular intervals, even if the
+		scheduler is locked. */
+		#if ( configUSE_TICK_HOOK == 1 )
+		{
+			vApplicationTickHook();
+		}
+		#endif
+	}
+
+	#if ( configUSE_PREEMPTION == 1 )
+	{
+		if( xYieldPending != pdFALSE )
+		{
+			xSwitchRequired = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_PREEMPTION */
+
+	return xSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+
+	void vTaskSetApplicationTaskTag( TaskHandle_t xTask, TaskHookFunction_t pxHookFunction )
+	{
+	TCB_t *xTCB;
+
+		/* If xTask is NULL then it is the task hook of the calling task that is
+		getting set. */
+		if( xTask == NULL )
+		{
+			xTCB = ( TCB_t * ) pxCurrentTCB;
+		}
+		else
+		{
+			xTCB = xTask;
+		}
+
+		/* Save the hook function in the TCB.  A critical section is required as
+		the value can be accessed from an interrupt. */
+		taskENTER_CRITICAL();
+		{
+			xTCB->pxTaskTag = pxHookFunction;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_APPLICATION_TASK_TAG */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+
+	TaskHookFunction_t xTaskGetApplicationTaskTag( TaskHandle_t xTask )
+	{
+	TCB_t *xTCB;
+	TaskHookFunction_t xReturn;
+
+		/* If xTask is NULL then we are setting our own task hook. */
+		if( xTask == NULL )
+		{
+			xTCB = ( TCB_t * ) pxCurrentTCB;
+		}
+		else
+		{
+			xTCB = xTask;
+		}
+
+		/* Save the hook function in the TCB.  A critical section is required as
+		the value can be accessed from an interrupt. */
+		taskENTER_CRITICAL();
+		{
+			xReturn = xTCB->pxTaskTag;
+		}
+		taskEXIT_CRITICAL();
+
+		return xReturn;
+	}
+
+#endif /* configUSE_APPLICATION_TASK_TAG */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+
+	BaseType_t xTaskCallApplicationTaskHook( TaskHandle_t xTask, void *pvParameter )
+	{
+	TCB_t *xTCB;
+	BaseType_t xReturn;
+
+		/* If xTask is NULL then we are calling our own task hook. */
+		if( xTask == NULL )
+		{
+			xTCB = pxCurrentTCB;
+		}
+		else
+		{
+			xTCB = xTask;
+		}
+
+		if( xTCB->pxTaskTag != NULL )
+		{
+			xReturn = xTCB->pxTaskTag( pvParameter );
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_APPLICATION_TASK_TAG */
+/*-----------------------------------------------------------*/
+
+void vTaskSwitchContext( void )
+{
+	#if( configGENERATE_EXECUTION_STATS == 1 )
+	TCB_t *pxPreviousTCB;
+	uint64_t ullNowNs;
+	#endif
+	#if( configNUMBER_OF_CORES > 1 )
+	BaseType_t xTaskLockTaken = pdFALSE;
+
+		/* Selecting a task needs both locks.  If the scheduler is suspended
+		the switch is deferred instead, which only needs the ISR lock - the task
+		lock is held by the core that suspended the scheduler, which may be this
+		one. */
+		portGET_ISR_LOCK();
+
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			portRELEASE_ISR_LOCK();
+			portGET_TASK_LOCK();
+			portGET_ISR_LOCK();
+			xTaskLockTaken = pdTRUE;
+		}
+	#endif /* configNUMBER_OF_CORES */
+
+	if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
+	{
+		/* The scheduler is currently suspended - do not allow a context
+		switch. */
+		xYieldPending = pdTRUE;
+	}
+	else
+	{
+		xYieldPending = pdFALSE;
+		traceTASK_SWITCHED_OUT();
+
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+				#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+					portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
+				#else
+					ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+				#endif
+
+				/* Add the amount of time the task has been running to the
+				accumulated time so far.  The time the task started running was
+				stored in ulTaskSwitchedInTime.  Note that there is no overflow
+				protection here so count values are only valid until the timer
+				overflows.  The guard against negative values is to protect
+				against suspect run time stat counter implementations - which
+				are provided by the application, not the kernel. */
+				if( ulTotalRunTime > ulTaskSwitchedInTime )
+				{
+					pxCurrentTCB->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				ulTaskSwitchedInTime = ulTotalRunTime;
+		}
+		#endif /* configGENERATE_RUN_TIME_STATS */
+
+		#if( configGENERATE_EXECUTION_STATS == 1 )
+		{
+			/* The execution statistics are only updated once it is known
+			that a different task is selected. */
+			pxPreviousTCB = pxCurrentTCB;
+			ullNowNs = portGET_RUN_TIME_NS();
+		}
+		#endif /* configGENERATE_EXECUTION_STATS */
+
+		/* Check for stack overflow, if configured. */
+		taskCHECK_FOR_STACK_OVERFLOW();
+
+		/* Before the currently running task is switched out, save its errno. */
+		#if( configUSE_POSIX_ERRNO == 1 )
+		{
+			pxCurrentTCB->iTaskErrno = FreeRTOS_errno;
+		}
+		#endif
+
+		#if( configUSE_EDF_SCHEDULING == 1 )
+		{
+			/* Move the task being switched out, if it is still ready, behind
+			the other ready tasks of its priority that have the same deadline,
+			so they take turns as tasks of the same priority otherwise would.
+			This also moves it to the right place if its deadline changed
+			while it was running. */
+			if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) != pdFALSE )
+			{
+				( void ) uxListRemove( &( pxCurrentTCB->xStateListItem ) );
+				prvInsertTaskByDeadline( pxCurrentTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_EDF_SCHEDULING */
+
+		/* Select a new task to run using either the generic C or port
+		optimised asm code. */
+		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+		#if( configGENERATE_EXECUTION_STATS == 1 )
+		{
+			if( pxCurrentTCB != pxPreviousTCB )
+			{
+				prvExecutionStatsSwitchOut( pxPreviousTCB, ullNowNs );
+				prvExecutionStatsSwitchIn( pxCurrentTCB, ullNowNs );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configGENERATE_EXECUTION_STATS */
+
+		traceTASK_SWITCHED_IN();
+
+		/* After the new task is switched in, update the global errno. */
+		#if( configUSE_POSIX_ERRNO == 1 )
+		{
+			FreeRTOS_errno = pxCurrentTCB->iTaskErrno;
+		}
+		#endif
+
+		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		{
+			/* Switch Newlib's _impure_ptr variable to point to the _reent
+			structure specific to this task. */
+			_impure_ptr = &( pxCurrentTCB->xNewLib_reent );
+		}
+		#endif /* configUSE_NEWLIB_REENTRANT */
+	}
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		portRELEASE_ISR_LOCK();
+
+		if( xTaskLockTaken != pdFALSE )
+		{
+			portRELEASE_TASK_LOCK();
+		}
+	}
+	#endif /* configNUMBER_OF_CORES */
+}
+/*-----------------------------------------------------------*/
+
+void vTaskPlaceOnEventList( List_t * const pxEventList, const TickType_t xTicksToWait )
+{
+	configASSERT( pxEventList );
+
+	/* THIS FUNCTION MUST BE CALLED WITH EITHER INTERRUPTS DISABLED OR THE
+	SCHEDULER SUSPENDED AND THE QUEUE BEING ACCESSED LOCKED. */
+
+	/* Place the event list item of the TCB in the appropriate event list.
+	This is placed in the list in priority order so the highest priority task
+	is the first to be woken by the event.  The queue that contains the event
+	list is locked, preventing simultaneous access from interrupts. */
+	vListInsert( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+
+	prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+void vTaskPlaceOnUnorderedEventList( List_t * pxEventList, const TickType_t xItemValue, const TickType_t xTicksToWait )
+{
+	configASSERT( pxEventList );
+
+	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
+	the event groups implementation. */
+	configASSERT( uxSchedulerSuspended != 0 );
+
+	/* Store the item value in the event list item.  It is safe to access the
+	event list item here as interrupts won't access the event list item of a
+	task that is not in the Blocked state. */
+	listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+	/* Place the event list item of the TCB at the end of the appropriate event
+	list.  It is safe to access the event list here because it is part of an
+	event group implementation - and interrupts don't access event groups
+	directly (instead they access them indirectly by pending function calls to
+	the task level). */
+	vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+
+	prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMERS == 1 )
+
+	void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely )
+	{
+		configASSERT( pxEventList );
+
+		/* This function should not be called by application code hence the
+		'Restricted' in its name.  It is not part of the public API.  It is
+		designed for use by kernel code, and has special calling requirements -
+		it should be called with the scheduler suspended. */
+
+
+		/* Place the event list item of the TCB in the appropriate event list.
+		In this case it is assume that this is the only task that is going to
+		be waiting on this event list, so the faster vListInsertEnd() function
+		can be used in place of vListInsert. */
+		vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+
+		/* If the task should block indefinitely then set the block time to a
+		value that will be recognised as an indefinite delay inside the
+		prvAddCurrentTaskToDelayedList() function. */
+		if( xWaitIndefinitely != pdFALSE )
+		{
+			xTicksToWait = portMAX_DELAY;
+		}
+
+		traceTASK_DELAY_UNTIL( ( xTickCount + xTicksToWait ) );
+		prvAddCurrentTaskToDelayedList( xTicksToWait, xWaitIndefinitely );
+	}
+
+#endif /* configUSE_TIMERS */
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
+{
+TCB_t *pxUnblockedTCB;
+BaseType_t xReturn;
+
+	/* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
+	called from a critical section within an ISR. */
+
+	/* The event list is sorted in priority order, so the first in the list can
+	be removed as it is known to be the highest priority.  Remove the TCB from
+	the delayed list, and add it to the ready list.
+
+	If an event is for a queue that is locked then this function will never
+	get called - the lock count on the queue will get modified instead.  This
+	means exclusive access to the event list is guaranteed here.
+
+	This function assumes that a check has already been made to ensure that
+	pxEventList is not empty. */
+	pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	configASSERT( pxUnblockedTCB );
+	( void ) uxListRemove( &( pxUnblockedTCB->xEventListItem ) );
+
+	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+	{
+		( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+		prvAddTaskToReadyList( pxUnblockedTCB );
+	}
+	else
+	{
+		/* The delayed and ready lists cannot be accessed, so hold this task
+		pending until the scheduler is resumed. */
+		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+	}
+
+	if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxUnblockedTCB, pxCurrentTCB ) ) )
+	{
+		/* Return true if the task removed from the event list has a higher
+		priority than the calling task.  This allows the calling task to know if
+		it should force a context switch now. */
+		xReturn = pdTRUE;
+
+		/* Mark that a yield is pending in case the user is not using the
+		"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
+		xYieldPending = pdTRUE;
+	}
+	else
+	{
+		xReturn = pdFALSE;
+	}
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+	{
+		/* If a task is blocked on a kernel object then xNextTaskUnblockTime
+		might be set to the blocked task's time out time.  If the task is
+		unblocked for a reason other than a timeout xNextTaskUnblockTime is
+		normally left unchanged, because it is automatically reset to a new
+		value when the tick count equals xNextTaskUnblockTime.  However if
+		tickless idling is used it might be more important to enter sleep mode
+		at the earliest possible time - so reset xNextTaskUnblockTime here to
+		ensure it is updated at the earliest possible time. */
+		prvResetNextTaskUnblockTime();
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+{
+TCB_t *pxUnblockedTCB;
+
+	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
+	the event flags implementation. */
+	configASSERT( uxSchedulerSuspended != pdFALSE );
+
+	/* Store the new item value in the event list. */
+	listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+	/* Remove the event list form the event flag.  Interrupts do not access
+	event flags. */
+	pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	configASSERT( pxUnblockedTCB );
+	( void ) uxListRemove( pxEventListItem );
+
+	/* Remove the task from the delayed list and add it to the ready list.  The
+	scheduler is suspended so interrupts will not be accessing the ready
+	lists. */
+	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+	prvAddTaskToReadyList( pxUnblockedTCB );
+
+	if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxUnblockedTCB, pxCurrentTCB ) ) )
+	{
+		/* The unblocked task has a priority above that of the calling task, so
+		a context switch is required.  This function is called with the
+		scheduler suspended so xYieldPending is set so the context switch
+		occurs immediately that the scheduler is resumed (unsuspended). */
+		xYieldPending = pdTRUE;
+	}
+}
+/*-----------------------------------------------------------*/
 
-					if( xConstTickCount < xItemValue )
-					{
-						/* It is not time to unblock this item yet, but the
-						item value is the time at which the task at the head
-						of the blocked list must be removed from the Blocked
-						state -	so record the item value in
-						xNextTaskUnblockTime. */
-						xNextTaskUnblockTime = xItemValue;
-						break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	configASSERT( pxTimeOut );
+	taskENTER_CRITICAL();
+	{
+		pxTimeOut->xOverflowCount = xNumOfOverflows;
+		pxTimeOut->xTimeOnEntering = xTickCount;
+	}
+	taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
 
-					/* It is time to remove the item from the Blocked state. */
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
+{
+	/* For internal use only as it does not use a critical section. */
+	pxTimeOut->xOverflowCount = xNumOfOverflows;
+	pxTimeOut->xTimeOnEntering = xTickCount;
+}
+/*-----------------------------------------------------------*/
 
-					/* Is the task waiting on an event also?  If so remove
-					it from the event list. */
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
-					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
+{
+BaseType_t xReturn;
 
-					/* Place the unblocked task into the appropriate ready
-					list. */
-					prvAddTaskToReadyList( pxTCB );
+	configASSERT( pxTimeOut );
+	configASSERT( pxTicksToWait );
 
-					/* A task being unblocked cannot cause an immediate
-					context switch if preemption is turned off. */
-					#if (  configUSE_PREEMPTION == 1 )
-					{
-						/* Preemption is on, but a context switch should
-						only be performed if the unblocked task has a
-						priority that is equal to or higher than the
-						currently executing task. */
-						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-						{
-							xSwitchRequired = pdTRUE;
-						}
-						else
-						{
-							mtCOVERAGE_TEST_MARKER();
-						}
-					}
-					#endif /* configUSE_PREEMPTION */
-				}
-			}
-		}
+	taskENTER_CRITICAL();
+	{
+		/* Minor optimisation.  The tick count cannot change in this block. */
+		const TickType_t xConstTickCount = xTickCount;
+		const TickType_t xElapsedTime = xConstTickCount - pxTimeOut->xTimeOnEntering;
 
-		/* Tasks of equal priority to the currently running task will share
-		processing time (time slice) if preemption is on, and the application
-		writer has not explicitly turned time slicing off. */
-		#if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
-		{
-			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+		#if( INCLUDE_xTaskAbortDelay == 1 )
+			if( pxCurrentTCB->ucDelayAborted != ( uint8_t ) pdFALSE )
 			{
-				xSwitchRequired = pdTRUE;
+				/* The delay was aborted, which is not the same as a time out,
+				but has the same result. */
+				pxCurrentTCB->ucDelayAborted = pdFALSE;
+				xReturn = pdTRUE;
 			}
 			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
-		}
-		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+		#endif
 
-		#if ( configUSE_TICK_HOOK == 1 )
-		{
-			/* Guard against the tick hook being called when the pended tick
-			count is being unwound (when the scheduler is being unlocked). */
-			if( uxPendedTicks == ( UBaseType_t ) 0U )
+		#if ( INCLUDE_vTaskSuspend == 1 )
+			if( *pxTicksToWait == portMAX_DELAY )
 			{
-				vApplicationTickHook();
+				/* If INCLUDE_vTaskSuspend is set to 1 and the block time
+				specified is the maximum block time then the task should block
+				indefinitely, and therefore never time out. */
+				xReturn = pdFALSE;
 			}
 			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
-		}
-		#endif /* configUSE_TICK_HOOK */
-	}
-	else
-	{
-		++uxPendedTicks;
+		#endif
 
-		/* The tick hook gets called at regular intervals, even if the
-		scheduler is locked. */
-		#if ( configUSE_TICK_HOOK == 1 )
+		if( ( xNumOfOverflows != pxTimeOut->xOverflowCount ) && ( xConstTickCount >= pxTimeOut->xTimeOnEntering ) ) /*lint !e525 Indentation preferred as is to make code within pre-processor directives clearer. */
 		{
-			vApplicationTickHook();
+			/* The tick count is greater than the time at which
+			vTaskSetTimeout() was called, but has also overflowed since
+			vTaskSetTimeOut() was called.  It must have wrapped all the way
+			around and gone past again. This passed since vTaskSetTimeout()
+			was called. */
+			xReturn = pdTRUE;
 		}
-		#endif
-	}
-
-	#if ( configUSE_PREEMPTION == 1 )
-	{
-		if( xYieldPending != pdFALSE )
+		else if( xElapsedTime < *pxTicksToWait ) /*lint !e961 Explicit casting is only redundant with some compilers, whereas others require it to prevent integer conversion errors. */
 		{
-			xSwitchRequired = pdTRUE;
+			/* Not a genuine timeout. Adjust parameters for time remaining. */
+			*pxTicksToWait -= xElapsedTime;
+			vTaskInternalSetTimeOutState( pxTimeOut );
+			xReturn = pdFALSE;
 		}
 		else
 		{
-			mtCOVERAGE_TEST_MARKER();
+			*pxTicksToWait = 0;
+			xReturn = pdTRUE;
 		}
 	}
-	#endif /* configUSE_PREEMPTION */
+	taskEXIT_CRITICAL();
 
-	return xSwitchRequired;
+	return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+void vTaskMissedYield( void )
+{
+	xYieldPending = pdTRUE;
+}
+/*-----------------------------------------------------------*/
 
-	void vTaskSetApplicationTaskTag( TaskHandle_t xTask, TaskHookFunction_t pxHookFunction )
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxTaskGetTaskNumber( TaskHandle_t xTask )
 	{
-	TCB_t *xTCB;
+	UBaseType_t uxReturn;
+	TCB_t const *pxTCB;
 
-		/* If xTask is NULL then it is the task hook of the calling task that is
-		getting set. */
-		if( xTask == NULL )
+		if( xTask != NULL )
 		{
-			xTCB = ( TCB_t * ) pxCurrentTCB;
+			pxTCB = xTask;
+			uxReturn = pxTCB->uxTaskNumber;
 		}
 		else
 		{
-			xTCB = xTask;
+			uxReturn = 0U;
 		}
 
-		/* Save the hook function in the TCB.  A critical section is required as
-		the value can be accessed from an interrupt. */
-		taskENTER_CRITICAL();
+		return uxReturn;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vTaskSetTaskNumber( TaskHandle_t xTask, const UBaseType_t uxHandle )
+	{
+	TCB_t * pxTCB;
+
+		if( xTask != NULL )
 		{
-			xTCB->pxTaskTag = pxHookFunction;
+			pxTCB = xTask;
+			pxTCB->uxTaskNumber = uxHandle;
 		}
-		taskEXIT_CRITICAL();
 	}
 
-#endif /* configUSE_APPLICATION_TASK_TAG */
-/*-----------------------------------------------------------*/
+#endif /* configUSE_TRACE_FACILITY */
 
-#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+/*
+ * -----------------------------------------------------------
+ * The Idle task.
+ * ----------------------------------------------------------
+ *
+ * The portTASK_FUNCTION() macro is used to allow port/compiler specific
+ * language extensions.  The equivalent prototype for this function is:
+ *
+ * void prvIdleTask( void *pvParameters );
+ *
+ */
+static portTASK_FUNCTION( prvIdleTask, pvParameters )
+{
+	/* Stop warnings. */
+	( void ) pvParameters;
 
-	TaskHookFunction_t xTaskGetApplicationTaskTag( TaskHandle_t xTask )
+	/** THIS IS THE RTOS IDLE TASK - WHICH IS CREATED AUTOMATICALLY WHEN THE
+	SCHEDULER IS STARTED. **/
+
+	/* In case a task that has a secure context deletes itself, in which case
+	the idle task is responsible for deleting the task's secure context, if
+	any. */
+	portTASK_CALLS_SECURE_FUNCTIONS();
+
+	for( ;; )
 	{
-	TCB_t *xTCB;
-	TaskHookFunction_t xReturn;
+		/* See if any tasks have deleted themselves - if so then the idle task
+		is responsible for freeing the deleted task's TCB and stack. */
+		prvCheckTasksWaitingTermination();
+
+		#if ( configUSE_PREEMPTION == 0 )
+		{
+			/* If we are not using preemption we keep forcing a task switch to
+			see if any other task has become available.  If we are using
+			preemption we don't need to do this as any task becoming available
+			will automatically get the processor anyway. */
+			taskYIELD();
+		}
+		#endif /* configUSE_PREEMPTION */
+
+		#if ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) )
+		{
+			/* When using preemption tasks of equal priority will be
+			timesliced.  If a task that is sharing the idle priority is ready
+			to run then the idle task should yield before the end of the
+			timeslice.
+
+			A critical region is not required here as we are just reading from
+			the list, and an occasional incorrect value will not matter.  If
+			the ready list at the idle priority contains more than one task
+			per core then a task other than an idle task is ready to
+			execute. */
+			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
+			{
+				taskYIELD();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) ) */
 
-		/* If xTask is NULL then we are setting our own task hook. */
-		if( xTask == NULL )
+		#if( configUSE_STACK_PROFILER == 1 )
 		{
-			xTCB = ( TCB_t * ) pxCurrentTCB;
+			prvSampleStackUsage();
 		}
-		else
+		#endif /* configUSE_STACK_PROFILER */
+
+		#if ( configUSE_IDLE_HOOK == 1 )
 		{
-			xTCB = xTask;
+			extern void vApplicationIdleHook( void );
+
+			/* Call the user defined function from within the idle task.  This
+			allows the application designer to add background functionality
+			without the overhead of a separate task.
+			NOTE: vApplicationIdleHook() MUST NOT, UNDER ANY CIRCUMSTANCES,
+			CALL A FUNCTION THAT MIGHT BLOCK. */
+			vApplicationIdleHook();
 		}
+		#endif /* configUSE_IDLE_HOOK */
 
-		/* Save the hook function in the TCB.  A critical section is required as
-		the value can be accessed from an interrupt. */
-		taskENTER_CRITICAL();
+		/* This conditional compilation should use inequality to 0, not equality
+		to 1.  This is to ensure portSUPPRESS_TICKS_AND_SLEEP() is called when
+		user defined low power mode	implementations require
+		configUSE_TICKLESS_IDLE to be set to a value other than 1. */
+		#if ( configUSE_TICKLESS_IDLE != 0 )
 		{
-			xReturn = xTCB->pxTaskTag;
-		}
-		taskEXIT_CRITICAL();
+		TickType_t xExpectedIdleTime;
 
-		return xReturn;
-	}
+			/* It is not desirable to suspend then resume the scheduler on
+			each iteration of the idle task.  Therefore, a preliminary
+			test of the expected idle time is performed without the
+			scheduler suspended.  The result here is not necessarily
+			valid. */
+			xExpectedIdleTime = prvGetExpectedIdleTime();
 
-#endif /* configUSE_APPLICATION_TASK_TAG */
+			if( xExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+			{
+				vTaskSuspendAll();
+				{
+					/* Now the scheduler is suspended, the expected idle
+					time can be sampled again, and this time its value can
+					be used. */
+					configASSERT( xNextTaskUnblockTime >= xTickCount );
+					xExpectedIdleTime = prvGetExpectedIdleTime();
+
+					/* Define the following macro to set xExpectedIdleTime to 0
+					if the application does not want
+					portSUPPRESS_TICKS_AND_SLEEP() to be called. */
+					configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( xExpectedIdleTime );
+
+					if( xExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
+					{
+						traceLOW_POWER_IDLE_BEGIN();
+						portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime );
+						traceLOW_POWER_IDLE_END();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				( void ) xTaskResumeAll();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_TICKLESS_IDLE */
+	}
+}
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_APPLICATION_TASK_TAG == 1 )
+#if( configUSE_TICKLESS_IDLE != 0 )
 
-	BaseType_t xTaskCallApplicationTaskHook( TaskHandle_t xTask, void *pvParameter )
+	eSleepModeStatus eTaskConfirmSleepModeStatus( void )
 	{
-	TCB_t *xTCB;
-	BaseType_t xReturn;
+	/* The idle task exists in addition to the application tasks. */
+	const UBaseType_t uxNonApplicationTasks = 1;
+	eSleepModeStatus eReturn = eStandardSleep;
 
-		/* If xTask is NULL then we are calling our own task hook. */
-		if( xTask == NULL )
-		{
-			xTCB = pxCurrentTCB;
-		}
-		else
+		if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 )
 		{
-			xTCB = xTask;
+			/* A task was made ready while the scheduler was suspended. */
+			eReturn = eAbortSleep;
 		}
-
-		if( xTCB->pxTaskTag != NULL )
+		else if( xYieldPending != pdFALSE )
 		{
-			xReturn = xTCB->pxTaskTag( pvParameter );
+			/* A yield was pended while the scheduler was suspended. */
+			eReturn = eAbortSleep;
 		}
 		else
 		{
-			xReturn = pdFAIL;
+			/* If all the tasks are in the suspended list (which might mean they
+			have an infinite block time rather than actually being suspended)
+			then it is safe to turn all clocks off and just wait for external
+			interrupts. */
+			if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == ( uxCurrentNumberOfTasks - uxNonApplicationTasks ) )
+			{
+				eReturn = eNoTasksWaitingTimeout;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 		}
 
-		return xReturn;
+		return eReturn;
 	}
 
-#endif /* configUSE_APPLICATION_TASK_TAG */
+#endif /* configUSE_TICKLESS_IDLE */
 /*-----------------------------------------------------------*/
 
-void vTaskSwitchContext( void )
-{
-	if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
-	{
-		/* The scheduler is currently suspended - do not allow a context
-		switch. */
-		xYieldPending = pdTRUE;
-	}
-	else
+#if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
+
+	void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
 	{
-		xYieldPending = pdFALSE;
-		traceTASK_SWITCHED_OUT();
+	TCB_t *pxTCB;
 
-		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
 		{
-				#ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-					portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
-				#else
-					ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
-				#endif
-
-				/* Add the amount of time the task has been running to the
-				accumulated time so far.  The time the task started running was
-				stored in ulTaskSwitchedInTime.  Note that there is no overflow
-				protection here so count values are only valid until the timer
-				overflows.  The guard against negative values is to protect
-				against suspect run time stat counter implementations - which
-				are provided by the application, not the kernel. */
-				if( ulTotalRunTime > ulTaskSwitchedInTime )
-				{
-					pxCurrentTCB->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime );
-				}
-				else
-				{
-					mtCOVERAGE_TEST_MARKER();
-				}
-				ulTaskSwitchedInTime = ulTotalRunTime;
+			pxTCB = prvGetTCBFromHandle( xTaskToSet );
+			pxTCB->pvThreadLocalStoragePointers[ xIndex ] = pvValue;
 		}
-		#endif /* configGENERATE_RUN_TIME_STATS */
+	}
 
-		/* Check for stack overflow, if configured. */
-		taskCHECK_FOR_STACK_OVERFLOW();
+#endif /* configNUM_THREAD_LOCAL_STORAGE_POINTERS */
+/*-----------------------------------------------------------*/
 
-		/* Before the currently running task is switched out, save its errno. */
-		#if( configUSE_POSIX_ERRNO == 1 )
-		{
-			pxCurrentTCB->iTaskErrno = FreeRTOS_errno;
-		}
-		#endif
+#if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
 
-		/* Select a new task to run using either the generic C or port
-		optimised asm code. */
-		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-		traceTASK_SWITCHED_IN();
+	void *pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex )
+	{
+	void *pvReturn = NULL;
+	TCB_t *pxTCB;
 
-		/* After the new task is switched in, update the global errno. */
-		#if( configUSE_POSIX_ERRNO == 1 )
+		if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
 		{
-			FreeRTOS_errno = pxCurrentTCB->iTaskErrno;
+			pxTCB = prvGetTCBFromHandle( xTaskToQuery );
+			pvReturn = pxTCB->pvThreadLocalStoragePointers[ xIndex ];
 		}
-		#endif
-
-		#if ( configUSE_NEWLIB_REENTRANT == 1 )
+		else
 		{
-			/* Switch Newlib's _impure_ptr variable to point to the _reent
-			structure specific to this task. */
-			_impure_ptr = &( pxCurrentTCB->xNewLib_reent );
+			pvReturn = NULL;
 		}
-		#endif /* configUSE_NEWLIB_REENTRANT */
-	}
-}
-/*-----------------------------------------------------------*/
-
-void vTaskPlaceOnEventList( List_t * const pxEventList, const TickType_t xTicksToWait )
-{
-	configASSERT( pxEventList );
-
-	/* THIS FUNCTION MUST BE CALLED WITH EITHER INTERRUPTS DISABLED OR THE
-	SCHEDULER SUSPENDED AND THE QUEUE BEING ACCESSED LOCKED. */
-
-	/* Place the event list item of the TCB in the appropriate event list.
-	This is placed in the list in priority order so the highest priority task
-	is the first to be woken by the event.  The queue that contains the event
-	list is locked, preventing simultaneous access from interrupts. */
-	vListInsert( pxEventList, &( pxCurrentTCB->xEventListItem ) );
-
-	prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
-}
-/*-----------------------------------------------------------*/
-
-void vTaskPlaceOnUnorderedEventList( List_t * pxEventList, const TickType_t xItemValue, const TickType_t xTicksToWait )
-{
-	configASSERT( pxEventList );
-
-	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
-	the event groups implementation. */
-	configASSERT( uxSchedulerSuspended != 0 );
-
-	/* Store the item value in the event list item.  It is safe to access the
-	event list item here as interrupts won't access the event list item of a
-	task that is not in the Blocked state. */
-	listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xEventListItem ), xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
 
-	/* Place the event list item of the TCB at the end of the appropriate event
-	list.  It is safe to access the event list here because it is part of an
-	event group implementation - and interrupts don't access event groups
-	directly (instead they access them indirectly by pending function calls to
-	the task level). */
-	vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+		return pvReturn;
+	}
 
-	prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
-}
+#endif /* configNUM_THREAD_LOCAL_STORAGE_POINTERS */
 /*-----------------------------------------------------------*/
 
-#if( configUSE_TIMERS == 1 )
+#if ( portUSING_MPU_WRAPPERS == 1 )
 
-	void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely )
+	void vTaskAllocateMPURegions( TaskHandle_t xTaskToModify, const MemoryRegion_t * const xRegions )
 	{
-		configASSERT( pxEventList );
-
-		/* This function should not be called by application code hence the
-		'Restricted' in its name.  It is not part of the public API.  It is
-		designed for use by kernel code, and has special calling requirements -
-		it should be called with the scheduler suspended. */
-
-
-		/* Place the event list item of the TCB in the appropriate event list.
-		In this case it is assume that this is the only task that is going to
-		be waiting on this event list, so the faster vListInsertEnd() function
-		can be used in place of vListInsert. */
-		vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+	TCB_t *pxTCB;
 
-		/* If the task should block indefinitely then set the block time to a
-		value that will be recognised as an indefinite delay inside the
-		prvAddCurrentTaskToDelayedList() function. */
-		if( xWaitIndefinitely != pdFALSE )
-		{
-			xTicksToWait = portMAX_DELAY;
-		}
+		/* If null is passed in here then we are modifying the MPU settings of
+		the calling task. */
+		pxTCB = prvGetTCBFromHandle( xTaskToModify );
 
-		traceTASK_DELAY_UNTIL( ( xTickCount + xTicksToWait ) );
-		prvAddCurrentTaskToDelayedList( xTicksToWait, xWaitIndefinitely );
+		vPortStoreTaskMPUSettings( &( pxTCB->xMPUSettings ), xRegions, NULL, 0 );
 	}
 
-#endif /* configUSE_TIMERS */
+#endif /* portUSING_MPU_WRAPPERS */
 /*-----------------------------------------------------------*/
 
-BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
+static void prvInitialiseTaskLists( void )
 {
-TCB_t *pxUnblockedTCB;
-BaseType_t xReturn;
-
-	/* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
-	called from a critical section within an ISR. */
-
-	/* The event list is sorted in priority order, so the first in the list can
-	be removed as it is known to be the highest priority.  Remove the TCB from
-	the delayed list, and add it to the ready list.
+UBaseType_t uxPriority;
 
-	If an event is for a queue that is locked then this function will never
-	get called - the lock count on the queue will get modified instead.  This
-	means exclusive access to the event list is guaranteed here.
+	for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+	{
+		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
+	}
 
-	This function assumes that a check has already been made to ensure that
-	pxEventList is not empty. */
-	pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-	configASSERT( pxUnblockedTCB );
-	( void ) uxListRemove( &( pxUnblockedTCB->xEventListItem ) );
+	vListInitialise( &xDelayedTaskList1 );
+	vListInitialise( &xDelayedTaskList2 );
+	vListInitialise( &xPendingReadyList );
 
-	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+	#if ( INCLUDE_vTaskDelete == 1 )
 	{
-		( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
-		prvAddTaskToReadyList( pxUnblockedTCB );
+		vListInitialise( &xTasksWaitingTermination );
 	}
-	else
+	#endif /* INCLUDE_vTaskDelete */
+
+	#if ( INCLUDE_vTaskSuspend == 1 )
 	{
-		/* The delayed and ready lists cannot be accessed, so hold this task
-		pending until the scheduler is resumed. */
-		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+		vListInitialise( &xSuspendedTaskList );
 	}
+	#endif /* INCLUDE_vTaskSuspend */
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	#if( configUSE_TASK_BUDGETS == 1 )
 	{
-		/* Return true if the task removed from the event list has a higher
-		priority than the calling task.  This allows the calling task to know if
-		it should force a context switch now. */
-		xReturn = pdTRUE;
+		vListInitialise( &xThrottledTaskList );
+	}
+	#endif /* configUSE_TASK_BUDGETS */
 
-		/* Mark that a yield is pending in case the user is not using the
-		"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
-		xYieldPending = pdTRUE;
+	#if( configUSE_STACK_PROFILER == 1 )
+	{
+		vListInitialise( &xStackProfiledTasks );
 	}
-	else
+	#endif /* configUSE_STACK_PROFILER */
+
+	#if( configUSE_TASK_POOL == 1 )
 	{
-		xReturn = pdFALSE;
+	UBaseType_t uxSizeClass;
+
+		for( uxSizeClass = ( UBaseType_t ) 0U; uxSizeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES; uxSizeClass++ )
+		{
+			vListInitialise( &( xTaskPools[ uxSizeClass ] ) );
+		}
 	}
+	#endif /* configUSE_TASK_POOL */
 
-	#if( configUSE_TICKLESS_IDLE != 0 )
+	#if( configUSE_TIMING_WHEEL == 1 )
 	{
-		/* If a task is blocked on a kernel object then xNextTaskUnblockTime
-		might be set to the blocked task's time out time.  If the task is
-		unblocked for a reason other than a timeout xNextTaskUnblockTime is
-		normally left unchanged, because it is automatically reset to a new
-		value when the tick count equals xNextTaskUnblockTime.  However if
-		tickless idling is used it might be more important to enter sleep mode
-		at the earliest possible time - so reset xNextTaskUnblockTime here to
-		ensure it is updated at the earliest possible time. */
-		prvResetNextTaskUnblockTime();
+	UBaseType_t uxLevel, uxSlot;
+
+		for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+		{
+			for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+			{
+				vListInitialise( &( xTimingWheel[ uxLevel ][ uxSlot ] ) );
+			}
+
+			ulTimingWheelOccupied[ uxLevel ] = 0UL;
+		}
 	}
-	#endif
+	#endif /* configUSE_TIMING_WHEEL */
 
-	return xReturn;
+	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
+	using list2. */
+	pxDelayedTaskList = &xDelayedTaskList1;
+	pxOverflowDelayedTaskList = &xDelayedTaskList2;
 }
 /*-----------------------------------------------------------*/
 
-void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+static void prvCheckTasksWaitingTermination( void )
 {
-TCB_t *pxUnblockedTCB;
 
-	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
-	the event flags implementation. */
-	configASSERT( uxSchedulerSuspended != pdFALSE );
+	/** THIS FUNCTION IS CALLED FROM THE RTOS IDLE TASK **/
 
-	/* Store the new item value in the event list. */
-	listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+	#if ( INCLUDE_vTaskDelete == 1 )
+	{
+		TCB_t *pxTCB;
 
-	/* Remove the event list form the event flag.  Interrupts do not access
-	event flags. */
-	pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-	configASSERT( pxUnblockedTCB );
-	( void ) uxListRemove( pxEventListItem );
+		/* uxDeletedTasksWaitingCleanUp is used to prevent taskENTER_CRITICAL()
+		being called too often in the idle task. */
+		while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
+		{
+			taskENTER_CRITICAL();
+			{
+				pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
-	/* Remove the task from the delayed list and add it to the ready list.  The
-	scheduler is suspended so interrupts will not be accessing the ready
-	lists. */
-	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
-	prvAddTaskToReadyList( pxUnblockedTCB );
+				#if( configNUMBER_OF_CORES > 1 )
+				{
+					/* A task deleted while running on another core cannot be
+					freed until that core has switched away from it. */
+					if( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE )
+					{
+						pxTCB = NULL;
+					}
+				}
+				#endif
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
-	{
-		/* The unblocked task has a priority above that of the calling task, so
-		a context switch is required.  This function is called with the
-		scheduler suspended so xYieldPending is set so the context switch
-		occurs immediately that the scheduler is resumed (unsuspended). */
-		xYieldPending = pdTRUE;
-	}
-}
-/*-----------------------------------------------------------*/
+				if( pxTCB != NULL )
+				{
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					--uxCurrentNumberOfTasks;
+					--uxDeletedTasksWaitingCleanUp;
+				}
+			}
+			taskEXIT_CRITICAL();
 
-void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
-{
-	configASSERT( pxTimeOut );
-	taskENTER_CRITICAL();
-	{
-		pxTimeOut->xOverflowCount = xNumOfOverflows;
-		pxTimeOut->xTimeOnEntering = xTickCount;
+			if( pxTCB == NULL )
+			{
+				break;
+			}
+
+			prvDeleteTCB( pxTCB );
+		}
 	}
-	taskEXIT_CRITICAL();
+	#endif /* INCLUDE_vTaskDelete */
 }
 /*-----------------------------------------------------------*/
 
-void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
-{
-	/* For internal use only as it does not use a critical section. */
-	pxTimeOut->xOverflowCount = xNumOfOverflows;
-	pxTimeOut->xTimeOnEntering = xTickCount;
-}
-/*-----------------------------------------------------------*/
+#if( configUSE_TRACE_FACILITY == 1 )
 
-BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut, TickType_t * const pxTicksToWait )
-{
-BaseType_t xReturn;
+	void vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xGetFreeStackSpace, eTaskState eState )
+	{
+	TCB_t *pxTCB;
 
-	configASSERT( pxTimeOut );
-	configASSERT( pxTicksToWait );
+		/* xTask is NULL then get the state of the calling task. */
+		pxTCB = prvGetTCBFromHandle( xTask );
 
-	taskENTER_CRITICAL();
-	{
-		/* Minor optimisation.  The tick count cannot change in this block. */
-		const TickType_t xConstTickCount = xTickCount;
-		const TickType_t xElapsedTime = xConstTickCount - pxTimeOut->xTimeOnEntering;
+		pxTaskStatus->xHandle = ( TaskHandle_t ) pxTCB;
+		pxTaskStatus->pcTaskName = ( const char * ) &( pxTCB->pcTaskName [ 0 ] );
+		pxTaskStatus->uxCurrentPriority = pxTCB->uxPriority;
+		pxTaskStatus->pxStackBase = pxTCB->pxStack;
+		pxTaskStatus->xTaskNumber = pxTCB->uxTCBNumber;
 
-		#if( INCLUDE_xTaskAbortDelay == 1 )
-			if( pxCurrentTCB->ucDelayAborted != ( uint8_t ) pdFALSE )
-			{
-				/* The delay was aborted, which is not the same as a time out,
-				but has the same result. */
-				pxCurrentTCB->ucDelayAborted = pdFALSE;
-				xReturn = pdTRUE;
-			}
-			else
+		#if ( configUSE_MUTEXES == 1 )
+		{
+			pxTaskStatus->uxBasePriority = pxTCB->uxBasePriority;
+		}
+		#else
+		{
+			pxTaskStatus->uxBasePriority = 0;
+		}
 		#endif
 
-		#if ( INCLUDE_vTaskSuspend == 1 )
-			if( *pxTicksToWait == portMAX_DELAY )
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
+		}
+		#else
+		{
+			pxTaskStatus->ulRunTimeCounter = 0;
+		}
+		#endif
+
+		/* Obtaining the task state is a little fiddly, so is only done if the
+		value of eState passed into this function is eInvalid - otherwise the
+		state is just set to whatever is passed in. */
+		if( eState != eInvalid )
+		{
+			if( taskTASK_IS_RUNNING( pxTCB ) != pdFALSE )
 			{
-				/* If INCLUDE_vTaskSuspend is set to 1 and the block time
-				specified is the maximum block time then the task should block
-				indefinitely, and therefore never time out. */
-				xReturn = pdFALSE;
+				pxTaskStatus->eCurrentState = eRunning;
 			}
 			else
-		#endif
+			{
+				pxTaskStatus->eCurrentState = eState;
 
-		if( ( xNumOfOverflows != pxTimeOut->xOverflowCount ) && ( xConstTickCount >= pxTimeOut->xTimeOnEntering ) ) /*lint !e525 Indentation preferred as is to make code within pre-processor directives clearer. */
-		{
-			/* The tick count is greater than the time at which
-			vTaskSetTimeout() was called, but has also overflowed since
-			vTaskSetTimeOut() was called.  It must have wrapped all the way
-			around and gone past again. This passed since vTaskSetTimeout()
-			was called. */
-			xReturn = pdTRUE;
+				#if ( INCLUDE_vTaskSuspend == 1 )
+				{
+					/* If the task is in the suspended list then there is a
+					chance it is actually just blocked indefinitely - so really
+					it should be reported as being in the Blocked state. */
+					if( eState == eSuspended )
+					{
+						vTaskSuspendAll();
+						{
+							if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+							{
+								pxTaskStatus->eCurrentState = eBlocked;
+							}
+						}
+						( void ) xTaskResumeAll();
+					}
+				}
+				#endif /* INCLUDE_vTaskSuspend */
+			}
+		}
+		else
+		{
+			pxTaskStatus->eCurrentState = eTaskGetState( pxTCB );
 		}
-		else if( xElapsedTime < *pxTicksToWait ) /*lint !e961 Explicit casting is only redundant with some compilers, whereas others require it to prevent integer conversion errors. */
+
+		/* Obtaining the stack space takes some time, so the xGetFreeStackSpace
+		parameter is provided to allow it to be skipped. */
+		if( xGetFreeStackSpace != pdFALSE )
 		{
-			/* Not a genuine timeout. Adjust parameters for time remaining. */
-			*pxTicksToWait -= xElapsedTime;
-			vTaskInternalSetTimeOutState( pxTimeOut );
-			xReturn = pdFALSE;
+			#if ( portSTACK_GROWTH > 0 )
+			{
+				pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
+			}
+			#else
+			{
+				pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
+			}
+			#endif
 		}
 		else
 		{
-			*pxTicksToWait = 0;
-			xReturn = pdTRUE;
+			pxTaskStatus->usStackHighWaterMark = 0;
 		}
 	}
-	taskEXIT_CRITICAL();
-
-	return xReturn;
-}
-/*-----------------------------------------------------------*/
 
-void vTaskMissedYield( void )
-{
-	xYieldPending = pdTRUE;
-}
+#endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
-	UBaseType_t uxTaskGetTaskNumber( TaskHandle_t xTask )
+	static UBaseType_t prvListTasksWithinSingleList( TaskStatus_t *pxTaskStatusArray, List_t *pxList, eTaskState eState )
 	{
-	UBaseType_t uxReturn;
-	TCB_t const *pxTCB;
+	configLIST_VOLATILE TCB_t *pxNextTCB, *pxFirstTCB;
+	UBaseType_t uxTask = 0;
 
-		if( xTask != NULL )
+		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
 		{
-			pxTCB = xTask;
-			uxReturn = pxTCB->uxTaskNumber;
+			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+			/* Populate an TaskStatus_t structure within the
+			pxTaskStatusArray array for each task that is referenced from
+			pxList.  See the definition of TaskStatus_t in task.h for the
+			meaning of each TaskStatus_t structure member. */
+			do
+			{
+				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+				vTaskGetInfo( ( TaskHandle_t ) pxNextTCB, &( pxTaskStatusArray[ uxTask ] ), pdTRUE, eState );
+				uxTask++;
+			} while( pxNextTCB != pxFirstTCB );
 		}
 		else
 		{
-			uxReturn = 0U;
+			mtCOVERAGE_TEST_MARKER();
 		}
 
-		return uxReturn;
+		return uxTask;
 	}
 
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
 
-	void vTaskSetTaskNumber( TaskHandle_t xTask, const UBaseType_t uxHandle )
+	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
 	{
-	TCB_t * pxTCB;
+	uint32_t ulCount = 0U;
 
-		if( xTask != NULL )
+		while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
 		{
-			pxTCB = xTask;
-			pxTCB->uxTaskNumber = uxHandle;
+			pucStackByte -= portSTACK_GROWTH;
+			ulCount++;
 		}
-	}
 
-#endif /* configUSE_TRACE_FACILITY */
+		ulCount /= ( uint32_t ) sizeof( StackType_t ); /*lint !e961 Casting is not redundant on smaller architectures. */
 
-/*
- * -----------------------------------------------------------
- * The Idle task.
- * ----------------------------------------------------------
- *
- * The portTASK_FUNCTION() macro is used to allow port/compiler specific
- * language extensions.  The equivalent prototype for this function is:
- *
- * void prvIdleTask( void *pvParameters );
- *
- */
-static portTASK_FUNCTION( prvIdleTask, pvParameters )
-{
-	/* Stop warnings. */
-	( void ) pvParameters;
+		return ( configSTACK_DEPTH_TYPE ) ulCount;
+	}
 
-	/** THIS IS THE RTOS IDLE TASK - WHICH IS CREATED AUTOMATICALLY WHEN THE
-	SCHEDULER IS STARTED. **/
+#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) ) */
+/*-----------------------------------------------------------*/
 
-	/* In case a task that has a secure context deletes itself, in which case
-	the idle task is responsible for deleting the task's secure context, if
-	any. */
-	portTASK_CALLS_SECURE_FUNCTIONS();
+#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
 
-	for( ;; )
+	UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
 	{
-		/* See if any tasks have deleted themselves - if so then the idle task
-		is responsible for freeing the deleted task's TCB and stack. */
-		prvCheckTasksWaitingTermination();
+	TCB_t *pxTCB;
+	uint8_t *pucEndOfStack;
+	UBaseType_t uxReturn;
 
-		#if ( configUSE_PREEMPTION == 0 )
-		{
-			/* If we are not using preemption we keep forcing a task switch to
-			see if any other task has become available.  If we are using
-			preemption we don't need to do this as any task becoming available
-			will automatically get the processor anyway. */
-			taskYIELD();
-		}
-		#endif /* configUSE_PREEMPTION */
+		pxTCB = prvGetTCBFromHandle( xTask );
 
-		#if ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) )
+		#if portSTACK_GROWTH < 0
 		{
-			/* When using preemption tasks of equal priority will be
-			timesliced.  If a task that is sharing the idle priority is ready
-			to run then the idle task should yield before the end of the
-			timeslice.
-
-			A critical region is not required here as we are just reading from
-			the list, and an occasional incorrect value will not matter.  If
-			the ready list at the idle priority contains more than one task
-			then a task other than the idle task is ready to execute. */
-			if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) 1 )
-			{
-				taskYIELD();
-			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
+			pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
 		}
-		#endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configIDLE_SHOULD_YIELD == 1 ) ) */
-
-		#if ( configUSE_IDLE_HOOK == 1 )
+		#else
 		{
-			extern void vApplicationIdleHook( void );
-
-			/* Call the user defined function from within the idle task.  This
-			allows the application designer to add background functionality
-			without the overhead of a separate task.
-			NOTE: vApplicationIdleHook() MUST NOT, UNDER ANY CIRCUMSTANCES,
-			CALL A FUNCTION THAT MIGHT BLOCK. */
-			vApplicationIdleHook();
+			pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
 		}
-		#endif /* configUSE_IDLE_HOOK */
-
-		/* This conditional compilation should use inequality to 0, not equality
-		to 1.  This is to ensure portSUPPRESS_TICKS_AND_SLEEP() is called when
-		user defined low power mode	implementations require
-		configUSE_TICKLESS_IDLE to be set to a value other than 1. */
-		#if ( configUSE_TICKLESS_IDLE != 0 )
-		{
-		TickType_t xExpectedIdleTime;
-
-			/* It is not desirable to suspend then resume the scheduler on
-			each iteration of the idle task.  Therefore, a preliminary
-			test of the expected idle time is performed without the
-			scheduler suspended.  The result here is not necessarily
-			valid. */
-			xExpectedIdleTime = prvGetExpectedIdleTime();
-
-			if( xExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
-			{
-				vTaskSuspendAll();
-				{
-					/* Now the scheduler is suspended, the expected idle
-					time can be sampled again, and this time its value can
-					be used. */
-					configASSERT( xNextTaskUnblockTime >= xTickCount );
-					xExpectedIdleTime = prvGetExpectedIdleTime();
+		#endif
 
-					/* Define the following macro to set xExpectedIdleTime to 0
-					if the application does not want
-					portSUPPRESS_TICKS_AND_SLEEP() to be called. */
-					configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( xExpectedIdleTime );
+		uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
 
-					if( xExpectedIdleTime >= configEXPECTED_IDLE_TIME_BEFORE_SLEEP )
-					{
-						traceLOW_POWER_IDLE_BEGIN();
-						portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime );
-						traceLOW_POWER_IDLE_END();
-					}
-					else
-					{
-						mtCOVERAGE_TEST_MARKER();
-					}
-				}
-				( void ) xTaskResumeAll();
-			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
-		}
-		#endif /* configUSE_TICKLESS_IDLE */
+		return uxReturn;
 	}
-}
+
+#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
 /*-----------------------------------------------------------*/
 
-#if( configUSE_TICKLESS_IDLE != 0 )
+#if( configUSE_STACK_PROFILER == 1 )
 
-	eSleepModeStatus eTaskConfirmSleepModeStatus( void )
+	static void prvSampleTaskStack( TCB_t *pxTCB )
 	{
-	/* The idle task exists in addition to the application tasks. */
-	const UBaseType_t uxNonApplicationTasks = 1;
-	eSleepModeStatus eReturn = eStandardSleep;
+	const StackType_t *pxStackWord;
+	uint32_t ulUnusedWords, ulWordsToSearch;
 
-		if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 )
+		/* A word only stops holding the fill value, so only the words that
+		still held it when the stack was last sampled are searched, from the
+		end of the stack furthest from its start, and a whole word rather than
+		a byte at a time. */
+		ulWordsToSearch = pxTCB->ulStackDepth - pxTCB->ulStackPeak;
+
+		#if( portSTACK_GROWTH < 0 )
 		{
-			/* A task was made ready while the scheduler was suspended. */
-			eReturn = eAbortSleep;
+			pxStackWord = pxTCB->pxStack;
 		}
-		else if( xYieldPending != pdFALSE )
+		#else
 		{
-			/* A yield was pended while the scheduler was suspended. */
-			eReturn = eAbortSleep;
+			pxStackWord = pxTCB->pxEndOfStack;
 		}
-		else
+		#endif
+
+		for( ulUnusedWords = 0UL; ulUnusedWords < ulWordsToSearch; ulUnusedWords++ )
 		{
-			/* If all the tasks are in the suspended list (which might mean they
-			have an infinite block time rather than actually being suspended)
-			then it is safe to turn all clocks off and just wait for external
-			interrupts. */
-			if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == ( uxCurrentNumberOfTasks - uxNonApplicationTasks ) )
-			{
-				eReturn = eNoTasksWaitingTimeout;
-			}
-			else
+			if( *pxStackWord != tskSTACK_FILL_WORD )
 			{
-				mtCOVERAGE_TEST_MARKER();
+				break;
 			}
-		}
-
-		return eReturn;
-	}
-
-#endif /* configUSE_TICKLESS_IDLE */
-/*-----------------------------------------------------------*/
-
-#if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
 
-	void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet, BaseType_t xIndex, void *pvValue )
-	{
-	TCB_t *pxTCB;
-
-		if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
-		{
-			pxTCB = prvGetTCBFromHandle( xTaskToSet );
-			pxTCB->pvThreadLocalStoragePointers[ xIndex ] = pvValue;
+			pxStackWord -= portSTACK_GROWTH;
 		}
-	}
-
-#endif /* configNUM_THREAD_LOCAL_STORAGE_POINTERS */
-/*-----------------------------------------------------------*/
 
-#if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
+		pxTCB->ulStackPeak = pxTCB->ulStackDepth - ulUnusedWords;
+	}
+	/*-----------------------------------------------------------*/
 
-	void *pvTaskGetThreadLocalStoragePointer( TaskHandle_t xTaskToQuery, BaseType_t xIndex )
+	static void prvSampleStackUsage( void )
 	{
-	void *pvReturn = NULL;
 	TCB_t *pxTCB;
 
-		if( xIndex < configNUM_THREAD_LOCAL_STORAGE_POINTERS )
+		/* The tick count is read outside of the critical section or the
+		suspension of the scheduler so most passes through the idle task do
+		not need either. */
+		if( ( xTickCount - xLastStackSampleTime ) >= ( TickType_t ) configSTACK_PROFILER_SAMPLE_PERIOD )
 		{
-			pxTCB = prvGetTCBFromHandle( xTaskToQuery );
-			pvReturn = pxTCB->pvThreadLocalStoragePointers[ xIndex ];
+			taskENTER_STACK_SAMPLE();
+			{
+				xLastStackSampleTime = xTickCount;
+
+				if( listLIST_IS_EMPTY( &xStackProfiledTasks ) == pdFALSE )
+				{
+					/* Sample the task at the head of the list, then move it to
+					the end so the tasks are sampled in turn. */
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &xStackProfiledTasks ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					( void ) uxListRemove( &( pxTCB->xStackProfileListItem ) );
+					vListInsertEnd( &xStackProfiledTasks, &( pxTCB->xStackProfileListItem ) );
+
+					prvSampleTaskStack( pxTCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			taskEXIT_STACK_SAMPLE();
 		}
 		else
 		{
-			pvReturn = NULL;
+			mtCOVERAGE_TEST_MARKER();
 		}
-
-		return pvReturn;
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* configNUM_THREAD_LOCAL_STORAGE_POINTERS */
-/*-----------------------------------------------------------*/
-
-#if ( portUSING_MPU_WRAPPERS == 1 )
-
-	void vTaskAllocateMPURegions( TaskHandle_t xTaskToModify, const MemoryRegion_t * const xRegions )
+	UBaseType_t uxTaskGetStackProfile( TaskStackProfile_t * const pxProfileArray, const UBaseType_t uxArraySize )
 	{
+	UBaseType_t uxTask = ( UBaseType_t ) 0U;
+	const ListItem_t *pxListItem;
+	const ListItem_t *pxListEnd;
 	TCB_t *pxTCB;
 
-		/* If null is passed in here then we are modifying the MPU settings of
-		the calling task. */
-		pxTCB = prvGetTCBFromHandle( xTaskToModify );
-
-		vPortStoreTaskMPUSettings( &( pxTCB->xMPUSettings ), xRegions, NULL, 0 );
-	}
-
-#endif /* portUSING_MPU_WRAPPERS */
-/*-----------------------------------------------------------*/
-
-static void prvInitialiseTaskLists( void )
-{
-UBaseType_t uxPriority;
+		configASSERT( ( pxProfileArray != NULL ) || ( uxArraySize == ( UBaseType_t ) 0U ) );
 
-	for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
-	{
-		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
-	}
+		/* Only the peaks recorded by the idle task are copied, so the time
+		the critical section is held for does not depend on the size of the
+		stacks. */
+		taskENTER_CRITICAL();
+		{
+			pxListEnd = listGET_END_MARKER( &xStackProfiledTasks );
 
-	vListInitialise( &xDelayedTaskList1 );
-	vListInitialise( &xDelayedTaskList2 );
-	vListInitialise( &xPendingReadyList );
+			for( pxListItem = listGET_HEAD_ENTRY( &xStackProfiledTasks ); ( pxListItem != pxListEnd ) && ( uxTask < uxArraySize ); pxListItem = listGET_NEXT( pxListItem ) )
+			{
+				pxTCB = listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
-	#if ( INCLUDE_vTaskDelete == 1 )
-	{
-		vListInitialise( &xTasksWaitingTermination );
-	}
-	#endif /* INCLUDE_vTaskDelete */
+				pxProfileArray[ uxTask ].xHandle = ( TaskHandle_t ) pxTCB;
+				pxProfileArray[ uxTask ].pcTaskName = ( const char * ) &( pxTCB->pcTaskName[ 0 ] );
+				pxProfileArray[ uxTask ].ulStackDepth = pxTCB->ulStackDepth;
+				pxProfileArray[ uxTask ].ulPeakStackUse = pxTCB->ulStackPeak;
+				pxProfileArray[ uxTask ].ulRecommendedStackDepth = pxTCB->ulStackPeak + ( ( ( pxTCB->ulStackPeak * ( uint32_t ) configSTACK_PROFILER_MARGIN_PERCENT ) + 99UL ) / 100UL );
+				uxTask++;
+			}
+		}
+		taskEXIT_CRITICAL();
 
-	#if ( INCLUDE_vTaskSuspend == 1 )
-	{
-		vListInitialise( &xSuspendedTaskList );
+		return uxTask;
 	}
-	#endif /* INCLUDE_vTaskSuspend */
 
-	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-	using list2. */
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
-}
+#endif /* configUSE_STACK_PROFILER */
 /*-----------------------------------------------------------*/
 
-static void prvCheckTasksWaitingTermination( void )
-{
-
-	/** THIS FUNCTION IS CALLED FROM THE RTOS IDLE TASK **/
+#if ( INCLUDE_vTaskDelete == 1 )
 
-	#if ( INCLUDE_vTaskDelete == 1 )
+	static void prvDeleteTCB( TCB_t *pxTCB )
 	{
-		TCB_t *pxTCB;
+		/* This call is required specifically for the TriCore port.  It must be
+		above the vPortFree() calls.  The call is also used by ports/demos that
+		want to allocate and clean RAM statically. */
+		portCLEAN_UP_TCB( pxTCB );
 
-		/* uxDeletedTasksWaitingCleanUp is used to prevent taskENTER_CRITICAL()
-		being called too often in the idle task. */
-		while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
+		/* Free up the memory allocated by the scheduler for the task.  It is up
+		to the task to free any memory allocated at the application level. */
+		#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		{
-			taskENTER_CRITICAL();
+			_reclaim_reent( &( pxTCB->xNewLib_reent ) );
+		}
+		#endif /* configUSE_NEWLIB_REENTRANT */
+
+		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+		{
+			/* The task can only have been allocated dynamically - free both
+			the stack and TCB, unless they are kept for reuse. */
+			if( taskRECYCLE_TCB( pxTCB ) == pdFALSE )
 			{
-				pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				--uxCurrentNumberOfTasks;
-				--uxDeletedTasksWaitingCleanUp;
+				vPortFree( pxTCB->pxStack );
+				vPortFree( pxTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+		{
+			/* The task could have been allocated statically or dynamically, so
+			check what was statically allocated before trying to free the
+			memory. */
+			if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+			{
+				/* Both the stack and TCB were allocated dynamically, so both
+				must be freed, unless they are kept for reuse. */
+				if( taskRECYCLE_TCB( pxTCB ) == pdFALSE )
+				{
+					vPortFree( pxTCB->pxStack );
+					vPortFree( pxTCB );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+			{
+				/* Only the stack was statically allocated, so the TCB is the
+				only memory that must be freed. */
+				vPortFree( pxTCB );
+			}
+			else
+			{
+				/* Neither the stack nor the TCB were allocated dynamically, so
+				nothing needs to be freed. */
+				configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB	);
+				mtCOVERAGE_TEST_MARKER();
 			}
-			taskEXIT_CRITICAL();
-
-			prvDeleteTCB( pxTCB );
 		}
+		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 	}
-	#endif /* INCLUDE_vTaskDelete */
-}
+
+#endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( configUSE_TASK_POOL == 1 )
 
-	void vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t *pxTaskStatus, BaseType_t xGetFreeStackSpace, eTaskState eState )
+	static TCB_t *prvTakeFromTaskPool( const configSTACK_DEPTH_TYPE usStackDepth )
 	{
-	TCB_t *pxTCB;
+	TCB_t *pxTCB = NULL;
+	UBaseType_t uxSizeClass;
 
-		/* xTask is NULL then get the state of the calling task. */
-		pxTCB = prvGetTCBFromHandle( xTask );
+		taskENTER_CRITICAL();
+		{
+			for( uxSizeClass = ( UBaseType_t ) 0U; uxSizeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES; uxSizeClass++ )
+			{
+				if( usTaskPoolStackDepths[ uxSizeClass ] == usStackDepth )
+				{
+					if( listLIST_IS_EMPTY( &( xTaskPools[ uxSizeClass ] ) ) == pdFALSE )
+					{
+						pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &( xTaskPools[ uxSizeClass ] ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 
-		pxTaskStatus->xHandle = ( TaskHandle_t ) pxTCB;
-		pxTaskStatus->pcTaskName = ( const char * ) &( pxTCB->pcTaskName [ 0 ] );
-		pxTaskStatus->uxCurrentPriority = pxTCB->uxPriority;
-		pxTaskStatus->pxStackBase = pxTCB->pxStack;
-		pxTaskStatus->xTaskNumber = pxTCB->uxTCBNumber;
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
 
-		#if ( configUSE_MUTEXES == 1 )
-		{
-			pxTaskStatus->uxBasePriority = pxTCB->uxBasePriority;
-		}
-		#else
-		{
-			pxTaskStatus->uxBasePriority = 0;
+			if( pxTCB != NULL )
+			{
+				ulTaskPoolHits++;
+			}
+			else
+			{
+				ulTaskPoolMisses++;
+			}
 		}
-		#endif
+		taskEXIT_CRITICAL();
 
-		#if ( configGENERATE_RUN_TIME_STATS == 1 )
-		{
-			pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
-		}
-		#else
-		{
-			pxTaskStatus->ulRunTimeCounter = 0;
-		}
-		#endif
+		return pxTCB;
+	}
+	/*-----------------------------------------------------------*/
 
-		/* Obtaining the task state is a little fiddly, so is only done if the
-		value of eState passed into this function is eInvalid - otherwise the
-		state is just set to whatever is passed in. */
-		if( eState != eInvalid )
+	static BaseType_t prvAddToTaskPool( TCB_t *pxTCB )
+	{
+	UBaseType_t uxSizeClass, uxFreeClass = ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES;
+	BaseType_t xPooled = pdFALSE;
+
+		taskENTER_CRITICAL();
 		{
-			if( pxTCB == pxCurrentTCB )
+			/* Look for the list that holds tasks of the same stack depth,
+			noting the first list that is free to take the stack depth on in
+			case there is none. */
+			for( uxSizeClass = ( UBaseType_t ) 0U; uxSizeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES; uxSizeClass++ )
 			{
-				pxTaskStatus->eCurrentState = eRunning;
+				if( usTaskPoolStackDepths[ uxSizeClass ] == pxTCB->usStackDepth )
+				{
+					uxFreeClass = uxSizeClass;
+					break;
+				}
+				else if( ( uxFreeClass == ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES ) &&
+						 ( listLIST_IS_EMPTY( &( xTaskPools[ uxSizeClass ] ) ) != pdFALSE ) )
+				{
+					uxFreeClass = uxSizeClass;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( ( uxFreeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES ) &&
+				( listCURRENT_LIST_LENGTH( &( xTaskPools[ uxFreeClass ] ) ) < ( UBaseType_t ) configTASK_POOL_TASKS_PER_SIZE_CLASS ) )
+			{
+				usTaskPoolStackDepths[ uxFreeClass ] = pxTCB->usStackDepth;
+				vListInsertEnd( &( xTaskPools[ uxFreeClass ] ), &( pxTCB->xStateListItem ) );
+				ulTaskPoolRecycled++;
+				xPooled = pdTRUE;
 			}
 			else
 			{
-				pxTaskStatus->eCurrentState = eState;
+				ulTaskPoolOverflows++;
+			}
+		}
+		taskEXIT_CRITICAL();
 
-				#if ( INCLUDE_vTaskSuspend == 1 )
+		return xPooled;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxTaskReleaseTaskPool( void )
+	{
+	TCB_t *pxTCB;
+	UBaseType_t uxSizeClass, uxReleased = ( UBaseType_t ) 0U;
+
+		for( uxSizeClass = ( UBaseType_t ) 0U; uxSizeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES; uxSizeClass++ )
+		{
+			do
+			{
+				taskENTER_CRITICAL();
 				{
-					/* If the task is in the suspended list then there is a
-					chance it is actually just blocked indefinitely - so really
-					it should be reported as being in the Blocked state. */
-					if( eState == eSuspended )
+					if( listLIST_IS_EMPTY( &( xTaskPools[ uxSizeClass ] ) ) == pdFALSE )
 					{
-						vTaskSuspendAll();
-						{
-							if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
-							{
-								pxTaskStatus->eCurrentState = eBlocked;
-							}
-						}
-						( void ) xTaskResumeAll();
+						pxTCB = listGET_OWNER_OF_HEAD_ENTRY( &( xTaskPools[ uxSizeClass ] ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					}
+					else
+					{
+						pxTCB = NULL;
 					}
 				}
-				#endif /* INCLUDE_vTaskSuspend */
-			}
-		}
-		else
-		{
-			pxTaskStatus->eCurrentState = eTaskGetState( pxTCB );
+				taskEXIT_CRITICAL();
+
+				/* The memory is freed outside of the critical section. */
+				if( pxTCB != NULL )
+				{
+					vPortFree( pxTCB->pxStack );
+					vPortFree( pxTCB );
+					uxReleased++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			} while( pxTCB != NULL );
 		}
 
-		/* Obtaining the stack space takes some time, so the xGetFreeStackSpace
-		parameter is provided to allow it to be skipped. */
-		if( xGetFreeStackSpace != pdFALSE )
+		return uxReleased;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskGetTaskPoolStats( TaskPoolStats_t *pxStats )
+	{
+	UBaseType_t uxSizeClass;
+
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
 		{
-			#if ( portSTACK_GROWTH > 0 )
-			{
-				pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxEndOfStack );
-			}
-			#else
+			pxStats->ulHits = ulTaskPoolHits;
+			pxStats->ulMisses = ulTaskPoolMisses;
+			pxStats->ulRecycled = ulTaskPoolRecycled;
+			pxStats->ulOverflows = ulTaskPoolOverflows;
+			pxStats->uxPooledTasks = ( UBaseType_t ) 0U;
+
+			for( uxSizeClass = ( UBaseType_t ) 0U; uxSizeClass < ( UBaseType_t ) configTASK_POOL_SIZE_CLASSES; uxSizeClass++ )
 			{
-				pxTaskStatus->usStackHighWaterMark = prvTaskCheckFreeStackSpace( ( uint8_t * ) pxTCB->pxStack );
+				pxStats->uxPooledTasks += listCURRENT_LIST_LENGTH( &( xTaskPools[ uxSizeClass ] ) );
 			}
-			#endif
-		}
-		else
-		{
-			pxTaskStatus->usStackHighWaterMark = 0;
 		}
+		taskEXIT_CRITICAL();
 	}
 
-#endif /* configUSE_TRACE_FACILITY */
+#endif /* configUSE_TASK_POOL */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if( configGENERATE_EXECUTION_STATS == 1 )
 
-	static UBaseType_t prvListTasksWithinSingleList( TaskStatus_t *pxTaskStatusArray, List_t *pxList, eTaskState eState )
+	static void prvExecutionStatsSwitchOut( TCB_t * const pxTCB, const uint64_t ullNowNs )
 	{
-	configLIST_VOLATILE TCB_t *pxNextTCB, *pxFirstTCB;
-	UBaseType_t uxTask = 0;
+		/* Make the sequence number odd until the update is complete, so
+		vTaskGetExecutionStats() does not copy a partial update. */
+		pxTCB->ulStatsSequence++;
+		portMEMORY_BARRIER();
 
-		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 0 )
+		/* The guard against negative values protects against a clock that
+		is not monotonic across cores. */
+		if( ullNowNs > pxTCB->ullSwitchedInNs )
 		{
-			listGET_OWNER_OF_NEXT_ENTRY( pxFirstTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-
-			/* Populate an TaskStatus_t structure within the
-			pxTaskStatusArray array for each task that is referenced from
-			pxList.  See the definition of TaskStatus_t in task.h for the
-			meaning of each TaskStatus_t structure member. */
-			do
-			{
-				listGET_OWNER_OF_NEXT_ENTRY( pxNextTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-				vTaskGetInfo( ( TaskHandle_t ) pxNextTCB, &( pxTaskStatusArray[ uxTask ] ), pdTRUE, eState );
-				uxTask++;
-			} while( pxNextTCB != pxFirstTCB );
+			pxTCB->ullRunTimeNs += ( ullNowNs - pxTCB->ullSwitchedInNs );
 		}
 		else
 		{
 			mtCOVERAGE_TEST_MARKER();
 		}
 
-		return uxTask;
-	}
-
-#endif /* configUSE_TRACE_FACILITY */
-/*-----------------------------------------------------------*/
-
-#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) )
-
-	static configSTACK_DEPTH_TYPE prvTaskCheckFreeStackSpace( const uint8_t * pucStackByte )
-	{
-	uint32_t ulCount = 0U;
+		pxTCB->xStatsRunning = pdFALSE;
 
-		while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
+		/* A task that is still in the ready list of its priority has been
+		preempted, or has yielded, so is switched out without having chosen to
+		stop running.  So has a task that has used its budget. */
+		if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
 		{
-			pucStackByte -= portSTACK_GROWTH;
-			ulCount++;
+			pxTCB->ulPreemptions++;
+		}
+		#if( configUSE_TASK_BUDGETS == 1 )
+			else if( taskIS_THROTTLED( pxTCB ) != pdFALSE )
+			{
+				pxTCB->ulPreemptions++;
+			}
+		#endif
+		else
+		{
+			pxTCB->ulVoluntaryBlocks++;
 		}
 
-		ulCount /= ( uint32_t ) sizeof( StackType_t ); /*lint !e961 Casting is not redundant on smaller architectures. */
-
-		return ( configSTACK_DEPTH_TYPE ) ulCount;
+		portMEMORY_BARRIER();
+		pxTCB->ulStatsSequence++;
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_uxTaskGetStackHighWaterMark == 1 ) ) */
-/*-----------------------------------------------------------*/
+	static void prvExecutionStatsSwitchIn( TCB_t * const pxTCB, const uint64_t ullNowNs )
+	{
+		pxTCB->ulStatsSequence++;
+		portMEMORY_BARRIER();
 
-#if ( INCLUDE_uxTaskGetStackHighWaterMark == 1 )
+		pxTCB->ullSwitchedInNs = ullNowNs;
+		pxTCB->xStatsRunning = pdTRUE;
+		pxTCB->ulContextSwitches++;
 
-	UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask )
+		portMEMORY_BARRIER();
+		pxTCB->ulStatsSequence++;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTaskGetExecutionStats( TaskHandle_t xTask, TaskExecutionStats_t *pxStats )
 	{
 	TCB_t *pxTCB;
-	uint8_t *pucEndOfStack;
-	UBaseType_t uxReturn;
+	uint32_t ulSequence;
+	uint64_t ullSwitchedInNs;
+
+		configASSERT( pxStats );
 
+		/* If null is passed in here then the calling task is being
+		queried. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
-		#if portSTACK_GROWTH < 0
-		{
-			pucEndOfStack = ( uint8_t * ) pxTCB->pxStack;
-		}
-		#else
+		/* No critical section is used, so the statistics are copied again
+		if a context switch updated them part way through the copy.  An
+		update only takes a few instructions, so another core making one
+		only holds the copy up briefly.  The copy must not be taken from an
+		interrupt that can nest within the context switch - on a single core
+		the update it interrupted could not complete until it returned, so
+		it would wait for the sequence number to become even for ever. */
+		do
 		{
-			pucEndOfStack = ( uint8_t * ) pxTCB->pxEndOfStack;
-		}
-		#endif
-
-		uxReturn = ( UBaseType_t ) prvTaskCheckFreeStackSpace( pucEndOfStack );
-
-		return uxReturn;
-	}
+			do
+			{
+				ulSequence = pxTCB->ulStatsSequence;
+			} while( ( ulSequence & 1UL ) != 0UL );
 
-#endif /* INCLUDE_uxTaskGetStackHighWaterMark */
-/*-----------------------------------------------------------*/
+			portMEMORY_BARRIER();
 
-#if ( INCLUDE_vTaskDelete == 1 )
+			pxStats->ullRunTimeNs = pxTCB->ullRunTimeNs;
+			pxStats->ulContextSwitches = pxTCB->ulContextSwitches;
+			pxStats->ulPreemptions = pxTCB->ulPreemptions;
+			pxStats->ulVoluntaryBlocks = pxTCB->ulVoluntaryBlocks;
+			pxStats->xRunning = pxTCB->xStatsRunning;
+			ullSwitchedInNs = pxTCB->ullSwitchedInNs;
 
-	static void prvDeleteTCB( TCB_t *pxTCB )
-	{
-		/* This call is required specifically for the TriCore port.  It must be
-		above the vPortFree() calls.  The call is also used by ports/demos that
-		want to allocate and clean RAM statically. */
-		portCLEAN_UP_TCB( pxTCB );
+			/* Taken before the sequence number is checked, so the task was
+			still running at this time if xRunning is pdTRUE. */
+			pxStats->ullSnapshotTimeNs = portGET_RUN_TIME_NS();
 
-		/* Free up the memory allocated by the scheduler for the task.  It is up
-		to the task to free any memory allocated at the application level. */
-		#if ( configUSE_NEWLIB_REENTRANT == 1 )
-		{
-			_reclaim_reent( &( pxTCB->xNewLib_reent ) );
-		}
-		#endif /* configUSE_NEWLIB_REENTRANT */
+			portMEMORY_BARRIER();
+		} while( pxTCB->ulStatsSequence != ulSequence );
 
-		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+		/* Include the time the task has been running for since it was last
+		switched in. */
+		if( ( pxStats->xRunning != pdFALSE ) && ( pxStats->ullSnapshotTimeNs > ullSwitchedInNs ) )
 		{
-			/* The task can only have been allocated dynamically - free both
-			the stack and TCB. */
-			vPortFree( pxTCB->pxStack );
-			vPortFree( pxTCB );
+			pxStats->ullRunTimeNs += ( pxStats->ullSnapshotTimeNs - ullSwitchedInNs );
 		}
-		#elif( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+		else
 		{
-			/* The task could have been allocated statically or dynamically, so
-			check what was statically allocated before trying to free the
-			memory. */
-			if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
-			{
-				/* Both the stack and TCB were allocated dynamically, so both
-				must be freed. */
-				vPortFree( pxTCB->pxStack );
-				vPortFree( pxTCB );
-			}
-			else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
-			{
-				/* Only the stack was statically allocated, so the TCB is the
-				only memory that must be freed. */
-				vPortFree( pxTCB );
-			}
-			else
-			{
-				/* Neither the stack nor the TCB were allocated dynamically, so
-				nothing needs to be freed. */
-				configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB	);
-				mtCOVERAGE_TEST_MARKER();
-			}
+			mtCOVERAGE_TEST_MARKER();
 		}
-		#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 	}
 
-#endif /* INCLUDE_vTaskDelete */
+#endif /* configGENERATE_EXECUTION_STATS */
 /*-----------------------------------------------------------*/
 
 static void prvResetNextTaskUnblockTime( void )
 {
 TCB_t *pxTCB;
 
+	#if( configUSE_TIMING_WHEEL == 1 )
+	TickType_t xEventTime;
+	#endif
+
 	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
 	{
-		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-		the maximum possible value so it is	extremely unlikely that the
-		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-		there is an item in the delayed list. */
-		xNextTaskUnblockTime = portMAX_DELAY;
+		#if( configUSE_TIMING_WHEEL == 1 )
+		{
+			/* The tasks on the wheel are not sorted, so the tick count must
+			next be checked when the next slot has to be processed.  That is
+			not necessarily the time a task wakes, only the earliest it can. */
+			if( prvGetNextTimingWheelEvent( &xEventTime ) != pdFALSE )
+			{
+				xNextTaskUnblockTime = xEventTime;
+			}
+			else
+			{
+				xNextTaskUnblockTime = portMAX_DELAY;
+			}
+		}
+		#else
+		{
+			/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+			the maximum possible value so it is	extremely unlikely that the
+			if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+			there is an item in the delayed list. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		#endif
 	}
 	else
 	{
@@ -3814,6 +6458,195 @@ TCB_t *pxTCB;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMING_WHEEL == 1 )
+
+	static UBaseType_t prvLowestSetBit( uint32_t ulBits )
+	{
+	/* Maps the top five bits of a single set bit multiplied by the de Bruijn
+	sequence 0x077CB531 to the position of the bit. */
+	static const uint8_t ucBitPositions[ 32 ] =
+	{
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+
+		configASSERT( ulBits != 0UL );
+		return ( UBaseType_t ) ucBitPositions[ ( uint32_t ) ( ( ulBits & ( 0UL - ulBits ) ) * 0x077CB531UL ) >> 27 ];
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvAddToTimingWheel( ListItem_t * const pxListItem )
+	{
+	const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxListItem );
+	const TickType_t xDifference = xTimeToWake ^ xTimingWheelTime;
+	TickType_t xEventTime;
+	UBaseType_t uxLevel, uxSlot;
+
+		/* Tasks are only added with wake times at or after the time the wheel
+		has been processed up to. */
+		configASSERT( xTimeToWake >= xTimingWheelTime );
+
+		if( xDifference == ( TickType_t ) 0 )
+		{
+			taskWHEEL_INSERT_END( pxDelayedTaskList, pxListItem );
+			xEventTime = xTimeToWake;
+		}
+		else
+		{
+			/* Use the highest level at which the wake time falls in a
+			different slot from the wheel time.  The task will be moved down to
+			the level below when the wheel time reaches the start of the slot,
+			and so on until the wake time is reached. */
+			uxLevel = taskWHEEL_LEVELS - 1U;
+			while( ( xDifference >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) == ( TickType_t ) 0 )
+			{
+				uxLevel--;
+			}
+
+			uxSlot = ( UBaseType_t ) ( xTimeToWake >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) & ( taskWHEEL_SLOTS - 1U );
+			taskWHEEL_INSERT_END( &( xTimingWheel[ uxLevel ][ uxSlot ] ), pxListItem );
+			ulTimingWheelOccupied[ uxLevel ] |= ( 1UL << uxSlot );
+			xEventTime = xTimeToWake & ( TickType_t ) ~( ( ( TickType_t ) 1 << ( uxLevel * taskWHEEL_SLOT_BITS ) ) - ( TickType_t ) 1 );
+		}
+
+		if( xEventTime < xNextTaskUnblockTime )
+		{
+			xNextTaskUnblockTime = xEventTime;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvGetNextTimingWheelEvent( TickType_t * const pxEventTime )
+	{
+	UBaseType_t uxLevel, uxShift, uxSlot;
+	uint32_t ulCandidates;
+	TickType_t xRangeStart;
+	BaseType_t xFound = pdFALSE;
+
+		/* Any slot at a lower level is processed before any at a higher
+		level, so the first level with a slot that holds a task gives the
+		next event. */
+		for( uxLevel = 0U; ( uxLevel < taskWHEEL_LEVELS ) && ( xFound == pdFALSE ); uxLevel++ )
+		{
+			uxShift = uxLevel * taskWHEEL_SLOT_BITS;
+			uxSlot = ( UBaseType_t ) ( xTimingWheelTime >> uxShift ) & ( taskWHEEL_SLOTS - 1U );
+
+			/* Only the slots after that of the wheel time can hold tasks -
+			the others were emptied when the wheel time reached them. */
+			ulCandidates = ulTimingWheelOccupied[ uxLevel ] & ( uint32_t ) ~( ( 2UL << uxSlot ) - 1UL );
+
+			while( ulCandidates != 0UL )
+			{
+				uxSlot = prvLowestSetBit( ulCandidates );
+
+				if( listLIST_IS_EMPTY( &( xTimingWheel[ uxLevel ][ uxSlot ] ) ) == pdFALSE )
+				{
+					/* The slot is processed when the wheel time reaches the
+					first wake time it can hold. */
+					if( uxLevel == ( taskWHEEL_LEVELS - 1U ) )
+					{
+						xRangeStart = ( TickType_t ) 0;
+					}
+					else
+					{
+						xRangeStart = xTimingWheelTime & ( TickType_t ) ~( ( ( TickType_t ) 1 << ( uxShift + taskWHEEL_SLOT_BITS ) ) - ( TickType_t ) 1 );
+					}
+
+					*pxEventTime = xRangeStart | ( ( TickType_t ) uxSlot << uxShift );
+					xFound = pdTRUE;
+					break;
+				}
+				else
+				{
+					/* The tasks in the slot were removed by other means, for
+					example because the event they were waiting for occurred. */
+					ulTimingWheelOccupied[ uxLevel ] &= ~( 1UL << uxSlot );
+					ulCandidates &= ~( 1UL << uxSlot );
+				}
+			}
+		}
+
+		return xFound;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvAdvanceTimingWheel( const TickType_t xTime )
+	{
+	TickType_t xEventTime;
+	UBaseType_t uxLevel, uxShift, uxSlot;
+	List_t *pxSlot;
+	ListItem_t *pxListItem;
+
+		/* Only the times at which a slot has to be processed are visited, so
+		a jump of many ticks, as made when leaving tickless idle, costs no more
+		than one. */
+		while( ( prvGetNextTimingWheelEvent( &xEventTime ) != pdFALSE ) && ( xEventTime <= xTime ) )
+		{
+			xTimingWheelTime = xEventTime;
+
+			/* Move the tasks out of every slot whose range starts at the new
+			wheel time.  The highest level is emptied first, and tasks are
+			moved in the order they were added, so tasks with the same wake
+			time reach pxDelayedTaskList in the order they were delayed. */
+			uxLevel = taskWHEEL_LEVELS;
+			do
+			{
+				uxLevel--;
+				uxShift = uxLevel * taskWHEEL_SLOT_BITS;
+
+				if( ( xTimingWheelTime & ( ( ( TickType_t ) 1 << uxShift ) - ( TickType_t ) 1 ) ) == ( TickType_t ) 0 )
+				{
+					uxSlot = ( UBaseType_t ) ( xTimingWheelTime >> uxShift ) & ( taskWHEEL_SLOTS - 1U );
+
+					if( ( ulTimingWheelOccupied[ uxLevel ] & ( 1UL << uxSlot ) ) != 0UL )
+					{
+						ulTimingWheelOccupied[ uxLevel ] &= ~( 1UL << uxSlot );
+						pxSlot = &( xTimingWheel[ uxLevel ][ uxSlot ] );
+
+						while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+						{
+							pxListItem = listGET_HEAD_ENTRY( pxSlot );
+							( void ) uxListRemove( pxListItem );
+							prvAddToTimingWheel( pxListItem );
+						}
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			} while( uxLevel > 0U );
+		}
+
+		xTimingWheelTime = xTime;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvPlaceOverflowedTasksOnTimingWheel( void )
+	{
+	ListItem_t *pxListItem;
+
+		xTimingWheelTime = ( TickType_t ) 0;
+
+		while( listLIST_IS_EMPTY( pxOverflowDelayedTaskList ) == pdFALSE )
+		{
+			pxListItem = listGET_HEAD_ENTRY( pxOverflowDelayedTaskList );
+			( void ) uxListRemove( pxListItem );
+			prvAddToTimingWheel( pxListItem );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMING_WHEEL */
+
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
 
 	TaskHandle_t xTaskGetCurrentTaskHandle( void )
@@ -3828,35 +6661,70 @@ TCB_t *pxTCB;
 		return xReturn;
 	}
 
-#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
+#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+
+	BaseType_t xTaskGetSchedulerState( void )
+	{
+	BaseType_t xReturn;
+
+		if( xSchedulerRunning == pdFALSE )
+		{
+			xReturn = taskSCHEDULER_NOT_STARTED;
+		}
+		else
+		{
+			/* Suspended by another core only delays this core until the
+			scheduler is resumed. */
+			if( prvSchedulerSuspendedOnThisCore() == pdFALSE )
+			{
+				xReturn = taskSCHEDULER_RUNNING;
+			}
+			else
+			{
+				xReturn = taskSCHEDULER_SUSPENDED;
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) */
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+#if( ( configNUMBER_OF_CORES > 1 ) && ( ( configASSERT_DEFINED == 1 ) || ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) )
 
-	BaseType_t xTaskGetSchedulerState( void )
+	static BaseType_t prvSchedulerSuspendedOnThisCore( void )
 	{
 	BaseType_t xReturn;
 
-		if( xSchedulerRunning == pdFALSE )
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 		{
-			xReturn = taskSCHEDULER_NOT_STARTED;
+			xReturn = pdFALSE;
 		}
 		else
 		{
-			if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+			/* See xSchedulerSuspendedCore for why reading it without the task
+			lock is safe.  The barrier keeps it from being read before
+			uxSchedulerSuspended. */
+			portMEMORY_BARRIER();
+
+			if( xSchedulerSuspendedCore == portGET_CORE_ID() )
 			{
-				xReturn = taskSCHEDULER_RUNNING;
+				xReturn = pdTRUE;
 			}
 			else
 			{
-				xReturn = taskSCHEDULER_SUSPENDED;
+				xReturn = pdFALSE;
 			}
 		}
 
 		return xReturn;
 	}
 
-#endif /* ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) */
+#endif /* configNUMBER_OF_CORES */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_MUTEXES == 1 )
@@ -3913,6 +6781,12 @@ TCB_t *pxTCB;
 
 				traceTASK_PRIORITY_INHERIT( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
 
+				#if( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 )
+				{
+					prvPropagateInheritedPriority( pxMutexHolderTCB );
+				}
+				#endif
+
 				/* Inheritance occurred. */
 				xReturn = pdTRUE;
 			}
@@ -4108,16 +6982,158 @@ TCB_t *pxTCB;
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
+
+					#if( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 )
+					{
+						prvPropagateInheritedPriority( pxTCB );
+					}
+					#endif
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+
+	static void prvPropagateInheritedPriority( TCB_t *pxTCB )
+	{
+	UBaseType_t uxLink, uxPriorityToUse;
+	List_t *pxMutexEventList;
+	TCB_t *pxHolderTCB;
+
+		/* pxTCB holds a mutex and its priority has just changed.  Walk the
+		chain of tasks that are blocked on a mutex held by the next task in
+		the chain, setting the priority of each holder to the greater of its
+		base priority and the priority of the highest priority task waiting
+		for its mutex.  The walk is bounded by
+		configPRIORITY_INHERITANCE_CHAIN_DEPTH, counting the holder whose
+		priority has already been changed, as the chain is only limited by the
+		number of mutexes and can be a cycle if the tasks have deadlocked.
+		Must be called from a critical section. */
+		for( uxLink = ( UBaseType_t ) 1; ( uxLink < ( UBaseType_t ) configPRIORITY_INHERITANCE_CHAIN_DEPTH ) && ( pxTCB != NULL ); uxLink++ )
+		{
+			pxHolderTCB = NULL;
+
+			/* pvBlockedOnMutex is not cleared until the task runs again, so
+			the task is only still blocked on that mutex if its event list item
+			is in an event list.  Once unblocked the item is either in no list
+			or in the pending ready list. */
+			pxMutexEventList = ( List_t * ) listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+			if( ( pxTCB->pvBlockedOnMutex != NULL ) && ( pxMutexEventList != NULL ) && ( pxMutexEventList != &xPendingReadyList ) )
+			{
+				/* The event list is ordered by priority, so the mutex is
+				given to the highest priority task waiting for it.  Move the
+				task to the position that matches its new priority. */
+				listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+				vListInsert( pxMutexEventList, &( pxTCB->xEventListItem ) );
+
+				/* The mutex can be without a holder for the short time
+				between it being given and the task it was given to running. */
+				pxHolderTCB = xQueueGetMutexHolderFromISR( ( QueueHandle_t ) pxTCB->pvBlockedOnMutex );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxHolderTCB != NULL )
+			{
+				uxPriorityToUse = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxMutexEventList );
+
+				if( uxPriorityToUse < pxHolderTCB->uxBasePriority )
+				{
+					uxPriorityToUse = pxHolderTCB->uxBasePriority;
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
+
+				/* As in vTaskPriorityDisinheritAfterTimeout(), the priority
+				of a holder of more than one mutex is only ever raised, as the
+				other mutexes may be the reason for its current priority. */
+				if( ( uxPriorityToUse > pxHolderTCB->uxPriority ) ||
+					( ( uxPriorityToUse < pxHolderTCB->uxPriority ) && ( pxHolderTCB->uxMutexesHeld == ( UBaseType_t ) 1 ) ) )
+				{
+					prvSetInheritedPriority( pxHolderTCB, uxPriorityToUse );
+				}
+				else
+				{
+					/* The rest of the chain is unaffected. */
+					pxHolderTCB = NULL;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			pxTCB = pxHolderTCB;
+		}
+	}
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_MUTEXES == 1 ) && ( ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) || ( configUSE_PRIORITY_CEILING_MUTEXES == 1 ) ) )
+
+	static void prvSetInheritedPriority( TCB_t * const pxTCB, const UBaseType_t uxNewPriority )
+	{
+	const UBaseType_t uxPriorityUsedOnEntry = pxTCB->uxPriority;
+
+		if( uxNewPriority > uxPriorityUsedOnEntry )
+		{
+			traceTASK_PRIORITY_INHERIT( pxTCB, uxNewPriority );
+		}
+		else
+		{
+			traceTASK_PRIORITY_DISINHERIT( pxTCB, uxNewPriority );
+		}
+
+		pxTCB->uxPriority = uxNewPriority;
+
+		/* Only reset the event list item value if the value is not being used
+		for anything else. */
+		if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+		{
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* There is one ready list per priority, so a task in the Ready state
+		has to be moved. */
+		if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+		{
+			if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+			{
+				taskRESET_READY_PRIORITY( uxPriorityUsedOnEntry );
 			}
 			else
 			{
 				mtCOVERAGE_TEST_MARKER();
 			}
+
+			prvAddTaskToReadyList( pxTCB );
 		}
 		else
 		{
@@ -4128,6 +7144,105 @@ TCB_t *pxTCB;
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_MUTEXES == 1 ) && ( configPRIORITY_INHERITANCE_CHAIN_DEPTH > 1 ) )
+
+	void vTaskSetBlockedOnMutex( void *pvMutex )
+	{
+		/* Only read by prvPropagateInheritedPriority() once the calling task
+		is in the event list of the mutex, so no critical section is needed. */
+		pxCurrentTCB->pvBlockedOnMutex = pvMutex;
+	}
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	UBaseType_t uxTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority )
+	{
+	TCB_t * const pxTCB = pxCurrentTCB;
+	const UBaseType_t uxPriorityBeforeCeiling = pxTCB->uxPriority;
+
+		/* Called from a critical section by the task that has just taken the
+		mutex.  A task whose priority is above the ceiling could be blocked by
+		a task holding the mutex at the ceiling, so the ceiling is wrong. */
+		configASSERT( pxTCB->uxBasePriority <= uxCeilingPriority );
+
+		/* The priority is not lowered if the task already runs above the
+		ceiling, because it holds another mutex. */
+		if( uxPriorityBeforeCeiling < uxCeilingPriority )
+		{
+			prvSetInheritedPriority( pxTCB, uxCeilingPriority );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxPriorityBeforeCeiling;
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PRIORITY_CEILING_MUTEXES == 1 )
+
+	BaseType_t xTaskPriorityRestoreFromCeiling( TaskHandle_t const pxMutexHolder, UBaseType_t uxCeilingPriority, UBaseType_t uxPriorityBeforeCeiling )
+	{
+	TCB_t * const pxTCB = pxMutexHolder;
+	UBaseType_t uxPriorityToUse;
+	BaseType_t xReturn = pdFALSE;
+
+		if( pxMutexHolder != NULL )
+		{
+			/* As xTaskPriorityDisinherit(), the mutex can only be given by
+			the task that holds it. */
+			configASSERT( pxTCB == pxCurrentTCB );
+			configASSERT( pxTCB->uxMutexesHeld );
+			( pxTCB->uxMutexesHeld )--;
+
+			if( pxTCB->uxMutexesHeld == ( UBaseType_t ) 0 )
+			{
+				/* No other mutex can be the reason for a raised priority. */
+				uxPriorityToUse = pxTCB->uxBasePriority;
+			}
+			else if( pxTCB->uxPriority <= uxCeilingPriority )
+			{
+				/* Return to the priority the task had from the mutexes it
+				held when it took this one. */
+				uxPriorityToUse = uxPriorityBeforeCeiling;
+			}
+			else
+			{
+				/* The task has inherited a priority above the ceiling from
+				another mutex it still holds. */
+				uxPriorityToUse = pxTCB->uxPriority;
+			}
+
+			if( uxPriorityToUse != pxTCB->uxPriority )
+			{
+				prvSetInheritedPriority( pxTCB, uxPriorityToUse );
+
+				/* A task of a priority between the old and new priorities may
+				be ready. */
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_PRIORITY_CEILING_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if ( portCRITICAL_NESTING_IN_TCB == 1 )
 
 	void vTaskEnterCritical( void )
@@ -4712,7 +7827,7 @@ TickType_t uxReturn;
 				}
 				#endif
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4837,7 +7952,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4925,7 +8040,7 @@ TickType_t uxReturn;
 					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskSHOULD_PREEMPT( taskIS_MORE_URGENT( pxTCB, pxCurrentTCB ) ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -5003,8 +8118,8 @@ const TickType_t xConstTickCount = xTickCount;
 	if( uxListRemove( &( pxCurrentTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
 	{
 		/* The current task must be in a ready list, so there is no need to
-		check, and the port reset macro can be called directly. */
-		portRESET_READY_PRIORITY( pxCurrentTCB->uxPriority, uxTopReadyPriority ); /*lint !e931 pxCurrentTCB cannot change as it is the calling task.  pxCurrentTCB->uxPriority and uxTopReadyPriority cannot change as called with scheduler suspended or in a critical section. */
+		check, and the ready priority can be cleared directly. */
+		taskCLEAR_READY_PRIORITY( pxCurrentTCB->uxPriority ); /*lint !e931 pxCurrentTCB cannot change as it is the calling task.  pxCurrentTCB->uxPriority and uxTopReadyPriority cannot change as called with scheduler suspended or in a critical section. */
 	}
 	else
 	{
@@ -5034,8 +8149,23 @@ const TickType_t xConstTickCount = xTickCount;
 			{
 				/* Wake time has overflowed.  Place this item in the overflow
 				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				#if( configUSE_TIMING_WHEEL == 1 )
+				{
+					taskWHEEL_INSERT_END( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				}
+				#else
+				{
+					vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				}
+				#endif
+			}
+			#if( configUSE_TIMING_WHEEL == 1 )
+			else
+			{
+				/* Also updates xNextTaskUnblockTime if needs be. */
+				prvAddToTimingWheel( &( pxCurrentTCB->xStateListItem ) );
 			}
+			#else
 			else
 			{
 				/* The wake time has not overflowed, so the current block list
@@ -5054,6 +8184,7 @@ const TickType_t xConstTickCount = xTickCount;
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
+			#endif /* configUSE_TIMING_WHEEL */
 		}
 	}
 	#else /* INCLUDE_vTaskSuspend */
@@ -5069,8 +8200,23 @@ const TickType_t xConstTickCount = xTickCount;
 		if( xTimeToWake < xConstTickCount )
 		{
 			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			#if( configUSE_TIMING_WHEEL == 1 )
+			{
+				taskWHEEL_INSERT_END( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			}
+			#else
+			{
+				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			}
+			#endif
 		}
+		#if( configUSE_TIMING_WHEEL == 1 )
+		else
+		{
+			/* Also updates xNextTaskUnblockTime if needs be. */
+			prvAddToTimingWheel( &( pxCurrentTCB->xStateListItem ) );
+		}
+		#else
 		else
 		{
 			/* The wake time has not overflowed, so the current block list is used. */
@@ -5088,12 +8234,152 @@ const TickType_t xConstTickCount = xTickCount;
 				mtCOVERAGE_TEST_MARKER();
 			}
 		}
+		#endif /* configUSE_TIMING_WHEEL */
 
 		/* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
 		( void ) xCanBlockIndefinitely;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 }
+/*-----------------------------------------------------------*/
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	static void prvSelectHighestPriorityTask( BaseType_t xCoreID )
+	{
+	UBaseType_t uxCurrentPriority;
+	BaseType_t xTaskScheduled = pdFALSE;
+	TCB_t *pxPreviousTCB = pxCurrentTCBs[ xCoreID ], *pxTCB = NULL;
+	List_t *pxReadyList;
+	ListItem_t *pxIterator;
+	ListItem_t const *pxEndMarker;
+
+		/* Lower uxTopReadyPriority past the empty lists, as
+		taskSELECT_HIGHEST_PRIORITY_TASK() does for a single core.  A list
+		holding only tasks this core cannot run is still searched each time. */
+		while( listLIST_IS_EMPTY( &( pxReadyTasksLists[ uxTopReadyPriority ] ) ) != pdFALSE )
+		{
+			configASSERT( uxTopReadyPriority );
+			--uxTopReadyPriority;
+		}
+
+		for( uxCurrentPriority = uxTopReadyPriority; xTaskScheduled == pdFALSE; uxCurrentPriority-- )
+		{
+			pxReadyList = &( pxReadyTasksLists[ uxCurrentPriority ] );
+
+			if( listLIST_IS_EMPTY( pxReadyList ) == pdFALSE )
+			{
+				/* Search the list starting after the task last selected from
+				it, so tasks of equal priority take turns, as they do when
+				listGET_OWNER_OF_NEXT_ENTRY() is used.  The task this core is
+				already running can be selected again, but not a task running
+				on another core. */
+				pxEndMarker = listGET_END_MARKER( pxReadyList );
+				pxIterator = pxReadyList->pxIndex;
+
+				do
+				{
+					pxIterator = listGET_NEXT( pxIterator );
+
+					if( pxIterator != pxEndMarker )
+					{
+						pxTCB = listGET_LIST_ITEM_OWNER( pxIterator );
+
+						if( ( ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) || ( pxTCB->xTaskRunState == xCoreID ) ) &&
+							( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1 << xCoreID ) ) != ( UBaseType_t ) 0 ) )
+						{
+							pxReadyList->pxIndex = pxIterator;
+							xTaskScheduled = pdTRUE;
+						}
+					}
+				} while( ( xTaskScheduled == pdFALSE ) && ( pxIterator != pxReadyList->pxIndex ) );
+			}
+
+			if( uxCurrentPriority == tskIDLE_PRIORITY )
+			{
+				/* The idle task of each core can only run on that core, so
+				one is always found by this point. */
+				configASSERT( xTaskScheduled );
+				break;
+			}
+		}
+
+		if( pxPreviousTCB != NULL )
+		{
+			pxPreviousTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+		}
+
+		pxTCB->xTaskRunState = xCoreID;
+		pxCurrentTCBs[ xCoreID ] = pxTCB;
+
+		/* A task switched out while still ready may be able to preempt a lower
+		priority task on another core. */
+		if( ( pxPreviousTCB != NULL ) && ( pxPreviousTCB != pxTCB ) )
+		{
+			if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxPreviousTCB->uxPriority ] ), &( pxPreviousTCB->xStateListItem ) ) != pdFALSE )
+			{
+				prvYieldForTask( pxPreviousTCB );
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvYieldForTask( TCB_t *pxTCB )
+	{
+		#if( configUSE_PREEMPTION == 1 )
+		{
+		BaseType_t xCoreID, xThisCoreID, xLowestCoreID = -1;
+		UBaseType_t uxLowestPriority = pxTCB->uxPriority, uxRunningPriority;
+
+			if( ( xSchedulerRunning != pdFALSE ) && ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) )
+			{
+				/* Find the core running the lowest priority task that pxTCB
+				can preempt, preferring this core if more than one is running
+				that priority.  A core that is already going to select a new
+				task is left alone, as it will consider pxTCB when it does. */
+				xThisCoreID = ( BaseType_t ) portGET_CORE_ID();
+
+				for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+				{
+					if( ( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1 << xCoreID ) ) != ( UBaseType_t ) 0 ) && ( xYieldPendings[ xCoreID ] == pdFALSE ) )
+					{
+						uxRunningPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+
+						if( ( uxRunningPriority < uxLowestPriority ) ||
+							( ( xCoreID == xThisCoreID ) && ( xLowestCoreID >= 0 ) && ( uxRunningPriority == uxLowestPriority ) ) )
+						{
+							uxLowestPriority = uxRunningPriority;
+							xLowestCoreID = xCoreID;
+						}
+					}
+				}
+
+				if( xLowestCoreID >= 0 )
+				{
+					prvYieldCore( xLowestCoreID );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		#else
+		{
+			/* Without preemption a readied task waits for a core to yield. */
+			( void ) pxTCB;
+		}
+		#endif /* configUSE_PREEMPTION */
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvYieldCore( BaseType_t xCoreID )
+	{
+		xYieldPendings[ xCoreID ] = pdTRUE;
+		portYIELD_CORE( xCoreID );
+	}
+
+#endif /* configNUMBER_OF_CORES */
 
 /* Code below here allows additional code to be inserted into this source file,
 especially where access to file scope functions and data is needed (for example